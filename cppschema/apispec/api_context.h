@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "cppschema/apispec/task_pool.h"
+
+namespace cppschema {
+
+/**
+ * What the framework offers to a backend method during a call, passed to the methods which take
+ * it (see `ImplMethod`). For now, the `TaskPool` for splitting the work of a call across the cores.
+ *
+ * @example
+ * Expected<std::vector<std::string>> addEdgesImpl(const AddEdgesRequest& request,
+ *                                                 const ApiContext& context) {
+ *     std::vector<std::string> ids(request.entries.size());
+ *     context.ParallelFor(0, ids.size(), 1024, [&](size_t begin, size_t end) { ... });
+ *     ...
+ * }
+ */
+class ApiContext {
+public:
+    ApiContext(const char* api, TaskPool* pool) : api_(api), pool_(pool) {}
+
+    // The name of the API method called.
+    const char* api() const { return api_; }
+
+    TaskPool& pool() const { return *pool_; }
+
+    // See `TaskPool::ParallelFor`.
+    template <typename Body>
+    void ParallelFor(size_t begin, size_t end, size_t grain, Body&& body) const {
+        pool_->ParallelFor(begin, end, grain, std::forward<Body>(body));
+    }
+
+    // See `TaskPool::ParallelReduce`.
+    template <typename T, typename Map, typename Combine>
+    T ParallelReduce(size_t begin, size_t end, size_t grain, T init, Map&& map, Combine&& combine) const {
+        return pool_->ParallelReduce(begin, end, grain, std::move(init), std::forward<Map>(map),
+            std::forward<Combine>(combine));
+    }
+
+private:
+    const char* api_;
+    TaskPool* pool_;
+};
+
+}  // namespace cppschema
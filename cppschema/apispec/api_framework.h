@@ -1,25 +1,174 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
+#include "cppschema/apispec/api_context.h"
+#include "cppschema/apispec/api_policies.h"
+#include "cppschema/apispec/request_view.h"
+#include "cppschema/apispec/task.h"
+#include "cppschema/common/status.h"
 #include "cppschema/common/types.h"
 #include "cppschema/common/visitor_macros.h"
 
 namespace cppschema {
 
-// This is an empty struct used to convery the types.
-template <typename Req, typename Res>
+// This is an empty struct used to convery the types, and the policies of the API (see
+// api_policies.h).
+template <typename Req, typename Res, typename... Policies>
 struct ApiStub {
     using RequestType = Req;
     using ResponseType = Res;
+    using PolicyTypes = ApiPolicies<Policies...>;
 };
 
+/**
+ * A writer for the elements of an array response (`std::vector<T>`). A backend method taking one
+ * (see `ImplMethod`) emits the elements one by one, and they go straight into the output of the
+ * caller: a JS array, the wire encoded response, or a native vector, without an intermediate
+ * container.
+ *
+ * @example
+ * Status addEdgesImpl(const AddEdgesRequest& request, ArraySink<std::string>* edge_ids) {
+ *     edge_ids->Reserve(request.entries.size());
+ *     for (const EdgeConnection& conn : request.entries) {
+ *         edge_ids->Append("edge_" + std::to_string(conn.id.value));
+ *     }
+ *     return OkStatus();
+ * }
+ */
+template <typename T>
+class ArraySink {
+public:
+    virtual ~ArraySink() = default;
+
+    // A hint of the number of elements to come.
+    virtual void Reserve(size_t /*count*/) {}
+    virtual void Append(T&& item) = 0;
+
+    void Append(const T& item) { Append(T(item)); }
+};
+
+// Collects the elements into a native vector, for the C++ callers.
+template <typename T, typename A = std::allocator<T>>
+class VectorSink final : public ArraySink<T> {
+public:
+    explicit VectorSink(std::vector<T, A>* out) : out_(out) {}
+
+    void Reserve(size_t count) override { out_->reserve(out_->size() + count); }
+    void Append(T&& item) override { out_->push_back(std::move(item)); }
+    using ArraySink<T>::Append;
+
+private:
+    std::vector<T, A>* out_;
+};
+
+namespace internal {
+
+// Placeholder sink of the responses which are not arrays, these can not be streamed.
+struct NoResponseSink {};
+
+template <typename Res>
+struct ResponseSinkOf {
+    using type = NoResponseSink;
+};
+template <typename T, typename A>
+struct ResponseSinkOf<std::vector<T, A>> {
+    using type = ArraySink<T>;
+};
+
+}  // namespace internal
+
+// The sink type of a response, `ArraySink<T>` for `std::vector<T>`.
+template <typename Res>
+using ResponseSink = typename internal::ResponseSinkOf<Res>::type;
+
+template <typename Res>
+inline constexpr bool kHasResponseSink = !std::is_same_v<ResponseSink<Res>, internal::NoResponseSink>;
+
 // Base class for backends to identify themselves
 template <typename API>
 struct ApiBackend {
     virtual ~ApiBackend() = default;
 };
 
+/**
+ * A backend method implementing an `ApiStub<Req, Res>`, as stored in the `ImplPtrs` fields. It
+ * accepts any of the supported signatures:
+ *
+ * @example
+ * Res method(const Req& req);                  // Always succeeds.
+ * Expected<Res> method(const Req& req);        // Returns `Unexpected(status)` on failure.
+ * Res method(const Req& req, Status* status);  // Sets `*status` on failure.
+ * Status method(const Req& req, ArraySink<T>* sink);  // Streams the elements of a vector<T>.
+ * Task<Res> method(const Req& req);            // A coroutine, which may wait on I/O.
+ * Expected<Res> method(const RequestView<Req>& req);  // Decodes the fields it reads, see `RequestView`.
+ * Expected<Res> method(const Req& req, const ApiContext& context);  // Runs parallel loops.
+ *
+ * The coroutine methods run on the `TaskScheduler` of the calling thread, see
+ * `ApiRegistry::TryCallAsync`. The other signatures run to completion within the call.
+ *
+ * A missing (nullptr) method is not registered, and calling it returns an `UNIMPLEMENTED` status.
+ */
+template <typename T, typename Req, typename Res>
+class ImplMethod {
+public:
+    using PlainPtr = Res (T::*)(const Req&);
+    using ExpectedPtr = Expected<Res> (T::*)(const Req&);
+    using StatusSinkPtr = Res (T::*)(const Req&, Status*);
+    using ResponseSinkPtr = Status (T::*)(const Req&, ResponseSink<Res>*);
+    using TaskPtr = Task<Res> (T::*)(const Req&);
+    using ViewPtr = Expected<Res> (T::*)(const RequestView<Req>&);
+    using ContextPtr = Expected<Res> (T::*)(const Req&, const ApiContext&);
+
+    ImplMethod() = default;
+    ImplMethod(std::nullptr_t) {}
+    ImplMethod(PlainPtr ptr) : ptr_(ptr) {}
+    ImplMethod(ExpectedPtr ptr) : ptr_(ptr) {}
+    ImplMethod(StatusSinkPtr ptr) : ptr_(ptr) {}
+    ImplMethod(ResponseSinkPtr ptr) : ptr_(ptr) {}
+    ImplMethod(TaskPtr ptr) : ptr_(ptr) {}
+    ImplMethod(ViewPtr ptr) : ptr_(ptr) {}
+    ImplMethod(ContextPtr ptr) : ptr_(ptr) {}
+
+    explicit operator bool() const {
+        return ptr_.index() != 0;
+    }
+
+    // Calls `visitor` with the typed member pointer, if set. This lets the caller specialize the
+    // dispatch once at registration, instead of checking the signature on every call.
+    template <typename Visitor>
+    void Visit(Visitor&& visitor) const {
+        if (const auto* ptr = std::get_if<PlainPtr>(&ptr_)) {
+            visitor(*ptr);
+        } else if (const auto* ptr = std::get_if<ExpectedPtr>(&ptr_)) {
+            visitor(*ptr);
+        } else if (const auto* ptr = std::get_if<StatusSinkPtr>(&ptr_)) {
+            visitor(*ptr);
+        } else if (const auto* ptr = std::get_if<TaskPtr>(&ptr_)) {
+            visitor(*ptr);
+        } else if (const auto* ptr = std::get_if<ContextPtr>(&ptr_)) {
+            visitor(*ptr);
+        } else if constexpr (internal::is_visible_struct_like<Req>::value) {
+            if (const auto* ptr = std::get_if<ViewPtr>(&ptr_)) {
+                visitor(*ptr);
+            }
+        }
+        if constexpr (kHasResponseSink<Res>) {
+            if (const auto* ptr = std::get_if<ResponseSinkPtr>(&ptr_)) {
+                visitor(*ptr);
+            }
+        }
+    }
+
+private:
+    std::variant<std::monostate, PlainPtr, ExpectedPtr, StatusSinkPtr, ResponseSinkPtr, TaskPtr, ViewPtr,
+        ContextPtr> ptr_;
+};
+
 }  // namespace cppschema
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace cppschema {
+
+/**
+ * The performance policies of an API, as tags after the types of its `ApiStub`. By default a call
+ * from JS decodes the whole request, checking for the missing properties, runs synchronously
+ * unless the backend method is a coroutine, and returns `{data, ok, status}`. Each tag changes one
+ * of these trade-offs, for the APIs which declare it only.
+ *
+ * @example
+ * struct GraphApi {
+ *     ApiStub<std::string, NodeInfo, Cacheable, NoStatusWrapper> getNode;
+ *     ApiStub<AddNodeRequest, std::string, Batchable> addNode;
+ *     ApiStub<EdgesRequest, std::vector<EdgeInfo>, SkipMissingFieldDefaults, Trace> getEdges;
+ *     DEFINE_API_VISITOR_FUNCTION(getNode, addNode, getEdges);
+ * };
+ */
+
+// JS gets the response data itself, instead of `{data, ok, status}`. A failed call returns
+// `undefined` (or rejects its promise with an `Error`), and the `lastStatus` property of the API
+// object has the status of the last call, as "ok" or "<CODE>: <message>".
+struct NoStatusWrapper {};
+
+// The responses are kept by request, and returned without calling the backend again until a
+// method of the API without this tag is called. For the methods which only read the backend. The
+// requests are wire encoded (see cppschema/common/wire_codec.h) as the keys, and the coroutine
+// methods are not cached.
+struct Cacheable {};
+
+// The responses cached per method. Once full, they are all dropped.
+inline constexpr size_t kMaxCachedResponses = 1024;
+
+// JS always gets a promise of the response, and the call goes through `TryCallAsync`, without
+// checking on each call whether the backend method is a coroutine.
+struct Async {};
+
+// Same as `Async`, for the methods given a batch handler (see `RegisterBatchMethod`). JS gets a
+// promise even before the batch handler is registered, so the calls do not change shape.
+struct Batchable {};
+
+// The JS requests have all their properties, so they are converted without checking for the
+// missing ones, which are otherwise left default initialized: a property fewer to check per
+// field, and no defaults to fill in for the value objects. A missing property then fails the
+// call. Only the properties of the request itself, its nested objects are checked as usual.
+struct SkipMissingFieldDefaults {};
+
+// The calls are traced (see cppschema/common/trace.h) even in the builds without
+// CPPSCHEMA_TRACING, for looking into a few APIs without paying for the spans of all of them.
+struct Trace {};
+
+namespace internal {
+
+template <typename Policy>
+inline constexpr bool is_api_policy_v =
+    std::is_same_v<Policy, NoStatusWrapper> || std::is_same_v<Policy, Cacheable> ||
+    std::is_same_v<Policy, Async> || std::is_same_v<Policy, Batchable> ||
+    std::is_same_v<Policy, SkipMissingFieldDefaults> || std::is_same_v<Policy, Trace>;
+
+}  // namespace internal
+
+// The policies of an `ApiStub`, as its `PolicyTypes`.
+template <typename... Policies>
+struct ApiPolicies {
+    static_assert((internal::is_api_policy_v<Policies> && ...), "Unknown API policy, see api_policies.h");
+
+    template <typename Policy>
+    static constexpr bool kHas = (std::is_same_v<Policy, Policies> || ...);
+};
+
+// True if the api of `Traits` (see DEFINE_API_VISITOR_FUNCTION) declares `Policy`.
+template <typename Traits, typename Policy>
+inline constexpr bool kHasPolicy = [] {
+    if constexpr (requires { typename Traits::PolicyTypes; }) {
+        return Traits::PolicyTypes::template kHas<Policy>;
+    } else {
+        return false;
+    }
+}();
+
+}  // namespace cppschema
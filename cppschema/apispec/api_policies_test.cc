@@ -0,0 +1,164 @@
+#include "cppschema/apispec/api_policies.h"
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/task.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/trace.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::Async;
+using ::cppschema::ArraySink;
+using ::cppschema::Cacheable;
+using ::cppschema::Expected;
+using ::cppschema::kHasPolicy;
+using ::cppschema::NoStatusWrapper;
+using ::cppschema::RegisterBatchMethod;
+using ::cppschema::ScopedRegister;
+using ::cppschema::Status;
+using ::cppschema::StatusCode;
+using ::cppschema::TaskScheduler;
+using ::cppschema::Trace;
+
+struct StoreApi {
+    ApiStub<std::string, int32_t, Cacheable, NoStatusWrapper> get;
+    ApiStub<int32_t, std::vector<std::string>, Cacheable> list;
+    ApiStub<std::string, bool> put;
+    ApiStub<std::string, bool, Async> putAll;
+    ApiStub<std::string, int32_t, Trace> count;
+
+    DEFINE_API_VISITOR_FUNCTION(get, list, put, putAll, count);
+};
+
+static_assert(kHasPolicy<StoreApi::get_traits, Cacheable>);
+static_assert(kHasPolicy<StoreApi::get_traits, NoStatusWrapper>);
+static_assert(!kHasPolicy<StoreApi::get_traits, Async>);
+static_assert(!kHasPolicy<StoreApi::put_traits, Cacheable>);
+static_assert(kHasPolicy<StoreApi::putAll_traits, Async>);
+
+// A multiset of strings, which counts the calls of its methods.
+class StoreApiImpl : public cppschema::ApiBackend<StoreApi> {
+public:
+    Expected<int32_t> getImpl(const std::string& key) {
+        ++get_calls;
+        if (key.empty()) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError("Empty key"));
+        }
+        return static_cast<int32_t>(std::count(values.begin(), values.end(), key));
+    }
+
+    Status listImpl(const int32_t& limit, ArraySink<std::string>* sink) {
+        ++list_calls;
+        for (int32_t i = 0; i < limit && i < static_cast<int32_t>(values.size()); ++i) {
+            sink->Append(values[i]);
+        }
+        return cppschema::OkStatus();
+    }
+
+    bool putImpl(const std::string& value) {
+        values.push_back(value);
+        return true;
+    }
+
+    Expected<std::vector<bool>> putBatchImpl(std::span<const std::string> batch) {
+        values.insert(values.end(), batch.begin(), batch.end());
+        return std::vector<bool>(batch.size(), true);
+    }
+
+    int32_t countImpl(const std::string&) { return static_cast<int32_t>(values.size()); }
+
+    std::vector<std::string> values;
+    int get_calls = 0;
+    int list_calls = 0;
+};
+
+class ApiPoliciesTest : public testing::Test {
+protected:
+    int32_t Get(const std::string& key) {
+        int32_t count = -1;
+        EXPECT_TRUE((registry_.TryCall<std::string, int32_t>("get", key, &count)).ok());
+        return count;
+    }
+
+    StoreApiImpl* impl_ = new StoreApiImpl();
+    ScopedRegister<StoreApi, StoreApiImpl> backend_{impl_, {
+        .get = &StoreApiImpl::getImpl,
+        .list = &StoreApiImpl::listImpl,
+        .put = &StoreApiImpl::putImpl,
+        .putAll = &StoreApiImpl::putImpl,
+        .count = &StoreApiImpl::countImpl,
+    }};
+    ApiRegistry<StoreApi>& registry_ = ApiRegistry<StoreApi>::Get();
+};
+
+TEST_F(ApiPoliciesTest, CachesUntilAnotherMethodIsCalled) {
+    impl_->values = {"a", "b", "a"};
+    EXPECT_EQ(Get("a"), 2);
+    EXPECT_EQ(Get("a"), 2);
+    EXPECT_EQ(Get("b"), 1);
+    EXPECT_EQ(impl_->get_calls, 2);
+
+    bool added = false;
+    ASSERT_TRUE((registry_.TryCall<std::string, bool>("put", "a", &added)).ok());
+    EXPECT_EQ(Get("a"), 3);
+    EXPECT_EQ(impl_->get_calls, 3);
+
+    // The errors are not cached.
+    int32_t count = 0;
+    EXPECT_EQ((registry_.TryCall<std::string, int32_t>("get", "", &count)).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ((registry_.TryCall<std::string, int32_t>("get", "", &count)).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(impl_->get_calls, 5);
+}
+
+TEST_F(ApiPoliciesTest, CachesTheStreamedResponses) {
+    impl_->values = {"a", "b", "c"};
+    // Cached as vectors, so the streams are served from them.
+    EXPECT_FALSE(registry_.IsStreaming("list"));
+    std::vector<std::string> values;
+    cppschema::VectorSink<std::string> sink(&values);
+    ASSERT_TRUE((registry_.TryStream<int32_t, std::vector<std::string>>("list", 2, &sink)).ok());
+    ASSERT_TRUE((registry_.TryStream<int32_t, std::vector<std::string>>("list", 2, &sink)).ok());
+    EXPECT_EQ(values, (std::vector<std::string>{"a", "b", "a", "b"}));
+    EXPECT_EQ(impl_->list_calls, 1);
+}
+
+TEST_F(ApiPoliciesTest, BatchesAndCoroutinesInvalidateTheCache) {
+    ASSERT_TRUE(RegisterBatchMethod<StoreApi>("putAll", impl_, &StoreApiImpl::putBatchImpl).ok());
+    EXPECT_EQ(Get("x"), 0);
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    std::optional<Expected<bool>> added;
+    scheduler.Spawn(registry_.TryCallAsync<std::string, bool>("putAll", "x"),
+        [&added](Expected<bool> res) { added = std::move(res); });
+    scheduler.RunUntilIdle();
+    ASSERT_TRUE(added.has_value() && added->has_value());
+    EXPECT_EQ(Get("x"), 1);
+    EXPECT_EQ(impl_->get_calls, 2);
+}
+
+TEST_F(ApiPoliciesTest, TracesWithoutTheFlag) {
+    cppschema::trace::ClearTrace();
+    int32_t count = 0;
+    ASSERT_TRUE((registry_.TryCall<std::string, int32_t>("count", "", &count)).ok());
+    bool added = false;
+    ASSERT_TRUE((registry_.TryCall<std::string, bool>("put", "a", &added)).ok());
+    const std::string trace = cppschema::trace::ExportChromeTrace();
+    EXPECT_NE(trace.find(R"("name":"count","cat":"backend")"), std::string::npos) << trace;
+    if constexpr (!cppschema::trace::kTracingEnabled) {
+        // Only the apis with the policy.
+        EXPECT_EQ(trace.find(R"("name":"put")"), std::string::npos) << trace;
+    }
+}
+
+}  // namespace
@@ -1,17 +1,35 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <type_traits>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/batcher.h"
+#include "cppschema/apispec/call_recorder.h"
+#include "cppschema/apispec/task.h"
+#include "cppschema/common/request_limits.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/trace.h"
 
 namespace cppschema {
 
 template <typename API>
 class ApiRegistry {
 public:
-    // A type-erased wrapper that handles the conversion internally
-    using RawDispatcher = std::function<void*(const void*)>;
+    // A type-erased wrapper that handles the conversion internally. It reads the request from the
+    // first argument, and on success writes the response to the second one. For the streaming
+    // dispatchers, the second argument is a `ResponseSink<Res>`.
+    using RawDispatcher = std::function<Status(const void* req, void* res)>;
+    // Same, for the coroutine backend methods: the returned task writes the response on success.
+    using AsyncDispatcher = std::function<Task<VoidType>(const void* req, void* res)>;
     using InstanceDeleter = std::function<void(void*)>;
 
     static ApiRegistry& Get() {
@@ -38,22 +56,248 @@ public:
         deleter_ = std::move(deleter);
     }
 
-    void RegisterHandler(const std::string& name, RawDispatcher func) {
-        dispatchers_[name] = std::move(func);
+    // `stream` is set for the backend methods writing to a `ResponseSink`.
+    void RegisterHandler(std::string_view name, RawDispatcher func, RawDispatcher stream = nullptr) {
+        const char* trace_name = nullptr;
+        if constexpr (trace::kTracingEnabled) {
+            trace_name = trace::PersistentName(name);
+        }
+        dispatchers_.insert_or_assign(std::string(name),
+                                      Handler{std::move(func), std::move(stream), nullptr, nullptr, nullptr, nullptr, trace_name});
+    }
+
+    // For the backend methods taking a `RequestView`. `view` reads a `RequestView<Req>`, and `func`
+    // a decoded request.
+    void RegisterViewHandler(std::string_view name, RawDispatcher func, RawDispatcher view) {
+        const char* trace_name = nullptr;
+        if constexpr (trace::kTracingEnabled) {
+            trace_name = trace::PersistentName(name);
+        }
+        dispatchers_.insert_or_assign(std::string(name),
+                                      Handler{std::move(func), nullptr, nullptr, nullptr, nullptr, std::move(view), trace_name});
     }
 
-    // This is called by the Dispatcher
+    // For the backend methods returning a `Task`.
+    void RegisterAsyncHandler(std::string_view name, AsyncDispatcher func) {
+        const char* trace_name = nullptr;
+        if constexpr (trace::kTracingEnabled) {
+            trace_name = trace::PersistentName(name);
+        }
+        dispatchers_.insert_or_assign(std::string(name), Handler{nullptr, nullptr, std::move(func), nullptr, nullptr, nullptr, trace_name});
+    }
+
+    // Adds a batch dispatcher (see `RegisterBatchMethod`) to the registered handler of `name`,
+    // which serves the calls made with `TryCallAsync`.
+    Status RegisterBatchHandler(std::string_view name, AsyncDispatcher func, std::function<BatchStats()> stats) {
+        auto it = dispatchers_.find(name);
+        if (it == dispatchers_.end()) {
+            return FailedPreconditionError("Register the method before its batch handler: " + std::string(name));
+        }
+        it->second.batch = std::move(func);
+        it->second.batch_stats = std::move(stats);
+        return OkStatus();
+    }
+
+    /**
+     * Calls the backend method of an API, and writes its response to `res` on success. Failures
+     * come back as the returned status, never as an abort or an exception:
+     * - FAILED_PRECONDITION if no backend is registered.
+     * - UNIMPLEMENTED if the backend has no method for the API.
+     * - Any error returned by the backend method.
+     *
+     * @example
+     * std::string nodeId;
+     * Status status = registry.TryCall<AddNodeRequest, std::string>("addNode", req, &nodeId);
+     *
+     * A successful call makes no allocations of its own, only those of the backend method (see
+     * api_registry_alloc_test.cc). With tracing (see cppschema/common/trace.h), the lookup and
+     * the backend method are recorded as spans. With a `CallRecorder` installed, the call is
+     * recorded for replaying.
+     *
+     * A coroutine backend method (see `Task`) is run to completion on the `TaskScheduler` of the
+     * thread, which blocks until the other threads complete what it awaits. In the builds without
+     * threads, it returns FAILED_PRECONDITION instead if the method is still waiting once the
+     * scheduler is idle, and the method then completes in the background: use `TryCallAsync`.
+     */
+    template <typename Req, typename Res>
+    Status TryCall(std::string_view name, const Req& req, Res* res) {
+        if (CallRecorder* recorder = ActiveCallRecorder()) [[unlikely]] {
+            recorder->Record(name, req);
+        }
+        [[maybe_unused]] trace::CallScope call;
+        const Handler* handler = nullptr;
+        if (Status status = FindHandler(name, &handler); !status.ok()) {
+            return status;
+        }
+        trace::ScopedSpan span(handler->trace_name, trace::kBackend, trace::PayloadSize(req));
+        return Invoke(*handler, req, res);
+    }
+
+    // True if the backend method of an API takes a `RequestView`. Then `TryCallView` decodes only
+    // the fields it reads.
+    bool TakesView(std::string_view name) const {
+        auto it = dispatchers_.find(name);
+        return it != dispatchers_.end() && it->second.view != nullptr;
+    }
+
+    /**
+     * Same as `TryCall`, with a request which may not be decoded yet (see `RequestView`). The
+     * backend methods taking a view decode the fields they read, the others the whole request. A
+     * field which fails to decode fails the call with its error.
+     *
+     * @example
+     * RequestView<ImportRequest> view(&DecodeField, &source);
+     * Status status = registry.TryCallView<ImportRequest, uint32_t>("import", view, &count);
+     *
+     * With a `CallRecorder` installed, the whole request is decoded to be recorded.
+     */
     template <typename Req, typename Res>
-    Res Call(const std::string& name, const Req& req) {
-        assert(backend_instance_ != nullptr && "Backend not set");
+    Status TryCallView(std::string_view name, const RequestView<Req>& view, Res* res) {
+        if (CallRecorder* recorder = ActiveCallRecorder()) [[unlikely]] {
+            recorder->Record(name, view.request());
+        }
+        [[maybe_unused]] trace::CallScope call;
+        const Handler* handler = nullptr;
+        if (Status status = FindHandler(name, &handler); !status.ok()) {
+            return status;
+        }
+        trace::ScopedSpan span(handler->trace_name, trace::kBackend);
+        Status status = handler->view != nullptr
+            ? handler->view(static_cast<const void*>(&view), static_cast<void*>(res))
+            : Invoke(*handler, view.request(), res);
+        if (!view.status().ok()) {
+            return view.status();
+        }
+        return status;
+    }
+
+    // True if the backend method of an API is a coroutine, or has a batch handler. Then
+    // `TryCallAsync` lets the other calls run while it waits.
+    bool IsAsync(std::string_view name) const {
         auto it = dispatchers_.find(name);
-        assert(it != dispatchers_.end() && "Method not implemented");
-        void* rawRes = it->second(static_cast<const void*>(&req));
-        // Cast back to the expected type and clean up the heap-allocated response
-        Res* typedRes = static_cast<Res*>(rawRes);
-        Res finalRes = std::move(*typedRes);
-        delete typedRes; 
-        return finalRes;
+        return it != dispatchers_.end() && (it->second.async != nullptr || it->second.batch != nullptr);
+    }
+
+    // The sizes of the batches dispatched to the batch handler of an API, if any.
+    BatchStats GetBatchStats(std::string_view name) const {
+        auto it = dispatchers_.find(name);
+        if (it == dispatchers_.end() || it->second.batch_stats == nullptr) {
+            return BatchStats();
+        }
+        return it->second.batch_stats();
+    }
+
+    // Bounds the size of the requests of an API, as they are decoded from JS (see `RequestLimits`).
+    // Kept across the backend registrations.
+    void SetRequestLimits(std::string_view name, const RequestLimits& limits) {
+        request_limits_.insert_or_assign(std::string(name), limits);
+    }
+
+    // The limits of the requests of an API, or null if unlimited.
+    const RequestLimits* GetRequestLimits(std::string_view name) const {
+        if (request_limits_.empty()) [[likely]] {
+            return nullptr;
+        }
+        auto it = request_limits_.find(name);
+        return it != request_limits_.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * Same as `TryCall`, as a task completing with the response. The task owns the request, and
+     * runs once awaited or spawned on a `TaskScheduler`, interleaved with the other tasks while the
+     * coroutine backend methods wait. The other backend methods run to completion when the task
+     * starts. The calls of a method with a batch handler are buffered and dispatched together,
+     * see `RegisterBatchMethod`. The backend must stay registered until the task completes.
+     *
+     * @example
+     * TaskScheduler& scheduler = TaskScheduler::Get();
+     * scheduler.Spawn(registry.TryCallAsync<LoadRequest, Graph>("load", req), [](Expected<Graph> graph) {
+     *     ...
+     * });
+     * scheduler.RunUntilIdle();
+     *
+     * The calls are recorded by a `CallRecorder` as they are made. They are not traced: the spans
+     * of the interleaved calls would not nest.
+     */
+    template <typename Req, typename Res>
+    Task<Res> TryCallAsync(std::string_view name, Req req) {
+        if (CallRecorder* recorder = ActiveCallRecorder()) [[unlikely]] {
+            recorder->Record(name, req);
+        }
+        const Handler* handler = nullptr;
+        if (Status status = FindHandler(name, &handler); !status.ok()) {
+            return Failed<Res>(std::move(status));
+        }
+        if (handler->batch != nullptr) {
+            return RunAsync<Req, Res>(&handler->batch, std::move(req));
+        }
+        if (handler->async != nullptr) {
+            return RunAsync<Req, Res>(&handler->async, std::move(req));
+        }
+        return RunSync<Req, Res>(handler, std::move(req));
+    }
+
+    // Drops the responses cached for the `Cacheable` methods (see api_policies.h). The other
+    // methods of their API call it as they return, since they may change what the cached ones
+    // would return.
+    void InvalidateResponseCaches() {
+        response_cache_generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // Changes whenever the cached responses are invalidated.
+    uint64_t response_cache_generation() const {
+        return response_cache_generation_.load(std::memory_order_acquire);
+    }
+
+    // True if the backend method of an API writes to a `ResponseSink`. Then `TryStream` skips the
+    // response container, otherwise it only adds a pass over it.
+    bool IsStreaming(std::string_view name) const {
+        auto it = dispatchers_.find(name);
+        return it != dispatchers_.end() && it->second.stream != nullptr;
+    }
+
+    /**
+     * Same as `TryCall` for the array responses, but the elements are appended to `sink`, e.g. to
+     * encode them as they come. On failure, the sink may have received a part of them.
+     *
+     * @example
+     * jsbridge::JsArraySink<EdgeInfo> sink;
+     * Status status = registry.TryStream<EdgesRequest, std::vector<EdgeInfo>>("getEdges", req, &sink);
+     */
+    template <typename Req, typename Res>
+    Status TryStream(std::string_view name, const Req& req, ResponseSink<Res>* sink) {
+        static_assert(kHasResponseSink<Res>, "Only the array responses can be streamed");
+        if (CallRecorder* recorder = ActiveCallRecorder()) [[unlikely]] {
+            recorder->Record(name, req);
+        }
+        [[maybe_unused]] trace::CallScope call;
+        const Handler* handler = nullptr;
+        if (Status status = FindHandler(name, &handler); !status.ok()) {
+            return status;
+        }
+        trace::ScopedSpan span(handler->trace_name, trace::kBackend, trace::PayloadSize(req));
+        if (handler->stream != nullptr) {
+            return handler->stream(static_cast<const void*>(&req), static_cast<void*>(sink));
+        }
+        Res res{};
+        Status status = Invoke(*handler, req, &res);
+        if (status.ok()) {
+            sink->Reserve(res.size());
+            for (auto& item : res) {
+                sink->Append(std::move(item));
+            }
+        }
+        return status;
+    }
+
+    // Same as `TryCall`, for the callers which expect the call to succeed. Asserts in debug
+    // builds, and returns a default constructed response otherwise.
+    template <typename Req, typename Res>
+    Res Call(std::string_view name, const Req& req) {
+        Res res{};
+        [[maybe_unused]] const Status status = TryCall<Req, Res>(name, req, &res);
+        assert(status.ok() && "Call failed, use TryCall to handle the errors");
+        return res;
     }
 
     ~ApiRegistry() {
@@ -70,8 +314,91 @@ private:
     ApiRegistry(ApiRegistry&&) = delete;
     ApiRegistry& operator=(ApiRegistry&&) = delete;
 
-    // Internal storage for method dispatchers.
-    std::map<std::string, RawDispatcher> dispatchers_;
+    struct Handler {
+        RawDispatcher call;
+        RawDispatcher stream;
+        // Set instead of `call` for the coroutine backend methods.
+        AsyncDispatcher async;
+        // Set in addition to the others for the methods with a batch handler.
+        AsyncDispatcher batch;
+        std::function<BatchStats()> batch_stats;
+        // Set in addition to `call` for the methods taking a `RequestView`.
+        RawDispatcher view;
+        // The name in the trace spans, which outlives the registration.
+        const char* trace_name;
+    };
+
+    Status FindHandler(std::string_view name, const Handler** handler) const {
+        trace::ScopedSpan span("", trace::kLookup);
+        if (backend_instance_ == nullptr) {
+            return FailedPreconditionError("Backend not set");
+        }
+        auto it = dispatchers_.find(name);
+        if (it == dispatchers_.end()) {
+            return UnimplementedError("Method not implemented: " + std::string(name));
+        }
+        *handler = &it->second;
+        span.set_name(it->second.trace_name);
+        return OkStatus();
+    }
+
+    template <typename Req, typename Res>
+    static Status Invoke(const Handler& handler, const Req& req, Res* res) {
+        if (handler.async != nullptr) [[unlikely]] {
+            return CallAndWait(handler, req, res);
+        }
+        return handler.call(static_cast<const void*>(&req), static_cast<void*>(res));
+    }
+
+    // Runs a coroutine backend method on the scheduler of the thread, see `TryCall`.
+    template <typename Req, typename Res>
+    static Status CallAndWait(const Handler& handler, const Req& req, Res* res) {
+        // Shared with the task, which may outlive the call in the builds without threads.
+        auto result = std::make_shared<std::optional<Expected<Res>>>();
+        TaskScheduler& scheduler = TaskScheduler::Get();
+        scheduler.Spawn(RunAsync<Req, Res>(&handler.async, req), [result](Expected<Res> value) {
+            result->emplace(std::move(value));
+        });
+        if (!scheduler.RunUntil([&] { return result->has_value(); })) {
+            return FailedPreconditionError("The backend method is waiting, call it with TryCallAsync");
+        }
+        Expected<Res>& value = **result;
+        if (!value.has_value()) {
+            return std::move(value).error();
+        }
+        *res = std::move(value).value();
+        return OkStatus();
+    }
+
+    template <typename Req, typename Res>
+    static Task<Res> RunAsync(const AsyncDispatcher* dispatcher, Req req) {
+        Res res{};
+        Expected<VoidType> done = co_await (*dispatcher)(static_cast<const void*>(&req), static_cast<void*>(&res));
+        if (!done.has_value()) {
+            co_return Unexpected(std::move(done).error());
+        }
+        co_return std::move(res);
+    }
+
+    template <typename Req, typename Res>
+    static Task<Res> RunSync(const Handler* handler, Req req) {
+        Res res{};
+        Status status = handler->call(static_cast<const void*>(&req), static_cast<void*>(&res));
+        if (!status.ok()) {
+            co_return Unexpected(std::move(status));
+        }
+        co_return std::move(res);
+    }
+
+    template <typename Res>
+    static Task<Res> Failed(Status status) {
+        co_return Unexpected(std::move(status));
+    }
+
+    // Internal storage for method dispatchers. Looked up by `string_view`, without a temporary.
+    std::map<std::string, Handler, std::less<>> dispatchers_;
+    std::map<std::string, RequestLimits, std::less<>> request_limits_;
+    std::atomic<uint64_t> response_cache_generation_ = 0;
 
     // Backend instance and its deleter for lifecycle management
     void* backend_instance_ = nullptr;
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/strong_types.h"
+#include "cppschema/common/visitor_macros.h"
+#include "cppschema/common/wire_codec.h"
+#include "cppschema/testing/alloc_counter.h"
+#include "gtest/gtest.h"
+
+// Guards the number of heap allocations per API call. The dispatch itself must not allocate, and
+// the values must be moved from the backend to the caller, not copied. If a change breaks this,
+// fix the change rather than the expected counts.
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::Expected;
+using ::cppschema::ScopedRegister;
+using ::cppschema::Status;
+using ::cppschema::testing::AllocationCounter;
+
+DEFINE_STRONG_STRING_TYPE(Label);
+
+// Longer than the small string buffer, so that each copy of it allocates.
+const std::string kLongLabel(100, 'x');
+
+struct CounterApi {
+    ApiStub<int32_t, int32_t> increment;
+    ApiStub<std::vector<int32_t>, std::vector<int32_t>> sortValues;
+    ApiStub<int32_t, Label> labelOfTheCounterWithALongName;
+
+    DEFINE_API_VISITOR_FUNCTION(increment, sortValues, labelOfTheCounterWithALongName);
+};
+
+class CounterApiImpl : public cppschema::ApiBackend<CounterApi> {
+public:
+    int32_t incrementImpl(const int32_t& delta) { return counter_ += delta; }
+
+    Expected<std::vector<int32_t>> sortValuesImpl(const std::vector<int32_t>& values) {
+        std::vector<int32_t> sorted = values;  // The one allocation.
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    }
+
+    Label labelImpl(const int32_t&, Status*) { return Label(kLongLabel); }  // The one allocation.
+
+private:
+    int32_t counter_ = 0;
+};
+
+class ApiRegistryAllocTest : public testing::Test {
+protected:
+    ApiRegistry<CounterApi>& registry_ = ApiRegistry<CounterApi>::Get();
+    ScopedRegister<CounterApi, CounterApiImpl> scoped_register_{new CounterApiImpl(), {
+        .increment = &CounterApiImpl::incrementImpl,
+        .sortValues = &CounterApiImpl::sortValuesImpl,
+        .labelOfTheCounterWithALongName = &CounterApiImpl::labelImpl,
+    }};
+};
+
+TEST_F(ApiRegistryAllocTest, PlainCallDoesNotAllocate) {
+    int32_t result = 0;
+    AllocationCounter counter;
+    ASSERT_TRUE((registry_.TryCall<int32_t, int32_t>("increment", 2, &result)).ok());
+    EXPECT_EQ(counter.count(), 0);
+    EXPECT_EQ(result, 2);
+}
+
+TEST_F(ApiRegistryAllocTest, ExpectedResponseIsMoved) {
+    const std::vector<int32_t> values = {3, 1, 2};
+    std::vector<int32_t> sorted;
+    AllocationCounter counter;
+    ASSERT_TRUE((registry_.TryCall<std::vector<int32_t>, std::vector<int32_t>>(
+        "sortValues", values, &sorted)).ok());
+    EXPECT_EQ(counter.count(), 1);
+    EXPECT_EQ(sorted, (std::vector<int32_t>{1, 2, 3}));
+}
+
+TEST_F(ApiRegistryAllocTest, StrongTypeResponseIsMoved) {
+    Label label;
+    AllocationCounter counter;
+    // The method name does not fit in a small string either.
+    ASSERT_TRUE((registry_.TryCall<int32_t, Label>("labelOfTheCounterWithALongName", 0, &label)).ok());
+    EXPECT_EQ(counter.count(), 1);
+    EXPECT_EQ(label.value, kLongLabel);
+}
+
+TEST_F(ApiRegistryAllocTest, WireRoundTripReusesTheBuffer) {
+    std::string buffer;
+    buffer.reserve(1024);
+    std::vector<int32_t> decoded;
+    const std::vector<int32_t> values = {3, 1, 2};
+    AllocationCounter counter;
+    cppschema::WireEncodeTo(values, &buffer);
+    ASSERT_TRUE(cppschema::WireDecode(buffer, &decoded));
+    EXPECT_EQ(counter.count(), 1);  // The decoded vector.
+    EXPECT_EQ(decoded, values);
+}
+
+}  // namespace
@@ -0,0 +1,100 @@
+// Measures the dispatch cost of `ApiRegistry` for each backend method signature, to check that the
+// calls which succeed pay nothing for the error propagation.
+//
+// $ bazel run -c opt //cppschema/apispec:api_registry_benchmark
+// $ bazel run -c opt --config=noexcept //cppschema/apispec:api_registry_benchmark
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::Expected;
+using ::cppschema::Status;
+
+struct BenchApi {
+    ApiStub<std::string, int64_t> plain;
+    ApiStub<std::string, int64_t> expected;
+    ApiStub<std::string, int64_t> statusSink;
+    ApiStub<std::string, int64_t> unimplemented;
+
+    DEFINE_API_VISITOR_FUNCTION(plain, expected, statusSink, unimplemented);
+};
+
+class BenchApiImpl : public cppschema::ApiBackend<BenchApi> {
+public:
+    int64_t plainImpl(const std::string& id) { return static_cast<int64_t>(id.size()); }
+
+    Expected<int64_t> expectedImpl(const std::string& id) {
+        if (id.empty()) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError("Empty id"));
+        }
+        return static_cast<int64_t>(id.size());
+    }
+
+    int64_t statusSinkImpl(const std::string& id, Status* status) {
+        if (id.empty()) {
+            *status = cppschema::InvalidArgumentError("Empty id");
+        }
+        return static_cast<int64_t>(id.size());
+    }
+};
+
+ApiRegistry<BenchApi>& Registry() {
+    static ApiRegistry<BenchApi>& registry = [] () -> ApiRegistry<BenchApi>& {
+        cppschema::RegisterBackend<BenchApi, BenchApiImpl>(new BenchApiImpl(), {
+            .plain = &BenchApiImpl::plainImpl,
+            .expected = &BenchApiImpl::expectedImpl,
+            .statusSink = &BenchApiImpl::statusSinkImpl,
+        });
+        return ApiRegistry<BenchApi>::Get();
+    }();
+    return registry;
+}
+
+const std::string kNodeId = "FUNCTION_1000";
+
+void BM_DirectCall(benchmark::State& state) {
+    BenchApiImpl impl;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(impl.plainImpl(kNodeId));
+    }
+}
+BENCHMARK(BM_DirectCall);
+
+// The `Call` API, which returns the response directly.
+void BM_Call(benchmark::State& state) {
+    auto& registry = Registry();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registry.Call<std::string, int64_t>("plain", kNodeId));
+    }
+}
+BENCHMARK(BM_Call);
+
+void BM_TryCall(benchmark::State& state, const char* name, const std::string& id) {
+    auto& registry = Registry();
+    int64_t res = 0;
+    for (auto _ : state) {
+        Status status = registry.TryCall<std::string, int64_t>(name, id, &res);
+        benchmark::DoNotOptimize(status);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK_CAPTURE(BM_TryCall, plain, "plain", kNodeId);
+BENCHMARK_CAPTURE(BM_TryCall, expected, "expected", kNodeId);
+BENCHMARK_CAPTURE(BM_TryCall, status_sink, "statusSink", kNodeId);
+// The failure paths, which allocate the error message.
+BENCHMARK_CAPTURE(BM_TryCall, expected_error, "expected", "");
+BENCHMARK_CAPTURE(BM_TryCall, unimplemented, "unimplemented", kNodeId);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,221 @@
+#include "cppschema/apispec/api_registry.h"
+
+#include <string>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/request_limits.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::Expected;
+using ::cppschema::ScopedRegister;
+using ::cppschema::Status;
+using ::cppschema::StatusCode;
+
+struct NodeApi {
+    ApiStub<std::string, int32_t> addNode;
+    ApiStub<std::string, bool> deleteNode;
+    ApiStub<std::string, std::string> getName;
+    ApiStub<VoidType, VoidType> clear;
+    ApiStub<std::string, std::vector<std::string>> findNodes;
+    ApiStub<VoidType, std::vector<std::string>> listNodes;
+
+    DEFINE_API_VISITOR_FUNCTION(addNode, deleteNode, getName, clear, findNodes, listNodes);
+};
+
+// Uses a different signature for each method.
+class NodeApiImpl : public cppschema::ApiBackend<NodeApi> {
+public:
+    int32_t addNodeImpl(const std::string& name) {
+        names_.push_back(name);
+        return static_cast<int32_t>(names_.size()) - 1;
+    }
+
+    Expected<bool> deleteNodeImpl(const std::string& name) {
+        if (name.empty()) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError("Empty name"));
+        }
+        return std::erase(names_, name) > 0;
+    }
+
+    std::string getNameImpl(const std::string& index, Status* status) {
+        const size_t i = std::stoul(index);
+        if (i >= names_.size()) {
+            *status = cppschema::NotFoundError("No node at " + index);
+            return "partial";
+        }
+        return names_[i];
+    }
+
+    Status findNodesImpl(const std::string& prefix, cppschema::ArraySink<std::string>* names) {
+        if (prefix.empty()) {
+            return cppschema::InvalidArgumentError("Empty prefix");
+        }
+        for (const std::string& name : names_) {
+            if (name.starts_with(prefix)) {
+                names->Append(name);
+            }
+        }
+        return Status();
+    }
+
+    std::vector<std::string> listNodesImpl(const VoidType&) { return names_; }
+
+private:
+    std::vector<std::string> names_;
+};
+
+class ApiRegistryTest : public testing::Test {
+protected:
+    ApiRegistry<NodeApi>& registry_ = ApiRegistry<NodeApi>::Get();
+    // `clear` is left unimplemented.
+    ScopedRegister<NodeApi, NodeApiImpl> backend_{new NodeApiImpl(), {
+        .addNode = &NodeApiImpl::addNodeImpl,
+        .deleteNode = &NodeApiImpl::deleteNodeImpl,
+        .getName = &NodeApiImpl::getNameImpl,
+        .findNodes = &NodeApiImpl::findNodesImpl,
+        .listNodes = &NodeApiImpl::listNodesImpl,
+    }};
+};
+
+TEST_F(ApiRegistryTest, PlainMethod) {
+    EXPECT_EQ((registry_.Call<std::string, int32_t>("addNode", "a")), 0);
+    int32_t index = -1;
+    EXPECT_TRUE((registry_.TryCall<std::string, int32_t>("addNode", "b", &index)).ok());
+    EXPECT_EQ(index, 1);
+}
+
+TEST_F(ApiRegistryTest, ExpectedMethod) {
+    registry_.Call<std::string, int32_t>("addNode", "a");
+    bool deleted = false;
+    EXPECT_TRUE((registry_.TryCall<std::string, bool>("deleteNode", "a", &deleted)).ok());
+    EXPECT_TRUE(deleted);
+
+    const Status status = registry_.TryCall<std::string, bool>("deleteNode", "", &deleted);
+    EXPECT_EQ(status.code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(status.ToString(), "INVALID_ARGUMENT: Empty name");
+}
+
+TEST_F(ApiRegistryTest, StatusSinkMethod) {
+    registry_.Call<std::string, int32_t>("addNode", "a");
+    std::string name;
+    EXPECT_TRUE((registry_.TryCall<std::string, std::string>("getName", "0", &name)).ok());
+    EXPECT_EQ(name, "a");
+
+    name = "unchanged";
+    const Status status = registry_.TryCall<std::string, std::string>("getName", "5", &name);
+    EXPECT_EQ(status, cppschema::NotFoundError("No node at 5"));
+    // The response is not written on failure.
+    EXPECT_EQ(name, "unchanged");
+}
+
+// Records the emitted elements.
+class RecordingSink : public cppschema::ArraySink<std::string> {
+public:
+    void Reserve(size_t count) override { reserved += count; }
+    void Append(std::string&& item) override { items.push_back(std::move(item)); }
+
+    size_t reserved = 0;
+    std::vector<std::string> items;
+};
+
+TEST_F(ApiRegistryTest, ResponseSinkMethod) {
+    for (const char* name : {"ab", "b", "ac"}) {
+        registry_.Call<std::string, int32_t>("addNode", name);
+    }
+    EXPECT_TRUE(registry_.IsStreaming("findNodes"));
+    RecordingSink sink;
+    ASSERT_TRUE((registry_.TryStream<std::string, std::vector<std::string>>("findNodes", "a", &sink)).ok());
+    EXPECT_EQ(sink.items, (std::vector<std::string>{"ab", "ac"}));
+
+    // C++ callers get a vector.
+    std::vector<std::string> found;
+    ASSERT_TRUE((registry_.TryCall<std::string, std::vector<std::string>>("findNodes", "b", &found)).ok());
+    EXPECT_EQ(found, std::vector<std::string>{"b"});
+
+    found = {"unchanged"};
+    EXPECT_EQ((registry_.TryCall<std::string, std::vector<std::string>>("findNodes", "", &found)).code(),
+              StatusCode::kInvalidArgument);
+    EXPECT_EQ(found, std::vector<std::string>{"unchanged"});
+}
+
+TEST_F(ApiRegistryTest, StreamFromPlainMethod) {
+    registry_.Call<std::string, int32_t>("addNode", "a");
+    registry_.Call<std::string, int32_t>("addNode", "b");
+    EXPECT_FALSE(registry_.IsStreaming("listNodes"));
+    RecordingSink sink;
+    ASSERT_TRUE((registry_.TryStream<VoidType, std::vector<std::string>>("listNodes", {}, &sink)).ok());
+    EXPECT_EQ(sink.items, (std::vector<std::string>{"a", "b"}));
+    EXPECT_EQ(sink.reserved, 2);
+}
+
+TEST_F(ApiRegistryTest, MissingHandlers) {
+    VoidType res;
+    EXPECT_EQ((registry_.TryCall<VoidType, VoidType>("clear", {}, &res)).code(),
+              StatusCode::kUnimplemented);
+    EXPECT_EQ((registry_.TryCall<VoidType, VoidType>("noSuchApi", {}, &res)).code(),
+              StatusCode::kUnimplemented);
+
+    registry_.Clear();
+    int32_t index;
+    EXPECT_EQ((registry_.TryCall<std::string, int32_t>("addNode", "a", &index)).code(),
+              StatusCode::kFailedPrecondition);
+}
+
+TEST_F(ApiRegistryTest, RequestLimits) {
+    EXPECT_EQ(registry_.GetRequestLimits("findNodes"), nullptr);
+    registry_.SetRequestLimits("findNodes", {.max_elements = 2, .max_bytes = 10});
+    const cppschema::RequestLimits* limits = registry_.GetRequestLimits("findNodes");
+    ASSERT_NE(limits, nullptr);
+    EXPECT_EQ(limits->max_elements, 2);
+    EXPECT_EQ(registry_.GetRequestLimits("addNode"), nullptr);
+
+    // Kept across the registrations.
+    registry_.Clear();
+    EXPECT_NE(registry_.GetRequestLimits("findNodes"), nullptr);
+}
+
+TEST(DecodeBudgetTest, ChargesTheCurrentRequest) {
+    using ::cppschema::DecodeBudget;
+    EXPECT_EQ(DecodeBudget::current(), nullptr);
+    const cppschema::RequestLimits limits{.max_elements = 3, .max_bytes = 10};
+    {
+        DecodeBudget budget(&limits);
+        EXPECT_EQ(DecodeBudget::current(), &budget);
+        EXPECT_TRUE(budget.Charge(2, 10).ok());
+        const Status status = budget.Charge(0, 1);
+        EXPECT_EQ(status.code(), StatusCode::kResourceExhausted);
+        EXPECT_EQ(status.message(), "The request has over 10 bytes");
+        // Still over.
+        EXPECT_EQ(budget.Charge(0, 0).code(), StatusCode::kResourceExhausted);
+        {
+            DecodeBudget unlimited(nullptr);
+            EXPECT_EQ(DecodeBudget::current(), &budget);
+        }
+    }
+    EXPECT_EQ(DecodeBudget::current(), nullptr);
+
+    const cppschema::RequestLimits elements{.max_elements = 3};
+    DecodeBudget budget(&elements);
+    EXPECT_TRUE(budget.Charge(3, 1 << 30).ok());
+    EXPECT_EQ(budget.Charge(1, 0).message(), "The request has over 3 elements");
+}
+
+TEST(ExpectedTest, ValueAndError) {
+    Expected<std::string> value = std::string("abc");
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(*value, "abc");
+    EXPECT_EQ(value->size(), 3);
+
+    Expected<std::string> error = cppschema::Unexpected(cppschema::InternalError("failed"));
+    ASSERT_FALSE(error);
+    EXPECT_EQ(error.error().message(), "failed");
+}
+
+}  // namespace
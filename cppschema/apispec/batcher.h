@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cppschema/apispec/task.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/types.h"
+
+namespace cppschema {
+
+// When the calls buffered for a batch handler are dispatched, see `RegisterBatchMethod`.
+struct BatchOptions {
+    // A full batch is dispatched at once.
+    size_t max_batch_size = 256;
+    // How long the first call of a batch waits for the others. Zero waits until the scheduler has
+    // run the other ready coroutines, i.e. coalesces the calls made in the same burst (e.g. the
+    // same JS task), without delaying them.
+    std::chrono::microseconds window{0};
+};
+
+// The sizes of the batches dispatched to a batch handler, to tune its `BatchOptions`.
+struct BatchStats {
+    // Bucket i counts the batches of [2^i, 2^(i+1)) calls.
+    static constexpr size_t kNumBuckets = 16;
+
+    uint64_t batches = 0;
+    uint64_t calls = 0;
+    // The batches which failed as a whole.
+    uint64_t errors = 0;
+    std::array<uint64_t, kNumBuckets> size_histogram{};
+
+    void Add(size_t size) {
+        ++batches;
+        calls += size;
+        const size_t bucket = static_cast<size_t>(std::bit_width(size)) - 1;
+        ++size_histogram[std::min(bucket, kNumBuckets - 1)];
+    }
+
+    double mean_batch_size() const { return batches == 0 ? 0 : static_cast<double>(calls) / batches; }
+
+    // One line per non-empty bucket, like "4-7: 12".
+    std::string ToString() const {
+        std::string out = std::to_string(batches) + " batches, " + std::to_string(calls) + " calls, " +
+            std::to_string(errors) + " errors\n";
+        for (size_t i = 0; i < kNumBuckets; ++i) {
+            if (size_histogram[i] == 0) {
+                continue;
+            }
+            const uint64_t low = uint64_t{1} << i;
+            out += std::to_string(low);
+            if (i + 1 == kNumBuckets) {
+                out += "+";
+            } else if (low > 1) {
+                out += "-" + std::to_string(2 * low - 1);
+            }
+            out += ": " + std::to_string(size_histogram[i]) + "\n";
+        }
+        return out;
+    }
+};
+
+namespace internal {
+
+/**
+ * Buffers the calls of one API, and dispatches them to its batch handler as one span of requests.
+ * Each call is a task which completes with its own response. The calls may come from the
+ * schedulers of several threads: each batch is dispatched on the thread of its first call.
+ */
+template <typename Req, typename Res>
+class Batcher : public std::enable_shared_from_this<Batcher<Req, Res>> {
+public:
+    // Returns the responses in the order of the requests.
+    using BatchFunction = std::function<Expected<std::vector<Res>>(std::span<const Req>)>;
+
+    Batcher(BatchFunction batch, BatchOptions options) : batch_(std::move(batch)), options_(options) {}
+
+    // Buffers a call, and completes with its response once its batch is dispatched.
+    Task<VoidType> Call(const Req& req, Res* res) {
+        Completion<Res> response = Enqueue(req);
+        Expected<Res> result = co_await response;
+        if (!result.has_value()) {
+            co_return Unexpected(std::move(result).error());
+        }
+        *res = std::move(result).value();
+        co_return VoidType{};
+    }
+
+    BatchStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Batch {
+        std::vector<Req> requests;
+        std::vector<Completion<Res>> responses;
+    };
+
+    Completion<Res> Enqueue(const Req& req) {
+        std::shared_ptr<Batch> full;
+        Completion<Res> response;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_ == nullptr) {
+                pending_ = std::make_shared<Batch>();
+                pending_->requests.reserve(options_.max_batch_size);
+                pending_->responses.reserve(options_.max_batch_size);
+                TaskScheduler::Get().Spawn(DispatchAfterWindow(this->shared_from_this(), pending_),
+                    [](Expected<VoidType>) {});
+            }
+            pending_->requests.push_back(req);
+            pending_->responses.push_back(response);
+            if (pending_->requests.size() >= options_.max_batch_size) {
+                full = std::move(pending_);
+            }
+        }
+        if (full != nullptr) {
+            Dispatch(*full);
+        }
+        return response;
+    }
+
+    // Owns the batcher, which may be unregistered in the meantime.
+    static Task<VoidType> DispatchAfterWindow(std::shared_ptr<Batcher> self, std::shared_ptr<Batch> batch) {
+        co_await SleepFor(self->options_.window);
+        {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            if (self->pending_ != batch) {
+                // Dispatched when it became full.
+                co_return VoidType{};
+            }
+            self->pending_ = nullptr;
+        }
+        self->Dispatch(*batch);
+        co_return VoidType{};
+    }
+
+    void Dispatch(Batch& batch) {
+        Expected<std::vector<Res>> responses = batch_(std::span<const Req>(batch.requests));
+        if (responses.has_value() && responses->size() != batch.requests.size()) {
+            responses = Unexpected(InternalError("The batch handler returned " + std::to_string(responses->size()) +
+                " responses for " + std::to_string(batch.requests.size()) + " requests"));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.Add(batch.requests.size());
+            stats_.errors += !responses.has_value();
+        }
+        for (size_t i = 0; i < batch.responses.size(); ++i) {
+            if (responses.has_value()) {
+                batch.responses[i].Set(std::move((*responses)[i]));
+            } else {
+                batch.responses[i].Set(Unexpected(responses.error()));
+            }
+        }
+    }
+
+    const BatchFunction batch_;
+    const BatchOptions options_;
+
+    mutable std::mutex mutex_;
+    // The batch buffering the calls, if any.
+    std::shared_ptr<Batch> pending_;
+    BatchStats stats_;
+};
+
+}  // namespace internal
+
+}  // namespace cppschema
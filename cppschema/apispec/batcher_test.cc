@@ -0,0 +1,182 @@
+#include "cppschema/apispec/batcher.h"
+
+#include <chrono>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/task.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::BatchOptions;
+using ::cppschema::BatchStats;
+using ::cppschema::Expected;
+using ::cppschema::RegisterBatchMethod;
+using ::cppschema::ScopedRegister;
+using ::cppschema::StatusCode;
+using ::cppschema::TaskScheduler;
+
+struct CounterApi {
+    ApiStub<int32_t, int32_t> add;
+    ApiStub<std::string, int32_t> length;
+    ApiStub<int32_t, std::string> unregistered;
+
+    DEFINE_API_VISITOR_FUNCTION(add, length, unregistered);
+};
+
+// Adds the requests to a total, and returns the total after each one.
+class CounterApiImpl : public cppschema::ApiBackend<CounterApi> {
+public:
+    int32_t addImpl(const int32_t& value) {
+        ++single_calls;
+        return total += value;
+    }
+
+    Expected<std::vector<int32_t>> addBatchImpl(std::span<const int32_t> values) {
+        batch_sizes.push_back(values.size());
+        std::vector<int32_t> totals;
+        for (int32_t value : values) {
+            if (value < 0) {
+                return cppschema::Unexpected(cppschema::InvalidArgumentError("Negative value"));
+            }
+            totals.push_back(total += value);
+        }
+        if (drop_last && !totals.empty()) {
+            totals.pop_back();
+        }
+        return totals;
+    }
+
+    int32_t lengthImpl(const std::string& s) { return static_cast<int32_t>(s.size()); }
+
+    Expected<std::vector<std::string>> unregisteredBatchImpl(std::span<const int32_t> values) {
+        return std::vector<std::string>(values.size());
+    }
+
+    int32_t total = 0;
+    int single_calls = 0;
+    bool drop_last = false;
+    std::vector<size_t> batch_sizes;
+};
+
+class BatcherTest : public testing::Test {
+protected:
+    // Starts the calls of `add`, whose responses are then stored in `responses_`.
+    void StartAdds(const std::vector<int32_t>& values) {
+        responses_.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            scheduler_.Spawn(registry_.TryCallAsync<int32_t, int32_t>("add", values[i]),
+                [this, i](Expected<int32_t> res) { responses_[i] = std::move(res); });
+        }
+    }
+
+    CounterApiImpl* impl_ = new CounterApiImpl();
+    ScopedRegister<CounterApi, CounterApiImpl> backend_{impl_, {
+        .add = &CounterApiImpl::addImpl,
+        .length = &CounterApiImpl::lengthImpl,
+    }};
+    ApiRegistry<CounterApi>& registry_ = ApiRegistry<CounterApi>::Get();
+    TaskScheduler& scheduler_ = TaskScheduler::Get();
+    std::vector<std::optional<Expected<int32_t>>> responses_;
+};
+
+TEST_F(BatcherTest, CoalescesABurst) {
+    ASSERT_TRUE(RegisterBatchMethod<CounterApi>("add", impl_, &CounterApiImpl::addBatchImpl).ok());
+    EXPECT_TRUE(registry_.IsAsync("add"));
+
+    StartAdds({1, 2, 3, 4, 5});
+    scheduler_.RunUntilIdle();
+    EXPECT_EQ(impl_->batch_sizes, (std::vector<size_t>{5}));
+    EXPECT_EQ(impl_->single_calls, 0);
+    // Each call gets its own response.
+    const std::vector<int32_t> expected = {1, 3, 6, 10, 15};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_TRUE(responses_[i].has_value()) << i;
+        EXPECT_EQ(**responses_[i], expected[i]);
+    }
+
+    const BatchStats stats = registry_.GetBatchStats("add");
+    EXPECT_EQ(stats.batches, 1);
+    EXPECT_EQ(stats.calls, 5);
+    EXPECT_EQ(stats.size_histogram[2], 1);
+    EXPECT_EQ(stats.ToString(), "1 batches, 5 calls, 0 errors\n4-7: 1\n");
+
+    // The synchronous calls go to the per-call method.
+    int32_t total = 0;
+    ASSERT_TRUE((registry_.TryCall<int32_t, int32_t>("add", 10, &total)).ok());
+    EXPECT_EQ(total, 25);
+    EXPECT_EQ(impl_->single_calls, 1);
+}
+
+TEST_F(BatcherTest, FullBatchesAreDispatchedAtOnce) {
+    ASSERT_TRUE(RegisterBatchMethod<CounterApi>("add", impl_, &CounterApiImpl::addBatchImpl,
+        {.max_batch_size = 2}).ok());
+    StartAdds({1, 1, 1, 1, 1});
+    scheduler_.RunUntilIdle();
+    EXPECT_EQ(impl_->batch_sizes, (std::vector<size_t>{2, 2, 1}));
+    EXPECT_EQ(**responses_[4], 5);
+
+    const BatchStats stats = registry_.GetBatchStats("add");
+    EXPECT_EQ(stats.size_histogram[0], 1);
+    EXPECT_EQ(stats.size_histogram[1], 2);
+    EXPECT_DOUBLE_EQ(stats.mean_batch_size(), 5.0 / 3);
+}
+
+TEST_F(BatcherTest, WaitsForTheWindow) {
+    const auto window = std::chrono::milliseconds(20);
+    ASSERT_TRUE(RegisterBatchMethod<CounterApi>("add", impl_, &CounterApiImpl::addBatchImpl,
+        {.window = window}).ok());
+    const auto start = std::chrono::steady_clock::now();
+    StartAdds({1});
+    scheduler_.RunUntilIdle();
+    EXPECT_TRUE(impl_->batch_sizes.empty());
+
+    // A later call joins the batch.
+    responses_.resize(2);
+    scheduler_.Spawn(registry_.TryCallAsync<int32_t, int32_t>("add", 2),
+        [this](Expected<int32_t> res) { responses_[1] = std::move(res); });
+    ASSERT_TRUE(scheduler_.RunUntil([this] { return responses_[1].has_value(); }));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, window);
+    EXPECT_EQ(impl_->batch_sizes, (std::vector<size_t>{2}));
+    EXPECT_EQ(**responses_[0], 1);
+    EXPECT_EQ(**responses_[1], 3);
+}
+
+TEST_F(BatcherTest, FailedBatchesFailAllTheirCalls) {
+    ASSERT_TRUE(RegisterBatchMethod<CounterApi>("add", impl_, &CounterApiImpl::addBatchImpl).ok());
+    StartAdds({1, -1, 2});
+    scheduler_.RunUntilIdle();
+    for (const auto& response : responses_) {
+        ASSERT_TRUE(response.has_value());
+        EXPECT_EQ(response->error().code(), StatusCode::kInvalidArgument);
+    }
+
+    impl_->drop_last = true;
+    StartAdds({1, 2});
+    scheduler_.RunUntilIdle();
+    EXPECT_EQ(responses_[0]->error().code(), StatusCode::kInternal);
+    EXPECT_EQ(registry_.GetBatchStats("add").errors, 2);
+}
+
+TEST_F(BatcherTest, RegistrationErrors) {
+    EXPECT_EQ(RegisterBatchMethod<CounterApi>("length", impl_, &CounterApiImpl::addBatchImpl).code(),
+        StatusCode::kNotFound);
+    EXPECT_EQ(RegisterBatchMethod<CounterApi>("missing", impl_, &CounterApiImpl::addBatchImpl).code(),
+        StatusCode::kNotFound);
+    EXPECT_EQ(RegisterBatchMethod<CounterApi>("unregistered", impl_, &CounterApiImpl::unregisteredBatchImpl).code(),
+        StatusCode::kFailedPrecondition);
+    EXPECT_FALSE(registry_.IsAsync("add"));
+    EXPECT_EQ(registry_.GetBatchStats("add").batches, 0);
+}
+
+}  // namespace
@@ -0,0 +1,103 @@
+#include "cppschema/apispec/call_recorder.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace cppschema {
+
+namespace {
+
+void WriteHeader(std::string* log) {
+    log->append(CallRecorder::kMagic);
+    log->push_back(static_cast<char>(CallRecorder::kVersion));
+}
+
+}  // namespace
+
+CallRecorder::CallRecorder() : last_call_(std::chrono::steady_clock::now()) {
+    WriteHeader(&log_);
+}
+
+void CallRecorder::Append(std::string_view name, std::string_view request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Taken under the lock, so that the times of the log are increasing.
+    const auto now = std::chrono::steady_clock::now();
+    WireWriter w(&log_);
+    auto it = name_ids_.find(name);
+    if (it != name_ids_.end()) {
+        w.writeVarint(it->second);
+    } else {
+        const uint32_t id = static_cast<uint32_t>(name_ids_.size());
+        name_ids_.emplace(std::string(name), id);
+        w.writeVarint(id);
+        w.writeVarint(name.size());
+        w.writeBytes(name.data(), name.size());
+    }
+    w.writeVarint(static_cast<uint64_t>(std::max<int64_t>(0, (now - last_call_).count())));
+    w.writeVarint(request.size());
+    w.writeBytes(request.data(), request.size());
+    last_call_ = now;
+    ++num_calls_;
+}
+
+std::string CallRecorder::TakeLog() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string log = std::move(log_);
+    log_.clear();
+    WriteHeader(&log_);
+    name_ids_.clear();
+    num_calls_ = 0;
+    return log;
+}
+
+size_t CallRecorder::num_calls() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_calls_;
+}
+
+CallLogReader::CallLogReader(std::string_view log) : reader_(log) {
+    std::string_view magic;
+    uint8_t version = 0;
+    if (!reader_.readBytes(CallRecorder::kMagic.size(), &magic) || magic != CallRecorder::kMagic ||
+        !reader_.readFixed(&version)) {
+        Fail("Not a call log");
+    } else if (version != CallRecorder::kVersion) {
+        Fail("Unsupported call log version: " + std::to_string(version));
+    }
+}
+
+bool CallLogReader::Next(RecordedCall* call) {
+    if (!status_.ok() || reader_.remaining() == 0) {
+        return false;
+    }
+    uint64_t id = 0;
+    if (!reader_.readVarint(&id) || id > names_.size()) {
+        return Fail("Corrupt call log");
+    }
+    if (id == names_.size()) {
+        size_t size = 0;
+        std::string_view name;
+        if (!reader_.readCount(1, &size) || !reader_.readBytes(size, &name)) {
+            return Fail("Corrupt call log");
+        }
+        names_.push_back(name);
+    }
+    uint64_t delta = 0;
+    size_t size = 0;
+    if (!reader_.readVarint(&delta) || !reader_.readCount(1, &size) ||
+        !reader_.readBytes(size, &call->request)) {
+        return Fail("Corrupt call log");
+    }
+    time_ += std::chrono::nanoseconds(delta);
+    call->name = names_[id];
+    call->time = time_;
+    return true;
+}
+
+bool CallLogReader::Fail(std::string message) {
+    status_ = InvalidArgumentError(std::move(message));
+    return false;
+}
+
+}  // namespace cppschema
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cppschema/common/status.h"
+#include "cppschema/common/wire_codec.h"
+
+namespace cppschema {
+
+/**
+ * Records the API calls dispatched through `ApiRegistry`, i.e. from C++, the JS bindings and the
+ * RPC servers, into a compact binary log for replaying them offline (see call_replay.h). Each
+ * call is recorded with its API name, its time and its wire encoded request (see wire_codec.h).
+ *
+ * Recording is off until a recorder is installed with `SetCallRecorder`, and then covers the
+ * registries of all the APIs. The calls are recorded as they are issued, including those which
+ * fail. Thread-safe.
+ *
+ * The log is a header ("CSCL" and a version byte), followed by a record per call:
+ * - The varint index of the API name, in the order of the first calls. The index of a new name is
+ *   followed by the name, as a varint length and the bytes.
+ * - The varint nanoseconds since the previous call (the recorder creation for the first one).
+ * - The varint length of the request, followed by its encoding.
+ *
+ * @example
+ * CallRecorder recorder;
+ * SetCallRecorder(&recorder);
+ * ...  // Serve the API.
+ * SetCallRecorder(nullptr);
+ * WriteFile("graph_calls.log", recorder.TakeLog());
+ */
+class CallRecorder {
+public:
+    static constexpr std::string_view kMagic = "CSCL";
+    static constexpr uint8_t kVersion = 1;
+
+    CallRecorder();
+
+    CallRecorder(const CallRecorder&) = delete;
+    CallRecorder& operator=(const CallRecorder&) = delete;
+
+    template <typename Req>
+    void Record(std::string_view name, const Req& req) {
+        // Encoded out of the lock, into a buffer which is reused by the thread.
+        thread_local std::string request;
+        request.clear();
+        WireEncodeTo(req, &request);
+        Append(name, request);
+    }
+
+    // Returns the log, and starts a new one. The API names are defined again in the new log.
+    std::string TakeLog();
+
+    size_t num_calls() const;
+
+private:
+    void Append(std::string_view name, std::string_view request);
+
+    mutable std::mutex mutex_;
+    std::string log_;
+    std::map<std::string, uint32_t, std::less<>> name_ids_;
+    std::chrono::steady_clock::time_point last_call_;
+    size_t num_calls_ = 0;
+};
+
+namespace internal {
+inline std::atomic<CallRecorder*> active_call_recorder{nullptr};
+}  // namespace internal
+
+// Installs the recorder of the calls of all the APIs, or removes it with nullptr. The recorder must
+// outlive the calls in flight when it is removed.
+inline void SetCallRecorder(CallRecorder* recorder) {
+    internal::active_call_recorder.store(recorder, std::memory_order_release);
+}
+
+inline CallRecorder* ActiveCallRecorder() {
+    return internal::active_call_recorder.load(std::memory_order_acquire);
+}
+
+// A recorded call. The views point into the log.
+struct RecordedCall {
+    std::string_view name;
+    // Since the start of the recording.
+    std::chrono::nanoseconds time{0};
+    std::string_view request;
+};
+
+/**
+ * Reads the calls of a log written by `CallRecorder`.
+ *
+ * @example
+ * CallLogReader reader(log);
+ * RecordedCall call;
+ * while (reader.Next(&call)) { ... }
+ * if (!reader.status().ok()) { ... }  // A corrupt log.
+ */
+class CallLogReader {
+public:
+    explicit CallLogReader(std::string_view log);
+
+    // Returns false at the end of the log, or on an error (see `status`).
+    bool Next(RecordedCall* call);
+
+    // INVALID_ARGUMENT if the log is corrupt.
+    const Status& status() const { return status_; }
+
+private:
+    bool Fail(std::string message);
+
+    WireReader reader_;
+    std::vector<std::string_view> names_;
+    std::chrono::nanoseconds time_{0};
+    Status status_;
+};
+
+}  // namespace cppschema
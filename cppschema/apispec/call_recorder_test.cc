@@ -0,0 +1,226 @@
+#include "cppschema/apispec/call_recorder.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/call_replay.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::CallLogReader;
+using ::cppschema::CallRecorder;
+using ::cppschema::Expected;
+using ::cppschema::RecordedCall;
+using ::cppschema::ReplayCalls;
+using ::cppschema::ReplayReport;
+using ::cppschema::ScopedRegister;
+using ::cppschema::SetCallRecorder;
+using ::cppschema::Status;
+using ::cppschema::StatusCode;
+
+struct Edge {
+    std::string source;
+    std::string target;
+    int32_t weight = 0;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(source, target, weight);
+};
+
+struct LogApi {
+    ApiStub<std::string, int32_t> addNode;
+    ApiStub<Edge, bool> addEdge;
+    ApiStub<VoidType, std::vector<std::string>> listNodes;
+
+    DEFINE_API_VISITOR_FUNCTION(addNode, addEdge, listNodes);
+};
+
+struct OtherApi {
+    ApiStub<std::string, std::string> echo;
+
+    DEFINE_API_VISITOR_FUNCTION(echo);
+};
+
+class LogApiImpl : public cppschema::ApiBackend<LogApi> {
+public:
+    int32_t addNodeImpl(const std::string& name) {
+        calls.push_back("addNode " + name);
+        return static_cast<int32_t>(calls.size());
+    }
+
+    Expected<bool> addEdgeImpl(const Edge& edge) {
+        calls.push_back("addEdge " + edge.source + " " + edge.target + " " + std::to_string(edge.weight));
+        if (edge.weight < 0) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError("Negative weight"));
+        }
+        return true;
+    }
+
+    Status listNodesImpl(const VoidType&, cppschema::ArraySink<std::string>* names) {
+        calls.push_back("listNodes");
+        names->Append("a");
+        return Status();
+    }
+
+    std::vector<std::string> calls;
+};
+
+class OtherApiImpl : public cppschema::ApiBackend<OtherApi> {
+public:
+    std::string echoImpl(const std::string& s) { return s; }
+};
+
+// Only the streamed elements.
+class DiscardingSink : public cppschema::ArraySink<std::string> {
+public:
+    void Append(std::string&&) override {}
+};
+
+class CallRecorderTest : public testing::Test {
+protected:
+    ~CallRecorderTest() override { SetCallRecorder(nullptr); }
+
+    // Makes a few calls, through each entry point of the registry.
+    void MakeCalls() {
+        registry_.Call<std::string, int32_t>("addNode", "a");
+        registry_.Call<std::string, int32_t>("addNode", "b");
+        bool added = false;
+        EXPECT_TRUE((registry_.TryCall<Edge, bool>("addEdge", {"a", "b", 3}, &added)).ok());
+        EXPECT_FALSE((registry_.TryCall<Edge, bool>("addEdge", {"b", "a", -1}, &added)).ok());
+        DiscardingSink sink;
+        EXPECT_TRUE((registry_.TryStream<VoidType, std::vector<std::string>>("listNodes", {}, &sink)).ok());
+    }
+
+    LogApiImpl* impl_ = new LogApiImpl();
+    ScopedRegister<LogApi, LogApiImpl> backend_{impl_, {
+        .addNode = &LogApiImpl::addNodeImpl,
+        .addEdge = &LogApiImpl::addEdgeImpl,
+        .listNodes = &LogApiImpl::listNodesImpl,
+    }};
+    ApiRegistry<LogApi>& registry_ = ApiRegistry<LogApi>::Get();
+    CallRecorder recorder_;
+};
+
+TEST_F(CallRecorderTest, RecordsTheCalls) {
+    SetCallRecorder(&recorder_);
+    MakeCalls();
+    SetCallRecorder(nullptr);
+    registry_.Call<std::string, int32_t>("addNode", "not recorded");
+    EXPECT_EQ(recorder_.num_calls(), 5);
+
+    const std::string log = recorder_.TakeLog();
+    CallLogReader reader(log);
+    RecordedCall call;
+    std::vector<std::string> names;
+    std::chrono::nanoseconds time(0);
+    while (reader.Next(&call)) {
+        names.emplace_back(call.name);
+        EXPECT_GE(call.time, time);
+        time = call.time;
+    }
+    ASSERT_TRUE(reader.status().ok()) << reader.status().ToString();
+    EXPECT_EQ(names, (std::vector<std::string>{"addNode", "addNode", "addEdge", "addEdge", "listNodes"}));
+
+    // The requests are wire encoded.
+    CallLogReader first(log);
+    ASSERT_TRUE(first.Next(&call));
+    std::string request;
+    ASSERT_TRUE(cppschema::WireDecode(call.request, &request));
+    EXPECT_EQ(request, "a");
+}
+
+TEST_F(CallRecorderTest, LogIsCompact) {
+    SetCallRecorder(&recorder_);
+    for (int i = 0; i < 100; ++i) {
+        registry_.Call<std::string, int32_t>("addNode", "n");
+    }
+    // The header and the name once, then the name index, time, and request per call.
+    EXPECT_LT(recorder_.TakeLog().size(), 5 + 8 + 100 * 8);
+}
+
+TEST_F(CallRecorderTest, ReplayMakesTheSameCalls) {
+    SetCallRecorder(&recorder_);
+    MakeCalls();
+    SetCallRecorder(nullptr);
+    const std::vector<std::string> recorded = impl_->calls;
+    impl_->calls.clear();
+
+    ReplayReport report;
+    ASSERT_TRUE(ReplayCalls<LogApi>(recorder_.TakeLog(), {}, &report).ok());
+    EXPECT_EQ(impl_->calls, recorded);
+    EXPECT_EQ(report.total_calls(), 5);
+    EXPECT_EQ(report.apis["addNode"].calls, 2);
+    EXPECT_EQ(report.apis["addEdge"].calls, 2);
+    EXPECT_EQ(report.apis["addEdge"].errors, 1);
+    EXPECT_EQ(report.apis["listNodes"].latencies.size(), 1);
+    EXPECT_GT(report.calls_per_second(), 0);
+    EXPECT_NE(report.ToString().find("addEdge"), std::string::npos);
+}
+
+TEST_F(CallRecorderTest, OriginalPacing) {
+    SetCallRecorder(&recorder_);
+    registry_.Call<std::string, int32_t>("addNode", "a");
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    registry_.Call<std::string, int32_t>("addNode", "b");
+    SetCallRecorder(nullptr);
+    const std::string log = recorder_.TakeLog();
+
+    ReplayReport fast;
+    ASSERT_TRUE(ReplayCalls<LogApi>(log, {}, &fast).ok());
+    EXPECT_LT(fast.wall_time, std::chrono::milliseconds(40));
+
+    ReplayReport paced;
+    ASSERT_TRUE(ReplayCalls<LogApi>(log, {.original_pacing = true}, &paced).ok());
+    EXPECT_GE(paced.wall_time, std::chrono::milliseconds(40));
+
+    ReplayReport faster;
+    ASSERT_TRUE(ReplayCalls<LogApi>(log, {.original_pacing = true, .speed = 4}, &faster).ok());
+    EXPECT_GE(faster.wall_time, std::chrono::milliseconds(10));
+    EXPECT_LT(faster.wall_time, paced.wall_time);
+}
+
+TEST_F(CallRecorderTest, SkipsOtherApis) {
+    ScopedRegister<OtherApi, OtherApiImpl> other(new OtherApiImpl(), {.echo = &OtherApiImpl::echoImpl});
+    SetCallRecorder(&recorder_);
+    ApiRegistry<OtherApi>::Get().Call<std::string, std::string>("echo", "x");
+    registry_.Call<std::string, int32_t>("addNode", "a");
+    SetCallRecorder(nullptr);
+
+    ReplayReport report;
+    ASSERT_TRUE(ReplayCalls<LogApi>(recorder_.TakeLog(), {}, &report).ok());
+    EXPECT_EQ(report.total_calls(), 1);
+    EXPECT_EQ(report.unknown_calls, 1);
+}
+
+TEST_F(CallRecorderTest, CorruptLogs) {
+    ReplayReport report;
+    EXPECT_EQ(ReplayCalls<LogApi>("", {}, &report).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(ReplayCalls<LogApi>("CSCL\x02", {}, &report).code(), StatusCode::kInvalidArgument);
+    // An empty log.
+    EXPECT_TRUE(ReplayCalls<LogApi>(recorder_.TakeLog(), {}, &report).ok());
+
+    SetCallRecorder(&recorder_);
+    registry_.Call<std::string, int32_t>("addNode", "abc");
+    SetCallRecorder(nullptr);
+    const std::string log = recorder_.TakeLog();
+    for (size_t size = 6; size < log.size(); ++size) {
+        EXPECT_EQ(ReplayCalls<LogApi>(log.substr(0, size), {}, &report).code(), StatusCode::kInvalidArgument)
+            << size;
+    }
+    // A request which does not decode: "abc" with a longer length prefix.
+    std::string bad = log;
+    bad[bad.size() - 4] = 5;
+    EXPECT_EQ(ReplayCalls<LogApi>(bad, {}, &report).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(impl_->calls.size(), 1);
+}
+
+}  // namespace
@@ -0,0 +1,78 @@
+#include "cppschema/apispec/call_replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace cppschema {
+
+namespace {
+
+double Micros(std::chrono::nanoseconds d) { return static_cast<double>(d.count()) / 1000.0; }
+
+}  // namespace
+
+std::chrono::nanoseconds ApiReplayStats::Percentile(double fraction) const {
+    if (latencies.empty()) {
+        return std::chrono::nanoseconds(0);
+    }
+    std::vector<std::chrono::nanoseconds> sorted = latencies;
+    // The nearest rank.
+    const double n = static_cast<double>(sorted.size());
+    const size_t rank = static_cast<size_t>(std::clamp(std::ceil(fraction * n) - 1, 0.0, n - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+std::chrono::nanoseconds ApiReplayStats::Mean() const {
+    if (latencies.empty()) {
+        return std::chrono::nanoseconds(0);
+    }
+    std::chrono::nanoseconds total(0);
+    for (const auto latency : latencies) {
+        total += latency;
+    }
+    return total / latencies.size();
+}
+
+uint64_t ReplayReport::total_calls() const {
+    uint64_t total = 0;
+    for (const auto& [name, stats] : apis) {
+        total += stats.calls;
+    }
+    return total;
+}
+
+double ReplayReport::calls_per_second() const {
+    const double seconds = std::chrono::duration<double>(wall_time).count();
+    return seconds > 0 ? static_cast<double>(total_calls()) / seconds : 0;
+}
+
+std::string ReplayReport::ToString() const {
+    std::string out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%llu calls in %.3f s, %.0f calls/s",
+                  static_cast<unsigned long long>(total_calls()),
+                  std::chrono::duration<double>(wall_time).count(), calls_per_second());
+    out += line;
+    if (unknown_calls > 0) {
+        std::snprintf(line, sizeof(line), " (%llu calls of unknown APIs skipped)",
+                      static_cast<unsigned long long>(unknown_calls));
+        out += line;
+    }
+    out += "\n";
+    std::snprintf(line, sizeof(line), "%-24s %10s %8s %12s %12s %12s %12s\n",
+                  "api", "calls", "errors", "mean (us)", "p50 (us)", "p99 (us)", "max (us)");
+    out += line;
+    for (const auto& [name, stats] : apis) {
+        std::snprintf(line, sizeof(line), "%-24s %10llu %8llu %12.2f %12.2f %12.2f %12.2f\n",
+                      name.c_str(), static_cast<unsigned long long>(stats.calls),
+                      static_cast<unsigned long long>(stats.errors), Micros(stats.Mean()),
+                      Micros(stats.Percentile(0.5)), Micros(stats.Percentile(0.99)),
+                      Micros(stats.Percentile(1)));
+        out += line;
+    }
+    return out;
+}
+
+}  // namespace cppschema
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/call_recorder.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/wire_codec.h"
+
+namespace cppschema {
+
+struct ReplayOptions {
+    // Waits for the recorded time of each call, instead of calling as fast as possible.
+    bool original_pacing = false;
+    // With the original pacing, replays this many times faster (or slower, below 1).
+    double speed = 1.0;
+};
+
+// The results of the calls of one API.
+struct ApiReplayStats {
+    uint64_t calls = 0;
+    // The calls which returned an error.
+    uint64_t errors = 0;
+    // Of the backend calls, excluding the decoding of the requests.
+    std::vector<std::chrono::nanoseconds> latencies;
+
+    // The latency below which `fraction` (0 to 1) of the calls are.
+    std::chrono::nanoseconds Percentile(double fraction) const;
+    std::chrono::nanoseconds Mean() const;
+};
+
+struct ReplayReport {
+    std::map<std::string, ApiReplayStats, std::less<>> apis;
+    // The calls of the APIs which are not in the replayed API spec, skipped.
+    uint64_t unknown_calls = 0;
+    std::chrono::nanoseconds wall_time{0};
+
+    uint64_t total_calls() const;
+    double calls_per_second() const;
+
+    // A table of the calls, errors, throughput and latencies (mean, p50, p99, max) per API.
+    std::string ToString() const;
+};
+
+namespace internal {
+
+// Returns false if the request can not be decoded.
+using ReplayInvoker = bool (*)(std::string_view request, Status* status, std::chrono::nanoseconds* latency);
+
+// Decodes a recorded request, and calls the backend with it.
+template <typename API, typename Traits>
+bool ReplayCall(std::string_view request, Status* status, std::chrono::nanoseconds* latency) {
+    using Req = typename Traits::RequestType;
+    using Res = typename Traits::ResponseType;
+    Req req{};
+    if (!WireDecode(request, &req)) {
+        return false;
+    }
+    Res res{};
+    const auto start = std::chrono::steady_clock::now();
+    *status = ApiRegistry<API>::Get().template TryCall<Req, Res>(Traits::name, req, &res);
+    *latency = std::chrono::steady_clock::now() - start;
+    return true;
+}
+
+}  // namespace internal
+
+/**
+ * Replays a log of `CallRecorder` through the backend registered in `ApiRegistry<API>`, and
+ * reports the throughput and the latencies per API. The calls of the other APIs are skipped. The
+ * errors returned by the backend are counted, not fatal.
+ *
+ * Returns INVALID_ARGUMENT if the log, or a request in it, is corrupt. Remove the recorder before
+ * replaying, or the replayed calls are recorded too.
+ *
+ * @example
+ * ReplayReport report;
+ * Status status = ReplayCalls<GraphApi>(log, {.original_pacing = true}, &report);
+ * std::cout << report.ToString();
+ */
+template <typename API>
+Status ReplayCalls(std::string_view log, const ReplayOptions& options, ReplayReport* report) {
+    static const auto* const invokers = [] {
+        auto* invokers = new std::map<std::string_view, internal::ReplayInvoker>();
+        auto visitor = [invokers]<typename Traits>(Traits) {
+            invokers->emplace(Traits::name, &internal::ReplayCall<API, Traits>);
+        };
+        API schema;
+        schema._visit_traits(visitor);
+        return invokers;
+    }();
+
+    CallLogReader reader(log);
+    RecordedCall call;
+    const auto start = std::chrono::steady_clock::now();
+    while (reader.Next(&call)) {
+        auto it = invokers->find(call.name);
+        if (it == invokers->end()) {
+            ++report->unknown_calls;
+            continue;
+        }
+        if (options.original_pacing) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                call.time / options.speed));
+        }
+        Status status;
+        std::chrono::nanoseconds latency{0};
+        if (!it->second(call.request, &status, &latency)) {
+            return InvalidArgumentError("Corrupt request of " + std::string(call.name));
+        }
+        auto stats = report->apis.find(call.name);
+        if (stats == report->apis.end()) {
+            stats = report->apis.emplace(std::string(call.name), ApiReplayStats()).first;
+        }
+        ++stats->second.calls;
+        stats->second.errors += status.ok() ? 0 : 1;
+        stats->second.latencies.push_back(latency);
+    }
+    report->wall_time += std::chrono::steady_clock::now() - start;
+    return reader.status();
+}
+
+}  // namespace cppschema
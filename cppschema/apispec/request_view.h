@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "cppschema/common/schema_traits.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+
+namespace cppschema {
+
+namespace internal {
+
+inline constexpr size_t kNoField = static_cast<size_t>(-1);
+
+// The position of a member in the DEFINE_STRUCT_VISITOR_FUNCTION list, or `kNoField`.
+template <typename T, auto Ptr>
+size_t FieldIndexOf() {
+    static const size_t index = [] {
+        size_t i = 0;
+        size_t found = kNoField;
+        auto lambda = [&]<typename P, P ptr>(const char*, std::integral_constant<P, ptr>) {
+            if constexpr (std::is_same_v<P, decltype(Ptr)>) {
+                if (ptr == Ptr) {
+                    found = i;
+                }
+            }
+            ++i;
+        };
+        T{}._visit_member_ptrs(lambda);
+        return found;
+    }();
+    return index;
+}
+
+}  // namespace internal
+
+/**
+ * A request of which the fields are decoded on their first access, for the backend methods which
+ * read few of them, or reject most requests early (see `ImplMethod`). From JS, the fields which
+ * are not read are never converted. The native callers pass a decoded request, which the view
+ * reads in place.
+ *
+ * A field which fails to decode reads as its default, and fails the call with its error once the
+ * backend method returns. `status()` has the error as soon as it happens, for the methods which
+ * rather stop.
+ *
+ * @example
+ * Expected<uint32_t> importImpl(const RequestView<ImportRequest>& request) {
+ *     if (request.Get<&ImportRequest::version>() != 2) {
+ *         return Unexpected(InvalidArgumentError("Unsupported version"));  // `nodes` is not decoded.
+ *     }
+ *     for (const Node& node : request.Get<&ImportRequest::nodes>()) {...}
+ * }
+ */
+template <typename Req>
+class RequestView {
+public:
+    // Decodes the field at `index`, in the DEFINE_STRUCT_VISITOR_FUNCTION order, from `source`
+    // into `req`.
+    using FieldDecoder = Status (*)(const void* source, size_t index, Req* req);
+
+    // Reads a decoded request, which must outlive the view.
+    explicit RequestView(const Req& req) : req_(&req) {}
+
+    // Decodes the fields of `source` with `decoder` as they are read. `source` must outlive the view.
+    RequestView(FieldDecoder decoder, const void* source)
+        : lazy_(std::in_place, decoder, source), req_(&lazy_->req) {}
+
+    // Not movable, as it may point into itself.
+    RequestView(const RequestView&) = delete;
+    RequestView& operator=(const RequestView&) = delete;
+
+    // The field pointed to by `Ptr`, which must be listed in DEFINE_STRUCT_VISITOR_FUNCTION.
+    template <auto Ptr>
+    const internal::member_pointee_t<Ptr>& Get() const {
+        if (lazy_.has_value()) {
+            const size_t index = internal::FieldIndexOf<Req, Ptr>();
+            assert(index != internal::kNoField && "Not a field of DEFINE_STRUCT_VISITOR_FUNCTION");
+            if (index != internal::kNoField) {
+                lazy_->Decode(index);
+            }
+        }
+        return req_->*Ptr;
+    }
+
+    // The whole request, decoding the fields not read yet.
+    const Req& request() const {
+        if (lazy_.has_value()) {
+            for (size_t i = 0; i < lazy_->num_fields; ++i) {
+                lazy_->Decode(i);
+            }
+        }
+        return *req_;
+    }
+
+    // The error of the first field which failed to decode, if any.
+    const Status& status() const {
+        static const Status ok;
+        return lazy_.has_value() ? lazy_->status : ok;
+    }
+
+private:
+    struct Lazy {
+        Lazy(FieldDecoder decoder, const void* source) : decoder(decoder), source(source) {
+            static_assert(internal::is_visible_struct_like<Req>::value,
+                          "Only the structs with DEFINE_STRUCT_VISITOR_FUNCTION are decoded lazily");
+            auto count = [this]<typename T>(const char*, T&) { ++num_fields; };
+            req._visit_members(count);
+        }
+
+        void Decode(size_t index) {
+            const uint32_t bit = uint32_t{1} << index;
+            if ((decoded & bit) != 0) {
+                return;
+            }
+            decoded |= bit;
+            Status field_status = decoder(source, index, &req);
+            if (status.ok() && !field_status.ok()) {
+                status = std::move(field_status);
+            }
+        }
+
+        FieldDecoder decoder;
+        const void* source;
+        Req req{};
+        size_t num_fields = 0;
+        // DEFINE_STRUCT_VISITOR_FUNCTION lists up to 30 fields.
+        uint32_t decoded = 0;
+        Status status;
+    };
+
+    // Unset for the decoded requests.
+    mutable std::optional<Lazy> lazy_;
+    const Req* req_;
+};
+
+}  // namespace cppschema
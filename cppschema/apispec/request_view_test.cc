@@ -0,0 +1,169 @@
+#include "cppschema/apispec/request_view.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::Expected;
+using ::cppschema::RequestView;
+using ::cppschema::ScopedRegister;
+using ::cppschema::Status;
+using ::cppschema::StatusCode;
+
+struct ImportRequest {
+    uint32_t version = 0;
+    std::string name;
+    std::vector<int32_t> values;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(version, name, values);
+};
+
+// A source of the fields of an `ImportRequest`, like a JS object, which counts the decodes.
+struct FakeSource {
+    ImportRequest fields;
+    // Fails the decode of this field, if set.
+    size_t failing_field = static_cast<size_t>(-1);
+    std::vector<size_t> decoded;
+
+    static Status Decode(const void* source, size_t index, ImportRequest* req) {
+        auto* self = const_cast<FakeSource*>(static_cast<const FakeSource*>(source));
+        self->decoded.push_back(index);
+        if (index == self->failing_field) {
+            return cppschema::InvalidArgumentError("Bad field " + std::to_string(index));
+        }
+        switch (index) {
+            case 0: req->version = self->fields.version; break;
+            case 1: req->name = self->fields.name; break;
+            case 2: req->values = self->fields.values; break;
+        }
+        return Status();
+    }
+};
+
+TEST(RequestViewTest, DecodesTheFieldsOnFirstAccess) {
+    FakeSource source{.fields = {.version = 2, .name = "a", .values = {1, 2}}};
+    RequestView<ImportRequest> view(&FakeSource::Decode, &source);
+    EXPECT_TRUE(source.decoded.empty());
+
+    EXPECT_EQ(view.Get<&ImportRequest::values>(), (std::vector<int32_t>{1, 2}));
+    EXPECT_EQ(view.Get<&ImportRequest::values>().size(), 2);
+    EXPECT_EQ(source.decoded, std::vector<size_t>{2});
+
+    const ImportRequest& request = view.request();
+    EXPECT_EQ(request.version, 2);
+    EXPECT_EQ(request.name, "a");
+    EXPECT_EQ(source.decoded, (std::vector<size_t>{2, 0, 1}));
+    EXPECT_TRUE(view.status().ok());
+}
+
+TEST(RequestViewTest, ReadsDecodedRequestsInPlace) {
+    const ImportRequest request{.version = 3, .name = "b"};
+    RequestView<ImportRequest> view(request);
+    EXPECT_EQ(&view.Get<&ImportRequest::name>(), &request.name);
+    EXPECT_EQ(&view.request(), &request);
+}
+
+TEST(RequestViewTest, KeepsTheFirstDecodeError) {
+    FakeSource source{.fields = {.version = 2, .name = "a"}, .failing_field = 1};
+    RequestView<ImportRequest> view(&FakeSource::Decode, &source);
+    EXPECT_EQ(view.Get<&ImportRequest::version>(), 2);
+    EXPECT_TRUE(view.status().ok());
+    EXPECT_EQ(view.Get<&ImportRequest::name>(), "");
+    EXPECT_EQ(view.status().code(), StatusCode::kInvalidArgument);
+    // Not decoded again.
+    view.request();
+    EXPECT_EQ(source.decoded, (std::vector<size_t>{0, 1, 2}));
+}
+
+struct ImportApi {
+    ApiStub<ImportRequest, int32_t> import;
+    ApiStub<ImportRequest, int32_t> importEager;
+
+    DEFINE_API_VISITOR_FUNCTION(import, importEager);
+};
+
+// Sums the values of the requests of version 2.
+class ImportApiImpl : public cppschema::ApiBackend<ImportApi> {
+public:
+    Expected<int32_t> importImpl(const RequestView<ImportRequest>& request) {
+        if (request.Get<&ImportRequest::version>() != 2) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError("Unsupported version"));
+        }
+        int32_t sum = 0;
+        for (int32_t value : request.Get<&ImportRequest::values>()) {
+            sum += value;
+        }
+        return sum;
+    }
+
+    int32_t importEagerImpl(const ImportRequest& request) { return static_cast<int32_t>(request.values.size()); }
+};
+
+class RequestViewRegistryTest : public testing::Test {
+protected:
+    Status TryImport(const char* name, const RequestView<ImportRequest>& view, int32_t* res) {
+        return registry_.TryCallView<ImportRequest, int32_t>(name, view, res);
+    }
+
+    ApiRegistry<ImportApi>& registry_ = ApiRegistry<ImportApi>::Get();
+    ScopedRegister<ImportApi, ImportApiImpl> backend_{new ImportApiImpl(), {
+        .import = &ImportApiImpl::importImpl,
+        .importEager = &ImportApiImpl::importEagerImpl,
+    }};
+};
+
+TEST_F(RequestViewRegistryTest, RejectsEarlyWithoutDecodingTheRest) {
+    EXPECT_TRUE(registry_.TakesView("import"));
+    EXPECT_FALSE(registry_.TakesView("importEager"));
+
+    FakeSource source{.fields = {.version = 1, .values = {1, 2, 3}}};
+    RequestView<ImportRequest> view(&FakeSource::Decode, &source);
+    int32_t sum = 0;
+    EXPECT_EQ(TryImport("import", view, &sum).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(source.decoded, std::vector<size_t>{0});
+
+    source = FakeSource{.fields = {.version = 2, .values = {1, 2, 3}}};
+    RequestView<ImportRequest> accepted(&FakeSource::Decode, &source);
+    EXPECT_TRUE(TryImport("import", accepted, &sum).ok());
+    EXPECT_EQ(sum, 6);
+    EXPECT_EQ(source.decoded, (std::vector<size_t>{0, 2}));
+}
+
+TEST_F(RequestViewRegistryTest, DecodeErrorsFailTheCall) {
+    FakeSource source{.fields = {.version = 2, .values = {1}}, .failing_field = 2};
+    RequestView<ImportRequest> view(&FakeSource::Decode, &source);
+    int32_t sum = -1;
+    const Status status = TryImport("import", view, &sum);
+    EXPECT_EQ(status.code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(status.message(), "Bad field 2");
+}
+
+TEST_F(RequestViewRegistryTest, OtherCallersAndMethods) {
+    // The native callers pass decoded requests.
+    int32_t sum = 0;
+    const ImportRequest request{.version = 2, .values = {4, 5}};
+    const Status status = registry_.TryCall<ImportRequest, int32_t>("import", request, &sum);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(sum, 9);
+
+    // The methods taking a decoded request get the whole request.
+    FakeSource source{.fields = {.version = 1, .values = {1, 2}}};
+    RequestView<ImportRequest> view(&FakeSource::Decode, &source);
+    int32_t count = 0;
+    EXPECT_TRUE(TryImport("importEager", view, &count).ok());
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(source.decoded.size(), 3);
+}
+
+}  // namespace
@@ -0,0 +1,115 @@
+#include "cppschema/apispec/task.h"
+
+#include <thread>
+
+namespace cppschema {
+
+namespace {
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+constexpr bool kHasThreads = false;
+#else
+constexpr bool kHasThreads = true;
+#endif
+
+}  // namespace
+
+TaskScheduler& TaskScheduler::Get() {
+    thread_local TaskScheduler scheduler;
+    return scheduler;
+}
+
+void TaskScheduler::Schedule(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(handle);
+    }
+    ready_cv_.notify_one();
+}
+
+void TaskScheduler::ScheduleAt(Clock::time_point deadline, std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timers_.emplace(deadline, handle);
+    }
+    // A blocked `RunUntil` may have to wake up earlier.
+    ready_cv_.notify_one();
+}
+
+std::optional<TaskScheduler::Clock::time_point> TaskScheduler::next_deadline() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timers_.empty()) {
+        return std::nullopt;
+    }
+    return timers_.begin()->first;
+}
+
+bool TaskScheduler::TakeDue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto end = timers_.upper_bound(Clock::now());
+    if (end == timers_.begin()) {
+        return false;
+    }
+    for (auto it = timers_.begin(); it != end; ++it) {
+        ready_.push_back(it->second);
+    }
+    timers_.erase(timers_.begin(), end);
+    return true;
+}
+
+size_t TaskScheduler::RunUntilIdle() {
+    size_t resumed = 0;
+    do {
+        resumed += RunReady();
+    } while (TakeDue());
+    return resumed;
+}
+
+size_t TaskScheduler::RunReady() {
+    size_t resumed = 0;
+    while (true) {
+        std::coroutine_handle<> next;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!ready_.empty()) {
+                next = ready_.front();
+                ready_.pop_front();
+            }
+        }
+        if (!next) {
+            return resumed;
+        }
+        next.resume();
+        ++resumed;
+    }
+}
+
+bool TaskScheduler::RunUntil(const std::function<bool()>& condition) {
+    while (true) {
+        RunUntilIdle();
+        if (condition()) {
+            return true;
+        }
+        const std::optional<Clock::time_point> deadline = next_deadline();
+        if constexpr (!kHasThreads) {
+            // Nothing else could wake up the coroutines.
+            if (!deadline) {
+                return false;
+            }
+            std::this_thread::sleep_until(*deadline);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        // Also woken up by an earlier timer, which then sets the time to wait until.
+        const auto woken = [&] {
+            return !ready_.empty() || (!timers_.empty() && (!deadline || timers_.begin()->first < *deadline));
+        };
+        if (deadline) {
+            ready_cv_.wait_until(lock, *deadline, woken);
+        } else {
+            ready_cv_.wait(lock, woken);
+        }
+    }
+}
+
+}  // namespace cppschema
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "cppschema/common/status.h"
+
+namespace cppschema {
+
+class TaskScheduler;
+
+/**
+ * A coroutine which completes with an `Expected<T>`, for the backend methods waiting on I/O (see
+ * `ImplMethod`). It is lazy: it runs once awaited with `co_await`, or spawned on a
+ * `TaskScheduler`. A task may `co_await` other tasks, `Completion`s and `Yield()`, and completes
+ * with `co_return value;` or `co_return Unexpected(status);`.
+ *
+ * @example
+ * Task<std::string> loadImpl(const std::string& path) {
+ *     Expected<Blob> bytes = co_await ReadFile(path);  // A Task<Blob>.
+ *     if (!bytes) {
+ *         co_return Unexpected(bytes.error());
+ *     }
+ *     co_return Parse(*bytes);
+ * }
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        // Resumes the awaiting coroutine, if any, without growing the stack.
+        std::coroutine_handle<> await_suspend(Handle handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    struct promise_type {
+        std::optional<Expected<T>> result;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() { return Task(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_value(Expected<T> value) { result.emplace(std::move(value)); }
+        // The library is used without exceptions, see `Status`.
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            Destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    ~Task() { Destroy(); }
+
+    bool done() const { return handle_ && handle_.done(); }
+
+    // Awaiting starts the task, and resumes the awaiting coroutine when it completes.
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    Expected<T> await_resume() { return std::move(*handle_.promise().result); }
+
+private:
+    explicit Task(Handle handle) : handle_(handle) {}
+
+    void Destroy() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    Handle handle_;
+};
+
+/**
+ * Runs the coroutines of the tasks, one at a time, on the thread calling `Run*`. A coroutine runs
+ * until it completes or suspends, then the next ready one is resumed, so many calls waiting on
+ * I/O interleave without threads. The other threads may only `Schedule` (e.g. through
+ * `Completion::Set`), which wakes up a blocked `RunUntil`.
+ *
+ * The coroutines waiting for a time (see `SleepFor`) are resumed by the first `Run*` past it, once
+ * the ready ones have run. Nothing runs them otherwise: in the wasm builds, see `jsbridge::RunTasks`.
+ *
+ * There is one scheduler per thread, see `Get`.
+ */
+class TaskScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static TaskScheduler& Get();
+
+    TaskScheduler() = default;
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Queues a suspended coroutine to be resumed. Thread-safe.
+    void Schedule(std::coroutine_handle<> handle);
+
+    // Queues a suspended coroutine to be resumed at `deadline`, after the ready ones. Thread-safe.
+    void ScheduleAt(Clock::time_point deadline, std::coroutine_handle<> handle);
+
+    // The earliest time a coroutine waits for, if any.
+    std::optional<Clock::time_point> next_deadline() const;
+
+    /**
+     * Starts a task, which then runs in the background: `done` is called with its result when it
+     * completes. The task only runs within `RunUntilIdle` or `RunUntil`.
+     *
+     * @example
+     * scheduler.Spawn(registry.TryCallAsync<Req, Res>("load", req), [](Expected<Res> res) {...});
+     * scheduler.RunUntilIdle();
+     */
+    template <typename T>
+    void Spawn(Task<T> task, std::type_identity_t<std::function<void(Expected<T>)>> done);
+
+    // Resumes the ready coroutines, and those whose time has come, until none is. Returns the
+    // number of resumptions.
+    size_t RunUntilIdle();
+
+    // Same, but leaves the coroutines waiting for a time, even if it has come.
+    size_t RunReady();
+
+    // Runs the coroutines until `condition` holds. When none is ready, waits for the next deadline,
+    // or for another thread to schedule one. Returns false if nothing could make one ready, in the
+    // builds without threads.
+    bool RunUntil(const std::function<bool()>& condition);
+
+private:
+    // Moves the coroutines due by now to the ready queue. Returns false if there were none.
+    bool TakeDue();
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::deque<std::coroutine_handle<>> ready_;
+    // In the order of their deadlines, then of their scheduling.
+    std::multimap<Clock::time_point, std::coroutine_handle<>> timers_;
+};
+
+namespace internal {
+
+// A coroutine which starts at once, and frees itself when it completes.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// Suspends first, so that the task runs from the scheduler.
+struct ScheduleOn {
+    TaskScheduler* scheduler;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) { scheduler->Schedule(handle); }
+    void await_resume() const noexcept {}
+};
+
+struct ScheduleAt {
+    TaskScheduler* scheduler;
+    TaskScheduler::Clock::time_point deadline;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) { scheduler->ScheduleAt(deadline, handle); }
+    void await_resume() const noexcept {}
+};
+
+template <typename T>
+DetachedTask RunDetached(TaskScheduler* scheduler, Task<T> task, std::function<void(Expected<T>)> done) {
+    co_await ScheduleOn{scheduler};
+    Expected<T> result = co_await std::move(task);
+    done(std::move(result));
+}
+
+}  // namespace internal
+
+template <typename T>
+void TaskScheduler::Spawn(Task<T> task, std::type_identity_t<std::function<void(Expected<T>)>> done) {
+    internal::RunDetached(this, std::move(task), std::move(done));
+}
+
+/**
+ * Lets the other ready coroutines run, and resumes the current one after them.
+ *
+ * @example
+ * for (const Chunk& chunk : chunks) {
+ *     Process(chunk);
+ *     co_await Yield();
+ * }
+ */
+inline internal::ScheduleOn Yield() { return internal::ScheduleOn{&TaskScheduler::Get()}; }
+
+/**
+ * Resumes the current coroutine after `duration`, once the ready coroutines have run. A zero
+ * duration waits until the scheduler is otherwise idle.
+ *
+ * @example
+ * co_await SleepFor(std::chrono::milliseconds(5));
+ */
+inline internal::ScheduleAt SleepFor(TaskScheduler::Clock::duration duration) {
+    return internal::ScheduleAt{&TaskScheduler::Get(), TaskScheduler::Clock::now() + duration};
+}
+
+/**
+ * A value set once by a producer, e.g. an I/O callback, and awaited by one coroutine, which takes
+ * it. Copies share the same state. The awaiting coroutine is resumed by the scheduler of its
+ * thread, and `Set` may be called from any thread.
+ *
+ * @example
+ * Task<Blob> ReadFile(const std::string& path) {
+ *     Completion<Blob> read;
+ *     StartRead(path, [read](Blob bytes) mutable { read.Set(std::move(bytes)); });
+ *     co_return co_await read;
+ * }
+ */
+template <typename T>
+class Completion {
+public:
+    Completion() : state_(std::make_shared<State>()) {}
+
+    // Only the first value is kept.
+    void Set(Expected<T> value) {
+        std::coroutine_handle<> waiter;
+        TaskScheduler* scheduler = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->value.has_value()) {
+                return;
+            }
+            state_->value.emplace(std::move(value));
+            waiter = std::exchange(state_->waiter, nullptr);
+            scheduler = state_->scheduler;
+        }
+        if (waiter) {
+            scheduler->Schedule(waiter);
+        }
+    }
+
+    bool is_set() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->value.has_value();
+    }
+
+    struct Awaiter {
+        std::shared_ptr<typename Completion::State> state;
+
+        bool await_ready() const {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            return state->value.has_value();
+        }
+        // Returns false, i.e. does not suspend, if the value was set in the meantime.
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->value.has_value()) {
+                return false;
+            }
+            state->waiter = handle;
+            state->scheduler = &TaskScheduler::Get();
+            return true;
+        }
+        Expected<T> await_resume() { return std::move(*state->value); }
+    };
+
+    Awaiter operator co_await() const { return Awaiter{state_}; }
+
+private:
+    struct State {
+        mutable std::mutex mutex;
+        std::optional<Expected<T>> value;
+        std::coroutine_handle<> waiter;
+        TaskScheduler* scheduler = nullptr;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace cppschema
@@ -0,0 +1,93 @@
+#include "cppschema/apispec/task_pool.h"
+
+namespace cppschema {
+namespace {
+
+// The index of the worker running on this thread in its pool, if any.
+thread_local const TaskPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+}  // namespace
+
+TaskPool::TaskPool(size_t num_threads) {
+    if (!CPPSCHEMA_TASK_POOL_THREADS) {
+        num_threads = 0;
+    }
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // Started once all the deques exist, as the workers steal from each other.
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_[i]->thread = std::thread([this, i] { Run(i); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        stop_ = true;
+    }
+    idle_.notify_all();
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+TaskPool& TaskPool::Default() {
+    static auto* pool = new TaskPool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return *pool;
+}
+
+void TaskPool::Push(std::function<void()> task) {
+    const size_t index = current_pool == this ? current_worker : next_worker_.fetch_add(1) % workers_.size();
+    // Counted first, so that the count never goes below zero.
+    pending_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    // Taken after the increment, so that a worker about to sleep either sees the task or is woken.
+    { std::lock_guard<std::mutex> lock(idle_mutex_); }
+    idle_.notify_one();
+}
+
+bool TaskPool::Pop(size_t self, std::function<void()>* task) {
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        Worker& worker = *workers_[(self + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            *task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        } else {
+            *task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        pending_.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void TaskPool::Run(size_t self) {
+    current_pool = this;
+    current_worker = self;
+    std::function<void()> task;
+    while (true) {
+        if (Pop(self, &task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+        if (stop_ && pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+}  // namespace cppschema
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Whether `TaskPool` can start threads: natively, and in the wasm builds with pthreads (`-pthread`,
+ * with `-sPTHREAD_POOL_SIZE` so that the workers start without yielding to the event loop). Without
+ * them, the pools run everything on the calling thread.
+ */
+#ifndef CPPSCHEMA_TASK_POOL_THREADS
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define CPPSCHEMA_TASK_POOL_THREADS 0
+#else
+#define CPPSCHEMA_TASK_POOL_THREADS 1
+#endif
+#endif
+
+namespace cppschema {
+
+namespace internal {
+
+// The chunks of a parallel loop, claimed one at a time by the threads which join it.
+class ParallelJob {
+public:
+    ParallelJob(size_t num_chunks, std::function<void(size_t)> run_chunk)
+        : num_chunks_(num_chunks), run_chunk_(std::move(run_chunk)) {}
+
+    // Runs the chunks left, if any.
+    void Work() {
+        for (size_t chunk = next_.fetch_add(1); chunk < num_chunks_; chunk = next_.fetch_add(1)) {
+            run_chunk_(chunk);
+            if (done_.fetch_add(1) + 1 == num_chunks_) {
+                done_.notify_all();
+            }
+        }
+    }
+
+    // Waits for the chunks claimed by the other threads.
+    void Wait() {
+        for (size_t done = done_.load(); done < num_chunks_; done = done_.load()) {
+            done_.wait(done);
+        }
+    }
+
+private:
+    const size_t num_chunks_;
+    const std::function<void(size_t)> run_chunk_;
+    std::atomic<size_t> next_ = 0;
+    std::atomic<size_t> done_ = 0;
+};
+
+}  // namespace internal
+
+/**
+ * A pool of worker threads for the parallel loops of the backend methods, reached from a method
+ * through its `ApiContext`. Each worker has its own deque of tasks, and the idle ones steal from
+ * the others. The calling thread works on its own loop too, so the loops can nest, and a pool
+ * without threads runs them serially.
+ *
+ * The iterations must be independent: they run on any thread, in any order.
+ *
+ * @example
+ * TaskPool& pool = TaskPool::Default();
+ * pool.ParallelFor(0, ids.size(), 1024, [&](size_t begin, size_t end) {
+ *     for (size_t i = begin; i < end; ++i) {
+ *         nodes[i] = store.FindNode(ids[i]);
+ *     }
+ * });
+ * const size_t missing = pool.ParallelReduce(0, nodes.size(), 1024, size_t{0},
+ *     [&](size_t begin, size_t end) { return std::count(&nodes[begin], &nodes[end], std::nullopt); },
+ *     std::plus<>());
+ */
+class TaskPool {
+public:
+    // A pool of `num_threads` workers besides the calling threads. Zero runs everything serially.
+    explicit TaskPool(size_t num_threads);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // The pool of the backend methods, with a worker per core besides the calling thread. Started
+    // on first use.
+    static TaskPool& Default();
+
+    size_t num_threads() const { return workers_.size(); }
+
+    /**
+     * Calls `body(chunk_begin, chunk_end)` over the chunks of [begin, end), of at least `grain`
+     * indexes each, in parallel. Returns once they have all run.
+     */
+    template <typename Body>
+    void ParallelFor(size_t begin, size_t end, size_t grain, Body&& body) {
+        const size_t chunk_size = ChunkSize(begin, end, grain);
+        const size_t num_chunks = chunk_size == 0 ? 0 : (end - begin + chunk_size - 1) / chunk_size;
+        if (num_chunks <= 1 || workers_.empty()) {
+            for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += chunk_size) {
+                body(chunk_begin, std::min(chunk_begin + chunk_size, end));
+            }
+            return;
+        }
+        auto job = std::make_shared<internal::ParallelJob>(num_chunks, [&](size_t chunk) {
+            const size_t chunk_begin = begin + chunk * chunk_size;
+            body(chunk_begin, std::min(chunk_begin + chunk_size, end));
+        });
+        // The helpers which find the chunks taken return at once, so the job is shared with them.
+        for (size_t i = 0; i < std::min(num_chunks - 1, workers_.size()); ++i) {
+            Push([job] { job->Work(); });
+        }
+        job->Work();
+        job->Wait();
+    }
+
+    /**
+     * Reduces [begin, end) in parallel: `map(chunk_begin, chunk_end)` reduces a chunk of at least
+     * `grain` indexes to a `T`, and the results are combined in order, from `init`, with
+     * `combine(T, T)`. The result is the same for any number of threads, as the chunks only depend
+     * on the range and the grain.
+     */
+    template <typename T, typename Map, typename Combine>
+    T ParallelReduce(size_t begin, size_t end, size_t grain, T init, Map&& map, Combine&& combine) {
+        const size_t chunk_size = std::max<size_t>(grain, 1);
+        const size_t num_chunks = end > begin ? (end - begin + chunk_size - 1) / chunk_size : 0;
+        std::vector<T> partials(num_chunks, init);
+        ParallelFor(0, num_chunks, 1, [&](size_t chunk_begin, size_t chunk_end) {
+            for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+                const size_t first = begin + chunk * chunk_size;
+                partials[chunk] = map(first, std::min(first + chunk_size, end));
+            }
+        });
+        T result = std::move(init);
+        for (T& partial : partials) {
+            result = combine(std::move(result), std::move(partial));
+        }
+        return result;
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    // The chunks are at least `grain`, and a few per thread, so that the faster threads take more.
+    size_t ChunkSize(size_t begin, size_t end, size_t grain) const {
+        if (end <= begin) {
+            return 0;
+        }
+        const size_t per_thread = (end - begin + 4 * (workers_.size() + 1) - 1) / (4 * (workers_.size() + 1));
+        return std::max({grain, per_thread, size_t{1}});
+    }
+
+    // Queues a task on the deque of the calling worker, or of the next one for the other threads.
+    void Push(std::function<void()> task);
+    // Takes the newest task of worker `self`, or else the oldest one of another worker.
+    bool Pop(size_t self, std::function<void()>* task);
+    void Run(size_t self);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_worker_ = 0;
+    // The queued tasks, for the idle workers to wait on.
+    std::atomic<size_t> pending_ = 0;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_;
+    bool stop_ = false;
+};
+
+}  // namespace cppschema
@@ -0,0 +1,155 @@
+#include "cppschema/apispec/task_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_context.h"
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiContext;
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::Expected;
+using ::cppschema::ScopedRegister;
+using ::cppschema::Status;
+using ::cppschema::StatusCode;
+using ::cppschema::TaskPool;
+
+// Counts the runs of each index of [0, size).
+void ExpectEachIndexOnce(TaskPool& pool, size_t size, size_t grain) {
+    std::vector<std::atomic<int>> runs(size);
+    pool.ParallelFor(0, size, grain, [&](size_t begin, size_t end) {
+        EXPECT_LT(begin, end);
+        EXPECT_LE(end, size);
+        for (size_t i = begin; i < end; ++i) {
+            ++runs[i];
+        }
+    });
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(runs[i].load(), 1) << "index " << i << " of " << size << ", grain " << grain;
+    }
+}
+
+TEST(TaskPoolTest, RunsEachIndexOnce) {
+    TaskPool pool(4);
+    for (size_t size : {0, 1, 7, 1000, 100003}) {
+        for (size_t grain : {1, 16, 1000000}) {
+            ExpectEachIndexOnce(pool, size, grain);
+        }
+    }
+    TaskPool serial(0);
+    ExpectEachIndexOnce(serial, 1000, 1);
+}
+
+TEST(TaskPoolTest, SplitsTheWorkAcrossThreads) {
+    TaskPool pool(3);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    pool.ParallelFor(0, 64, 1, [&](size_t, size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    EXPECT_GT(threads.size(), 1);
+    EXPECT_LE(threads.size(), 4);
+}
+
+TEST(TaskPoolTest, SerialWithoutThreads) {
+    TaskPool pool(0);
+    EXPECT_EQ(pool.num_threads(), 0);
+    const std::thread::id caller = std::this_thread::get_id();
+    pool.ParallelFor(0, 100, 1, [caller](size_t, size_t) { EXPECT_EQ(std::this_thread::get_id(), caller); });
+}
+
+TEST(TaskPoolTest, NestedLoops) {
+    TaskPool pool(2);
+    std::atomic<int> runs = 0;
+    pool.ParallelFor(0, 8, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pool.ParallelFor(0, 100, 1, [&](size_t b, size_t e) { runs += static_cast<int>(e - b); });
+        }
+    });
+    EXPECT_EQ(runs.load(), 800);
+}
+
+TEST(TaskPoolTest, ReduceIsTheSameForAnyNumberOfThreads) {
+    std::vector<double> values(100000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    auto sum = [&](TaskPool& pool) {
+        return pool.ParallelReduce(0, values.size(), 1000, 0.0,
+            [&](size_t begin, size_t end) {
+                double s = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    s += values[i];
+                }
+                return s;
+            },
+            [](double a, double b) { return a + b; });
+    };
+    TaskPool serial(0);
+    TaskPool parallel(4);
+    const double expected = sum(serial);
+    EXPECT_NEAR(expected, 12.09, 0.01);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(sum(parallel), expected);  // Bitwise, the chunks are the same.
+    }
+    EXPECT_EQ(parallel.ParallelReduce(5, 5, 1, std::string("init"),
+        [](size_t, size_t) { return std::string("x"); }, [](std::string a, std::string b) { return a + b; }),
+        "init");
+}
+
+// A backend method taking the context.
+struct SumApi {
+    ApiStub<std::vector<int32_t>, int64_t> sum;
+
+    DEFINE_API_VISITOR_FUNCTION(sum);
+};
+
+class SumApiImpl : public cppschema::ApiBackend<SumApi> {
+public:
+    Expected<int64_t> sumImpl(const std::vector<int32_t>& values, const ApiContext& context) {
+        EXPECT_STREQ(context.api(), "sum");
+        if (values.empty()) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError("Nothing to sum"));
+        }
+        return context.ParallelReduce(0, values.size(), 64, int64_t{0},
+            [&](size_t begin, size_t end) {
+                int64_t s = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    s += values[i];
+                }
+                return s;
+            },
+            [](int64_t a, int64_t b) { return a + b; });
+    }
+};
+
+TEST(ApiContextTest, PassedToTheBackendMethods) {
+    ScopedRegister<SumApi, SumApiImpl> backend(new SumApiImpl(), {.sum = &SumApiImpl::sumImpl});
+    std::vector<int32_t> values(10000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int32_t>(i);
+    }
+    int64_t sum = 0;
+    ASSERT_TRUE(ApiRegistry<SumApi>::Get().TryCall("sum", values, &sum).ok());
+    EXPECT_EQ(sum, 49995000);
+    Status status = ApiRegistry<SumApi>::Get().TryCall("sum", std::vector<int32_t>(), &sum);
+    EXPECT_EQ(status.code(), StatusCode::kInvalidArgument);
+}
+
+}  // namespace
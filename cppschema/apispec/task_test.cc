@@ -0,0 +1,230 @@
+#include "cppschema/apispec/task.h"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::Completion;
+using ::cppschema::Expected;
+using ::cppschema::ScopedRegister;
+using ::cppschema::Status;
+using ::cppschema::StatusCode;
+using ::cppschema::Task;
+using ::cppschema::TaskScheduler;
+using ::cppschema::Yield;
+
+Task<int> Add(int a, int b) {
+    co_return a + b;
+}
+
+Task<int> Fail() {
+    co_return cppschema::Unexpected(cppschema::NotFoundError("No value"));
+}
+
+Task<int> SumOfAdds() {
+    Expected<int> a = co_await Add(1, 2);
+    Expected<int> b = co_await Add(3, 4);
+    co_return *a + *b;
+}
+
+Task<int> PropagatesErrors() {
+    Expected<int> a = co_await Fail();
+    if (!a.has_value()) {
+        co_return cppschema::Unexpected(std::move(a).error());
+    }
+    co_return *a;
+}
+
+// Runs a task to completion on the scheduler of the thread.
+template <typename T>
+Expected<T> RunTask(Task<T> task) {
+    std::optional<Expected<T>> result;
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    scheduler.Spawn(std::move(task), [&](Expected<T> value) { result.emplace(std::move(value)); });
+    scheduler.RunUntilIdle();
+    EXPECT_TRUE(result.has_value());
+    return std::move(*result);
+}
+
+TEST(TaskTest, AwaitsNestedTasks) {
+    EXPECT_EQ(*RunTask(SumOfAdds()), 10);
+    Expected<int> error = RunTask(PropagatesErrors());
+    ASSERT_FALSE(error.has_value());
+    EXPECT_EQ(error.error().code(), StatusCode::kNotFound);
+}
+
+TEST(TaskTest, IsLazy) {
+    bool started = false;
+    // The coroutine refers to the lambda, which must outlive it.
+    auto start = [&]() -> Task<int> {
+        started = true;
+        co_return 1;
+    };
+    Task<int> task = start();
+    EXPECT_FALSE(started);
+    EXPECT_EQ(*RunTask(std::move(task)), 1);
+    EXPECT_TRUE(started);
+}
+
+TEST(TaskTest, YieldInterleavesTasks) {
+    std::vector<std::string> steps;
+    auto worker = [&](std::string name) -> Task<int> {
+        for (int i = 0; i < 3; ++i) {
+            steps.push_back(name + std::to_string(i));
+            co_await Yield();
+        }
+        co_return 0;
+    };
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    scheduler.Spawn(worker("a"), [](Expected<int>) {});
+    scheduler.Spawn(worker("b"), [](Expected<int>) {});
+    scheduler.RunUntilIdle();
+    EXPECT_EQ(steps, (std::vector<std::string>{"a0", "b0", "a1", "b1", "a2", "b2"}));
+}
+
+TEST(TaskTest, CompletionResumesTheAwaitingTask) {
+    Completion<std::string> completion;
+    std::optional<Expected<std::string>> result;
+    auto waiter = [](Completion<std::string> completion) -> Task<std::string> {
+        Expected<std::string> value = co_await completion;
+        co_return *value + "!";
+    };
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    scheduler.Spawn(waiter(completion), [&](Expected<std::string> value) { result.emplace(std::move(value)); });
+    scheduler.RunUntilIdle();
+    EXPECT_FALSE(result.has_value());
+
+    completion.Set(std::string("done"));
+    completion.Set(std::string("ignored"));
+    EXPECT_TRUE(completion.is_set());
+    scheduler.RunUntilIdle();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(**result, "done!");
+
+    // Already set: does not suspend.
+    Completion<std::string> ready;
+    ready.Set(std::string("ready"));
+    EXPECT_EQ(*RunTask(waiter(ready)), "ready!");
+}
+
+TEST(TaskTest, RunUntilWaitsForOtherThreads) {
+    Completion<int> completion;
+    std::optional<Expected<int>> result;
+    auto waiter = [](Completion<int> completion) -> Task<int> {
+        co_return *(co_await completion) * 2;
+    };
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    scheduler.Spawn(waiter(completion), [&](Expected<int> value) { result.emplace(std::move(value)); });
+    std::thread producer([completion]() mutable { completion.Set(21); });
+    EXPECT_TRUE(scheduler.RunUntil([&] { return result.has_value(); }));
+    producer.join();
+    EXPECT_EQ(**result, 42);
+}
+
+// Backend methods which wait on `Completion`s, like the I/O callbacks would.
+struct LoadApi {
+    ApiStub<std::string, std::string> load;
+    ApiStub<std::string, int32_t> size;
+
+    DEFINE_API_VISITOR_FUNCTION(load, size);
+};
+
+class LoadApiImpl : public cppschema::ApiBackend<LoadApi> {
+public:
+    Task<std::string> loadImpl(const std::string& path) {
+        if (path.empty()) {
+            co_return cppschema::Unexpected(cppschema::InvalidArgumentError("Empty path"));
+        }
+        Completion<std::string> read;
+        if (reader) {
+            reader(read);
+        } else {
+            pending.emplace_back(path, read);
+        }
+        Expected<std::string> contents = co_await read;
+        if (!contents.has_value()) {
+            co_return cppschema::Unexpected(std::move(contents).error());
+        }
+        co_return path + ":" + *contents;
+    }
+
+    int32_t sizeImpl(const std::string& path) { return static_cast<int32_t>(path.size()); }
+
+    // Starts the reads, which are left pending otherwise.
+    std::function<void(Completion<std::string>)> reader;
+    std::vector<std::pair<std::string, Completion<std::string>>> pending;
+};
+
+class AsyncRegistryTest : public testing::Test {
+protected:
+    LoadApiImpl* impl_ = new LoadApiImpl();
+    ScopedRegister<LoadApi, LoadApiImpl> backend_{impl_, {
+        .load = &LoadApiImpl::loadImpl,
+        .size = &LoadApiImpl::sizeImpl,
+    }};
+    ApiRegistry<LoadApi>& registry_ = ApiRegistry<LoadApi>::Get();
+    TaskScheduler& scheduler_ = TaskScheduler::Get();
+};
+
+TEST_F(AsyncRegistryTest, InterleavesTheCalls) {
+    EXPECT_TRUE(registry_.IsAsync("load"));
+    EXPECT_FALSE(registry_.IsAsync("size"));
+
+    std::vector<std::string> responses;
+    for (const char* path : {"a", "b", "c"}) {
+        scheduler_.Spawn(registry_.TryCallAsync<std::string, std::string>("load", path),
+            [&](Expected<std::string> res) { responses.push_back(res.has_value() ? *res : res.error().ToString()); });
+    }
+    scheduler_.RunUntilIdle();
+    ASSERT_EQ(impl_->pending.size(), 3);
+    EXPECT_TRUE(responses.empty());
+
+    // Completed out of order.
+    impl_->pending[2].second.Set(std::string("3"));
+    impl_->pending[0].second.Set(cppschema::Unexpected(cppschema::NotFoundError("No file")));
+    scheduler_.RunUntilIdle();
+    impl_->pending[1].second.Set(std::string("2"));
+    scheduler_.RunUntilIdle();
+    ASSERT_EQ(responses.size(), 3);
+    EXPECT_EQ(responses[0], "c:3");
+    EXPECT_NE(responses[1].find("No file"), std::string::npos);
+    EXPECT_EQ(responses[2], "b:2");
+}
+
+TEST_F(AsyncRegistryTest, TryCallAsyncOfOtherMethods) {
+    EXPECT_EQ(*RunTask(registry_.TryCallAsync<std::string, int32_t>("size", "abcd")), 4);
+    Expected<std::string> error = RunTask(registry_.TryCallAsync<std::string, std::string>("load", ""));
+    EXPECT_EQ(error.error().code(), StatusCode::kInvalidArgument);
+
+    Expected<int32_t> missing = RunTask(registry_.TryCallAsync<std::string, int32_t>("missing", ""));
+    EXPECT_EQ(missing.error().code(), StatusCode::kUnimplemented);
+}
+
+TEST_F(AsyncRegistryTest, TryCallWaitsForTheCoroutine) {
+    // The read completes on another thread.
+    std::thread io;
+    impl_->reader = [&](Completion<std::string> read) {
+        io = std::thread([read]() mutable { read.Set(std::string("contents")); });
+    };
+    std::string res;
+    Status status = registry_.TryCall<std::string, std::string>("load", "f", &res);
+    io.join();
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    EXPECT_EQ(res, "f:contents");
+    EXPECT_EQ((registry_.TryCall<std::string, std::string>("load", "", &res)).code(), StatusCode::kInvalidArgument);
+}
+
+}  // namespace
@@ -1,10 +1,116 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_policies.h"
 #include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/batcher.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/trace.h"
 #include "cppschema/common/visitor_macros.h"
+#include "cppschema/common/wire_codec.h"
 
 namespace cppschema {
 
+namespace internal {
+
+// Moves the result of a coroutine backend method into the type-erased response.
+template <typename Res>
+Task<VoidType> StoreTaskResult(Task<Res> task, Res* res) {
+    Expected<Res> result = co_await std::move(task);
+    if (!result.has_value()) {
+        co_return Unexpected(std::move(result).error());
+    }
+    *res = std::move(result).value();
+    co_return VoidType{};
+}
+
+// The responses of a `Cacheable` method, by wire encoded request. They are dropped once the cache
+// generation of the registry changes, and all at once when there are `kMaxCachedResponses`.
+template <typename Res>
+class ResponseCache {
+public:
+    // Copies the response cached for `key` to `res`, if any.
+    bool Find(const std::string& key, uint64_t generation, Res* res) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!Sync(generation)) {
+            return false;
+        }
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return false;
+        }
+        *res = it->second;
+        return true;
+    }
+
+    // Caches the response of a call made at `generation`.
+    void Insert(std::string key, uint64_t generation, const Res& res) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!Sync(generation)) {
+            return;
+        }
+        if (entries_.size() >= kMaxCachedResponses) {
+            entries_.clear();
+        }
+        entries_.insert_or_assign(std::move(key), res);
+    }
+
+private:
+    // Drops the entries of the older generations. False for a call made before an invalidation.
+    bool Sync(uint64_t generation) {
+        if (generation < generation_) {
+            return false;
+        }
+        if (generation > generation_) {
+            entries_.clear();
+            generation_ = generation;
+        }
+        return true;
+    }
+
+    std::mutex mutex_;
+    uint64_t generation_ = 0;
+    std::unordered_map<std::string, Res> entries_;
+};
+
+// True if some methods of `API` are `Cacheable`. Then the others invalidate their responses.
+template <typename API>
+bool HasCacheableMethods() {
+    bool cacheable = false;
+    auto visitor = [&]<typename Traits>(Traits) { cacheable = cacheable || kHasPolicy<Traits, Cacheable>; };
+    API schema;
+    schema._visit_traits(visitor);
+    return cacheable;
+}
+
+// Runs a coroutine dispatch, then invalidates the cached responses of its API.
+template <typename API>
+Task<VoidType> InvalidateResponsesAfter(Task<VoidType> task) {
+    Expected<VoidType> result = co_await std::move(task);
+    ApiRegistry<API>::Get().InvalidateResponseCaches();
+    co_return result;
+}
+
+}  // namespace internal
+
+/**
+ * Registers the methods of a backend instance for `API`, taking its ownership. Each method gets
+ * the dispatch of its signature (see `ImplMethod`), specialized for the policies of its api (see
+ * api_policies.h): the `Cacheable` ones are wrapped in a cache of their responses, which the
+ * other methods of the API invalidate, and the `Trace` ones record a backend span per call even
+ * without CPPSCHEMA_TRACING. The methods without policies pay for none of them.
+ */
 template <typename API, typename Impl>
 void RegisterBackend(Impl* instance, const typename API::template ImplPtrs<Impl>& ptrs) {
     auto& registry = ApiRegistry<API>::Get();
@@ -16,23 +122,160 @@ void RegisterBackend(Impl* instance, const typename API::template ImplPtrs<Impl>
         [](void* ptr) { delete static_cast<Impl*>(ptr); }
     );
 
+    const bool has_cacheable = internal::HasCacheableMethods<API>();
+
     /**
      * Internal Visitor Lambda:
      * This matches the signature expected by API::_visit_traits_with_impl.
      * It captures the 'instance' pointer to create the final dispatch lambdas.
      */
-    auto binder = [&](auto stub, auto& impl_ref, auto member_ptr) {
-        using Req = typename decltype(stub)::RequestType;
-        using Res = typename decltype(stub)::ResponseType;
-        using ImplPtr = Res (Impl::*)(const Req&);
+    auto binder = [&]<typename Traits>(Traits, auto& impl_ref, const auto& method) {
+        using Req = typename Traits::RequestType;
+        using Res = typename Traits::ResponseType;
+        using Method = ImplMethod<Impl, Req, Res>;
         static_assert(std::is_same_v<Impl, std::decay_t<decltype(impl_ref)>>, "Impl type mismatch");
-        static_assert(std::is_same_v<ImplPtr, decltype(member_ptr)>, "Member pointer type mismatch");
-        const char* name = decltype(stub)::name;
-        registry.RegisterHandler(name, [instance, member_ptr](const void* rawReq) -> void* {
-            const Req& typedReq = *static_cast<const Req*>(rawReq);
-            Res result = (instance->*member_ptr)(typedReq);
-            // Return heap-allocated void*
-            return static_cast<void*>(new Res(std::move(result)));
+        static_assert(std::is_same_v<Method, std::decay_t<decltype(method)>>, "Member pointer type mismatch");
+        const char* name = Traits::name;
+        using RawDispatcher = typename ApiRegistry<API>::RawDispatcher;
+        constexpr bool kCacheable = kHasPolicy<Traits, Cacheable>;
+        // In the tracing builds, the registry traces all the calls already.
+        constexpr bool kTraced = kHasPolicy<Traits, Trace> && !trace::kTracingEnabled;
+        const bool invalidates = !kCacheable && has_cacheable;
+        // Wraps a dispatcher in the policies of the api. `kDecoded` if it reads a `Req`.
+        auto specialize = [&]<bool kDecoded>(RawDispatcher dispatch) -> RawDispatcher {
+            if constexpr (kTraced) {
+                dispatch = [dispatch = std::move(dispatch), name](const void* rawReq, void* rawRes) {
+                    size_t payload_size = 0;
+                    if constexpr (kDecoded) {
+                        payload_size = trace::PayloadSize(*static_cast<const Req*>(rawReq));
+                    }
+                    trace::enabled::ScopedSpan span(name, trace::kBackend, payload_size);
+                    return dispatch(rawReq, rawRes);
+                };
+            }
+            if (invalidates) {
+                dispatch = [dispatch = std::move(dispatch), registry = &registry](const void* rawReq, void* rawRes) {
+                    Status status = dispatch(rawReq, rawRes);
+                    registry->InvalidateResponseCaches();
+                    return status;
+                };
+            }
+            return dispatch;
+        };
+        // The calls with a decoded request, cached for the `Cacheable` methods.
+        auto specialize_call = [&](RawDispatcher call) -> RawDispatcher {
+            call = specialize.template operator()<true>(std::move(call));
+            if constexpr (kCacheable) {
+                auto cache = std::make_shared<internal::ResponseCache<Res>>();
+                call = [call = std::move(call), cache, registry = &registry](const void* rawReq, void* rawRes) {
+                    std::string key = WireEncode(*static_cast<const Req*>(rawReq));
+                    const uint64_t generation = registry->response_cache_generation();
+                    if (cache->Find(key, generation, static_cast<Res*>(rawRes))) {
+                        return OkStatus();
+                    }
+                    Status status = call(rawReq, rawRes);
+                    if (status.ok()) {
+                        cache->Insert(std::move(key), generation, *static_cast<const Res*>(rawRes));
+                    }
+                    return status;
+                };
+            }
+            return call;
+        };
+        // Each signature gets its own dispatch lambda, so a plain method pays nothing for the
+        // error handling of the others. Unset methods are not registered.
+        method.Visit([&]<typename Ptr>(Ptr member_ptr) {
+            if constexpr (std::is_same_v<Ptr, typename Method::PlainPtr>) {
+                registry.RegisterHandler(name, specialize_call([instance, member_ptr](const void* rawReq, void* rawRes) {
+                    *static_cast<Res*>(rawRes) = (instance->*member_ptr)(*static_cast<const Req*>(rawReq));
+                    return Status();
+                }));
+            } else if constexpr (std::is_same_v<Ptr, typename Method::ExpectedPtr>) {
+                registry.RegisterHandler(name, specialize_call([instance, member_ptr](const void* rawReq, void* rawRes) {
+                    Expected<Res> result = (instance->*member_ptr)(*static_cast<const Req*>(rawReq));
+                    if (!result.has_value()) {
+                        return std::move(result).error();
+                    }
+                    *static_cast<Res*>(rawRes) = std::move(result).value();
+                    return Status();
+                }));
+            } else if constexpr (std::is_same_v<Ptr, typename Method::ContextPtr>) {
+                registry.RegisterHandler(name, specialize_call([instance, member_ptr, name](const void* rawReq, void* rawRes) {
+                    const ApiContext context(name, &TaskPool::Default());
+                    Expected<Res> result = (instance->*member_ptr)(*static_cast<const Req*>(rawReq), context);
+                    if (!result.has_value()) {
+                        return std::move(result).error();
+                    }
+                    *static_cast<Res*>(rawRes) = std::move(result).value();
+                    return Status();
+                }));
+            } else if constexpr (std::is_same_v<Ptr, typename Method::TaskPtr>) {
+                // The request outlives the coroutine, see `ApiRegistry::TryCallAsync`. The coroutines
+                // are neither cached nor traced, as their spans would not nest.
+                typename ApiRegistry<API>::AsyncDispatcher async =
+                    [instance, member_ptr](const void* rawReq, void* rawRes) {
+                        return internal::StoreTaskResult<Res>(
+                            (instance->*member_ptr)(*static_cast<const Req*>(rawReq)), static_cast<Res*>(rawRes));
+                    };
+                if (invalidates) {
+                    async = [async = std::move(async)](const void* rawReq, void* rawRes) {
+                        return internal::InvalidateResponsesAfter<API>(async(rawReq, rawRes));
+                    };
+                }
+                registry.RegisterAsyncHandler(name, std::move(async));
+            } else if constexpr (std::is_same_v<Ptr, typename Method::ViewPtr>) {
+                // The decoded requests are read in place, see `ApiRegistry::TryCallView` for the others.
+                auto call = [instance, member_ptr](const RequestView<Req>& view, void* rawRes) {
+                    Expected<Res> result = (instance->*member_ptr)(view);
+                    if (!result.has_value()) {
+                        return std::move(result).error();
+                    }
+                    *static_cast<Res*>(rawRes) = std::move(result).value();
+                    return Status();
+                };
+                RawDispatcher decoded = specialize_call([call](const void* rawReq, void* rawRes) {
+                    return call(RequestView<Req>(*static_cast<const Req*>(rawReq)), rawRes);
+                });
+                if constexpr (kCacheable) {
+                    // The whole request is the key, so it is decoded.
+                    registry.RegisterHandler(name, std::move(decoded));
+                } else {
+                    registry.RegisterViewHandler(name, std::move(decoded),
+                        specialize.template operator()<false>([call](const void* rawView, void* rawRes) {
+                            return call(*static_cast<const RequestView<Req>*>(rawView), rawRes);
+                        }));
+                }
+            } else if constexpr (std::is_same_v<Ptr, typename Method::ResponseSinkPtr>) {
+                // C++ callers get a vector, the other callers pass their own sink to `TryStream`. The
+                // cached responses are vectors, so they are not streamed.
+                RawDispatcher stream = nullptr;
+                if constexpr (!kCacheable) {
+                    stream = specialize.template operator()<true>([instance, member_ptr](const void* rawReq, void* rawSink) {
+                        return (instance->*member_ptr)(*static_cast<const Req*>(rawReq),
+                            static_cast<ResponseSink<Res>*>(rawSink));
+                    });
+                }
+                registry.RegisterHandler(name,
+                    specialize_call([instance, member_ptr](const void* rawReq, void* rawRes) {
+                        Res result;
+                        VectorSink<typename Res::value_type, typename Res::allocator_type> sink(&result);
+                        Status status = (instance->*member_ptr)(*static_cast<const Req*>(rawReq), &sink);
+                        if (status.ok()) {
+                            *static_cast<Res*>(rawRes) = std::move(result);
+                        }
+                        return status;
+                    }),
+                    std::move(stream));
+            } else {
+                registry.RegisterHandler(name, specialize_call([instance, member_ptr](const void* rawReq, void* rawRes) {
+                    Status status;
+                    Res result = (instance->*member_ptr)(*static_cast<const Req*>(rawReq), &status);
+                    if (status.ok()) {
+                        *static_cast<Res*>(rawRes) = std::move(result);
+                    }
+                    return status;
+                }));
+            }
         });
     };
 
@@ -41,4 +284,54 @@ void RegisterBackend(Impl* instance, const typename API::template ImplPtrs<Impl>
     schema._visit_traits_with_impl(binder, *instance, const_cast<typename API::template ImplPtrs<Impl>&>(ptrs));
 }
 
+/**
+ * Registers a batch implementation of a backend method, next to the per-call one registered by
+ * `RegisterBackend`. The calls made with `TryCallAsync` (and from JS, where the method then
+ * returns a promise) are buffered as set by `options`, and dispatched to it as one span of
+ * requests. It returns their responses in the same order, or fails them all. The `TryCall`s still
+ * go to the per-call method. See `ApiRegistry::GetBatchStats` for the sizes of the batches.
+ *
+ * Returns NOT_FOUND if `API` has no method `name` with these request and response types, and
+ * FAILED_PRECONDITION if the backend has no per-call method for it.
+ *
+ * @example
+ * Expected<std::vector<std::string>> addNodeBatchImpl(std::span<const AddNodeRequest> requests);
+ *
+ * RegisterBatchMethod<GraphApi>("addNode", impl, &GraphApiImpl::addNodeBatchImpl);
+ */
+template <typename API, typename Impl, typename Req, typename Res>
+Status RegisterBatchMethod(std::string_view name, Impl* instance,
+                           Expected<std::vector<Res>> (Impl::*method)(std::span<const Req>),
+                           BatchOptions options = {}) {
+    bool found = false;
+    bool cacheable = false;
+    auto matcher = [&]<typename Traits>(Traits) {
+        if constexpr (std::is_same_v<Req, typename Traits::RequestType> &&
+                      std::is_same_v<Res, typename Traits::ResponseType>) {
+            if (name == Traits::name) {
+                found = true;
+                cacheable = kHasPolicy<Traits, Cacheable>;
+            }
+        }
+    };
+    API schema;
+    schema._visit_traits(matcher);
+    if (!found) {
+        return NotFoundError("No method with these types: " + std::string(name));
+    }
+
+    auto batcher = std::make_shared<internal::Batcher<Req, Res>>(
+        [instance, method](std::span<const Req> requests) { return (instance->*method)(requests); }, options);
+    typename ApiRegistry<API>::AsyncDispatcher dispatch = [batcher](const void* rawReq, void* rawRes) {
+        return batcher->Call(*static_cast<const Req*>(rawReq), static_cast<Res*>(rawRes));
+    };
+    if (!cacheable && internal::HasCacheableMethods<API>()) {
+        dispatch = [dispatch = std::move(dispatch)](const void* rawReq, void* rawRes) {
+            return internal::InvalidateResponsesAfter<API>(dispatch(rawReq, rawRes));
+        };
+    }
+    return ApiRegistry<API>::Get().RegisterBatchHandler(name, std::move(dispatch),
+        [batcher] { return batcher->stats(); });
+}
+
 }  // namespace cppschema
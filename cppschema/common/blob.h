@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace cppschema {
+
+/**
+ * A schema type for large binary payloads (images, serialized models), which crosses to JS without
+ * copying the bytes. Copies of a `Blob` share its bytes, like a handle, and the bytes are freed
+ * with the last copy.
+ *
+ * In JS a blob is a handle `{bytes, size, release()}`, where `bytes` is a `Uint8Array` view of the
+ * wasm memory. The handle keeps the bytes alive until `release()` is called, so JS must release
+ * each handle it receives. JS can also fill a blob of its own from `allocBlob(size)`, and pass its
+ * handle in a request, then the backend adopts the same bytes. See `JSConverter<Blob>`.
+ *
+ * The wire codec (see wire_codec.h) copies the bytes once, as a varint size and the raw bytes.
+ *
+ * @example
+ * struct Thumbnail {
+ *     int32_t width;
+ *     int32_t height;
+ *     Blob pixels;
+ *     DEFINE_STRUCT_VISITOR_FUNCTION(width, height, pixels);
+ * };
+ * Blob pixels = Blob::Allocate(width * height * 4);
+ * Render(pixels.mutable_data());
+ */
+class Blob {
+public:
+    Blob() = default;
+
+    // Uninitialized bytes, to be written through `mutable_data`.
+    static Blob Allocate(size_t size) {
+        Blob blob;
+        if (size > 0) {
+            blob.bytes_ = std::make_shared_for_overwrite<uint8_t[]>(size);
+            blob.size_ = size;
+        }
+        return blob;
+    }
+
+    static Blob CopyOf(const void* data, size_t size) {
+        Blob blob = Allocate(size);
+        if (size > 0) {
+            std::memcpy(blob.bytes_.get(), data, size);
+        }
+        return blob;
+    }
+    static Blob CopyOf(std::string_view bytes) { return CopyOf(bytes.data(), bytes.size()); }
+
+    const uint8_t* data() const { return bytes_.get(); }
+    // Writes are seen by all the copies of the blob.
+    uint8_t* mutable_data() { return bytes_.get(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(bytes_.get()), size_);
+    }
+
+    // True if both share the same bytes.
+    bool SharesBytesWith(const Blob& other) const { return bytes_ == other.bytes_; }
+
+    // Compares the contents.
+    friend bool operator==(const Blob& a, const Blob& b) {
+        return a.SharesBytesWith(b) ? a.size_ == b.size_ : a.view() == b.view();
+    }
+
+private:
+    std::shared_ptr<uint8_t[]> bytes_;
+    size_t size_ = 0;
+};
+
+}  // namespace cppschema
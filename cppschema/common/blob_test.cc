@@ -0,0 +1,67 @@
+#include "cppschema/common/blob.h"
+
+#include <string>
+
+#include "cppschema/common/visitor_macros.h"
+#include "cppschema/common/wire_codec.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::Blob;
+
+struct Image {
+    int32_t width = 0;
+    Blob pixels;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(width, pixels);
+};
+
+TEST(BlobTest, CopiesShareTheBytes) {
+    Blob blob = Blob::Allocate(1 << 20);
+    blob.mutable_data()[0] = 7;
+    const Blob copy = blob;
+    EXPECT_TRUE(copy.SharesBytesWith(blob));
+    EXPECT_EQ(copy.data(), blob.data());
+    blob.mutable_data()[1] = 8;
+    EXPECT_EQ(copy.data()[1], 8);
+
+    // Alive until the last copy goes.
+    const uint8_t* data = copy.data();
+    blob = Blob();
+    EXPECT_EQ(copy.data(), data);
+    EXPECT_EQ(copy.data()[0], 7);
+}
+
+TEST(BlobTest, Empty) {
+    EXPECT_TRUE(Blob().empty());
+    EXPECT_TRUE(Blob::Allocate(0).empty());
+    EXPECT_EQ(Blob(), Blob::CopyOf(""));
+    EXPECT_EQ(Blob().view(), "");
+}
+
+TEST(BlobTest, ComparesContents) {
+    EXPECT_EQ(Blob::CopyOf("abc"), Blob::CopyOf("abc"));
+    EXPECT_NE(Blob::CopyOf("abc"), Blob::CopyOf("abd"));
+    EXPECT_NE(Blob::CopyOf("abc"), Blob::CopyOf("ab"));
+    EXPECT_FALSE(Blob::CopyOf("abc").SharesBytesWith(Blob::CopyOf("abc")));
+}
+
+TEST(BlobTest, WireRoundTrip) {
+    std::string bytes(100000, '\0');
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<char>(i % 251);
+    }
+    const Image image{.width = 10, .pixels = Blob::CopyOf(bytes)};
+    const std::string encoded = cppschema::WireEncode(image);
+    EXPECT_LT(encoded.size(), bytes.size() + 8);
+
+    Image decoded;
+    ASSERT_TRUE(cppschema::WireDecode(encoded, &decoded));
+    EXPECT_EQ(decoded.width, 10);
+    EXPECT_EQ(decoded.pixels, image.pixels);
+
+    EXPECT_FALSE(cppschema::WireDecode(encoded.substr(0, encoded.size() - 1), &decoded));
+}
+
+}  // namespace
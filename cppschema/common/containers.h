@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "cppschema/common/schema_traits.h"
+
+// Bulk construction of the array, set and map types of the schema (see schema_traits.h), shared by
+// the converters which know the element count before the elements: the JS converter and the wire
+// codec. The containers are reserved to the count when they can be, and the elements are
+// constructed in place.
+
+namespace cppschema::internal {
+
+// Reserves room for `n` elements, in the containers which support it (vectors, hash maps and sets,
+// flat maps and sets).
+template <typename C>
+void ReserveFor(C& c, size_t n) {
+    if constexpr (requires { c.reserve(n); }) {
+        c.reserve(n);
+    }
+}
+
+/**
+ * Builds an array from its element count, then its elements in order. The fixed size arrays take
+ * exactly their size.
+ *
+ * @example
+ * ArrayBuilder<std::deque<int32_t>> builder(&container);
+ * if (!builder.Start(len)) { ... }
+ * for (size_t i = 0; i < len; ++i) {
+ *     builder.Next() = ...;
+ * }
+ */
+template <typename ArrayType>
+class ArrayBuilder {
+public:
+    explicit ArrayBuilder(ArrayType* container) : container_(container) {}
+
+    // Clears the container for `n` elements. Returns false if a fixed size array has another size.
+    bool Start(size_t n) {
+        if constexpr (is_fixed_size_array<ArrayType>::value) {
+            return n == container_->size();
+        } else {
+            container_->clear();
+            ReserveFor(*container_, n);
+            return true;
+        }
+    }
+
+    // The next element, value initialized in place. Not for `std::vector<bool>`, see `Append`.
+    typename ArrayType::value_type& Next() {
+        if constexpr (is_fixed_size_array<ArrayType>::value) {
+            auto& element = (*container_)[index_++];
+            element = {};
+            return element;
+        } else {
+            return container_->emplace_back();
+        }
+    }
+
+    template <typename... Args>
+    void Append(Args&&... args) {
+        if constexpr (is_fixed_size_array<ArrayType>::value) {
+            (*container_)[index_++] = typename ArrayType::value_type(std::forward<Args>(args)...);
+        } else {
+            container_->emplace_back(std::forward<Args>(args)...);
+        }
+    }
+
+private:
+    ArrayType* container_;
+    size_t index_ = 0;
+};
+
+/**
+ * Builds a set or a map from its elements in order. The sorted containers (e.g. std::map,
+ * absl::btree_map, flat_map) are hinted with the position after the previous element, so each
+ * sorted run of the input, which is all of it when it comes from a sorted container, costs an
+ * amortized constant time per element rather than a search. The hash containers are reserved.
+ *
+ * A repeated map key keeps its last value, and a repeated set element its first, as with
+ * `m[key] = value` and `s.insert(item)`.
+ */
+template <typename C>
+class KeyedBuilder {
+public:
+    static constexpr bool kSorted = requires { typename C::key_compare; };
+
+    // Clears the container for `n` elements.
+    KeyedBuilder(C* container, size_t n) : container_(container) {
+        container_->clear();
+        ReserveFor(*container_, n);
+        hint_ = container_->end();
+    }
+
+    // SETS: Inserts an element, unless already there.
+    void Insert(typename C::value_type&& item) {
+        if constexpr (kSorted) {
+            hint_ = std::next(container_->insert(hint_, std::move(item)));
+        } else {
+            container_->insert(std::move(item));
+        }
+    }
+
+    // MAPS: The value of `key`, value initialized in place if the key is new.
+    template <typename M = C>
+    typename M::mapped_type& Emplace(typename M::key_type&& key) {
+        if constexpr (kSorted) {
+            auto it = container_->try_emplace(hint_, std::move(key));
+            hint_ = std::next(it);
+            return it->second;
+        } else {
+            return container_->try_emplace(std::move(key)).first->second;
+        }
+    }
+
+private:
+    C* container_;
+    typename C::iterator hint_;
+};
+
+}  // namespace cppschema::internal
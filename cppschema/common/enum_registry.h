@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <functional>
 #include <typeindex>
 #include <optional>
@@ -9,7 +11,6 @@
 #include <iostream>
 #include <utility>
 
-#include "absl/log/log.h"
 #include "cppschema/common/visitor_macros.h"
 
 /**
@@ -30,8 +31,36 @@
  * This will register the conversion functions for NodeTypeEnum, and you can then use
  * - EnumRegistry::instance().getToEnum<NodeTypeEnum>()
  * - EnumRegistry::instance().getToInfo<NodeTypeEnum>()
- * to get the conversion functions. See the unit tests for example usage.
+ * to get the conversion functions, which are null if the enum is not registered. See the unit tests
+ * for example usage.
+ *
+ * The names of the enumerators by ordinal are also kept (see `getNames`), so that the converters
+ * can send the enums as ordinals and export the name tables once instead.
  */
+// The enumerators of a registered enum.
+struct EnumNames {
+    // The enum type, as spelled in DEFINE_ENUM_CONVERSION_FUNCTION.
+    std::string type_name;
+    // (ordinal, name) pairs in declaration order.
+    std::vector<std::pair<int, std::string>> values;
+
+    bool contains(int ordinal) const {
+        if (contiguous_) {
+            return ordinal >= min_ && ordinal <= max_;
+        }
+        return std::binary_search(sorted_ordinals_.begin(), sorted_ordinals_.end(), ordinal);
+    }
+
+private:
+    friend class EnumRegistry;
+
+    // Most enums are declared without explicit values, then validating an ordinal is a range check.
+    bool contiguous_ = true;
+    int min_ = 0;
+    int max_ = -1;
+    std::vector<int> sorted_ordinals_;
+};
+
 class EnumRegistry {
 public:
     // Signature types for clarity
@@ -69,9 +98,8 @@ public:
     const ToEnumFunc<EnumType> getToEnum() const {
         auto it = toEnumRegistry_.find(std::type_index(typeid(EnumType)));
         if (it != toEnumRegistry_.end()) {
-            return std::any_cast<ToEnumFunc<EnumType>>(it->second);
+            return *std::any_cast<ToEnumFunc<EnumType>>(&it->second);
         }
-        LOG(FATAL) << "Not found";
         return nullptr;
     }
 
@@ -79,17 +107,44 @@ public:
     const ToInfoFunc<EnumType> getToInfo() const {
         auto it = toInfoRegistry_.find(std::type_index(typeid(EnumType)));
         if (it != toInfoRegistry_.end()) {
-            return std::any_cast<ToInfoFunc<EnumType>>(it->second);
+            return *std::any_cast<ToInfoFunc<EnumType>>(&it->second);
         }
-        LOG(FATAL) << "Not found";
         return nullptr;
     }
 
+    template <typename EnumType>
+    void registerNames(std::string type_name, std::vector<std::pair<int, std::string>> values) {
+        EnumNames names;
+        names.type_name = std::move(type_name);
+        names.values = std::move(values);
+        for (const auto& [ordinal, name] : names.values) {
+            names.sorted_ordinals_.push_back(ordinal);
+        }
+        std::sort(names.sorted_ordinals_.begin(), names.sorted_ordinals_.end());
+        if (!names.sorted_ordinals_.empty()) {
+            names.min_ = names.sorted_ordinals_.front();
+            names.max_ = names.sorted_ordinals_.back();
+            names.contiguous_ = static_cast<size_t>(names.max_ - names.min_) + 1 ==
+                names.sorted_ordinals_.size();
+        }
+        namesRegistry_.try_emplace(std::type_index(typeid(EnumType)), std::move(names));
+    }
+
+    // Returns null if the enum is not registered. The pointer stays valid.
+    template <typename EnumType>
+    const EnumNames* getNames() const {
+        auto it = namesRegistry_.find(std::type_index(typeid(EnumType)));
+        return it != namesRegistry_.end() ? &it->second : nullptr;
+    }
+
+    const std::unordered_map<std::type_index, EnumNames>& allNames() const { return namesRegistry_; }
+
 private:
     EnumRegistry() = default;
     std::unordered_map<std::type_index, std::any> toEnumRegistry_;
     std::unordered_map<std::type_index, std::any> toInfoRegistry_;
     std::unordered_map<std::type_index, std::string> locationMap_;
+    std::unordered_map<std::type_index, EnumNames> namesRegistry_;
 };
 
 // Macro Helpers
@@ -111,6 +166,9 @@ private:
 #define ENUM_NAME_TO_VALUE_SINGLE_DICT_ENTRY(field) \
     {#field, ThisEnum::field},
 
+#define ENUM_ORDINAL_AND_NAME_SINGLE_ENTRY(field) \
+    {static_cast<int>(ThisEnum::field), #field},
+
 /**
  * Macro: DEFINE_ENUM_CONVERSION_FUNCTION
  *
@@ -150,9 +208,28 @@ private:
                 FOR_EACH(ENUM_VALUE_TO_INFO_SINGLE_SWITCH_CASE, __VA_ARGS__) \
             } \
         }; \
+        EnumRegistry::instance().registerNames<ThisEnum>(#EnumType, { \
+            FOR_EACH(ENUM_ORDINAL_AND_NAME_SINGLE_ENTRY, __VA_ARGS__) \
+        }); \
         return EnumRegistry::instance().registerEnum<ThisEnum>( \
             EnumRegistry::ToEnumFunc<ThisEnum>(std::move(toEnum)), \
             EnumRegistry::ToInfoFunc<ThisEnum>(std::move(toInfo)), \
             (__FILE__ ":" STR(__LINE__)) \
         ); \
     }();
+
+/**
+ * Macro: DEFINE_ENUM_ORDINAL_TRANSFER
+ *
+ * @brief Makes the JS converter send an enum as its ordinal (a JS number) instead of its name,
+ * which avoids creating a string per value, and lets `std::vector<EnumType>` cross in bulk like an
+ * `int32_t` array. JS gets the names from the exported name tables (see `ExportEnumNames`).
+ *
+ * Place it next to DEFINE_ENUM_CONVERSION_FUNCTION, in the namespace of the enum.
+ *
+ * @example
+ * DEFINE_ENUM_CONVERSION_FUNCTION(NodeTypeEnum, UNKNOWN, GRAPH_INPUT, GRAPH_OUTPUT, FUNCTION);
+ * DEFINE_ENUM_ORDINAL_TRANSFER(NodeTypeEnum);
+ */
+#define DEFINE_ENUM_ORDINAL_TRANSFER(EnumType) \
+    [[maybe_unused]] constexpr bool CppSchemaEnumAsOrdinal(const EnumType*) { return true; }
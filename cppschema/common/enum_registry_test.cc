@@ -68,4 +68,32 @@ TEST(EnumRegistryTest, SimilarEnums) {
     EXPECT_EQ(toEnum2("A"), std::nullopt);
 }
 
+enum class SparseEnum { NONE = -1, LOW = 10, HIGH = 20 };
+
+DEFINE_ENUM_CONVERSION_FUNCTION(SparseEnum, NONE, LOW, HIGH);
+
+TEST(EnumRegistryTest, NamesByOrdinal) {
+    const EnumNames* colors = EnumRegistry::instance().getNames<BasicColorEnum>();
+    ASSERT_NE(colors, nullptr);
+    EXPECT_EQ(colors->type_name, "BasicColorEnum");
+    EXPECT_THAT(colors->values, testing::ElementsAre(Pair(0, "RED"), Pair(1, "GREEN"), Pair(2, "BLUE")));
+    EXPECT_TRUE(colors->contains(2));
+    EXPECT_FALSE(colors->contains(3));
+    EXPECT_FALSE(colors->contains(-1));
+
+    const EnumNames* sparse = EnumRegistry::instance().getNames<SparseEnum>();
+    ASSERT_NE(sparse, nullptr);
+    EXPECT_TRUE(sparse->contains(-1));
+    EXPECT_TRUE(sparse->contains(20));
+    EXPECT_FALSE(sparse->contains(15));
+}
+
+enum class UnregisteredEnum { A };
+
+TEST(EnumRegistryTest, UnregisteredEnumHasNoConversion) {
+    EXPECT_EQ(EnumRegistry::instance().getToEnum<UnregisteredEnum>(), nullptr);
+    EXPECT_EQ(EnumRegistry::instance().getToInfo<UnregisteredEnum>(), nullptr);
+    EXPECT_EQ(EnumRegistry::instance().getNames<UnregisteredEnum>(), nullptr);
+}
+
 }  // namespace
\ No newline at end of file
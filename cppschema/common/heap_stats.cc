@@ -0,0 +1,69 @@
+#include "cppschema/common/heap_stats.h"
+
+#include <algorithm>
+
+#if defined(__EMSCRIPTEN__) || defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace cppschema {
+
+HeapSample SampleHeap() {
+#if defined(__GLIBC__)
+    const struct mallinfo2 info = mallinfo2();
+#elif defined(__EMSCRIPTEN__)
+    const struct mallinfo info = mallinfo();
+#endif
+#if defined(__EMSCRIPTEN__) || defined(__GLIBC__)
+    // The large allocations may be mapped apart from the heap.
+    return HeapSample{
+        .live_bytes = static_cast<size_t>(info.uordblks) + static_cast<size_t>(info.hblkhd),
+        .reserved_bytes = static_cast<size_t>(info.arena) + static_cast<size_t>(info.hblkhd),
+    };
+#else
+    return HeapSample();
+#endif
+}
+
+HeapAccounting& HeapAccounting::Get() {
+    static auto* instance = new HeapAccounting();
+    return *instance;
+}
+
+void HeapAccounting::Record(std::string_view api, const HeapSample& before, const HeapSample& after,
+        size_t peak_live_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stats_.find(api);
+    if (it == stats_.end()) {
+        it = stats_.emplace(std::string(api), ApiHeapStats()).first;
+    }
+    ApiHeapStats& stats = it->second;
+    ++stats.calls;
+    if (peak_live_bytes > before.live_bytes) {
+        stats.max_growth_bytes = std::max(stats.max_growth_bytes, peak_live_bytes - before.live_bytes);
+    }
+    stats.net_bytes += static_cast<int64_t>(after.live_bytes) - static_cast<int64_t>(before.live_bytes);
+    stats.peak_live_bytes = std::max(stats.peak_live_bytes, peak_live_bytes);
+    if (after.reserved_bytes > before.reserved_bytes) {
+        stats.reserved_growth_bytes += after.reserved_bytes - before.reserved_bytes;
+    }
+    peak_live_bytes_ = std::max({peak_live_bytes_, before.live_bytes, peak_live_bytes});
+}
+
+std::map<std::string, ApiHeapStats> HeapAccounting::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::map<std::string, ApiHeapStats>(stats_.begin(), stats_.end());
+}
+
+size_t HeapAccounting::peak_live_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_live_bytes_;
+}
+
+void HeapAccounting::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.clear();
+    peak_live_bytes_ = 0;
+}
+
+}  // namespace cppschema
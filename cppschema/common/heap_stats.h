@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace cppschema {
+
+// The malloc heap, as `mallinfo` reports it. All zero where it is not available (e.g. macOS).
+struct HeapSample {
+    // The bytes of the live allocations.
+    size_t live_bytes = 0;
+    // The bytes obtained from the system. A wasm heap never shrinks, so this is its high-water mark.
+    size_t reserved_bytes = 0;
+};
+
+// Walks the heap, so its cost grows with the number of live allocations.
+HeapSample SampleHeap();
+
+// The changes of the heap over the calls of one API method.
+struct ApiHeapStats {
+    uint64_t calls = 0;
+    // The largest increase of the live bytes during one call, as of the samples of the call.
+    size_t max_growth_bytes = 0;
+    // The sum of the changes of the live bytes, i.e. what the calls left allocated.
+    int64_t net_bytes = 0;
+    // The largest live bytes sampled during the calls.
+    size_t peak_live_bytes = 0;
+    // The growth of the reserved bytes during the calls, i.e. the heap growth which they caused.
+    size_t reserved_growth_bytes = 0;
+};
+
+/**
+ * Attributes the changes of the heap to the API methods, for finding those which grow it. The JS
+ * dispatch samples the heap around each call (see `HeapCallScope`) once enabled, e.g. by
+ * `jsbridge::ExportHeapStats()`. Off by default, as each sample walks the heap.
+ *
+ * @example
+ * HeapAccounting::Get().SetEnabled(true);
+ * ...
+ * for (const auto& [api, stats] : HeapAccounting::Get().GetStats()) { ... }
+ */
+class HeapAccounting {
+public:
+    static HeapAccounting& Get();
+
+    void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Records a call, which started at `before` and ended at `after`, and peaked at `peak_live_bytes`
+    // in between.
+    void Record(std::string_view api, const HeapSample& before, const HeapSample& after,
+        size_t peak_live_bytes);
+
+    // The stats by API method.
+    std::map<std::string, ApiHeapStats> GetStats() const;
+
+    // The largest live bytes of the samples.
+    size_t peak_live_bytes() const;
+
+    void Reset();
+
+private:
+    HeapAccounting() = default;
+
+    std::atomic<bool> enabled_ = false;
+    mutable std::mutex mutex_;
+    std::map<std::string, ApiHeapStats, std::less<>> stats_;
+    size_t peak_live_bytes_ = 0;
+};
+
+/**
+ * Samples the heap around an API call, and records the change, if the accounting is enabled. The
+ * call's temporaries are usually freed by its end, so it can also be sampled in between, e.g. once
+ * the request and the response are both allocated.
+ */
+class HeapCallScope {
+public:
+    explicit HeapCallScope(const char* api) : api_(api), active_(HeapAccounting::Get().enabled()) {
+        if (active_) [[unlikely]] {
+            before_ = SampleHeap();
+            peak_live_bytes_ = before_.live_bytes;
+        }
+    }
+
+    ~HeapCallScope() {
+        if (active_) [[unlikely]] {
+            const HeapSample after = SampleHeap();
+            HeapAccounting::Get().Record(api_, before_, after, std::max(peak_live_bytes_, after.live_bytes));
+        }
+    }
+
+    void Sample() {
+        if (active_) [[unlikely]] {
+            peak_live_bytes_ = std::max(peak_live_bytes_, SampleHeap().live_bytes);
+        }
+    }
+
+    HeapCallScope(const HeapCallScope&) = delete;
+    HeapCallScope& operator=(const HeapCallScope&) = delete;
+
+private:
+    const char* api_;
+    bool active_;
+    HeapSample before_;
+    size_t peak_live_bytes_ = 0;
+};
+
+}  // namespace cppschema
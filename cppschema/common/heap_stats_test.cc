@@ -0,0 +1,82 @@
+#include "cppschema/common/heap_stats.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::HeapAccounting;
+using ::cppschema::HeapCallScope;
+using ::cppschema::HeapSample;
+using ::cppschema::SampleHeap;
+
+constexpr size_t kSize = 4 << 20;
+
+class HeapAccountingTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (SampleHeap().reserved_bytes == 0) {
+            GTEST_SKIP() << "No mallinfo";
+        }
+        accounting_.Reset();
+        accounting_.SetEnabled(true);
+    }
+
+    void TearDown() override {
+        accounting_.SetEnabled(false);
+        accounting_.Reset();
+    }
+
+    HeapAccounting& accounting_ = HeapAccounting::Get();
+};
+
+TEST_F(HeapAccountingTest, SamplesTheLiveBytes) {
+    const HeapSample before = SampleHeap();
+    auto block = std::make_unique<char[]>(kSize);
+    block[kSize - 1] = 1;
+    const HeapSample after = SampleHeap();
+    EXPECT_GE(after.live_bytes, before.live_bytes + kSize);
+    EXPECT_GE(after.reserved_bytes, after.live_bytes);
+}
+
+TEST_F(HeapAccountingTest, AttributesTheChangesToTheCalls) {
+    std::unique_ptr<char[]> kept;
+    {
+        HeapCallScope scope("load");
+        kept = std::make_unique<char[]>(kSize);
+    }
+    {
+        HeapCallScope scope("unload");
+        kept.reset();
+    }
+    {
+        HeapCallScope scope("load");
+        auto temporary = std::make_unique<char[]>(2 * kSize);
+        scope.Sample();
+    }
+    const auto stats = accounting_.GetStats();
+    ASSERT_EQ(stats.size(), 2);
+    const cppschema::ApiHeapStats& load = stats.at("load");
+    EXPECT_EQ(load.calls, 2);
+    // The temporary block, as of the sample.
+    EXPECT_GE(load.max_growth_bytes, 2 * kSize);
+    // Only the first call kept its block.
+    EXPECT_GE(load.net_bytes, static_cast<int64_t>(kSize));
+    EXPECT_LT(load.net_bytes, static_cast<int64_t>(2 * kSize));
+    EXPECT_GE(load.peak_live_bytes, 2 * kSize);
+    EXPECT_LE(stats.at("unload").net_bytes, -static_cast<int64_t>(kSize));
+    EXPECT_EQ(stats.at("unload").max_growth_bytes, 0);
+    EXPECT_GE(accounting_.peak_live_bytes(), load.peak_live_bytes);
+}
+
+TEST_F(HeapAccountingTest, NothingRecordedWhenDisabled) {
+    accounting_.SetEnabled(false);
+    {
+        HeapCallScope scope("load");
+    }
+    EXPECT_TRUE(accounting_.GetStats().empty());
+    EXPECT_EQ(accounting_.peak_live_bytes(), 0);
+}
+
+}  // namespace
@@ -0,0 +1,99 @@
+#include "cppschema/common/interned_string.h"
+
+#include <utility>
+
+namespace cppschema {
+
+InternPool& InternPool::Get() {
+    static InternPool* pool = new InternPool();
+    return *pool;
+}
+
+std::shared_ptr<const InternEntry> InternPool::Intern(std::string_view value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = index_.find(value); it != index_.end()) {
+        return Acquire(it->second);
+    }
+    if (free_slots_.empty() && slots_.size() >= capacity_ && !EvictUnused()) {
+        return std::make_shared<const InternEntry>(InternEntry{.value = std::string(value)});
+    }
+    uint32_t id;
+    if (free_slots_.empty()) {
+        id = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    } else {
+        id = free_slots_.back();
+        free_slots_.pop_back();
+    }
+    Slot& slot = slots_[id];
+    slot.entry = std::make_unique<InternEntry>(InternEntry{.value = std::string(value), .id = id});
+    index_.emplace(slot.entry->value, id);
+    return Acquire(id);
+}
+
+std::shared_ptr<const InternEntry> InternPool::Find(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= slots_.size() || slots_[id].entry == nullptr) {
+        return nullptr;
+    }
+    return Acquire(id);
+}
+
+void InternPool::SetEvictionListener(EvictionListener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = std::move(listener);
+}
+
+size_t InternPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+std::shared_ptr<const InternEntry> InternPool::Acquire(uint32_t id) {
+    Slot& slot = slots_[id];
+    if (std::shared_ptr<const InternEntry> entry = slot.refs.lock()) {
+        return entry;
+    }
+    // The pool owns the entry, the references only track its use.
+    std::shared_ptr<const InternEntry> entry(slot.entry.get(), [this, id](const InternEntry*) { Release(id); });
+    slot.refs = entry;
+    return entry;
+}
+
+void InternPool::Release(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The slot may have been evicted, or referenced again, meanwhile. The eviction checks that.
+    Slot& slot = slots_[id];
+    if (slot.entry != nullptr && !slot.queued) {
+        slot.queued = true;
+        unreferenced_.push_back(id);
+    }
+}
+
+bool InternPool::EvictUnused() {
+    while (!unreferenced_.empty()) {
+        const uint32_t id = unreferenced_.front();
+        unreferenced_.pop_front();
+        Slot& slot = slots_[id];
+        slot.queued = false;
+        if (slot.entry == nullptr || !slot.refs.expired()) {
+            continue;
+        }
+        if (listener_) {
+            listener_(id);
+        }
+        index_.erase(slot.entry->value);
+        slot.entry.reset();
+        free_slots_.push_back(id);
+        return true;
+    }
+    return false;
+}
+
+InternedString::InternedString() {
+    static const auto* const empty = new std::shared_ptr<const InternEntry>(
+        std::make_shared<const InternEntry>());
+    entry_ = *empty;
+}
+
+}  // namespace cppschema
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "cppschema/common/strong_types.h"
+
+namespace cppschema {
+
+// An immutable string owned by the `InternPool`.
+struct InternEntry {
+    static constexpr uint32_t kNotInterned = std::numeric_limits<uint32_t>::max();
+
+    std::string value;
+    // Slot in the pool, or kNotInterned if the pool was full.
+    uint32_t id = kNotInterned;
+};
+
+/**
+ * A bounded table of the interned strings, which maps each content to a small integer id.
+ *
+ * When full, the entries not referenced by any `InternedString` are evicted, the least recently
+ * released first, and their ids are reused. The entries are tracked as their last reference is
+ * released, so a miss never scans the table. If all are referenced, new strings are not interned
+ * (they still work, without the caching). Thread-safe. The pool must outlive its entries.
+ */
+class InternPool {
+public:
+    // Called with the id of each evicted entry, under the pool lock.
+    using EvictionListener = std::function<void(uint32_t id)>;
+
+    static constexpr size_t kDefaultCapacity = 1 << 16;
+
+    static InternPool& Get();
+
+    explicit InternPool(size_t capacity = kDefaultCapacity) : capacity_(capacity) {}
+
+    InternPool(const InternPool&) = delete;
+    InternPool& operator=(const InternPool&) = delete;
+
+    std::shared_ptr<const InternEntry> Intern(std::string_view value);
+
+    // Returns the entry in a slot, or nullptr if the slot is free.
+    std::shared_ptr<const InternEntry> Find(uint32_t id);
+
+    void SetEvictionListener(EvictionListener listener);
+
+    // Number of the interned strings.
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        // Null if the slot is free.
+        std::unique_ptr<InternEntry> entry;
+        // The references handed out, which share a deleter calling `Release`.
+        std::weak_ptr<const InternEntry> refs;
+        // Whether the id is in `unreferenced_`.
+        bool queued = false;
+    };
+
+    // A reference to the entry of a live slot. Requires the lock.
+    std::shared_ptr<const InternEntry> Acquire(uint32_t id);
+    // Called as the last reference to the entry of `id` is released.
+    void Release(uint32_t id);
+    // Frees the least recently released slot which is still unreferenced. False if there is none.
+    // Requires the lock.
+    bool EvictUnused();
+
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    // The released ids, oldest first. Those referenced again since are skipped on eviction.
+    std::deque<uint32_t> unreferenced_;
+    // Keys are views of the values of the entries in `slots_`.
+    std::unordered_map<std::string_view, uint32_t> index_;
+    EvictionListener listener_;
+};
+
+/**
+ * A string type for the values repeated across many calls, like the node ids. Equal strings share
+ * a single copy in the `InternPool`, and the converters use the pool id to avoid re-encoding and
+ * re-allocating them. In JS, each interned string crosses the boundary once, and is then reused by
+ * its handle (see `JSConverter<InternedString>`).
+ *
+ * It is opt-in, use it in place of `std::string` for the fields and the request / response types.
+ *
+ * @example
+ * struct EdgeConnection {
+ *     EdgeId id;
+ *     InternedString source;
+ *     InternedString target;
+ *     DEFINE_STRUCT_VISITOR_FUNCTION(id, source, target);
+ * };
+ */
+class InternedString {
+public:
+    InternedString();
+    InternedString(std::string_view value) : entry_(InternPool::Get().Intern(value)) {}
+    InternedString(const std::string& value) : InternedString(std::string_view(value)) {}
+    InternedString(const char* value) : InternedString(std::string_view(value)) {}
+    explicit InternedString(std::shared_ptr<const InternEntry> entry) : entry_(std::move(entry)) {}
+
+    const std::string& str() const { return entry_->value; }
+    operator std::string_view() const { return entry_->value; }
+    bool empty() const { return entry_->value.empty(); }
+    size_t size() const { return entry_->value.size(); }
+
+    // The pool id, or `InternEntry::kNotInterned`.
+    uint32_t id() const { return entry_->id; }
+
+    friend bool operator==(const InternedString& a, const InternedString& b) {
+        return a.entry_ == b.entry_ || a.str() == b.str();
+    }
+    // Compares with a plain string without interning it.
+    friend bool operator==(const InternedString& a, std::string_view b) { return a.str() == b; }
+    friend bool operator==(const InternedString& a, const char* b) { return a.str() == b; }
+    friend std::strong_ordering operator<=>(const InternedString& a, const InternedString& b) {
+        return a.str() <=> b.str();
+    }
+    friend std::ostream& operator<<(std::ostream& os, const InternedString& s) { return os << s.str(); }
+
+private:
+    std::shared_ptr<const InternEntry> entry_;
+};
+
+}  // namespace cppschema
+
+// A strong type over an interned string, e.g. `DEFINE_STRONG_INTERNED_STRING_TYPE(NodeId);`
+#define DEFINE_STRONG_INTERNED_STRING_TYPE(Name) DEFINE_STRONG_TYPE(Name, ::cppschema::InternedString)
+
+template <>
+struct std::hash<cppschema::InternedString> {
+    size_t operator()(const cppschema::InternedString& s) const {
+        return std::hash<std::string_view>()(s);
+    }
+};
@@ -0,0 +1,131 @@
+#include "cppschema/common/interned_string.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cppschema/common/wire_codec.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::InternEntry;
+using ::cppschema::InternedString;
+using ::cppschema::InternPool;
+
+DEFINE_STRONG_INTERNED_STRING_TYPE(NodeId);
+
+TEST(InternPoolTest, EqualStringsShareAnEntry) {
+    InternPool pool(4);
+    auto a = pool.Intern("FUNCTION_1000");
+    auto b = pool.Intern(std::string("FUNCTION_") + "1000");
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a->id, InternEntry::kNotInterned);
+    EXPECT_EQ(pool.Find(a->id), a);
+    EXPECT_NE(pool.Intern("FUNCTION_1001"), a);
+    EXPECT_EQ(pool.size(), 2);
+}
+
+TEST(InternPoolTest, EvictsUnreferencedEntriesWhenFull) {
+    InternPool pool(2);
+    std::vector<uint32_t> evicted;
+    pool.SetEvictionListener([&](uint32_t id) { evicted.push_back(id); });
+
+    auto kept = pool.Intern("kept");
+    const uint32_t dropped_id = pool.Intern("dropped")->id;
+    auto added = pool.Intern("added");
+    EXPECT_EQ(evicted, std::vector<uint32_t>{dropped_id});
+    EXPECT_EQ(added->id, dropped_id);  // The slot is reused.
+    EXPECT_EQ(pool.Find(kept->id), kept);
+    EXPECT_EQ(pool.size(), 2);
+
+    // Both the entries are referenced, so the new one is not interned.
+    auto overflow = pool.Intern("overflow");
+    EXPECT_EQ(overflow->id, InternEntry::kNotInterned);
+    EXPECT_EQ(overflow->value, "overflow");
+    EXPECT_EQ(pool.size(), 2);
+}
+
+// The seconds taken to intern `count` new strings.
+double TimeInterns(InternPool& pool, int count, const std::string& prefix) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        pool.Intern(prefix + std::to_string(i));
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(InternPoolTest, MissesOnAFullPoolDoNotScan) {
+    constexpr int kMisses = 20000;
+    InternPool empty;
+    const double empty_seconds = TimeInterns(empty, kMisses, "new_");
+
+    InternPool full;
+    std::vector<uint32_t> evicted;
+    full.SetEvictionListener([&](uint32_t id) { evicted.push_back(id); });
+    std::vector<std::shared_ptr<const InternEntry>> live;
+    for (size_t i = 0; i < full.capacity(); ++i) {
+        live.push_back(full.Intern("live_" + std::to_string(i)));
+    }
+    EXPECT_EQ(full.Intern("missed")->id, InternEntry::kNotInterned);
+    // A scan of the 64k slots on each miss would make them hundreds of times slower.
+    const double full_seconds = TimeInterns(full, kMisses, "new_");
+    EXPECT_LT(full_seconds, 20 * empty_seconds + 0.05);
+    EXPECT_TRUE(evicted.empty());
+
+    // A released entry is evicted by the next miss.
+    const uint32_t released_id = live[123]->id;
+    live[123].reset();
+    auto added = full.Intern("added");
+    EXPECT_EQ(added->id, released_id);
+    EXPECT_EQ(evicted, std::vector<uint32_t>{released_id});
+    EXPECT_EQ(full.size(), full.capacity());
+}
+
+TEST(InternPoolTest, ReferencedAgainAfterARelease) {
+    InternPool pool(1);
+    const uint32_t id = pool.Intern("a")->id;
+    // Released, then referenced again, by its id and by its content.
+    auto by_id = pool.Find(id);
+    ASSERT_NE(by_id, nullptr);
+    auto by_value = pool.Intern("a");
+    EXPECT_EQ(by_id, by_value);
+    EXPECT_EQ(pool.Intern("b")->id, InternEntry::kNotInterned);
+
+    by_id.reset();
+    by_value.reset();
+    EXPECT_EQ(pool.Intern("b")->id, id);
+    EXPECT_EQ(pool.Find(id)->value, "b");
+}
+
+TEST(InternedStringTest, BehavesLikeAString) {
+    InternedString empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, "");
+
+    InternedString a = "node";
+    InternedString b = std::string("node");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.id(), b.id());
+    EXPECT_EQ(a, "node");
+    EXPECT_LT(a, InternedString("other"));
+    EXPECT_EQ(std::unordered_set<InternedString>({a, b, "other"}).size(), 2);
+
+    std::map<NodeId, int> degrees = {{NodeId("a"), 1}, {NodeId("b"), 2}};
+    EXPECT_EQ(degrees[NodeId("b")], 2);
+}
+
+TEST(InternedStringTest, WireRoundTrip) {
+    const std::vector<NodeId> ids = {NodeId("x"), NodeId("中文"), NodeId("x"), NodeId("")};
+    std::vector<NodeId> decoded;
+    ASSERT_TRUE(cppschema::WireDecode(cppschema::WireEncode(ids), &decoded));
+    EXPECT_EQ(decoded, ids);
+    EXPECT_EQ(decoded[0].value.id(), ids[0].value.id());
+    // Encoded as a plain string.
+    EXPECT_EQ(cppschema::WireEncode(InternedString("abc")), cppschema::WireEncode(std::string("abc")));
+}
+
+}  // namespace
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "cppschema/common/status.h"
+
+namespace cppschema {
+
+/**
+ * Bounds on the size of the requests of an API method, checked as they are decoded, before their
+ * containers and strings are allocated (see `ApiRegistry::SetRequestLimits`). Zero is no limit.
+ *
+ * @example
+ * registry.SetRequestLimits("addNodes", {.max_elements = 100000, .max_bytes = 16 << 20});
+ */
+struct RequestLimits {
+    // The elements of all the arrays, sets and maps of a request.
+    size_t max_elements = 0;
+    // The bytes of all its strings and numeric arrays. A JS string counts its length, which is its
+    // UTF-8 size for ASCII.
+    size_t max_bytes = 0;
+};
+
+/**
+ * Counts the size of the request being decoded on this thread against its `RequestLimits`, while
+ * in scope. The converters charge each container and string before they allocate it, and give up
+ * on the request once a limit is exceeded.
+ *
+ * @example
+ * DecodeBudget budget(registry.GetRequestLimits(name));
+ * req = JSConverter<Req>::fromJS(jsArgs);  // Charges `DecodeBudget::current()`, if any.
+ */
+class DecodeBudget {
+public:
+    // No budget is installed for a null `limits`.
+    explicit DecodeBudget(const RequestLimits* limits) : previous_(current_) {
+        if (limits != nullptr) {
+            limits_ = *limits;
+            current_ = this;
+        }
+    }
+
+    ~DecodeBudget() { current_ = previous_; }
+
+    DecodeBudget(const DecodeBudget&) = delete;
+    DecodeBudget& operator=(const DecodeBudget&) = delete;
+
+    // The budget of the request being decoded on this thread, or null.
+    static DecodeBudget* current() { return current_; }
+
+    // Charges `elements` and `bytes` to the request. RESOURCE_EXHAUSTED once a limit is exceeded,
+    // and for the charges after that.
+    Status Charge(size_t elements, size_t bytes) {
+        elements_ += elements;
+        bytes_ += bytes;
+        if (limits_.max_elements != 0 && elements_ > limits_.max_elements) {
+            return ResourceExhaustedError("The request has over " + std::to_string(limits_.max_elements) +
+                " elements");
+        }
+        if (limits_.max_bytes != 0 && bytes_ > limits_.max_bytes) {
+            return ResourceExhaustedError("The request has over " + std::to_string(limits_.max_bytes) +
+                " bytes");
+        }
+        return OkStatus();
+    }
+
+private:
+    static inline thread_local DecodeBudget* current_ = nullptr;
+
+    RequestLimits limits_;
+    size_t elements_ = 0;
+    size_t bytes_ = 0;
+    DecodeBudget* previous_;
+};
+
+}  // namespace cppschema
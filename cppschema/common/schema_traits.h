@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cppschema/common/blob.h"
+#include "cppschema/common/interned_string.h"
+#include "cppschema/common/strong_types.h"
+#include "cppschema/common/types.h"
+
+// Type detection traits shared by the schema-driven converters (the JS converter in `wasm` and the
+// binary wire codec). Each schema type falls into exactly one category below, and every converter
+// provides one specialization per category.
+
+namespace cppschema::internal {
+
+// Used to make a `static_assert` in a template depend on the template parameter.
+template <typename T>
+inline constexpr bool always_false_v = false;
+
+// Numeric: The fixed width integers and floating point numbers (not bool). Their vectors have bulk
+// conversion paths, and 64-bit integers map to BigInt in JS.
+template <typename T>
+struct is_numeric_like : std::disjunction<
+    std::is_same<T, int8_t>,
+    std::is_same<T, uint8_t>,
+    std::is_same<T, int16_t>,
+    std::is_same<T, uint16_t>,
+    std::is_same<T, int32_t>,
+    std::is_same<T, uint32_t>,
+    std::is_same<T, int64_t>,
+    std::is_same<T, uint64_t>,
+    std::is_same<T, float>,
+    std::is_same<T, double>
+> {};
+
+// Primitive-like: Smaller types with direct emscripten support.
+template <typename T>
+struct is_primitive_like : std::disjunction<
+    std::is_same<T, bool>,
+    std::is_same<T, std::string>,
+    is_numeric_like<T>
+> {};
+
+
+// VOID: Type trait / Concept to identify VoidType (represents void in C++).
+template <typename T> struct is_void_like : std::false_type {};
+template <> struct is_void_like<VoidType> : std::true_type {};
+
+
+// The types allowed in sets and map keys are very restrictive, because in JS
+// using objects as map keys or as set elements yields a different semantics
+// (object reference) than in C++ (object content).
+// So we only allow primitive types as keys, which have the same semantics in
+// both C++ and Javascript.
+template<typename T>
+struct is_keyable_type : std::disjunction<
+    std::is_same<T, int32_t>,
+    std::is_same<T, uint32_t>,
+    std::is_same<T, std::string>,
+    std::is_same<T, InternedString>
+> {};
+
+
+// INTERNED STRINGS: A string in JS, cached by the pool id on both the sides of the boundary.
+template <typename T> struct is_interned_string_like : std::false_type {};
+template <> struct is_interned_string_like<InternedString> : std::true_type {};
+
+
+// BLOBS: Binary payloads, which cross to JS without a copy as a view of the wasm memory.
+template <typename T> struct is_blob_like : std::false_type {};
+template <> struct is_blob_like<Blob> : std::true_type {};
+
+
+// TODO: Use concept, like:
+// template <typename T> concept is_void_type = std::is_same_v<std::decay_t<T>, VoidType>;
+
+// PAIRS: std::pair.
+template <typename T>
+struct is_pair_like : std::false_type {};
+template <typename T1, typename T2>
+struct is_pair_like<std::pair<T1, T2>> : std::true_type {};
+
+
+// TUPLE: std::tuple.
+template <typename T>
+struct is_tuple_like : std::false_type {};
+template <typename... Ts>
+struct is_tuple_like<std::tuple<Ts...>> : std::true_type {};
+
+
+// MAP: Has key_type and mapped_type, e.g. std::map, std::unordered_map, absl::flat_hash_map,
+// absl::btree_map and flat_map.
+template <typename T, typename = void>
+struct is_map_like_impl : std::false_type {};
+
+template <typename T>
+struct is_map_like_impl<T, std::void_t<
+    typename T::key_type,
+    typename T::mapped_type,
+    typename T::value_type,
+    decltype(std::declval<T&>()[std::declval<typename T::key_type>()])
+>> : std::true_type {};
+
+template <typename T>
+using is_map_like = is_map_like_impl<T>;
+
+
+// ARRAY: std::vector, std::deque and std::array. In JS, an array.
+template <typename T, typename = void>
+struct is_array_like : std::false_type {};
+template <typename T, typename A> struct is_array_like<std::vector<T, A>> : std::true_type {};
+template <typename T, typename A> struct is_array_like<std::deque<T, A>> : std::true_type {};
+template <typename T, size_t N> struct is_array_like<std::array<T, N>> : std::true_type {};
+
+// The arrays of a fixed size, which are filled by index rather than appended to.
+template <typename T>
+struct is_fixed_size_array : std::false_type {};
+template <typename T, size_t N>
+struct is_fixed_size_array<std::array<T, N>> : std::true_type {};
+
+// The arrays of which the elements are contiguous in memory, which convert in bulk.
+template <typename T>
+struct is_contiguous_array : std::false_type {};
+template <typename T, typename A>
+struct is_contiguous_array<std::vector<T, A>> : std::bool_constant<!std::is_same_v<T, bool>> {};
+template <typename T, size_t N>
+struct is_contiguous_array<std::array<T, N>> : std::true_type {};
+
+
+// SET: Has key_type and value_type, but they are the same, e.g. std::set, std::unordered_set,
+// absl::flat_hash_set, absl::btree_set and flat_set.
+template <typename T, typename = void>
+struct is_set_like : std::false_type {};
+template <typename T>
+struct is_set_like<T, std::void_t<typename T::key_type, typename T::value_type>> 
+    : std::bool_constant<std::is_same_v<typename T::key_type, typename T::value_type> && !is_array_like<T>::value> {};
+
+
+// OPTIONAL: std::optional.
+template <typename T> struct is_optional_like : std::false_type {};
+template <typename U> struct is_optional_like<std::optional<U>> : std::true_type {};
+
+
+// Visible struct like, i.e. a struct whose members are visible. Supports only those C++ structs
+// which has defined the visitor MACRO.
+
+// Mock visitor used only for the concept check to ensure _visit_members exists and is callable.
+struct ProbeVisitor {
+    template<typename T> void visitfn(const char*, T&) {}
+};
+
+template<typename T, typename = void>
+struct is_visible_struct_like : std::false_type {};
+
+template<typename T>
+struct is_visible_struct_like<
+    T,
+    std::void_t<
+        decltype(
+            std::declval<T&>()._visit_members(
+                std::declval<ProbeVisitor&>()
+            )
+        )
+    >
+> : std::true_type {};
+
+// The type of a member, from a member pointer of `_visit_member_ptrs`.
+template <typename P>
+struct member_pointee;
+template <typename C, typename F>
+struct member_pointee<F C::*> {
+    using type = F;
+};
+
+template <auto Ptr>
+using member_pointee_t = typename member_pointee<decltype(Ptr)>::type;
+
+
+// ENUMS: should be scoped enum (i.e. not trivially convertible to int).
+template <typename T>
+struct is_enum_like : std::bool_constant<
+    std::is_enum_v<T> &&
+    !std::is_convertible_v<T, int>
+> {};
+
+
+// STRONG TYPES: Types that are wrappers around primitives, but are not implicitly convertible
+// to them.
+template<typename T>
+struct is_strong_type_like : std::false_type {};
+template <typename T, typename Tag>
+struct is_strong_type_like<StrongType<T, Tag>> : std::true_type {};
+
+template<typename T>
+struct is_keyable_strong_type : std::false_type {};
+template <typename T, typename Tag>
+struct is_keyable_strong_type<StrongType<T, Tag>> : is_keyable_type<T> {};
+
+
+// Unsupported type: One which satisfies none of the above.
+template<typename T>
+struct is_unsupported_like : std::conjunction<
+    std::negation<is_primitive_like<T>>,
+    std::negation<is_void_like<T>>,
+    std::negation<is_interned_string_like<T>>,
+    std::negation<is_blob_like<T>>,
+    std::negation<is_pair_like<T>>,
+    std::negation<is_tuple_like<T>>,
+    std::negation<is_array_like<T>>,
+    std::negation<is_map_like<T>>,
+    std::negation<is_set_like<T>>,
+    std::negation<is_optional_like<T>>,
+    std::negation<is_visible_struct_like<T>>,
+    std::negation<is_enum_like<T>>,
+    std::negation<is_strong_type_like<T>>
+> {};
+
+}  // namespace cppschema::internal
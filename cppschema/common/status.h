@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#include <expected>
+#else
+#include <cassert>
+#include <variant>
+#endif
+
+namespace cppschema {
+
+enum class StatusCode : uint8_t {
+    kOk = 0,
+    // The request could not be decoded, or has invalid values.
+    kInvalidArgument,
+    kNotFound,
+    // No backend method is registered for the API.
+    kUnimplemented,
+    // The backend is not registered, or is not in a state to serve the request.
+    kFailedPrecondition,
+    kInternal,
+    // The request is over a limit, e.g. of its size (see `RequestLimits`).
+    kResourceExhausted,
+};
+
+inline const char* StatusCodeName(StatusCode code) {
+    switch (code) {
+        case StatusCode::kOk: return "OK";
+        case StatusCode::kInvalidArgument: return "INVALID_ARGUMENT";
+        case StatusCode::kNotFound: return "NOT_FOUND";
+        case StatusCode::kUnimplemented: return "UNIMPLEMENTED";
+        case StatusCode::kFailedPrecondition: return "FAILED_PRECONDITION";
+        case StatusCode::kInternal: return "INTERNAL";
+        case StatusCode::kResourceExhausted: return "RESOURCE_EXHAUSTED";
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * The error type of the API calls, used instead of C++ exceptions so that the modules can be built
+ * with `-fno-exceptions`. An ok status has an empty message, and costs no allocation.
+ *
+ * @example
+ * Status status = NotFoundError("No node with id: " + id);
+ * if (!status.ok()) {
+ *     LOG(ERROR) << status.ToString();  // "NOT_FOUND: No node with id: ..."
+ * }
+ */
+class [[nodiscard]] Status {
+public:
+    Status() = default;
+    Status(StatusCode code, std::string message) : code_(code), message_(std::move(message)) {}
+
+    bool ok() const { return code_ == StatusCode::kOk; }
+    StatusCode code() const { return code_; }
+    const std::string& message() const { return message_; }
+
+    std::string ToString() const {
+        if (ok()) {
+            return "OK";
+        }
+        return std::string(StatusCodeName(code_)) + ": " + message_;
+    }
+
+    friend bool operator==(const Status& a, const Status& b) {
+        return a.code_ == b.code_ && a.message_ == b.message_;
+    }
+
+private:
+    StatusCode code_ = StatusCode::kOk;
+    std::string message_;
+};
+
+inline Status OkStatus() { return Status(); }
+inline Status InvalidArgumentError(std::string message) {
+    return Status(StatusCode::kInvalidArgument, std::move(message));
+}
+inline Status NotFoundError(std::string message) {
+    return Status(StatusCode::kNotFound, std::move(message));
+}
+inline Status UnimplementedError(std::string message) {
+    return Status(StatusCode::kUnimplemented, std::move(message));
+}
+inline Status FailedPreconditionError(std::string message) {
+    return Status(StatusCode::kFailedPrecondition, std::move(message));
+}
+inline Status InternalError(std::string message) {
+    return Status(StatusCode::kInternal, std::move(message));
+}
+inline Status ResourceExhaustedError(std::string message) {
+    return Status(StatusCode::kResourceExhausted, std::move(message));
+}
+
+/**
+ * Expected<T>: Either a value, or the `Status` explaining why there is none. This is
+ * `std::expected<T, Status>` when the standard library has it (C++23), and a minimal stand-in with
+ * the same spelling otherwise. Errors are always created with `Unexpected(status)`.
+ *
+ * @example
+ * Expected<std::string> addNodeImpl(const AddNodeRequest& req) {
+ *     if (req.ui_name.empty()) {
+ *         return Unexpected(InvalidArgumentError("Empty ui_name"));
+ *     }
+ *     return NewNodeId();
+ * }
+ */
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+
+template <typename T>
+using Expected = std::expected<T, Status>;
+
+inline std::unexpected<Status> Unexpected(Status status) {
+    return std::unexpected<Status>(std::move(status));
+}
+
+#else
+
+struct UnexpectedStatus {
+    Status status;
+};
+
+inline UnexpectedStatus Unexpected(Status status) {
+    return UnexpectedStatus{std::move(status)};
+}
+
+template <typename T>
+class Expected {
+public:
+    using value_type = T;
+    using error_type = Status;
+
+    Expected() : data_(std::in_place_index<0>) {}
+
+    template <typename U = T, typename = std::enable_if_t<
+        std::is_constructible_v<T, U&&> &&
+        !std::is_same_v<std::decay_t<U>, Expected> &&
+        !std::is_same_v<std::decay_t<U>, UnexpectedStatus>>>
+    Expected(U&& value) : data_(std::in_place_index<0>, std::forward<U>(value)) {}
+
+    Expected(UnexpectedStatus error) : data_(std::in_place_index<1>, std::move(error.status)) {}
+
+    bool has_value() const { return data_.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+
+    T& value() & { assert(has_value()); return *std::get_if<0>(&data_); }
+    const T& value() const& { assert(has_value()); return *std::get_if<0>(&data_); }
+    T&& value() && { assert(has_value()); return std::move(*std::get_if<0>(&data_)); }
+
+    T& operator*() & { return value(); }
+    const T& operator*() const& { return value(); }
+    T&& operator*() && { return std::move(*this).value(); }
+    T* operator->() { return &value(); }
+    const T* operator->() const { return &value(); }
+
+    const Status& error() const& { assert(!has_value()); return *std::get_if<1>(&data_); }
+    Status&& error() && { assert(!has_value()); return std::move(*std::get_if<1>(&data_)); }
+
+private:
+    std::variant<T, Status> data_;
+};
+
+#endif
+
+}  // namespace cppschema
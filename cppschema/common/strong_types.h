@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>  // IWYU pragma: keep
+#include <utility>
 
 template <typename T, typename Tag>
 struct StrongType {
@@ -10,7 +11,7 @@ struct StrongType {
     T value = T();
 
     // Explicit constructor prevents accidental implicit conversions
-    explicit constexpr StrongType(T val) : value(val) {}
+    explicit constexpr StrongType(T val) : value(std::move(val)) {}
     constexpr StrongType() : value{} {}
 
     // Comparison operators (C++20 spaceship operator)
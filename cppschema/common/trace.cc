@@ -0,0 +1,197 @@
+#include "cppschema/common/trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace cppschema::trace {
+namespace {
+
+/**
+ * A ring of the last `kTraceBufferSize` spans. Writers claim a slot with a single fetch_add, and
+ * publish it with its sequence number, which readers check before and after copying it (like a
+ * seqlock), so neither side ever waits.
+ */
+class SpanRing {
+public:
+    struct Span {
+        const char* name;
+        const char* category;
+        uint64_t start_ns;
+        uint64_t end_ns;
+        uint64_t payload_size;
+        uint32_t tid;
+    };
+
+    void Push(const Span& span) {
+        const uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots_[index % kTraceBufferSize];
+        // Odd while being written.
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(span.name, std::memory_order_relaxed);
+        slot.category.store(span.category, std::memory_order_relaxed);
+        slot.start_ns.store(span.start_ns, std::memory_order_relaxed);
+        slot.end_ns.store(span.end_ns, std::memory_order_relaxed);
+        slot.payload_size.store(span.payload_size, std::memory_order_relaxed);
+        slot.tid.store(span.tid, std::memory_order_relaxed);
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    // The published spans, oldest first.
+    std::vector<Span> Snapshot() const {
+        const uint64_t end = next_.load(std::memory_order_acquire);
+        const uint64_t begin = std::max(cleared_.load(std::memory_order_relaxed),
+                                        end > kTraceBufferSize ? end - kTraceBufferSize : 0);
+        std::vector<Span> spans;
+        spans.reserve(end - begin);
+        for (uint64_t index = begin; index < end; ++index) {
+            const Slot& slot = slots_[index % kTraceBufferSize];
+            if (slot.sequence.load(std::memory_order_acquire) != 2 * index + 2) {
+                continue;  // Not written yet, or overwritten.
+            }
+            Span span = {
+                .name = slot.name.load(std::memory_order_relaxed),
+                .category = slot.category.load(std::memory_order_relaxed),
+                .start_ns = slot.start_ns.load(std::memory_order_relaxed),
+                .end_ns = slot.end_ns.load(std::memory_order_relaxed),
+                .payload_size = slot.payload_size.load(std::memory_order_relaxed),
+                .tid = slot.tid.load(std::memory_order_relaxed),
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == 2 * index + 2) {
+                spans.push_back(span);
+            }
+        }
+        return spans;
+    }
+
+    void Clear() {
+        // The indices keep growing, the spans before them are only hidden.
+        cleared_.store(next_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<const char*> category{nullptr};
+        std::atomic<uint64_t> start_ns{0};
+        std::atomic<uint64_t> end_ns{0};
+        std::atomic<uint64_t> payload_size{0};
+        std::atomic<uint32_t> tid{0};
+    };
+
+    Slot slots_[kTraceBufferSize];
+    std::atomic<uint64_t> next_{0};
+    // The first index visible to the snapshots.
+    std::atomic<uint64_t> cleared_{0};
+};
+
+SpanRing& Ring() {
+    static SpanRing* ring = new SpanRing();
+    return *ring;
+}
+
+std::atomic<uint32_t> sample_every{1};
+
+uint32_t ThreadId() {
+    static std::atomic<uint32_t> next_tid{1};
+    thread_local const uint32_t tid = next_tid.fetch_add(1, std::memory_order_relaxed);
+    return tid;
+}
+
+void AppendJsonString(std::string& out, const char* value) {
+    out += '"';
+    for (const char* c = value; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+        }
+        out += *c;
+    }
+    out += '"';
+}
+
+// Microseconds, the unit of the trace events.
+void AppendMicros(std::string& out, uint64_t ns) {
+    char buffer[32];
+    const int size = std::snprintf(buffer, sizeof(buffer), "%.3f", ns / 1000.0);
+    out.append(buffer, size);
+}
+
+}  // namespace
+
+void SetSampling(uint32_t every_n) { sample_every.store(every_n, std::memory_order_relaxed); }
+
+std::string ExportChromeTrace() {
+    const std::vector<SpanRing::Span> spans = Ring().Snapshot();
+    std::string out = "{\"traceEvents\":[";
+    for (size_t i = 0; i < spans.size(); ++i) {
+        const SpanRing::Span& span = spans[i];
+        if (i > 0) {
+            out += ',';
+        }
+        out += "{\"name\":";
+        AppendJsonString(out, span.name);
+        out += ",\"cat\":";
+        AppendJsonString(out, span.category);
+        out += ",\"ph\":\"X\",\"ts\":";
+        AppendMicros(out, span.start_ns);
+        out += ",\"dur\":";
+        AppendMicros(out, span.end_ns - span.start_ns);
+        out += ",\"pid\":1,\"tid\":" + std::to_string(span.tid);
+        out += ",\"args\":{\"size\":" + std::to_string(span.payload_size) + "}}";
+    }
+    out += "]}";
+    return out;
+}
+
+void ClearTrace() { Ring().Clear(); }
+
+const char* PersistentName(std::string_view name) {
+    static std::mutex mutex;
+    static auto* names = new std::set<std::string, std::less<>>();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = names->find(name);
+    if (it == names->end()) {
+        it = names->emplace(name).first;
+    }
+    return it->c_str();
+}
+
+namespace internal {
+
+bool SampleCall() {
+    const uint32_t every_n = sample_every.load(std::memory_order_relaxed);
+    if (every_n <= 1) {
+        return every_n == 1;
+    }
+    thread_local uint32_t calls = 0;
+    return calls++ % every_n == 0;
+}
+
+uint64_t NowNanos() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch)
+        .count();
+}
+
+void RecordSpan(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns,
+                uint64_t payload_size) {
+    Ring().Push({
+        .name = name,
+        .category = category,
+        .start_ns = start_ns,
+        .end_ns = end_ns,
+        .payload_size = payload_size,
+        .tid = ThreadId(),
+    });
+}
+
+}  // namespace internal
+}  // namespace cppschema::trace
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Tracing of the API calls, as spans of their phases (decode, lookup, backend, encode). Define this
+ * to 1 to build it in, e.g. with `bazel build --config=tracing`. Otherwise the spans are empty
+ * objects, and compile to nothing.
+ */
+#ifndef CPPSCHEMA_TRACING
+#define CPPSCHEMA_TRACING 0
+#endif
+
+namespace cppschema::trace {
+
+inline constexpr bool kTracingEnabled = CPPSCHEMA_TRACING;
+
+// The spans kept for the export. The older ones are overwritten.
+inline constexpr size_t kTraceBufferSize = 1 << 16;
+
+// Phases of a call, used as the span categories.
+inline constexpr const char* kCall = "call";
+inline constexpr const char* kDecode = "decode";
+inline constexpr const char* kLookup = "lookup";
+inline constexpr const char* kBackend = "backend";
+inline constexpr const char* kEncode = "encode";
+
+/**
+ * Traces one call in every `every_n` on each thread, with all of its spans. 1 (the default) traces
+ * all the calls, and 0 none.
+ */
+void SetSampling(uint32_t every_n);
+
+/**
+ * Returns the buffered spans as Chrome trace-event JSON, to load in chrome://tracing or Perfetto.
+ * Each span is a complete ("X") event named after the API, with its phase as the category, and
+ * its payload size in the args. Thread-safe, concurrent spans may be missing from it.
+ *
+ * @example
+ * {"traceEvents":[{"name":"addNode","cat":"backend","ph":"X","ts":12.5,"dur":3.1,"pid":1,"tid":1,
+ *                  "args":{"size":24}}, ...]}
+ */
+std::string ExportChromeTrace();
+
+// Drops the buffered spans.
+void ClearTrace();
+
+// Returns a copy of `name` which lives as long as the process, for the span names not known at
+// compile time. For the registration paths, not per call.
+const char* PersistentName(std::string_view name);
+
+// The payload size recorded for a value: the element count of the arrays and strings, and the
+// size of the others.
+template <typename T>
+size_t PayloadSize(const T& value) {
+    if constexpr (requires { value.size(); }) {
+        return value.size();
+    } else {
+        return sizeof(T);
+    }
+}
+
+namespace internal {
+
+struct ThreadState {
+    // Nesting of the calls and spans.
+    int depth = 0;
+    // Whether the outermost call is sampled.
+    bool sampled = false;
+};
+
+inline thread_local ThreadState thread_state;
+
+// Whether to trace the next call on this thread, per the sampling.
+bool SampleCall();
+uint64_t NowNanos();
+void RecordSpan(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns,
+                uint64_t payload_size);
+
+}  // namespace internal
+
+// The span classes differ with the flag, and are kept apart to not violate the ODR if it is only
+// set for some targets. The recording ones are also available without it, for the APIs traced
+// on their own (see `Span`).
+#if CPPSCHEMA_TRACING
+inline namespace enabled {
+#else
+namespace enabled {
+#endif
+
+/**
+ * Marks a call, without recording a span of its own. The outermost call (or span) on a thread
+ * decides if it is sampled, and everything nested in it follows.
+ */
+class CallScope {
+public:
+    CallScope() {
+        internal::ThreadState& state = internal::thread_state;
+        if (state.depth++ == 0) {
+            state.sampled = internal::SampleCall();
+        }
+    }
+    ~CallScope() { --internal::thread_state.depth; }
+
+    CallScope(const CallScope&) = delete;
+    CallScope& operator=(const CallScope&) = delete;
+};
+
+/**
+ * Records the time until its destruction as a span of `name`, in the `category` phase.
+ *
+ * @example
+ * trace::ScopedSpan span(Traits::name, trace::kDecode);
+ * req = Decode(payload);
+ * span.set_payload_size(payload.size());
+ */
+class ScopedSpan {
+public:
+    ScopedSpan(const char* name, const char* category, size_t payload_size = 0)
+        : name_(name), category_(category), payload_size_(payload_size),
+          active_(internal::thread_state.sampled) {
+        if (active_) {
+            start_ns_ = internal::NowNanos();
+        }
+    }
+
+    ~ScopedSpan() {
+        if (active_) {
+            internal::RecordSpan(name_, category_, start_ns_, internal::NowNanos(), payload_size_);
+        }
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    void set_name(const char* name) { name_ = name; }
+    void set_payload_size(size_t size) { payload_size_ = size; }
+
+private:
+    CallScope scope_;
+    const char* name_;
+    const char* category_;
+    uint64_t payload_size_;
+    uint64_t start_ns_ = 0;
+    bool active_;
+};
+
+}  // namespace enabled
+
+#if !CPPSCHEMA_TRACING
+inline namespace disabled {
+
+class CallScope {};
+
+class ScopedSpan {
+public:
+    ScopedSpan(const char*, const char*, size_t = 0) {}
+    void set_name(const char*) {}
+    void set_payload_size(size_t) {}
+};
+
+static_assert(std::is_empty_v<CallScope> && std::is_empty_v<ScopedSpan>);
+
+}  // namespace disabled
+#endif
+
+// The spans of a call which is traced if `kTraced` even without the flag, e.g. the calls of the
+// APIs with the `Trace` policy.
+template <bool kTraced>
+using Span = std::conditional_t<kTraced, enabled::ScopedSpan, ScopedSpan>;
+
+}  // namespace cppschema::trace
@@ -0,0 +1,135 @@
+#include "cppschema/common/trace.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/visitor_macros.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+namespace trace = ::cppschema::trace;
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::ScopedRegister;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+static_assert(trace::kTracingEnabled, "Built with CPPSCHEMA_TRACING=1");
+
+struct TracedApi {
+    ApiStub<std::vector<int32_t>, int32_t> sum;
+
+    DEFINE_API_VISITOR_FUNCTION(sum);
+};
+
+class TracedApiImpl : public cppschema::ApiBackend<TracedApi> {
+public:
+    int32_t sumImpl(const std::vector<int32_t>& values) {
+        int32_t sum = 0;
+        for (int32_t value : values) {
+            sum += value;
+        }
+        return sum;
+    }
+};
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        trace::SetSampling(1);
+        trace::ClearTrace();
+    }
+    void TearDown() override { trace::SetSampling(1); }
+
+    static size_t CountEvents(const std::string& json) {
+        size_t count = 0;
+        for (size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos;
+             pos = json.find("\"ph\":\"X\"", pos + 1)) {
+            ++count;
+        }
+        return count;
+    }
+};
+
+TEST_F(TraceTest, ExportsNestedSpans) {
+    {
+        trace::ScopedSpan call("addNode", trace::kCall);
+        trace::ScopedSpan decode("addNode", trace::kDecode, 24);
+    }
+    const std::string json = trace::ExportChromeTrace();
+    EXPECT_THAT(json, HasSubstr("{\"traceEvents\":[{\"name\":\"addNode\",\"cat\":\"decode\",\"ph\":\"X\""));
+    EXPECT_THAT(json, HasSubstr("\"args\":{\"size\":24}}"));
+    EXPECT_THAT(json, HasSubstr("\"cat\":\"call\""));
+    EXPECT_EQ(CountEvents(json), 2);
+
+    trace::ClearTrace();
+    EXPECT_EQ(trace::ExportChromeTrace(), "{\"traceEvents\":[]}");
+}
+
+TEST_F(TraceTest, RegistryCallSpans) {
+    ScopedRegister<TracedApi, TracedApiImpl> reg(new TracedApiImpl(), {.sum = &TracedApiImpl::sumImpl});
+    auto& registry = ApiRegistry<TracedApi>::Get();
+    EXPECT_EQ((registry.Call<std::vector<int32_t>, int32_t>("sum", {1, 2, 3})), 6);
+    const std::string json = trace::ExportChromeTrace();
+    EXPECT_THAT(json, HasSubstr("{\"name\":\"sum\",\"cat\":\"lookup\""));
+    EXPECT_THAT(json, HasSubstr("{\"name\":\"sum\",\"cat\":\"backend\""));
+    // The request has 3 elements.
+    EXPECT_THAT(json, HasSubstr("\"args\":{\"size\":3}}"));
+}
+
+TEST_F(TraceTest, SamplesWholeCalls) {
+    trace::SetSampling(4);
+    for (int i = 0; i < 8; ++i) {
+        trace::ScopedSpan call("call", trace::kCall);
+        trace::ScopedSpan backend("call", trace::kBackend);
+    }
+    EXPECT_EQ(CountEvents(trace::ExportChromeTrace()), 4);
+
+    trace::ClearTrace();
+    trace::SetSampling(0);
+    { trace::ScopedSpan call("call", trace::kCall); }
+    EXPECT_EQ(CountEvents(trace::ExportChromeTrace()), 0);
+}
+
+TEST_F(TraceTest, KeepsTheLatestSpans) {
+    for (size_t i = 0; i < trace::kTraceBufferSize + 10; ++i) {
+        trace::ScopedSpan span(i < 10 ? "old" : "new", trace::kCall);
+    }
+    const std::string json = trace::ExportChromeTrace();
+    EXPECT_EQ(CountEvents(json), trace::kTraceBufferSize);
+    EXPECT_THAT(json, Not(HasSubstr("\"old\"")));
+}
+
+TEST_F(TraceTest, ConcurrentWriters) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 1000; ++i) {
+                trace::ScopedSpan span("span", trace::kCall);
+            }
+        });
+    }
+    // Exports meanwhile, which may miss the spans being written.
+    EXPECT_THAT(trace::ExportChromeTrace(), HasSubstr("traceEvents"));
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(CountEvents(trace::ExportChromeTrace()), 4000);
+}
+
+TEST(PersistentNameTest, ReturnsTheSameCopy) {
+    std::string name = "method";
+    const char* persistent = trace::PersistentName(name);
+    name = "other";
+    EXPECT_STREQ(persistent, "method");
+    EXPECT_EQ(trace::PersistentName("method"), persistent);
+}
+
+}  // namespace
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+/**
+ * The string kernels below process 16 bytes at a time with SIMD when the target has it: wasm SIMD
+ * (`-msimd128`, see `--config=simd`) or SSE2 natively. Otherwise, or with this defined to 0, they
+ * run the scalar code, which still skips ASCII 8 bytes at a time.
+ */
+#ifndef CPPSCHEMA_SIMD
+#if defined(__wasm_simd128__) || defined(__SSE2__)
+#define CPPSCHEMA_SIMD 1
+#else
+#define CPPSCHEMA_SIMD 0
+#endif
+#endif
+
+#if CPPSCHEMA_SIMD && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif CPPSCHEMA_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace cppschema {
+
+inline constexpr bool kSimd = CPPSCHEMA_SIMD;
+
+namespace internal {
+
+#if CPPSCHEMA_SIMD
+namespace simd {
+
+#if defined(__wasm_simd128__)
+using V128 = v128_t;
+
+inline V128 Load(const void* p) { return wasm_v128_load(p); }
+inline void Store(void* p, V128 v) { wasm_v128_store(p, v); }
+// The high bit of each byte.
+inline uint32_t HighBits(V128 v) { return static_cast<uint32_t>(wasm_i8x16_bitmask(v)); }
+// Whether a 16-bit lane of `a` or `b` is above 0x7F.
+inline bool AnyAbove7F(V128 a, V128 b) {
+    return wasm_v128_any_true(wasm_v128_and(wasm_v128_or(a, b), wasm_i16x8_splat(static_cast<int16_t>(0xFF80))));
+}
+// The 16-bit lanes of `a` then `b` as bytes, for lanes up to 0xFF.
+inline V128 Narrow(V128 a, V128 b) { return wasm_u8x16_narrow_i16x8(a, b); }
+// The low or high 8 bytes as 16-bit lanes.
+inline V128 WidenLow(V128 v) { return wasm_u16x8_extend_low_u8x16(v); }
+inline V128 WidenHigh(V128 v) { return wasm_u16x8_extend_high_u8x16(v); }
+#else
+using V128 = __m128i;
+
+inline V128 Load(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+inline void Store(void* p, V128 v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+inline uint32_t HighBits(V128 v) { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+inline bool AnyAbove7F(V128 a, V128 b) {
+    const __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF;
+}
+inline V128 Narrow(V128 a, V128 b) { return _mm_packus_epi16(a, b); }
+inline V128 WidenLow(V128 v) { return _mm_unpacklo_epi8(v, _mm_setzero_si128()); }
+inline V128 WidenHigh(V128 v) { return _mm_unpackhi_epi8(v, _mm_setzero_si128()); }
+#endif
+
+}  // namespace simd
+#endif
+
+// Decodes the multi-byte UTF-8 sequence at `p`, before `end`. Returns its size, or 0 if it is not
+// valid (overlong forms, surrogates, and code points above U+10FFFF are invalid).
+inline size_t DecodeUtf8Sequence(const uint8_t* p, const uint8_t* end, uint32_t* code_point) {
+    const uint8_t lead = *p;
+    size_t size;
+    uint32_t value;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        size = 2;
+        value = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        size = 3;
+        value = lead & 0x0F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        size = 4;
+        value = lead & 0x07;
+    } else {
+        return 0;  // ASCII, a continuation byte, or an overlong 2 byte lead.
+    }
+    if (static_cast<size_t>(end - p) < size) {
+        return 0;
+    }
+    for (size_t i = 1; i < size; ++i) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (p[i] & 0x3F);
+    }
+    if ((size == 3 && (value < 0x800 || (value >= 0xD800 && value <= 0xDFFF))) ||
+        (size == 4 && (value < 0x10000 || value > 0x10FFFF))) {
+        return 0;
+    }
+    *code_point = value;
+    return size;
+}
+
+}  // namespace internal
+
+/**
+ * Returns the number of leading ASCII bytes of a string. `kVector = false` forces the scalar code,
+ * as do the kernels below, for comparing them.
+ *
+ * @example
+ * AsciiPrefixLength("FUNCTION_1000");  // 13
+ * AsciiPrefixLength("ab\xC3\xA9");  // 2
+ */
+template <bool kVector = kSimd>
+size_t AsciiPrefixLength(std::string_view s) {
+    const auto* p = reinterpret_cast<const uint8_t*>(s.data());
+    const size_t size = s.size();
+    size_t i = 0;
+#if CPPSCHEMA_SIMD
+    if constexpr (kVector) {
+        for (; i + 16 <= size; i += 16) {
+            const uint32_t high = internal::simd::HighBits(internal::simd::Load(p + i));
+            if (high != 0) {
+                return i + std::countr_zero(high);
+            }
+        }
+    }
+#endif
+    for (; i + 8 <= size; i += 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, p + i, sizeof(chunk));
+        const uint64_t high = chunk & 0x8080808080808080ull;
+        if (high != 0) {
+            if constexpr (std::endian::native == std::endian::little) {
+                return i + std::countr_zero(high) / 8;
+            }
+            break;
+        }
+    }
+    while (i < size && p[i] < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+/**
+ * Returns the length of a UTF-8 string in UTF-16 code units, i.e. its JS `length`, or nullopt if
+ * it is not valid UTF-8 (overlong forms, surrogates, and code points above U+10FFFF are invalid).
+ *
+ * Used to slice a single decoded JS string into the elements of a packed string array. ASCII runs
+ * are skipped with `AsciiPrefixLength`.
+ *
+ * @example
+ * Utf16Length("abc");    // 3
+ * Utf16Length("\xF0\x9F\x98\x80");  // 2, a surrogate pair in JS.
+ * Utf16Length("\xC0\x80");  // nullopt, overlong.
+ */
+template <bool kVector = kSimd>
+std::optional<size_t> Utf16Length(std::string_view utf8) {
+    const auto* p = reinterpret_cast<const uint8_t*>(utf8.data());
+    const auto* const end = p + utf8.size();
+    size_t length = 0;
+    while (p < end) {
+        if (*p < 0x80) {
+            // The short runs, e.g. between CJK characters, are not worth a scan.
+            if (end - p < 8 || p[1] >= 0x80) {
+                ++p;
+                ++length;
+                continue;
+            }
+            const size_t ascii = AsciiPrefixLength<kVector>(
+                std::string_view(reinterpret_cast<const char*>(p), end - p));
+            p += ascii;
+            length += ascii;
+            continue;
+        }
+        uint32_t code_point;
+        const size_t size = internal::DecodeUtf8Sequence(p, end, &code_point);
+        if (size == 0) {
+            return std::nullopt;
+        }
+        p += size;
+        length += size == 4 ? 2 : 1;
+    }
+    return length;
+}
+
+template <bool kVector = kSimd>
+bool IsValidUtf8(std::string_view utf8) {
+    return Utf16Length<kVector>(utf8).has_value();
+}
+
+/**
+ * Encodes UTF-16 code units, e.g. those of a JS string, as UTF-8 into `out`, which must have room
+ * for 3 bytes per unit. Returns the bytes written. Unpaired surrogates become U+FFFD, as with
+ * `TextEncoder`.
+ *
+ * @example
+ * std::string utf8(3 * units.size(), '\0');
+ * utf8.resize(Utf16ToUtf8(units, utf8.data()));
+ */
+template <bool kVector = kSimd>
+size_t Utf16ToUtf8(std::u16string_view utf16, char* out) {
+    const char16_t* const p = utf16.data();
+    const size_t size = utf16.size();
+    auto* o = reinterpret_cast<uint8_t*>(out);
+    size_t i = 0;
+    while (i < size) {
+        size_t scalar_end = size;
+#if CPPSCHEMA_SIMD
+        if constexpr (kVector) {
+            if (i + 16 <= size) {
+                const internal::simd::V128 a = internal::simd::Load(p + i);
+                const internal::simd::V128 b = internal::simd::Load(p + i + 8);
+                if (!internal::simd::AnyAbove7F(a, b)) {
+                    internal::simd::Store(o, internal::simd::Narrow(a, b));
+                    o += 16;
+                    i += 16;
+                    continue;
+                }
+                // Not all ASCII, encoded a unit at a time.
+                scalar_end = i + 16;
+            }
+        }
+#endif
+        while (i < scalar_end) {
+            uint32_t unit = p[i++];
+            if (unit < 0x80) {
+                *o++ = static_cast<uint8_t>(unit);
+            } else if (unit < 0x800) {
+                *o++ = static_cast<uint8_t>(0xC0 | (unit >> 6));
+                *o++ = static_cast<uint8_t>(0x80 | (unit & 0x3F));
+            } else if (unit >= 0xD800 && unit <= 0xDBFF && i < size && p[i] >= 0xDC00 && p[i] <= 0xDFFF) {
+                const uint32_t code_point = 0x10000 + ((unit - 0xD800) << 10) + (p[i++] - 0xDC00);
+                *o++ = static_cast<uint8_t>(0xF0 | (code_point >> 18));
+                *o++ = static_cast<uint8_t>(0x80 | ((code_point >> 12) & 0x3F));
+                *o++ = static_cast<uint8_t>(0x80 | ((code_point >> 6) & 0x3F));
+                *o++ = static_cast<uint8_t>(0x80 | (code_point & 0x3F));
+            } else {
+                if (unit >= 0xD800 && unit <= 0xDFFF) {
+                    unit = 0xFFFD;
+                }
+                *o++ = static_cast<uint8_t>(0xE0 | (unit >> 12));
+                *o++ = static_cast<uint8_t>(0x80 | ((unit >> 6) & 0x3F));
+                *o++ = static_cast<uint8_t>(0x80 | (unit & 0x3F));
+            }
+        }
+    }
+    return o - reinterpret_cast<uint8_t*>(out);
+}
+
+/**
+ * Decodes UTF-8 into UTF-16 code units in `out`, which must have room for a unit per byte.
+ * Returns the units written, or nullopt if it is not valid UTF-8.
+ */
+template <bool kVector = kSimd>
+std::optional<size_t> Utf8ToUtf16(std::string_view utf8, char16_t* out) {
+    const auto* p = reinterpret_cast<const uint8_t*>(utf8.data());
+    const auto* const end = p + utf8.size();
+    char16_t* o = out;
+    while (p < end) {
+        const uint8_t* scalar_end = end;
+#if CPPSCHEMA_SIMD
+        if constexpr (kVector) {
+            if (end - p >= 16) {
+                const internal::simd::V128 v = internal::simd::Load(p);
+                if (internal::simd::HighBits(v) == 0) {
+                    internal::simd::Store(o, internal::simd::WidenLow(v));
+                    internal::simd::Store(o + 8, internal::simd::WidenHigh(v));
+                    p += 16;
+                    o += 16;
+                    continue;
+                }
+                scalar_end = p + 16;
+            }
+        }
+#endif
+        while (p < scalar_end) {
+            if (*p < 0x80) {
+                *o++ = *p++;
+                continue;
+            }
+            uint32_t code_point;
+            const size_t size = internal::DecodeUtf8Sequence(p, end, &code_point);
+            if (size == 0) {
+                return std::nullopt;
+            }
+            p += size;
+            if (code_point >= 0x10000) {
+                code_point -= 0x10000;
+                *o++ = static_cast<char16_t>(0xD800 + (code_point >> 10));
+                *o++ = static_cast<char16_t>(0xDC00 + (code_point & 0x3FF));
+            } else {
+                *o++ = static_cast<char16_t>(code_point);
+            }
+        }
+    }
+    return o - out;
+}
+
+/**
+ * Decodes UTF-8 into Latin-1 bytes in `out`, which must have room for a byte per byte, e.g. for
+ * a JS string of one byte characters. Returns the bytes written, or nullopt if it is not valid
+ * UTF-8 or has a code point above U+00FF.
+ */
+template <bool kVector = kSimd>
+std::optional<size_t> Utf8ToLatin1(std::string_view utf8, char* out) {
+    const auto* p = reinterpret_cast<const uint8_t*>(utf8.data());
+    const auto* const end = p + utf8.size();
+    auto* o = reinterpret_cast<uint8_t*>(out);
+    while (p < end) {
+        const uint8_t* scalar_end = end;
+#if CPPSCHEMA_SIMD
+        if constexpr (kVector) {
+            if (end - p >= 16) {
+                const internal::simd::V128 v = internal::simd::Load(p);
+                if (internal::simd::HighBits(v) == 0) {
+                    internal::simd::Store(o, v);
+                    p += 16;
+                    o += 16;
+                    continue;
+                }
+                scalar_end = p + 16;
+            }
+        }
+#endif
+        while (p < scalar_end) {
+            if (*p < 0x80) {
+                *o++ = *p++;
+                continue;
+            }
+            if (*p > 0xC3) {
+                return std::nullopt;  // Above U+00FF, or invalid.
+            }
+            uint32_t code_point;
+            const size_t size = internal::DecodeUtf8Sequence(p, end, &code_point);
+            if (size == 0) {
+                return std::nullopt;
+            }
+            p += size;
+            *o++ = static_cast<uint8_t>(code_point);
+        }
+    }
+    return o - reinterpret_cast<uint8_t*>(out);
+}
+
+}  // namespace cppschema
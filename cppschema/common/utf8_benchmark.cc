@@ -0,0 +1,121 @@
+// Measures the string kernels of utf8.h, with and without SIMD, on identifiers (ASCII), European
+// text (mixed) and Chinese text (CJK). The bytes processed are those of the UTF-8 text.
+//
+// $ bazel run -c opt //cppschema/common:utf8_benchmark
+// $ bazel run -c opt --copt=-DCPPSCHEMA_SIMD=0 //cppschema/common:utf8_benchmark
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "cppschema/common/utf8.h"
+
+namespace {
+
+using ::cppschema::Utf16Length;
+using ::cppschema::Utf16ToUtf8;
+using ::cppschema::Utf8ToLatin1;
+using ::cppschema::Utf8ToUtf16;
+
+enum Corpus { kAscii, kMixed, kCjk };
+
+// The strings of a request, of a few dozen bytes each.
+std::vector<std::string> MakeCorpus(Corpus corpus) {
+    std::vector<std::string> strings;
+    for (int i = 0; i < 1000; ++i) {
+        switch (corpus) {
+            case kAscii:
+                strings.push_back("graph/FUNCTION_" + std::to_string(i) + "/output_tensor_0");
+                break;
+            case kMixed:
+                strings.push_back("Caf\xC3\xA9 cr\xC3\xA8me br\xC3\xBBl\xC3\xA9" "e n\xC2\xB0" + std::to_string(i));
+                break;
+            case kCjk:
+                // 节点 (node) and 输出 (output).
+                strings.push_back("\xE8\x8A\x82\xE7\x82\xB9" + std::to_string(i) + "\xE8\xBE\x93\xE5\x87\xBA");
+                break;
+        }
+    }
+    return strings;
+}
+
+int64_t TotalBytes(const std::vector<std::string>& strings) {
+    int64_t bytes = 0;
+    for (const std::string& s : strings) {
+        bytes += s.size();
+    }
+    return bytes;
+}
+
+template <bool kVector>
+void BM_Utf16Length(benchmark::State& state) {
+    const std::vector<std::string> strings = MakeCorpus(static_cast<Corpus>(state.range(0)));
+    for (auto _ : state) {
+        for (const std::string& s : strings) {
+            benchmark::DoNotOptimize(Utf16Length<kVector>(s));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * TotalBytes(strings));
+}
+
+// The JS strings into C++, as the converters decode them.
+template <bool kVector>
+void BM_Utf16ToUtf8(benchmark::State& state) {
+    const std::vector<std::string> strings = MakeCorpus(static_cast<Corpus>(state.range(0)));
+    std::vector<std::u16string> units;
+    for (const std::string& s : strings) {
+        std::u16string u(s.size(), u'\0');
+        u.resize(*Utf8ToUtf16(s, u.data()));
+        units.push_back(std::move(u));
+    }
+    std::string out(3 * 256, '\0');
+    for (auto _ : state) {
+        for (const std::u16string& u : units) {
+            benchmark::DoNotOptimize(Utf16ToUtf8<kVector>(u, out.data()));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * TotalBytes(strings));
+}
+
+// The C++ strings into JS.
+template <bool kVector>
+void BM_Utf8ToUtf16(benchmark::State& state) {
+    const std::vector<std::string> strings = MakeCorpus(static_cast<Corpus>(state.range(0)));
+    std::u16string out(256, u'\0');
+    for (auto _ : state) {
+        for (const std::string& s : strings) {
+            benchmark::DoNotOptimize(Utf8ToUtf16<kVector>(s, out.data()));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * TotalBytes(strings));
+}
+
+template <bool kVector>
+void BM_Utf8ToLatin1(benchmark::State& state) {
+    const std::vector<std::string> strings = MakeCorpus(static_cast<Corpus>(state.range(0)));
+    std::string out(256, '\0');
+    for (auto _ : state) {
+        for (const std::string& s : strings) {
+            benchmark::DoNotOptimize(Utf8ToLatin1<kVector>(s, out.data()));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * TotalBytes(strings));
+}
+
+#define CORPORA ArgName("corpus")->Arg(kAscii)->Arg(kMixed)->Arg(kCjk)
+
+BENCHMARK(BM_Utf16Length<false>)->CORPORA;
+BENCHMARK(BM_Utf16Length<true>)->CORPORA;
+BENCHMARK(BM_Utf16ToUtf8<false>)->CORPORA;
+BENCHMARK(BM_Utf16ToUtf8<true>)->CORPORA;
+BENCHMARK(BM_Utf8ToUtf16<false>)->CORPORA;
+BENCHMARK(BM_Utf8ToUtf16<true>)->CORPORA;
+// Only the ASCII and mixed corpora fit in Latin-1.
+BENCHMARK(BM_Utf8ToLatin1<false>)->ArgName("corpus")->Arg(kAscii)->Arg(kMixed);
+BENCHMARK(BM_Utf8ToLatin1<true>)->ArgName("corpus")->Arg(kAscii)->Arg(kMixed);
+
+}  // namespace
+
+BENCHMARK_MAIN();
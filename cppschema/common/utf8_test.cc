@@ -0,0 +1,129 @@
+#include "cppschema/common/utf8.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::AsciiPrefixLength;
+using ::cppschema::Utf16Length;
+using ::cppschema::Utf16ToUtf8;
+using ::cppschema::Utf8ToLatin1;
+using ::cppschema::Utf8ToUtf16;
+
+// ASCII with a multi-byte character at each position, so that it falls in every lane of a
+// vector, and across the vector boundaries.
+std::vector<std::string> Corpus() {
+    std::vector<std::string> corpus = {"", "FUNCTION_1000", std::string(100, 'x'),
+        "\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87\xE4\xB8\xAD\xE6\x96\x87",  // 中文中文中文
+        std::string("a\0b", 3)};
+    for (const char* character : {"\xC3\xA9", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80"}) {  // é 中 😀
+        for (size_t i = 0; i < 40; ++i) {
+            corpus.push_back(std::string(i, 'a') + character + std::string(40 - i, 'b'));
+        }
+    }
+    return corpus;
+}
+
+template <bool kVector>
+std::u16string ToUtf16(const std::string& utf8) {
+    std::u16string units(utf8.size(), u'\0');
+    const std::optional<size_t> size = Utf8ToUtf16<kVector>(utf8, units.data());
+    EXPECT_TRUE(size.has_value()) << utf8;
+    units.resize(size.value_or(0));
+    return units;
+}
+
+template <bool kVector>
+std::string ToUtf8(std::u16string_view units) {
+    std::string utf8(3 * units.size(), '\0');
+    utf8.resize(Utf16ToUtf8<kVector>(units, utf8.data()));
+    return utf8;
+}
+
+template <bool kVector>
+std::optional<std::string> ToLatin1(const std::string& utf8) {
+    std::string latin1(utf8.size(), '\0');
+    const std::optional<size_t> size = Utf8ToLatin1<kVector>(utf8, latin1.data());
+    if (!size.has_value()) {
+        return std::nullopt;
+    }
+    latin1.resize(*size);
+    return latin1;
+}
+
+TEST(Utf16LengthTest, CountsCodeUnits) {
+    EXPECT_EQ(Utf16Length(""), 0);
+    EXPECT_EQ(Utf16Length("FUNCTION_1000"), 13);
+    EXPECT_EQ(Utf16Length(std::string(1000, 'x') + "\xC3\xA9"), 1001);  // é
+    EXPECT_EQ(Utf16Length("\xE4\xB8\xAD\xE6\x96\x87"), 2);  // 中文
+    EXPECT_EQ(Utf16Length("a\xF0\x9F\x98\x80z"), 4);  // 😀 is a surrogate pair.
+    EXPECT_EQ(Utf16Length(std::string("a\0b", 3)), 3);
+}
+
+TEST(Utf16LengthTest, RejectsInvalidUtf8) {
+    EXPECT_EQ(Utf16Length("\x80"), std::nullopt);  // Stray continuation byte.
+    EXPECT_EQ(Utf16Length("\xC0\x80"), std::nullopt);  // Overlong NUL.
+    EXPECT_EQ(Utf16Length("\xE0\x80\x80"), std::nullopt);  // Overlong.
+    EXPECT_EQ(Utf16Length("\xED\xA0\x80"), std::nullopt);  // Surrogate U+D800.
+    EXPECT_EQ(Utf16Length("\xF4\x90\x80\x80"), std::nullopt);  // Above U+10FFFF.
+    EXPECT_EQ(Utf16Length("abcdefgh\xE4\xB8"), std::nullopt);  // Truncated.
+    EXPECT_EQ(Utf16Length("\xE4" "abc"), std::nullopt);
+}
+
+TEST(AsciiPrefixLengthTest, StopsAtTheFirstNonAsciiByte) {
+    EXPECT_EQ(AsciiPrefixLength(""), 0);
+    EXPECT_EQ(AsciiPrefixLength("FUNCTION_1000"), 13);
+    for (size_t i = 0; i < 40; ++i) {
+        const std::string s = std::string(i, 'a') + "\xC3\xA9" + std::string(40, 'b');
+        EXPECT_EQ(AsciiPrefixLength(s), i);
+        EXPECT_EQ(AsciiPrefixLength<false>(s), i);
+    }
+}
+
+TEST(TranscodeTest, RoundTripsTheCorpus) {
+    for (const std::string& s : Corpus()) {
+        const std::u16string units = ToUtf16<true>(s);
+        EXPECT_EQ(units, ToUtf16<false>(s)) << s;
+        EXPECT_EQ(units.size(), Utf16Length(s)) << s;
+        EXPECT_EQ(ToUtf8<true>(units), s);
+        EXPECT_EQ(ToUtf8<false>(units), s);
+    }
+    EXPECT_EQ(ToUtf16<true>("a\xF0\x9F\x98\x80"), u"a\U0001F600");
+    EXPECT_EQ(ToUtf16<true>("\xC3\xA9\xE4\xB8\xAD"), u"\u00E9\u4E2D");
+}
+
+TEST(TranscodeTest, UnpairedSurrogatesAreReplaced) {
+    const std::string replacement = "\xEF\xBF\xBD";
+    EXPECT_EQ(ToUtf8<true>(u"a\xD800"), "a" + replacement);
+    const std::u16string high_then_ascii = std::u16string(u"\xD83D") + u"abcdefghijklmnopqrstuvwxyz";
+    EXPECT_EQ(ToUtf8<true>(high_then_ascii), replacement + "abcdefghijklmnopqrstuvwxyz");
+    EXPECT_EQ(ToUtf8<false>(high_then_ascii), replacement + "abcdefghijklmnopqrstuvwxyz");
+    EXPECT_EQ(ToUtf8<true>(std::u16string(1, u'\xDC00')), replacement);
+    // A pair split across a vector boundary.
+    const std::u16string split = std::u16string(15, u'a') + u"\U0001F600" + std::u16string(16, u'b');
+    EXPECT_EQ(ToUtf8<true>(split), std::string(15, 'a') + "\xF0\x9F\x98\x80" + std::string(16, 'b'));
+}
+
+TEST(TranscodeTest, InvalidUtf8IsRejected) {
+    char16_t units[64];
+    const std::vector<std::string> invalid = {"\x80", "\xC0\x80", "\xED\xA0\x80", std::string(20, 'a') + "\xE4\xB8"};
+    for (const std::string& s : invalid) {
+        EXPECT_EQ(Utf8ToUtf16<true>(s, units), std::nullopt) << s;
+        EXPECT_EQ(Utf8ToUtf16<false>(s, units), std::nullopt) << s;
+        EXPECT_EQ(ToLatin1<true>(s), std::nullopt) << s;
+    }
+}
+
+TEST(TranscodeTest, Latin1) {
+    EXPECT_EQ(ToLatin1<true>(std::string(20, 'a') + "caf\xC3\xA9\xC3\xBF"),
+        std::string(20, 'a') + "caf\xE9\xFF");
+    EXPECT_EQ(ToLatin1<false>("caf\xC3\xA9"), "caf\xE9");
+    EXPECT_EQ(ToLatin1<true>(std::string(20, 'a') + "\xE4\xB8\xAD"), std::nullopt);  // Above U+00FF.
+    EXPECT_EQ(ToLatin1<true>("\xC4\x80"), std::nullopt);  // U+0100.
+}
+
+}  // namespace
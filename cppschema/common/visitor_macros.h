@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 // Recursive Expansions. Supports upto 30 members.
 #define FE_1(WHAT, X) WHAT(X)
 #define FE_2(WHAT, X, ...) WHAT(X) FE_1(WHAT, __VA_ARGS__)
@@ -59,10 +61,15 @@
  * s._visit_members(lambda);
  * 
  * @note It has two overloads of _visit_members, one for const and one for non-const structs.
+ *
+ * It also defines `_visit_member_ptrs`, which visits the member pointers instead of the values, as
+ * compile time constants, for generating code per field (see cppschema/wasm/js_value_object.h):
+ *  `auto lambda = []<typename P, P ptr>(const char* name, std::integral_constant<P, ptr>) {..}`
  * 
  * @param ... List of member variables to be visited.
  */
 #define VISIT_STRUCT_FIELD(field) v(#field, this->field);
+#define VISIT_STRUCT_FIELD_PTR(field) v(#field, std::integral_constant<decltype(&_Self::field), &_Self::field>{});
 #define DEFINE_STRUCT_VISITOR_FUNCTION(...) \
     template <typename V> \
     void _visit_members(V& v) { \
@@ -71,6 +78,11 @@
     template <typename V> \
     void _visit_members(V& v) const { \
         FOR_EACH(VISIT_STRUCT_FIELD, __VA_ARGS__) \
+    } \
+    template <typename V> \
+    void _visit_member_ptrs(V& v) const { \
+        using _Self = std::remove_cvref_t<decltype(*this)>; \
+        FOR_EACH(VISIT_STRUCT_FIELD_PTR, __VA_ARGS__) \
     }
 
 /**
@@ -87,6 +99,8 @@
  *   using Req = typename Traits::RequestType;
  *   using Res = typename Traits::ResponseType;
  *   const char* name = Traits::name;
+ *   // The policies, see cppschema/apispec/api_policies.h.
+ *   constexpr bool cacheable = cppschema::kHasPolicy<Traits, cppschema::Cacheable>;
  *   // implement..
  * }
  * 
@@ -101,6 +115,10 @@
  * };
  * 
  * api._visit_traits(GraphApi{});
+ *
+ * It also defines a client stub `Client<Caller>` with one method per API, each forwarding to
+ * `caller.Invoke<Traits>(request)`. The return type is decided by the caller (i.e. the transport),
+ * see `cppschema/rpc/rpc_client.h` for an example.
  * 
  * @param ... List of member api descriptors to be visited.
  */
@@ -108,11 +126,18 @@
     struct field##_traits { \
         using RequestType = typename decltype(field)::RequestType; \
         using ResponseType = typename decltype(field)::ResponseType; \
+        using PolicyTypes = typename decltype(field)::PolicyTypes; \
         static constexpr const char* name = #field; \
     };
 
+// See `cppschema::ImplMethod` in cppschema/apispec/api_framework.h for the accepted signatures.
 #define API_VISITOR_DEFINE_IMPL_PTR(field) \
-    typename decltype(field)::ResponseType (T::*field)(const typename decltype(field)::RequestType&) = nullptr;
+    ::cppschema::ImplMethod<T, typename field##_traits::RequestType, typename field##_traits::ResponseType> field;
+
+#define API_VISITOR_DEFINE_CLIENT_METHOD(field) \
+    auto field(const typename field##_traits::RequestType& req) { \
+        return caller.template Invoke<field##_traits>(req); \
+    }
 
 #define API_VISITOR_DEFINE_VISIT_TRAITS(field) \
     v(field##_traits{});
@@ -136,4 +161,9 @@
     template <typename Impl, typename Visitor> \
     void _visit_traits_with_impl(Visitor& v, Impl& impl, ImplPtrs<Impl>& ptrs) { \
         FOR_EACH(API_VISITOR_DEFINE_VISIT_TRAITS_WITH_IMPL, __VA_ARGS__) \
-    }
+    } \
+    /* Part 5: Define a client stub with one method per API, forwarding to a transport */ \
+    template <typename Caller> struct Client { \
+        Caller& caller; \
+        FOR_EACH(API_VISITOR_DEFINE_CLIENT_METHOD, __VA_ARGS__) \
+    };
@@ -0,0 +1,503 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cppschema/common/blob.h"  // IWYU pragma: keep
+#include "cppschema/common/containers.h"
+#include "cppschema/common/interned_string.h"  // IWYU pragma: keep
+#include "cppschema/common/schema_traits.h"
+#include "cppschema/common/strong_types.h"  // IWYU pragma: keep
+#include "cppschema/common/types.h"
+#include "cppschema/common/visitor_macros.h"  // IWYU pragma: keep
+
+namespace cppschema {
+
+static_assert(std::endian::native == std::endian::little,
+    "The wire codec copies fixed width values as-is, and assumes a little endian host");
+
+/**
+ * @brief A compact, schema-driven binary encoding for the API types.
+ *
+ * This is the native counterpart of `jsbridge::JSConverter`: it supports exactly the same set of
+ * types, using the same type detection traits. The encoding carries no field names or type tags,
+ * both the sides must be compiled against the same API spec.
+ *
+ * - Booleans, integers and floats: fixed width, little endian.
+ * - Strings: varint length, followed by the raw bytes. Interned strings are encoded the same way,
+ *   and decoded into the `InternPool`. So are blobs, decoded with a single copy.
+ * - Arrays, sets and maps: varint element count, followed by the elements (key, value for maps).
+ *   A `std::array` only decodes from its own size. The sets and maps are built in bulk, see
+ *   containers.h.
+ * - Optionals: one byte presence flag, followed by the value if present.
+ * - Pairs, tuples and visible structs: the members in declaration (visit) order.
+ * - Enums: zigzag varint of the ordinal.
+ * - Strong types: same as the underlying type. `VoidType`: nothing.
+ *
+ * @example
+ * std::string bytes = WireEncode(request);
+ * GraphApi::AddNodeRequest decoded;
+ * bool ok = WireDecode(bytes, &decoded);
+ */
+class WireWriter {
+public:
+    explicit WireWriter(std::string* out) : out_(out) {}
+
+    void writeVarint(uint64_t value) {
+        char buf[10];
+        size_t n = 0;
+        while (value >= 0x80) {
+            buf[n++] = static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        buf[n++] = static_cast<char>(value);
+        out_->append(buf, n);
+    }
+
+    void writeBytes(const void* data, size_t size) {
+        out_->append(static_cast<const char*>(data), size);
+    }
+
+    template <typename T>
+    void writeFixed(T value) {
+        static_assert(std::is_arithmetic_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+private:
+    std::string* out_;
+};
+
+class WireReader {
+public:
+    explicit WireReader(std::string_view in) : data_(in) {}
+
+    bool readVarint(uint64_t* value) {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64 && pos_ < data_.size(); shift += 7) {
+            const uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                *value = result;
+                return true;
+            }
+        }
+        return fail();
+    }
+
+    // Returns a view into the input buffer, valid as long as the input is.
+    bool readBytes(size_t size, std::string_view* bytes) {
+        if (size > remaining()) {
+            return fail();
+        }
+        *bytes = data_.substr(pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    template <typename T>
+    bool readFixed(T* value) {
+        static_assert(std::is_arithmetic_v<T>);
+        if (sizeof(T) > remaining()) {
+            return fail();
+        }
+        std::memcpy(value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    // Reads an element count, rejecting counts which can not possibly fit in the remaining input
+    // (each element takes at least `min_element_size` bytes). This guards the `reserve` calls
+    // against corrupt or malicious input.
+    bool readCount(size_t min_element_size, size_t* count) {
+        uint64_t n = 0;
+        if (!readVarint(&n)) {
+            return false;
+        }
+        if (min_element_size > 0 && n > remaining() / min_element_size) {
+            return fail();
+        }
+        *count = static_cast<size_t>(n);
+        return true;
+    }
+
+    size_t remaining() const { return data_.size() - pos_; }
+    bool ok() const { return ok_; }
+    bool done() const { return ok_ && pos_ == data_.size(); }
+
+private:
+    bool fail() {
+        ok_ = false;
+        return false;
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+template <typename T, typename Enable = void>
+struct WireCodec {
+    static void encode(const T& value, WireWriter& w);
+    static bool decode(WireReader& r, T& value);
+};
+
+//-----------------------------------------------------------------------------
+// Specialization Implementations
+//-----------------------------------------------------------------------------
+
+// PRIMITIVES: string, boolean, int32_t etc.
+template <typename PrimitiveType>
+struct WireCodec<PrimitiveType, std::enable_if_t<internal::is_primitive_like<PrimitiveType>::value>> {
+    static void encode(const PrimitiveType& value, WireWriter& w) {
+        if constexpr (std::is_same_v<PrimitiveType, std::string>) {
+            w.writeVarint(value.size());
+            w.writeBytes(value.data(), value.size());
+        } else if constexpr (std::is_same_v<PrimitiveType, bool>) {
+            w.writeFixed<uint8_t>(value ? 1 : 0);
+        } else {
+            w.writeFixed<PrimitiveType>(value);
+        }
+    }
+
+    static bool decode(WireReader& r, PrimitiveType& value) {
+        if constexpr (std::is_same_v<PrimitiveType, std::string>) {
+            size_t size = 0;
+            std::string_view bytes;
+            if (!r.readCount(1, &size) || !r.readBytes(size, &bytes)) {
+                return false;
+            }
+            value.assign(bytes.data(), bytes.size());
+            return true;
+        } else if constexpr (std::is_same_v<PrimitiveType, bool>) {
+            uint8_t byte = 0;
+            if (!r.readFixed(&byte)) {
+                return false;
+            }
+            value = byte != 0;
+            return true;
+        } else {
+            return r.readFixed(&value);
+        }
+    }
+};
+
+// VOID: VoidType (represents void in C++).
+template <typename VoidLikeType>
+struct WireCodec<VoidLikeType, std::enable_if_t<internal::is_void_like<VoidLikeType>::value>> {
+    static void encode(const VoidLikeType&, WireWriter&) {}
+    static bool decode(WireReader&, VoidLikeType&) { return true; }
+};
+
+// INTERNED STRINGS: Same as std::string. Decoding a known string does not allocate.
+template <typename InternedType>
+struct WireCodec<InternedType, std::enable_if_t<internal::is_interned_string_like<InternedType>::value>> {
+    static void encode(const InternedType& value, WireWriter& w) {
+        w.writeVarint(value.size());
+        w.writeBytes(value.str().data(), value.size());
+    }
+
+    static bool decode(WireReader& r, InternedType& value) {
+        size_t size = 0;
+        std::string_view bytes;
+        if (!r.readCount(1, &size) || !r.readBytes(size, &bytes)) {
+            return false;
+        }
+        value = InternedType(bytes);
+        return true;
+    }
+};
+
+// BLOBS: Same as std::string.
+template <typename BlobType>
+struct WireCodec<BlobType, std::enable_if_t<internal::is_blob_like<BlobType>::value>> {
+    static void encode(const BlobType& value, WireWriter& w) {
+        w.writeVarint(value.size());
+        w.writeBytes(value.data(), value.size());
+    }
+
+    static bool decode(WireReader& r, BlobType& value) {
+        size_t size = 0;
+        std::string_view bytes;
+        if (!r.readCount(1, &size) || !r.readBytes(size, &bytes)) {
+            return false;
+        }
+        value = BlobType::CopyOf(bytes);
+        return true;
+    }
+};
+
+// PAIRS: std::pair
+template <typename PairType>
+struct WireCodec<PairType, std::enable_if_t<internal::is_pair_like<PairType>::value>> {
+    static void encode(const PairType& value, WireWriter& w) {
+        WireCodec<typename PairType::first_type>::encode(value.first, w);
+        WireCodec<typename PairType::second_type>::encode(value.second, w);
+    }
+
+    static bool decode(WireReader& r, PairType& value) {
+        return WireCodec<typename PairType::first_type>::decode(r, value.first) &&
+            WireCodec<typename PairType::second_type>::decode(r, value.second);
+    }
+};
+
+// TUPLES: std::tuple
+template <typename TupleType>
+struct WireCodec<TupleType, std::enable_if_t<internal::is_tuple_like<TupleType>::value>> {
+    static void encode(const TupleType& value, WireWriter& w) {
+        std::apply([&w]<typename... Ts>(const Ts&... elems) {
+            (WireCodec<Ts>::encode(elems, w), ...);
+        }, value);
+    }
+
+    static bool decode(WireReader& r, TupleType& value) {
+        return std::apply([&r]<typename... Ts>(Ts&... elems) {
+            return (WireCodec<Ts>::decode(r, elems) && ...);
+        }, value);
+    }
+};
+
+// MAPS: std::map, flat_map, etc.
+template <typename MapType>
+struct WireCodec<MapType, std::enable_if_t<internal::is_map_like<MapType>::value>> {
+    using K = typename MapType::key_type;
+    using V = typename MapType::mapped_type;
+
+    static void encode(const MapType& m, WireWriter& w) {
+        w.writeVarint(m.size());
+        for (const auto& [key, value] : m) {
+            WireCodec<K>::encode(key, w);
+            WireCodec<V>::encode(value, w);
+        }
+    }
+
+    static bool decode(WireReader& r, MapType& m) {
+        size_t len = 0;
+        if (!r.readCount(1, &len)) {
+            return false;
+        }
+        internal::KeyedBuilder<MapType> builder(&m, len);
+        for (size_t i = 0; i < len; ++i) {
+            K key{};
+            if (!WireCodec<K>::decode(r, key) || !WireCodec<V>::decode(r, builder.Emplace(std::move(key)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// ARRAYS: std::vector, std::deque, std::array
+template <typename ArrayType>
+struct WireCodec<ArrayType, std::enable_if_t<internal::is_array_like<ArrayType>::value>> {
+    using T = typename ArrayType::value_type;
+
+    // The contiguous numeric arrays are copied as-is.
+    static constexpr bool kBulk = internal::is_numeric_like<T>::value &&
+        internal::is_contiguous_array<ArrayType>::value;
+
+    static void encode(const ArrayType& container, WireWriter& w) {
+        w.writeVarint(container.size());
+        if constexpr (kBulk) {
+            // Same bytes as the per element encoding, in a single copy.
+            w.writeBytes(reinterpret_cast<const char*>(container.data()), container.size() * sizeof(T));
+        } else {
+            for (const auto& item : container) {
+                WireCodec<T>::encode(item, w);
+            }
+        }
+    }
+
+    static bool decode(WireReader& r, ArrayType& container) {
+        size_t len = 0;
+        internal::ArrayBuilder<ArrayType> builder(&container);
+        if constexpr (kBulk) {
+            std::string_view bytes;
+            if (!r.readCount(sizeof(T), &len) || !r.readBytes(len * sizeof(T), &bytes)) {
+                return false;
+            }
+            if constexpr (internal::is_fixed_size_array<ArrayType>::value) {
+                if (!builder.Start(len)) {
+                    return false;
+                }
+            } else {
+                container.resize(len);
+            }
+            if (len > 0) {
+                std::memcpy(container.data(), bytes.data(), bytes.size());
+            }
+            return true;
+        }
+        // `VoidType` elements take no space, so only those skip the size sanity check.
+        if (!r.readCount(internal::is_void_like<T>::value ? 0 : 1, &len) || !builder.Start(len)) {
+            return false;
+        }
+        for (size_t i = 0; i < len; ++i) {
+            if constexpr (std::is_same_v<T, bool>) {
+                // std::vector<bool> has no addressable elements.
+                bool item = false;
+                if (!WireCodec<T>::decode(r, item)) {
+                    return false;
+                }
+                builder.Append(item);
+            } else if (!WireCodec<T>::decode(r, builder.Next())) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// SETS: std::set, flat_set
+template <typename SetType>
+struct WireCodec<SetType, std::enable_if_t<internal::is_set_like<SetType>::value>> {
+    using T = typename SetType::value_type;
+
+    static void encode(const SetType& s, WireWriter& w) {
+        w.writeVarint(s.size());
+        for (const auto& item : s) {
+            WireCodec<T>::encode(item, w);
+        }
+    }
+
+    static bool decode(WireReader& r, SetType& s) {
+        size_t len = 0;
+        if (!r.readCount(1, &len)) {
+            return false;
+        }
+        internal::KeyedBuilder<SetType> builder(&s, len);
+        for (size_t i = 0; i < len; ++i) {
+            T item{};
+            if (!WireCodec<T>::decode(r, item)) {
+                return false;
+            }
+            builder.Insert(std::move(item));
+        }
+        return true;
+    }
+};
+
+// OPTIONAL: std::optional
+template <typename OptionalType>
+struct WireCodec<OptionalType, std::enable_if_t<internal::is_optional_like<OptionalType>::value>> {
+    using T = typename OptionalType::value_type;
+
+    static void encode(const OptionalType& opt, WireWriter& w) {
+        w.writeFixed<uint8_t>(opt.has_value() ? 1 : 0);
+        if (opt.has_value()) {
+            WireCodec<T>::encode(*opt, w);
+        }
+    }
+
+    static bool decode(WireReader& r, OptionalType& opt) {
+        uint8_t present = 0;
+        if (!r.readFixed(&present)) {
+            return false;
+        }
+        if (!present) {
+            opt.reset();
+            return true;
+        }
+        return WireCodec<T>::decode(r, opt.emplace());
+    }
+};
+
+// Visible (visitable) STRUCTS.
+template <typename StructType>
+struct WireCodec<StructType, std::enable_if_t<internal::is_visible_struct_like<StructType>::value>> {
+    static void encode(const StructType& s, WireWriter& w) {
+        auto lambda = [&w]<typename T>(const char*, const T& t) -> void {
+            WireCodec<T>::encode(t, w);
+        };
+        s._visit_members(lambda);
+    }
+
+    static bool decode(WireReader& r, StructType& s) {
+        bool ok = true;
+        auto lambda = [&r, &ok]<typename T>(const char*, T& t) -> void {
+            ok = ok && WireCodec<T>::decode(r, t);
+        };
+        s._visit_members(lambda);
+        return ok;
+    }
+};
+
+// ENUM: Transferred as the ordinal, the names are not needed on the wire.
+template <typename EnumType>
+struct WireCodec<EnumType, std::enable_if_t<internal::is_enum_like<EnumType>::value>> {
+    using U = std::underlying_type_t<EnumType>;
+
+    static void encode(const EnumType& value, WireWriter& w) {
+        const int64_t ordinal = static_cast<int64_t>(static_cast<U>(value));
+        w.writeVarint((static_cast<uint64_t>(ordinal) << 1) ^ static_cast<uint64_t>(ordinal >> 63));
+    }
+
+    static bool decode(WireReader& r, EnumType& value) {
+        uint64_t zigzag = 0;
+        if (!r.readVarint(&zigzag)) {
+            return false;
+        }
+        const int64_t ordinal = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        value = static_cast<EnumType>(static_cast<U>(ordinal));
+        return true;
+    }
+};
+
+// STRONG TYPES: Same as the underlying primitive type.
+template <typename StrongType>
+struct WireCodec<StrongType, std::enable_if_t<internal::is_strong_type_like<StrongType>::value>> {
+    static void encode(const StrongType& s, WireWriter& w) {
+        WireCodec<typename StrongType::value_type>::encode(s.value, w);
+    }
+
+    static bool decode(WireReader& r, StrongType& s) {
+        return WireCodec<typename StrongType::value_type>::decode(r, s.value);
+    }
+};
+
+// Invisible (non-visitable) STRUCTS. This is implemented just to give a better error feedback.
+template <typename FallbackType>
+struct WireCodec<FallbackType, std::enable_if_t<internal::is_unsupported_like<FallbackType>::value>> {
+    static void encode(const FallbackType&, WireWriter&) {
+        static_assert(internal::always_false_v<FallbackType>, "unsupported type");
+    }
+
+    static bool decode(WireReader&, FallbackType&) {
+        static_assert(internal::always_false_v<FallbackType>, "unsupported type");
+        return false;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Helpers
+//-----------------------------------------------------------------------------
+
+// Appends the encoding of `value` to `out`.
+template <typename T>
+void WireEncodeTo(const T& value, std::string* out) {
+    WireWriter w(out);
+    WireCodec<T>::encode(value, w);
+}
+
+template <typename T>
+std::string WireEncode(const T& value) {
+    std::string out;
+    WireEncodeTo(value, &out);
+    return out;
+}
+
+// Decodes `bytes` into `value`. Fails if the input is malformed, or has trailing bytes.
+template <typename T>
+bool WireDecode(std::string_view bytes, T* value) {
+    WireReader r(bytes);
+    return WireCodec<T>::decode(r, *value) && r.done();
+}
+
+}  // namespace cppschema
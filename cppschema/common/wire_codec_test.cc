@@ -0,0 +1,183 @@
+#include <array>
+#include <deque>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "cppschema/common/strong_types.h"
+#include "cppschema/common/types.h"
+#include "cppschema/common/visitor_macros.h"
+#include "cppschema/common/wire_codec.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::WireDecode;
+using ::cppschema::WireEncode;
+
+DEFINE_STRONG_UINT_TYPE(EdgeId);
+
+enum class ColorEnum { RED, GREEN, BLUE };
+
+struct Edge {
+    EdgeId id;
+    std::string source;
+    std::string target;
+    std::optional<float> weight;
+
+    bool operator==(const Edge&) const = default;
+    DEFINE_STRUCT_VISITOR_FUNCTION(id, source, target, weight);
+};
+
+struct Graph {
+    std::vector<Edge> edges;
+    std::map<std::string, ColorEnum> colors;
+    std::set<int32_t> roots;
+    std::pair<int64_t, bool> range;
+    std::tuple<std::string, uint32_t, uint64_t> meta;
+    VoidType nothing;
+
+    bool operator==(const Graph& o) const {
+        return edges == o.edges && colors == o.colors && roots == o.roots && range == o.range &&
+            meta == o.meta;
+    }
+    DEFINE_STRUCT_VISITOR_FUNCTION(edges, colors, roots, range, meta, nothing);
+};
+
+template <typename T>
+T RoundTrip(const T& value) {
+    T decoded{};
+    EXPECT_TRUE(WireDecode(WireEncode(value), &decoded));
+    return decoded;
+}
+
+TEST(WireCodecTest, Primitives) {
+    EXPECT_EQ(RoundTrip(true), true);
+    EXPECT_EQ(RoundTrip(int32_t{-42}), -42);
+    EXPECT_EQ(RoundTrip(uint32_t{4000000000u}), 4000000000u);
+    EXPECT_EQ(RoundTrip(int64_t{-9000000000000000000}), -9000000000000000000);
+    EXPECT_EQ(RoundTrip(uint64_t{18000000000000000000u}), 18000000000000000000u);
+    EXPECT_EQ(RoundTrip(1.5f), 1.5f);
+    EXPECT_EQ(RoundTrip(0.1 + 0.2), 0.1 + 0.2);
+    EXPECT_EQ(RoundTrip(std::numeric_limits<double>::denorm_min()), std::numeric_limits<double>::denorm_min());
+    EXPECT_EQ(RoundTrip(int8_t{-128}), -128);
+    EXPECT_EQ(RoundTrip(uint8_t{255}), 255);
+    EXPECT_EQ(RoundTrip(int16_t{-32768}), -32768);
+    EXPECT_EQ(RoundTrip(uint16_t{65535}), 65535);
+    EXPECT_EQ(RoundTrip(std::string("hello")), "hello");
+    EXPECT_EQ(RoundTrip(std::string("")), "");
+}
+
+TEST(WireCodecTest, EnumsAndStrongTypes) {
+    EXPECT_EQ(RoundTrip(ColorEnum::BLUE), ColorEnum::BLUE);
+    EXPECT_EQ(RoundTrip(EdgeId(7)), EdgeId(7));
+    EXPECT_EQ(WireEncode(ColorEnum::GREEN).size(), 1);
+}
+
+TEST(WireCodecTest, NestedStructs) {
+    Graph graph = {
+        .edges = {
+            {.id = EdgeId(1), .source = "a", .target = "b", .weight = 0.5f},
+            {.id = EdgeId(2), .source = "b", .target = "a", .weight = std::nullopt},
+        },
+        .colors = {{"a", ColorEnum::RED}, {"b", ColorEnum::BLUE}},
+        .roots = {3, 1, 2},
+        .range = {-5, true},
+        .meta = {"meta", 9, 10},
+    };
+    EXPECT_EQ(RoundTrip(graph), graph);
+}
+
+TEST(WireCodecTest, VectorOfBool) {
+    EXPECT_EQ(RoundTrip(std::vector<bool>{true, false, true}), std::vector<bool>({true, false, true}));
+}
+
+TEST(WireCodecTest, NumericVectors) {
+    const std::vector<double> weights = {0.1, -1e308, std::numeric_limits<double>::infinity()};
+    EXPECT_EQ(RoundTrip(weights), weights);
+    const std::vector<int64_t> timestamps = {std::numeric_limits<int64_t>::min(), 0, (int64_t{1} << 53) + 1};
+    EXPECT_EQ(RoundTrip(timestamps), timestamps);
+    EXPECT_EQ(RoundTrip(std::vector<uint8_t>{}), std::vector<uint8_t>{});
+    // The bulk path writes the same bytes as the per element encoding.
+    EXPECT_EQ(WireEncode(std::vector<int16_t>{1, -2}), std::string("\x02\x01\x00\xfe\xff", 5));
+}
+
+struct Containers {
+    absl::flat_hash_map<std::string, int32_t> counts;
+    absl::flat_hash_set<uint32_t> ids;
+    absl::btree_map<int32_t, std::vector<std::string>> buckets;
+    std::unordered_map<std::string, Edge> edges;
+    std::unordered_set<std::string> tags;
+    std::deque<Edge> queue;
+    std::array<double, 3> position{};
+    std::array<std::string, 2> names;
+
+    bool operator==(const Containers&) const = default;
+    DEFINE_STRUCT_VISITOR_FUNCTION(counts, ids, buckets, edges, tags, queue, position, names);
+};
+
+TEST(WireCodecTest, OtherContainers) {
+    const Containers containers{
+        .counts = {{"a", 1}, {"b", -2}},
+        .ids = {7, 3, 5},
+        .buckets = {{2, {"x"}}, {-1, {"y", "z"}}},
+        .edges = {{"e", {.id = EdgeId(4), .source = "s", .target = "t"}}},
+        .tags = {"red", "blue"},
+        .queue = {{.id = EdgeId(1)}, {.id = EdgeId(2), .weight = 0.5f}},
+        .position = {1.5, -2, 3},
+        .names = {"first", "second"},
+    };
+    EXPECT_EQ(RoundTrip(containers), containers);
+    // The same encoding as the vectors.
+    EXPECT_EQ(WireEncode(std::array<int16_t, 2>{1, -2}), WireEncode(std::vector<int16_t>{1, -2}));
+    EXPECT_EQ(WireEncode(std::deque<std::string>{"a"}), WireEncode(std::vector<std::string>{"a"}));
+}
+
+TEST(WireCodecTest, FixedSizeArraysRejectOtherSizes) {
+    std::array<int32_t, 3> numbers{};
+    EXPECT_FALSE(WireDecode(WireEncode(std::vector<int32_t>{1, 2}), &numbers));
+    std::array<std::string, 1> strings;
+    EXPECT_FALSE(WireDecode(WireEncode(std::vector<std::string>{"a", "b"}), &strings));
+    EXPECT_TRUE(WireDecode(WireEncode(std::vector<std::string>{"a"}), &strings));
+    EXPECT_EQ(strings[0], "a");
+}
+
+TEST(WireCodecTest, RepeatedMapKeysKeepTheLastValue) {
+    const std::vector<std::pair<std::string, int32_t>> entries = {{"a", 1}, {"b", 2}, {"a", 3}};
+    std::map<std::string, int32_t> decoded;
+    EXPECT_TRUE(WireDecode(WireEncode(entries), &decoded));
+    EXPECT_EQ(decoded, (std::map<std::string, int32_t>{{"a", 3}, {"b", 2}}));
+}
+
+TEST(WireCodecTest, RejectsTruncatedInput) {
+    const std::string bytes = WireEncode(std::vector<std::string>{"alpha", "beta"});
+    for (size_t len = 0; len < bytes.size(); ++len) {
+        std::vector<std::string> decoded;
+        EXPECT_FALSE(WireDecode(std::string_view(bytes).substr(0, len), &decoded)) << len;
+    }
+}
+
+TEST(WireCodecTest, RejectsTrailingBytes) {
+    std::string bytes = WireEncode(int32_t{1});
+    bytes.push_back('x');
+    int32_t decoded = 0;
+    EXPECT_FALSE(WireDecode(bytes, &decoded));
+}
+
+TEST(WireCodecTest, RejectsOversizedCount) {
+    // A count of 2^40 elements, followed by nothing.
+    const std::string bytes("\x80\x80\x80\x80\x80\x20", 6);
+    std::vector<int32_t> decoded;
+    EXPECT_FALSE(WireDecode(bytes, &decoded));
+}
+
+}  // namespace
@@ -0,0 +1,63 @@
+#include "cppschema/rpc/rpc_client.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "cppschema/rpc/unix_socket.h"
+
+namespace cppschema::rpc {
+
+std::unique_ptr<RpcChannel> RpcChannel::Connect(const std::string& socket_path) {
+    sockaddr_un addr;
+    socklen_t addr_len = 0;
+    if (!internal::MakeUnixAddress(socket_path, &addr, &addr_len)) {
+        return nullptr;
+    }
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), addr_len) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<RpcChannel>(new RpcChannel(fd));
+}
+
+RpcChannel::~RpcChannel() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+RpcStatus RpcChannel::Call(uint16_t method_id, std::string_view request, std::string* response) {
+    if (fd_ < 0) {
+        return RpcStatus::kTransportError;
+    }
+    const RpcFrameHeader header = {
+        .payload_size = static_cast<uint32_t>(request.size()),
+        .call_id = next_call_id_++,
+        .method_id = method_id,
+    };
+    // A single write per call, so that the server sees the frame in one read.
+    request_frame_.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+    request_frame_.append(request);
+    RpcFrameHeader reply;
+    if (!internal::WriteFully(fd_, request_frame_.data(), request_frame_.size()) ||
+        !internal::ReadFully(fd_, &reply, sizeof(reply)) ||
+        reply.call_id != header.call_id) {
+        close(fd_);
+        fd_ = -1;
+        return RpcStatus::kTransportError;
+    }
+    response->resize(reply.payload_size);
+    if (!internal::ReadFully(fd_, response->data(), reply.payload_size)) {
+        close(fd_);
+        fd_ = -1;
+        return RpcStatus::kTransportError;
+    }
+    return static_cast<RpcStatus>(reply.status);
+}
+
+}  // namespace cppschema::rpc
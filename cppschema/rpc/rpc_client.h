@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "cppschema/common/wire_codec.h"
+#include "cppschema/rpc/rpc_dispatch.h"
+#include "cppschema/rpc/rpc_protocol.h"
+
+namespace cppschema::rpc {
+
+/**
+ * A blocking connection to an `RpcServer`, which sends one request at a time. It is not
+ * thread-safe, use one channel per thread.
+ */
+class RpcChannel {
+public:
+    // Returns nullptr if the connection fails.
+    static std::unique_ptr<RpcChannel> Connect(const std::string& socket_path);
+
+    ~RpcChannel();
+
+    RpcChannel(const RpcChannel&) = delete;
+    RpcChannel& operator=(const RpcChannel&) = delete;
+
+    // Sends a wire encoded request, and waits for the wire encoded response.
+    RpcStatus Call(uint16_t method_id, std::string_view request, std::string* response);
+
+private:
+    explicit RpcChannel(int fd) : fd_(fd) {}
+
+    int fd_ = -1;
+    uint32_t next_call_id_ = 1;
+    std::string request_frame_;
+};
+
+/**
+ * Typed caller for the client stub `API::Client`, which is generated by
+ * `DEFINE_API_VISITOR_FUNCTION`. Each stub method returns `std::optional<ResponseType>`, which is
+ * empty if the call failed. See `last_status()` for the reason, and `last_error()` for the message
+ * of the backend errors.
+ *
+ * The `Channel` is the transport, anything with a `RpcChannel::Call` like method. See
+ * `ShmChannel` for the shared memory transport.
+ *
+ * @example
+ * RpcClient<GraphApi> rpc(RpcChannel::Connect("/tmp/graph.sock"));
+ * GraphApi::Client<RpcClient<GraphApi>> stub{rpc};
+ * std::optional<std::string> node_id = stub.addNode({.ui_name = "Sum"});
+ */
+template <typename API, typename Channel = RpcChannel>
+class RpcClient {
+public:
+    explicit RpcClient(std::unique_ptr<Channel> channel) : channel_(std::move(channel)) {}
+
+    bool connected() const { return channel_ != nullptr; }
+    RpcStatus last_status() const { return last_status_; }
+
+    // The error message of the last call, if it failed with `RpcStatus::kBackendError`.
+    std::string_view last_error() const {
+        return last_status_ == RpcStatus::kBackendError ? std::string_view(response_) : std::string_view();
+    }
+
+    template <typename Traits>
+    std::optional<typename Traits::ResponseType> Invoke(const typename Traits::RequestType& req) {
+        using Res = typename Traits::ResponseType;
+        if (!channel_) {
+            last_status_ = RpcStatus::kTransportError;
+            return std::nullopt;
+        }
+        request_.clear();
+        WireEncodeTo(req, &request_);
+        last_status_ = channel_->Call(RpcMethodId<API, Traits>(), request_, &response_);
+        if (last_status_ != RpcStatus::kOk) {
+            return std::nullopt;
+        }
+        std::optional<Res> res(std::in_place);
+        if (!WireDecode(response_, &*res)) {
+            last_status_ = RpcStatus::kTransportError;
+            return std::nullopt;
+        }
+        return res;
+    }
+
+    Channel* channel() const { return channel_.get(); }
+
+private:
+    std::unique_ptr<Channel> channel_;
+    RpcStatus last_status_ = RpcStatus::kOk;
+    // Reused across the calls to avoid the allocations.
+    std::string request_;
+    std::string response_;
+};
+
+// The generated client stub, for use with `RpcClient<API, Channel>`.
+template <typename API, typename Channel = RpcChannel>
+using RpcStub = typename API::template Client<RpcClient<API, Channel>>;
+
+}  // namespace cppschema::rpc
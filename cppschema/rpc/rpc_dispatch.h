@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/trace.h"
+#include "cppschema/common/wire_codec.h"
+#include "cppschema/rpc/rpc_protocol.h"
+
+namespace cppschema::rpc {
+
+inline constexpr uint16_t kInvalidMethodId = std::numeric_limits<uint16_t>::max();
+
+/**
+ * Returns the method id of an API, which is its index in the `_visit_traits` order. The client and
+ * the server agree on the ids as long as they are compiled against the same API spec.
+ *
+ * @example
+ * uint16_t id = RpcMethodId<GraphApi, GraphApi::addNode_traits>();
+ */
+template <typename API, typename Traits>
+uint16_t RpcMethodId() {
+    static const uint16_t method_id = [] {
+        uint16_t index = 0;
+        uint16_t found = kInvalidMethodId;
+        auto visitor = [&]<typename T>(T) {
+            if (std::is_same_v<T, Traits>) {
+                found = index;
+            }
+            ++index;
+        };
+        API schema;
+        schema._visit_traits(visitor);
+        return found;
+    }();
+    return method_id;
+}
+
+/**
+ * Wire encodes the elements of a streamed array response (see `ArraySink`) as they are emitted.
+ * The element count, which leads the encoding of an array, is inserted by `Finish`.
+ */
+template <typename T>
+class WireArraySink final : public ArraySink<T> {
+public:
+    explicit WireArraySink(std::string* out) : out_(out), start_(out->size()), writer_(out) {}
+
+    void Append(T&& item) override {
+        WireCodec<T>::encode(item, writer_);
+        ++count_;
+    }
+    using ArraySink<T>::Append;
+
+    void Finish() {
+        std::string count;
+        WireWriter(&count).writeVarint(count_);
+        out_->insert(start_, count);
+    }
+
+private:
+    std::string* out_;
+    size_t start_;
+    WireWriter writer_;
+    uint64_t count_ = 0;
+};
+
+/**
+ * Maps method ids to type-erased handlers, which decode the wire encoded request, dispatch it to
+ * the backend registered in `ApiRegistry<API>`, and wire encode the response.
+ *
+ * This is the native counterpart of `jsbridge::JsDispatchVisitor`, and is shared by the different
+ * transports (unix socket, shared memory).
+ */
+template <typename API>
+class RpcDispatchTable {
+public:
+    using Handler = RpcStatus (*)(std::string_view request, std::string* response);
+
+    static const RpcDispatchTable& Get() {
+        static const RpcDispatchTable instance;
+        return instance;
+    }
+
+    size_t size() const { return methods_.size(); }
+
+    // Returns the API name of a method id, or nullptr if out of range.
+    const char* MethodName(uint16_t method_id) const {
+        return method_id < methods_.size() ? methods_[method_id].name : nullptr;
+    }
+
+    uint16_t FindMethod(std::string_view name) const {
+        for (size_t i = 0; i < methods_.size(); ++i) {
+            if (name == methods_[i].name) {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        return kInvalidMethodId;
+    }
+
+    // Thread-safe as long as the registered backend is.
+    RpcStatus Dispatch(uint16_t method_id, std::string_view request, std::string* response) const {
+        if (method_id >= methods_.size()) {
+            return RpcStatus::kUnknownMethod;
+        }
+        return methods_[method_id].handler(request, response);
+    }
+
+private:
+    struct Method {
+        const char* name;
+        Handler handler;
+    };
+
+    RpcDispatchTable() {
+        auto visitor = [this]<typename Traits>(Traits) {
+            methods_.push_back({Traits::name, &Invoke<Traits>});
+        };
+        API schema;
+        schema._visit_traits(visitor);
+    }
+
+    template <typename Traits>
+    static RpcStatus Invoke(std::string_view request, std::string* response) {
+        using Req = typename Traits::RequestType;
+        using Res = typename Traits::ResponseType;
+        trace::ScopedSpan call_span(Traits::name, trace::kCall, request.size());
+        Req req{};
+        {
+            trace::ScopedSpan span(Traits::name, trace::kDecode, request.size());
+            if (!WireDecode(request, &req)) {
+                return RpcStatus::kBadRequest;
+            }
+        }
+        auto& registry = ApiRegistry<API>::Get();
+        response->clear();
+        Status status;
+        if constexpr (kHasResponseSink<Res>) {
+            if (registry.IsStreaming(Traits::name)) {
+                // The elements are encoded straight into the response, without the vector.
+                WireArraySink<typename Res::value_type> sink(response);
+                status = registry.template TryStream<Req, Res>(Traits::name, req, &sink);
+                if (status.ok()) {
+                    sink.Finish();
+                    return RpcStatus::kOk;
+                }
+                response->clear();
+            }
+        }
+        Res res{};
+        if (status.ok()) {
+            status = registry.template TryCall<Req, Res>(Traits::name, req, &res);
+        }
+        if (!status.ok()) {
+            if (status.code() == StatusCode::kUnimplemented) {
+                return RpcStatus::kUnimplemented;
+            }
+            response->assign(status.ToString());
+            return RpcStatus::kBackendError;
+        }
+        trace::ScopedSpan span(Traits::name, trace::kEncode);
+        WireEncodeTo(res, response);
+        span.set_payload_size(response->size());
+        return RpcStatus::kOk;
+    }
+
+    std::vector<Method> methods_;
+};
+
+}  // namespace cppschema::rpc
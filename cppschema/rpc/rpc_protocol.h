@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace cppschema::rpc {
+
+// Result of an RPC, carried in the response frame header.
+enum class RpcStatus : uint16_t {
+    kOk = 0,
+    // The method id is not part of the API schema.
+    kUnknownMethod = 1,
+    // The request payload could not be decoded into the request type.
+    kBadRequest = 2,
+    // The connection failed, the response was malformed, or the message does not fit in the
+    // transport.
+    kTransportError = 3,
+    // The backend has no method registered for the API.
+    kUnimplemented = 4,
+    // The backend method returned an error. The response payload is the error message.
+    kBackendError = 5,
+};
+
+inline const char* RpcStatusName(RpcStatus status) {
+    switch (status) {
+        case RpcStatus::kOk: return "OK";
+        case RpcStatus::kUnknownMethod: return "UNKNOWN_METHOD";
+        case RpcStatus::kBadRequest: return "BAD_REQUEST";
+        case RpcStatus::kTransportError: return "TRANSPORT_ERROR";
+        case RpcStatus::kUnimplemented: return "UNIMPLEMENTED";
+        case RpcStatus::kBackendError: return "BACKEND_ERROR";
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * Every message on the socket, in either direction, is a fixed size header followed by
+ * `payload_size` bytes of wire encoded (see `cppschema/common/wire_codec.h`) request or response.
+ *
+ * Requests may be pipelined on a connection, and the responses can arrive out of order when the
+ * server runs a worker pool. They are matched using the `call_id`, which is echoed back.
+ */
+struct RpcFrameHeader {
+    uint32_t payload_size = 0;
+    uint32_t call_id = 0;
+    // Index of the API in the `_visit_traits` order of the API spec.
+    uint16_t method_id = 0;
+    // RpcStatus in responses, zero in requests.
+    uint16_t status = 0;
+};
+
+static_assert(sizeof(RpcFrameHeader) == 12, "RpcFrameHeader is sent as raw bytes");
+
+// Server side handler of the transports, which maps a wire encoded request to a wire encoded
+// response. See `RpcDispatchTable` for the one serving an API.
+using RpcHandler =
+    std::function<RpcStatus(uint16_t method_id, std::string_view request, std::string* response)>;
+
+}  // namespace cppschema::rpc
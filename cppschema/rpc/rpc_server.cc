@@ -0,0 +1,356 @@
+#include "cppschema/rpc/rpc_server.h"
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "absl/log/log.h"
+#include "cppschema/rpc/unix_socket.h"
+
+namespace cppschema::rpc {
+
+namespace {
+
+// Reserved epoll tags, the connections use ids starting from 1.
+constexpr uint64_t kListenTag = 0;
+constexpr uint64_t kWakeTag = std::numeric_limits<uint64_t>::max();
+
+constexpr size_t kReadChunkSize = 64 << 10;
+
+// Compact the input buffer once the consumed prefix grows beyond this.
+constexpr size_t kCompactThreshold = 64 << 10;
+
+}  // namespace
+
+struct RpcServer::Connection {
+    uint64_t id = 0;
+    int fd = -1;
+    std::string in;
+    size_t in_pos = 0;
+    std::string out;
+    size_t out_pos = 0;
+    bool want_write = false;
+};
+
+RpcServer::RpcServer(Options options, Handler handler)
+    : options_(std::move(options)), handler_(std::move(handler)) {}
+
+RpcServer::~RpcServer() {
+    Stop();
+}
+
+bool RpcServer::Start() {
+    sockaddr_un addr;
+    socklen_t addr_len = 0;
+    if (!internal::MakeUnixAddress(options_.socket_path, &addr, &addr_len)) {
+        LOG(ERROR) << "[RpcServer] Invalid socket path: " << options_.socket_path;
+        return false;
+    }
+    if (options_.socket_path[0] != '@') {
+        unlink(options_.socket_path.c_str());
+    }
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0 ||
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), addr_len) != 0 ||
+        listen(listen_fd_, options_.listen_backlog) != 0) {
+        LOG(ERROR) << "[RpcServer] Failed to listen on " << options_.socket_path << ": "
+                   << std::strerror(errno);
+        Stop();
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event listen_ev = {.events = EPOLLIN, .data = {.u64 = kListenTag}};
+    epoll_event wake_ev = {.events = EPOLLIN, .data = {.u64 = kWakeTag}};
+    if (epoll_fd_ < 0 || wake_fd_ < 0 ||
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &listen_ev) != 0 ||
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_ev) != 0) {
+        LOG(ERROR) << "[RpcServer] Failed to set up epoll: " << std::strerror(errno);
+        Stop();
+        return false;
+    }
+
+    stopping_ = false;
+    for (int i = 0; i < options_.num_workers; ++i) {
+        workers_.emplace_back([this] { WorkerLoop(); });
+    }
+    loop_thread_ = std::thread([this] { EventLoop(); });
+    return true;
+}
+
+void RpcServer::Stop() {
+    stopping_ = true;
+    if (loop_thread_.joinable()) {
+        const uint64_t one = 1;
+        (void)!write(wake_fd_, &one, sizeof(one));
+        loop_thread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobs_mu_);
+        jobs_.clear();
+    }
+    jobs_cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    done_.clear();
+
+    for (auto& [id, conn] : connections_) {
+        close(conn->fd);
+    }
+    connections_.clear();
+    num_connections_ = 0;
+
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!options_.socket_path.empty() && options_.socket_path[0] != '@') {
+        unlink(options_.socket_path.c_str());
+    }
+}
+
+void RpcServer::EventLoop() {
+    epoll_event events[64];
+    while (!stopping_) {
+        const int n = epoll_wait(epoll_fd_, events, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "[RpcServer] epoll_wait failed: " << std::strerror(errno);
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            const uint64_t tag = events[i].data.u64;
+            if (tag == kListenTag) {
+                AcceptConnections();
+                continue;
+            }
+            if (tag == kWakeTag) {
+                uint64_t count;
+                (void)!read(wake_fd_, &count, sizeof(count));
+                DrainCompletions();
+                continue;
+            }
+            auto it = connections_.find(tag);
+            if (it == connections_.end()) {
+                continue;  // Closed earlier in this batch.
+            }
+            Connection& conn = *it->second;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                CloseConnection(tag);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !FlushWrites(conn)) {
+                continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                ReadFrames(conn);
+            }
+        }
+    }
+}
+
+void RpcServer::AcceptConnections() {
+    while (true) {
+        const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG(ERROR) << "[RpcServer] accept failed: " << std::strerror(errno);
+            }
+            return;
+        }
+        auto conn = std::make_unique<Connection>();
+        conn->id = next_conn_id_++;
+        conn->fd = fd;
+        epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP, .data = {.u64 = conn->id}};
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            continue;
+        }
+        connections_[conn->id] = std::move(conn);
+        num_connections_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RpcServer::ReadFrames(Connection& conn) {
+    const uint64_t conn_id = conn.id;
+    bool peer_closed = false;
+    char buf[kReadChunkSize];
+    while (true) {
+        const ssize_t n = read(conn.fd, buf, sizeof(buf));
+        if (n > 0) {
+            conn.in.append(buf, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        peer_closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+        break;
+    }
+
+    RpcFrameHeader header;
+    while (conn.in.size() - conn.in_pos >= sizeof(header)) {
+        std::memcpy(&header, conn.in.data() + conn.in_pos, sizeof(header));
+        if (header.payload_size > options_.max_frame_size) {
+            LOG(ERROR) << "[RpcServer] Frame too large: " << header.payload_size;
+            CloseConnection(conn_id);
+            return;
+        }
+        if (conn.in.size() - conn.in_pos - sizeof(header) < header.payload_size) {
+            break;
+        }
+        Job job = {
+            .conn_id = conn_id,
+            .header = header,
+            .payload = conn.in.substr(conn.in_pos + sizeof(header), header.payload_size),
+        };
+        conn.in_pos += sizeof(header) + header.payload_size;
+        if (workers_.empty()) {
+            std::string frame;
+            Execute(job, &frame);
+            if (!QueueFrame(conn, frame)) {
+                return;
+            }
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(jobs_mu_);
+                jobs_.push_back(std::move(job));
+            }
+            jobs_cv_.notify_one();
+        }
+    }
+    if (conn.in_pos == conn.in.size()) {
+        conn.in.clear();
+        conn.in_pos = 0;
+    } else if (conn.in_pos > kCompactThreshold) {
+        conn.in.erase(0, conn.in_pos);
+        conn.in_pos = 0;
+    }
+
+    if (peer_closed) {
+        CloseConnection(conn_id);
+    }
+}
+
+void RpcServer::Execute(Job& job, std::string* frame) {
+    RpcFrameHeader header = {.call_id = job.header.call_id, .method_id = job.header.method_id};
+    std::string response;
+    // On errors, the response is empty or has the error message.
+    const RpcStatus status = handler_(job.header.method_id, job.payload, &response);
+    header.status = static_cast<uint16_t>(status);
+    header.payload_size = static_cast<uint32_t>(response.size());
+    frame->reserve(sizeof(header) + response.size());
+    frame->assign(reinterpret_cast<const char*>(&header), sizeof(header));
+    frame->append(response);
+}
+
+void RpcServer::WorkerLoop() {
+    std::string frame;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mu_);
+            jobs_cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        Execute(job, &frame);
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(done_mu_);
+            was_empty = done_.empty();
+            done_.emplace_back(job.conn_id, std::move(frame));
+        }
+        frame.clear();
+        if (was_empty) {
+            // Only the first completion of a batch needs to wake the event loop.
+            const uint64_t one = 1;
+            (void)!write(wake_fd_, &one, sizeof(one));
+        }
+    }
+}
+
+void RpcServer::DrainCompletions() {
+    std::vector<std::pair<uint64_t, std::string>> done;
+    {
+        std::lock_guard<std::mutex> lock(done_mu_);
+        done.swap(done_);
+    }
+    for (auto& [conn_id, frame] : done) {
+        auto it = connections_.find(conn_id);
+        if (it != connections_.end()) {
+            // Responses for the closed connections are dropped.
+            QueueFrame(*it->second, frame);
+        }
+    }
+}
+
+bool RpcServer::QueueFrame(Connection& conn, std::string_view frame) {
+    conn.out.append(frame);
+    // While waiting for writability, the frame goes out with the next EPOLLOUT.
+    return conn.want_write || FlushWrites(conn);
+}
+
+bool RpcServer::FlushWrites(Connection& conn) {
+    while (conn.out_pos < conn.out.size()) {
+        const ssize_t n = send(conn.fd, conn.out.data() + conn.out_pos,
+                               conn.out.size() - conn.out_pos, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            CloseConnection(conn.id);
+            return false;
+        }
+        conn.out_pos += static_cast<size_t>(n);
+    }
+    const bool pending = conn.out_pos < conn.out.size();
+    if (!pending) {
+        conn.out.clear();
+        conn.out_pos = 0;
+    }
+    if (pending != conn.want_write) {
+        // Listen for writability only while there is something left to write.
+        conn.want_write = pending;
+        epoll_event ev = {
+            .events = EPOLLIN | EPOLLRDHUP | (pending ? EPOLLOUT : 0u),
+            .data = {.u64 = conn.id},
+        };
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+    }
+    return true;
+}
+
+void RpcServer::CloseConnection(uint64_t conn_id) {
+    auto it = connections_.find(conn_id);
+    if (it == connections_.end()) {
+        return;
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second->fd, nullptr);
+    close(it->second->fd);
+    connections_.erase(it);
+    num_connections_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}  // namespace cppschema::rpc
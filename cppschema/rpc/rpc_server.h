@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cppschema/rpc/rpc_dispatch.h"
+#include "cppschema/rpc/rpc_protocol.h"
+
+namespace cppschema::rpc {
+
+/**
+ * A Unix domain socket RPC server (Linux only).
+ *
+ * A single event loop thread accepts connections and reads / writes the frames using non-blocking
+ * sockets and epoll. By default, the handler runs inline on the event loop thread, one request at
+ * a time, which also gives the lowest latency for cheap handlers. With `num_workers`, complete
+ * request frames are handed over to a pool of worker threads which run the handler, and hand the
+ * response back to the event loop through an eventfd.
+ *
+ * The server is transport only, and is not aware of the API. Use `CreateRpcServer<API>` to serve
+ * the backend registered in `ApiRegistry<API>`.
+ *
+ * @note With workers, the backend methods are called concurrently and must be thread-safe. Only
+ * opt in for such backends (e.g. not the example `GraphApi` one).
+ */
+class RpcServer {
+public:
+    using Handler = RpcHandler;
+
+    struct Options {
+        // Filesystem path of the socket. A leading '@' denotes the Linux abstract namespace.
+        std::string socket_path;
+        // The threads calling the handler concurrently, 0 for the event loop thread only.
+        int num_workers = 0;
+        // Connections sending bigger frames are closed.
+        uint32_t max_frame_size = 64 << 20;
+        int listen_backlog = 128;
+    };
+
+    RpcServer(Options options, Handler handler);
+    ~RpcServer();
+
+    RpcServer(const RpcServer&) = delete;
+    RpcServer& operator=(const RpcServer&) = delete;
+
+    // Binds the socket and starts the threads. Returns false if the socket could not be set up.
+    bool Start();
+
+    // Stops the threads and closes all the connections. Called by the destructor.
+    void Stop();
+
+    size_t num_connections() const { return num_connections_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection;
+    struct Job {
+        uint64_t conn_id;
+        RpcFrameHeader header;
+        std::string payload;
+    };
+
+    void EventLoop();
+    void WorkerLoop();
+    void AcceptConnections();
+    void ReadFrames(Connection& conn);
+    void Execute(Job& job, std::string* frame);
+    // These return false if the connection failed, and was closed.
+    bool QueueFrame(Connection& conn, std::string_view frame);
+    bool FlushWrites(Connection& conn);
+    void DrainCompletions();
+    void CloseConnection(uint64_t conn_id);
+
+    const Options options_;
+    const Handler handler_;
+
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> num_connections_{0};
+
+    // Owned by the event loop thread.
+    uint64_t next_conn_id_ = 1;
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections_;
+
+    std::thread loop_thread_;
+    std::vector<std::thread> workers_;
+
+    // Requests from the event loop to the workers.
+    std::mutex jobs_mu_;
+    std::condition_variable jobs_cv_;
+    std::deque<Job> jobs_;
+
+    // Response frames from the workers to the event loop, keyed by the connection id.
+    std::mutex done_mu_;
+    std::vector<std::pair<uint64_t, std::string>> done_;
+};
+
+/**
+ * Creates a server for the backend registered in `ApiRegistry<API>`.
+ *
+ * @example
+ * auto server = CreateRpcServer<GraphApi>({.socket_path = "/tmp/graph.sock"});
+ * server->Start();
+ */
+template <typename API>
+std::unique_ptr<RpcServer> CreateRpcServer(RpcServer::Options options) {
+    const RpcDispatchTable<API>& table = RpcDispatchTable<API>::Get();
+    return std::make_unique<RpcServer>(std::move(options),
+        [&table](uint16_t method_id, std::string_view request, std::string* response) {
+            return table.Dispatch(method_id, request, response);
+        });
+}
+
+}  // namespace cppschema::rpc
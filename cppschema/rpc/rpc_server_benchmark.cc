@@ -0,0 +1,157 @@
+// Load generator for the unix socket RPC server. For a growing number of client connections (one
+// thread each), it issues back to back calls for a fixed duration, and reports the throughput and
+// the latency percentiles.
+//
+// $ bazel run -c opt //cppschema/rpc:rpc_server_benchmark -- --workers=4 --payload=64
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/visitor_macros.h"
+#include "cppschema/rpc/rpc_client.h"
+#include "cppschema/rpc/rpc_server.h"
+
+namespace {
+
+using ::cppschema::ApiStub;
+using ::cppschema::rpc::RpcChannel;
+using ::cppschema::rpc::RpcClient;
+using ::cppschema::rpc::RpcStub;
+using Clock = std::chrono::steady_clock;
+
+struct BenchApi {
+    struct EchoRequest {
+        std::string payload;
+        int32_t sequence = 0;
+        DEFINE_STRUCT_VISITOR_FUNCTION(payload, sequence);
+    };
+
+    ApiStub<EchoRequest, EchoRequest> echo;
+
+    DEFINE_API_VISITOR_FUNCTION(echo);
+};
+
+class BenchApiImpl : public cppschema::ApiBackend<BenchApi> {
+public:
+    BenchApi::EchoRequest echoImpl(const BenchApi::EchoRequest& req) { return req; }
+};
+
+struct Flags {
+    int max_connections = 64;
+    int workers = 4;
+    int payload = 64;
+    double seconds = 1.0;
+};
+
+Flags ParseFlags(int argc, char** argv) {
+    Flags flags;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        auto value = [arg](const char* name) -> const char* {
+            const size_t len = std::strlen(name);
+            return std::strncmp(arg, name, len) == 0 && arg[len] == '=' ? arg + len + 1 : nullptr;
+        };
+        if (const char* v = value("--max_connections")) flags.max_connections = std::atoi(v);
+        else if (const char* v = value("--workers")) flags.workers = std::atoi(v);
+        else if (const char* v = value("--payload")) flags.payload = std::atoi(v);
+        else if (const char* v = value("--seconds")) flags.seconds = std::atof(v);
+        else {
+            std::fprintf(stderr, "Unknown flag: %s\n", arg);
+            std::exit(1);
+        }
+    }
+    return flags;
+}
+
+double Percentile(const std::vector<uint32_t>& sorted_ns, double p) {
+    if (sorted_ns.empty()) {
+        return 0;
+    }
+    const size_t index = std::min(sorted_ns.size() - 1, static_cast<size_t>(p * sorted_ns.size()));
+    return sorted_ns[index] / 1000.0;
+}
+
+void RunLoad(const std::string& socket_path, int connections, const Flags& flags) {
+    std::vector<std::vector<uint32_t>> latencies(connections);
+    std::atomic<bool> start = false;
+    std::atomic<int> failures = 0;
+    const auto duration = std::chrono::duration<double>(flags.seconds);
+
+    std::vector<std::thread> clients;
+    for (int c = 0; c < connections; ++c) {
+        clients.emplace_back([&, c] {
+            RpcClient<BenchApi> rpc(RpcChannel::Connect(socket_path));
+            RpcStub<BenchApi> stub{rpc};
+            BenchApi::EchoRequest req = {.payload = std::string(flags.payload, 'x')};
+            std::vector<uint32_t>& samples = latencies[c];
+            samples.reserve(1 << 20);
+            while (!start) {
+                std::this_thread::yield();
+            }
+            const auto end = Clock::now() + duration;
+            for (auto now = Clock::now(); now < end;) {
+                req.sequence++;
+                if (!stub.echo(req)) {
+                    ++failures;
+                    return;
+                }
+                const auto done = Clock::now();
+                samples.push_back(static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(done - now).count()));
+                now = done;
+            }
+        });
+    }
+    start = true;
+    for (std::thread& client : clients) {
+        client.join();
+    }
+
+    std::vector<uint32_t> all;
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    std::printf("%11d %14.0f %10.1f %10.1f %10.1f %10.1f %9d\n", connections,
+                all.size() / flags.seconds, Percentile(all, 0.5), Percentile(all, 0.99),
+                Percentile(all, 0.999), all.empty() ? 0.0 : all.back() / 1000.0, failures.load());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const Flags flags = ParseFlags(argc, argv);
+
+    cppschema::ScopedRegister<BenchApi, BenchApiImpl> backend(new BenchApiImpl(), {
+        .echo = &BenchApiImpl::echoImpl,
+    });
+    const std::string socket_path = "@cppschema_rpc_bench_" + std::to_string(getpid());
+    auto server = cppschema::rpc::CreateRpcServer<BenchApi>({
+        .socket_path = socket_path,
+        .num_workers = flags.workers,
+    });
+    if (!server->Start()) {
+        return 1;
+    }
+
+    std::printf("workers=%d payload=%dB duration=%.1fs\n", flags.workers, flags.payload,
+                flags.seconds);
+    std::printf("%11s %14s %10s %10s %10s %10s %9s\n", "connections", "calls/s", "p50(us)",
+                "p99(us)", "p99.9(us)", "max(us)", "failures");
+    for (int connections = 1; connections <= flags.max_connections; connections *= 2) {
+        RunLoad(socket_path, connections, flags);
+    }
+    return 0;
+}
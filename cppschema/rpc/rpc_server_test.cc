@@ -0,0 +1,200 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/types.h"
+#include "cppschema/common/visitor_macros.h"
+#include "cppschema/rpc/rpc_client.h"
+#include "cppschema/rpc/rpc_server.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::rpc::CreateRpcServer;
+using ::cppschema::rpc::RpcChannel;
+using ::cppschema::rpc::RpcClient;
+using ::cppschema::rpc::RpcServer;
+using ::cppschema::rpc::RpcStatus;
+using ::cppschema::rpc::RpcStub;
+
+struct CalcApi {
+    struct AddRequest {
+        int32_t a = 0;
+        int32_t b = 0;
+        DEFINE_STRUCT_VISITOR_FUNCTION(a, b);
+    };
+
+    ApiStub<AddRequest, int32_t> add;
+    ApiStub<std::vector<std::string>, std::string> join;
+    ApiStub<VoidType, int64_t> numCalls;
+    ApiStub<AddRequest, int32_t> divide;
+    // Not implemented by the backend.
+    ApiStub<AddRequest, int32_t> multiply;
+    // The integers in [a, b), streamed by the backend.
+    ApiStub<AddRequest, std::vector<int32_t>> range;
+
+    DEFINE_API_VISITOR_FUNCTION(add, join, numCalls, divide, multiply, range);
+};
+
+class CalcApiImpl : public cppschema::ApiBackend<CalcApi> {
+public:
+    int32_t addImpl(const CalcApi::AddRequest& req) {
+        ++calls_;
+        return req.a + req.b;
+    }
+
+    std::string joinImpl(const std::vector<std::string>& parts) {
+        ++calls_;
+        std::string joined;
+        for (const std::string& part : parts) {
+            joined += part;
+        }
+        return joined;
+    }
+
+    int64_t numCallsImpl(const VoidType&) { return calls_; }
+
+    cppschema::Expected<int32_t> divideImpl(const CalcApi::AddRequest& req) {
+        if (req.b == 0) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError("Division by zero"));
+        }
+        return req.a / req.b;
+    }
+
+    cppschema::Status rangeImpl(const CalcApi::AddRequest& req, cppschema::ArraySink<int32_t>* values) {
+        if (req.b < req.a) {
+            return cppschema::InvalidArgumentError("Empty range");
+        }
+        values->Reserve(req.b - req.a);
+        for (int32_t i = req.a; i < req.b; ++i) {
+            values->Append(i);
+        }
+        return cppschema::OkStatus();
+    }
+
+private:
+    std::atomic<int64_t> calls_ = 0;
+};
+
+class RpcServerTest : public testing::TestWithParam<int> {
+protected:
+    void SetUp() override {
+        cppschema::RegisterBackend<CalcApi, CalcApiImpl>(new CalcApiImpl(), {
+            .add = &CalcApiImpl::addImpl,
+            .join = &CalcApiImpl::joinImpl,
+            .numCalls = &CalcApiImpl::numCallsImpl,
+            .divide = &CalcApiImpl::divideImpl,
+            .range = &CalcApiImpl::rangeImpl,
+        });
+        socket_path_ = "@cppschema_rpc_test_" + std::to_string(getpid());
+        server_ = CreateRpcServer<CalcApi>({.socket_path = socket_path_, .num_workers = GetParam()});
+        ASSERT_TRUE(server_->Start());
+    }
+
+    void TearDown() override {
+        server_.reset();
+        ApiRegistry<CalcApi>::Get().Clear();
+    }
+
+    std::string socket_path_;
+    std::unique_ptr<RpcServer> server_;
+};
+
+TEST_P(RpcServerTest, GeneratedStub) {
+    RpcClient<CalcApi> rpc(RpcChannel::Connect(socket_path_));
+    ASSERT_TRUE(rpc.connected());
+    RpcStub<CalcApi> stub{rpc};
+
+    EXPECT_EQ(stub.add({.a = 40, .b = 2}), 42);
+    EXPECT_EQ(stub.join({"a", "b", "c"}), "abc");
+    EXPECT_EQ(stub.numCalls({}), 2);
+    EXPECT_EQ(rpc.last_status(), RpcStatus::kOk);
+}
+
+TEST_P(RpcServerTest, UnknownMethodAndBadRequest) {
+    std::unique_ptr<RpcChannel> channel = RpcChannel::Connect(socket_path_);
+    ASSERT_NE(channel, nullptr);
+    std::string response;
+    EXPECT_EQ(channel->Call(100, "", &response), RpcStatus::kUnknownMethod);
+    // `add` expects 8 bytes.
+    EXPECT_EQ(channel->Call(0, "abc", &response), RpcStatus::kBadRequest);
+    // The connection is still usable after the errors.
+    RpcClient<CalcApi> rpc(std::move(channel));
+    EXPECT_EQ(RpcStub<CalcApi>{rpc}.add({.a = 1, .b = 2}), 3);
+}
+
+TEST_P(RpcServerTest, BackendErrors) {
+    RpcClient<CalcApi> rpc(RpcChannel::Connect(socket_path_));
+    RpcStub<CalcApi> stub{rpc};
+
+    EXPECT_EQ(stub.divide({.a = 9, .b = 3}), 3);
+    EXPECT_EQ(stub.divide({.a = 9, .b = 0}), std::nullopt);
+    EXPECT_EQ(rpc.last_status(), RpcStatus::kBackendError);
+    EXPECT_EQ(rpc.last_error(), "INVALID_ARGUMENT: Division by zero");
+
+    EXPECT_EQ(stub.multiply({.a = 9, .b = 3}), std::nullopt);
+    EXPECT_EQ(rpc.last_status(), RpcStatus::kUnimplemented);
+}
+
+TEST_P(RpcServerTest, StreamedResponse) {
+    RpcClient<CalcApi> rpc(RpcChannel::Connect(socket_path_));
+    RpcStub<CalcApi> stub{rpc};
+
+    EXPECT_EQ(stub.range({.a = 3, .b = 6}), (std::vector<int32_t>{3, 4, 5}));
+    EXPECT_EQ(stub.range({.a = 3, .b = 3}), std::vector<int32_t>{});
+    std::optional<std::vector<int32_t>> large = stub.range({.a = 0, .b = 100000});
+    ASSERT_TRUE(large.has_value());
+    EXPECT_EQ(large->size(), 100000);
+    EXPECT_EQ(large->back(), 99999);
+
+    EXPECT_EQ(stub.range({.a = 3, .b = 2}), std::nullopt);
+    EXPECT_EQ(rpc.last_error(), "INVALID_ARGUMENT: Empty range");
+}
+
+TEST_P(RpcServerTest, ConcurrentClients) {
+    constexpr int kClients = 8;
+    constexpr int kCallsPerClient = 200;
+    std::vector<std::thread> clients;
+    std::atomic<int> failures = 0;
+    for (int c = 0; c < kClients; ++c) {
+        clients.emplace_back([&, c] {
+            RpcClient<CalcApi> rpc(RpcChannel::Connect(socket_path_));
+            RpcStub<CalcApi> stub{rpc};
+            for (int i = 0; i < kCallsPerClient; ++i) {
+                if (stub.add({.a = c, .b = i}) != c + i) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(failures, 0);
+
+    RpcClient<CalcApi> rpc(RpcChannel::Connect(socket_path_));
+    EXPECT_EQ(RpcStub<CalcApi>{rpc}.numCalls({}), kClients * kCallsPerClient);
+}
+
+TEST_P(RpcServerTest, LargePayload) {
+    RpcClient<CalcApi> rpc(RpcChannel::Connect(socket_path_));
+    RpcStub<CalcApi> stub{rpc};
+    std::vector<std::string> parts(1000, std::string(1000, 'x'));
+    std::optional<std::string> joined = stub.join(parts);
+    ASSERT_TRUE(joined.has_value());
+    EXPECT_EQ(joined->size(), 1000 * 1000);
+}
+
+INSTANTIATE_TEST_SUITE_P(Workers, RpcServerTest, testing::Values(0, 4));
+
+}  // namespace
@@ -0,0 +1,157 @@
+#include "cppschema/rpc/shm_ring.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace cppschema::rpc {
+
+namespace {
+
+constexpr uint32_t kRecordAlignment = 16;
+constexpr uint32_t kWrapMarker = 0xffffffff;
+
+static_assert(sizeof(RpcFrameHeader) <= kRecordAlignment,
+    "A wrap marker must fit in the smallest gap at the end of the ring");
+
+uint32_t RecordSize(size_t payload_size) {
+    const size_t size = sizeof(RpcFrameHeader) + payload_size;
+    return static_cast<uint32_t>((size + kRecordAlignment - 1) & ~size_t{kRecordAlignment - 1});
+}
+
+// Not using FUTEX_PRIVATE_FLAG, as the futex word is shared between the processes.
+long Futex(std::atomic<uint32_t>* word, int op, uint32_t value) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+void ShmDoorbell::Ring() {
+    signal.fetch_add(1, std::memory_order_release);
+    // Pairs with the fence in `Wait`: either the consumer sees the new signal, or we see it waiting.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed) != 0) {
+        Futex(&signal, FUTEX_WAKE, INT32_MAX);
+    }
+}
+
+void ShmDoorbell::Wait(uint32_t seen) {
+    waiting.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (signal.load(std::memory_order_relaxed) == seen) {
+        // Returns immediately if the signal changed in the meantime.
+        Futex(&signal, FUTEX_WAIT, seen);
+    }
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool ShmRing::TryWrite(const RpcFrameHeader& header, std::string_view payload) {
+    if (payload.size() > max_payload_size()) {
+        return false;
+    }
+    const uint32_t record_size = RecordSize(payload.size());
+    uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    const uint64_t head = control_->head.load(std::memory_order_acquire);
+    uint32_t pos = static_cast<uint32_t>(tail & (capacity_ - 1));
+    const uint32_t contiguous = capacity_ - pos;
+    const uint32_t needed = contiguous < record_size ? contiguous + record_size : record_size;
+    if (capacity_ - (tail - head) < needed) {
+        return false;
+    }
+    if (contiguous < record_size) {
+        const RpcFrameHeader marker = {.payload_size = kWrapMarker};
+        std::memcpy(data_ + pos, &marker, sizeof(marker));
+        tail += contiguous;
+        pos = 0;
+    }
+    RpcFrameHeader record = header;
+    record.payload_size = static_cast<uint32_t>(payload.size());
+    std::memcpy(data_ + pos, &record, sizeof(record));
+    std::memcpy(data_ + pos + sizeof(record), payload.data(), payload.size());
+    control_->tail.store(tail + record_size, std::memory_order_release);
+    return true;
+}
+
+ShmReadResult ShmRing::TryRead(RpcFrameHeader* header, std::string* payload) {
+    uint64_t head = control_->head.load(std::memory_order_relaxed);
+    const uint64_t tail = control_->tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return ShmReadResult::kEmpty;
+    }
+    // Also catches a tail behind the head, as the difference wraps around.
+    if (tail - head > capacity_ || head % kRecordAlignment != 0) {
+        return ShmReadResult::kCorrupted;
+    }
+    uint32_t pos = static_cast<uint32_t>(head & (capacity_ - 1));
+    std::memcpy(header, data_ + pos, sizeof(*header));
+    if (header->payload_size == kWrapMarker) {
+        const uint32_t gap = capacity_ - pos;
+        if (tail - head <= gap) {
+            return ShmReadResult::kCorrupted;
+        }
+        head += gap;
+        pos = 0;
+        std::memcpy(header, data_, sizeof(*header));
+    }
+    // Read once into `header`, so the producer can not change the size after the checks.
+    if (header->payload_size > max_payload_size()) {
+        return ShmReadResult::kCorrupted;
+    }
+    const uint32_t record_size = RecordSize(header->payload_size);
+    if (pos + record_size > capacity_ || tail - head < record_size) {
+        return ShmReadResult::kCorrupted;
+    }
+    payload->assign(data_ + pos + sizeof(*header), header->payload_size);
+    control_->head.store(head + record_size, std::memory_order_release);
+    return ShmReadResult::kRead;
+}
+
+std::unique_ptr<ShmSegment> ShmSegment::Create(const std::string& name, size_t size) {
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void* data = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    return std::unique_ptr<ShmSegment>(new ShmSegment(name, static_cast<char*>(data), size, true));
+}
+
+std::unique_ptr<ShmSegment> ShmSegment::Open(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return std::unique_ptr<ShmSegment>(
+        new ShmSegment(name, static_cast<char*>(data), static_cast<size_t>(st.st_size), false));
+}
+
+ShmSegment::~ShmSegment() {
+    munmap(data_, size_);
+    if (owner_) {
+        shm_unlink(name_.c_str());
+    }
+}
+
+}  // namespace cppschema::rpc
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "cppschema/rpc/rpc_protocol.h"
+
+namespace cppschema::rpc {
+
+/**
+ * A futex based wakeup, which lives in shared memory and works across processes. The producer
+ * calls `Ring()` after publishing, and it makes a syscall only if the consumer is asleep.
+ */
+struct ShmDoorbell {
+    std::atomic<uint32_t> signal{0};
+    std::atomic<uint32_t> waiting{0};
+
+    void Ring();
+
+    // Blocks until `Ring()` is called after `Load()` returned `seen`. The caller must check for
+    // work after `Load()`, and before calling `Wait()`, else the wakeup can be missed.
+    void Wait(uint32_t seen);
+
+    uint32_t Load() const { return signal.load(std::memory_order_acquire); }
+};
+
+// The positions of a ring, kept on separate cache lines to avoid false sharing.
+struct ShmRingControl {
+    // Consumer position, in bytes since the start.
+    alignas(64) std::atomic<uint64_t> head{0};
+    // Producer position, in bytes since the start.
+    alignas(64) std::atomic<uint64_t> tail{0};
+};
+
+// The outcomes of `ShmRing::TryRead`.
+enum class ShmReadResult {
+    kEmpty,
+    kRead,
+    // The positions or the next record are out of the ring, written by a buggy or hostile peer.
+    // Nothing is read, and the ring can not be read anymore.
+    kCorrupted,
+};
+
+/**
+ * A lock-free single producer, single consumer ring of frames (a `RpcFrameHeader` followed by the
+ * payload), over memory which may be shared between the processes. The ring is only a view, the
+ * memory is owned by `ShmSegment`.
+ *
+ * The records are 16-byte aligned, and a record which does not fit at the end of the buffer is
+ * preceded by a wrap marker.
+ */
+class ShmRing {
+public:
+    // `capacity` must be a power of two.
+    ShmRing(ShmRingControl* control, char* data, uint32_t capacity)
+        : control_(control), data_(data), capacity_(capacity) {}
+
+    // Returns false if the ring is full. The `payload_size` of the header is set from the payload.
+    // Does not wake the consumer, see `ShmDoorbell`.
+    bool TryWrite(const RpcFrameHeader& header, std::string_view payload);
+
+    // The positions and the record headers are in memory the producer can write, so they are
+    // checked against the capacity before the payload is copied.
+    ShmReadResult TryRead(RpcFrameHeader* header, std::string* payload);
+
+    bool Empty() const {
+        return control_->head.load(std::memory_order_relaxed) ==
+            control_->tail.load(std::memory_order_acquire);
+    }
+
+    // The biggest payload which can be written, half the capacity to always let the ring progress.
+    size_t max_payload_size() const { return capacity_ / 2 - sizeof(RpcFrameHeader); }
+
+private:
+    ShmRingControl* control_;
+    char* data_;
+    uint32_t capacity_;
+};
+
+/**
+ * A named POSIX shared memory segment, mapped read-write. The creator unlinks the name when
+ * destroyed, the existing mappings stay valid until they are unmapped.
+ */
+class ShmSegment {
+public:
+    // Returns nullptr on failure. Replaces any stale segment of the same name.
+    static std::unique_ptr<ShmSegment> Create(const std::string& name, size_t size);
+    static std::unique_ptr<ShmSegment> Open(const std::string& name);
+
+    ~ShmSegment();
+
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    ShmSegment(std::string name, char* data, size_t size, bool owner)
+        : name_(std::move(name)), data_(data), size_(size), owner_(owner) {}
+
+    std::string name_;
+    char* data_;
+    size_t size_;
+    bool owner_;
+};
+
+}  // namespace cppschema::rpc
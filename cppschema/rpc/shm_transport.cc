@@ -0,0 +1,334 @@
+#include "cppschema/rpc/shm_transport.h"
+
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+
+namespace cppschema::rpc {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x43505353;  // "CPSS"
+constexpr uint32_t kClientSpinIterations = 4096;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Spinning only helps when the other side runs on another core. On a single core, it just delays
+// the other side until the time slice ends.
+uint32_t SpinBudget(uint32_t iterations) {
+    return std::thread::hardware_concurrency() > 1 ? iterations : 0;
+}
+
+constexpr size_t AlignUp(size_t size) {
+    return (size + 63) & ~size_t{63};
+}
+
+}  // namespace
+
+struct ShmSegmentHeader {
+    std::atomic<uint32_t> magic{0};
+    uint32_t num_channels;
+    uint32_t ring_capacity;
+    std::atomic<uint32_t> shutdown{0};
+    // Rung by the clients after queuing requests.
+    ShmDoorbell server_doorbell;
+};
+
+struct ShmChannelControl {
+    std::atomic<uint32_t> claimed{0};
+    // Set by the server when the requests are malformed, the channel is not served anymore.
+    std::atomic<uint32_t> dropped{0};
+    // Rung by the server after queuing responses.
+    ShmDoorbell client_doorbell;
+    ShmRingControl requests;
+    ShmRingControl responses;
+};
+
+/**
+ * Segment layout: the header, the channel controls, and then a request ring and a response ring
+ * per channel. The ring geometry is copied from the header once, as the other processes can write
+ * to it.
+ */
+struct ShmSegmentLayout {
+    ShmSegmentHeader* header;
+    uint32_t num_channels;
+    uint32_t ring_capacity;
+    ShmChannelControl* channels;
+    char* rings;
+
+    static size_t SegmentSize(uint32_t num_channels, uint32_t ring_capacity) {
+        return AlignUp(sizeof(ShmSegmentHeader)) + AlignUp(sizeof(ShmChannelControl) * num_channels) +
+            size_t{2} * ring_capacity * num_channels;
+    }
+
+    ShmSegmentLayout(char* base, uint32_t num_channels, uint32_t ring_capacity)
+        : header(reinterpret_cast<ShmSegmentHeader*>(base)),
+          num_channels(num_channels),
+          ring_capacity(ring_capacity),
+          channels(reinterpret_cast<ShmChannelControl*>(base + AlignUp(sizeof(ShmSegmentHeader)))),
+          rings(base + AlignUp(sizeof(ShmSegmentHeader)) +
+                AlignUp(sizeof(ShmChannelControl) * num_channels)) {}
+
+    ShmRing requests(uint32_t i) const {
+        return ShmRing(&channels[i].requests, rings + size_t{2} * i * ring_capacity, ring_capacity);
+    }
+
+    ShmRing responses(uint32_t i) const {
+        return ShmRing(&channels[i].responses, rings + (size_t{2} * i + 1) * ring_capacity, ring_capacity);
+    }
+};
+
+//-----------------------------------------------------------------------------
+// ShmServer
+//-----------------------------------------------------------------------------
+
+ShmServer::ShmServer(Options options, RpcHandler handler)
+    : options_(std::move(options)), handler_(std::move(handler)) {}
+
+ShmServer::~ShmServer() {
+    Stop();
+}
+
+bool ShmServer::Start() {
+    const uint32_t capacity = options_.ring_capacity;
+    if (capacity < 1024 || (capacity & (capacity - 1)) != 0 || options_.num_channels == 0) {
+        LOG(ERROR) << "[ShmServer] Invalid ring capacity or channel count";
+        return false;
+    }
+    segment_ = ShmSegment::Create(
+        options_.name, ShmSegmentLayout::SegmentSize(options_.num_channels, capacity));
+    if (!segment_) {
+        LOG(ERROR) << "[ShmServer] Failed to create the shared memory segment: " << options_.name;
+        return false;
+    }
+    char* base = segment_->data();
+    auto* header = new (base) ShmSegmentHeader();
+    header->num_channels = options_.num_channels;
+    header->ring_capacity = capacity;
+    layout_ = std::make_unique<ShmSegmentLayout>(base, options_.num_channels, capacity);
+    for (uint32_t i = 0; i < options_.num_channels; ++i) {
+        new (&layout_->channels[i]) ShmChannelControl();
+    }
+    // Publish the magic last, the clients reject the segment until then.
+    header->magic.store(kMagic, std::memory_order_release);
+
+    stopping_ = false;
+    thread_ = std::thread([this] { Loop(); });
+    return true;
+}
+
+void ShmServer::Stop() {
+    stopping_ = true;
+    if (thread_.joinable()) {
+        layout_->header->server_doorbell.Ring();
+        thread_.join();
+    }
+    if (layout_) {
+        // Wake up the waiting clients, they fail the pending calls.
+        layout_->header->shutdown.store(1, std::memory_order_release);
+        for (uint32_t i = 0; i < layout_->num_channels; ++i) {
+            layout_->channels[i].client_doorbell.Ring();
+        }
+    }
+    layout_.reset();
+    segment_.reset();
+}
+
+void ShmServer::Loop() {
+    ShmSegmentHeader& header = *layout_->header;
+    const uint32_t num_channels = layout_->num_channels;
+    // The channels of which the requests were malformed, see `DropChannel`.
+    std::vector<bool> dropped(num_channels, false);
+    std::string request;
+    std::string response;
+    const uint32_t spin_iterations = SpinBudget(options_.spin_iterations);
+    uint32_t idle = 0;
+
+    auto has_requests = [&] {
+        for (uint32_t i = 0; i < num_channels; ++i) {
+            if (!dropped[i] && layout_->channels[i].claimed.load(std::memory_order_relaxed) &&
+                !layout_->requests(i).Empty()) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        bool did_work = false;
+        for (uint32_t i = 0; i < num_channels; ++i) {
+            ShmChannelControl& channel = layout_->channels[i];
+            if (dropped[i] || !channel.claimed.load(std::memory_order_acquire)) {
+                continue;
+            }
+            ShmRing requests = layout_->requests(i);
+            ShmRing responses = layout_->responses(i);
+            bool replied = false;
+            RpcFrameHeader frame;
+            ShmReadResult read;
+            while ((read = requests.TryRead(&frame, &request)) == ShmReadResult::kRead) {
+                RpcStatus status = handler_(frame.method_id, request, &response);
+                if (response.size() > responses.max_payload_size()) {
+                    status = RpcStatus::kTransportError;
+                    response.clear();
+                }
+                const RpcFrameHeader reply = {
+                    .payload_size = static_cast<uint32_t>(response.size()),
+                    .call_id = frame.call_id,
+                    .method_id = frame.method_id,
+                    .status = static_cast<uint16_t>(status),
+                };
+                while (!responses.TryWrite(reply, response)) {
+                    // The client is not keeping up with the responses, make sure it is awake.
+                    channel.client_doorbell.Ring();
+                    if (stopping_.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+                replied = true;
+            }
+            if (read == ShmReadResult::kCorrupted) {
+                // Never served again, the client fails its pending calls.
+                LOG(ERROR) << "[ShmServer] Dropping channel " << i << " of " << options_.name
+                           << ", its requests are malformed";
+                dropped[i] = true;
+                channel.dropped.store(1, std::memory_order_release);
+                channel.client_doorbell.Ring();
+            }
+            if (replied) {
+                channel.client_doorbell.Ring();
+                did_work = true;
+            }
+        }
+        if (did_work) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < spin_iterations) {
+            CpuRelax();
+            continue;
+        }
+        const uint32_t seen = header.server_doorbell.Load();
+        if (!has_requests() && !stopping_.load(std::memory_order_relaxed)) {
+            header.server_doorbell.Wait(seen);
+        }
+        idle = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// ShmChannel
+//-----------------------------------------------------------------------------
+
+std::unique_ptr<ShmChannel> ShmChannel::Connect(const std::string& name) {
+    std::unique_ptr<ShmSegment> segment = ShmSegment::Open(name);
+    if (!segment || segment->size() < sizeof(ShmSegmentHeader)) {
+        return nullptr;
+    }
+    auto* header = reinterpret_cast<ShmSegmentHeader*>(segment->data());
+    if (header->magic.load(std::memory_order_acquire) != kMagic ||
+        header->shutdown.load() ||
+        segment->size() < ShmSegmentLayout::SegmentSize(header->num_channels, header->ring_capacity)) {
+        return nullptr;
+    }
+    auto layout = std::make_unique<ShmSegmentLayout>(segment->data(), header->num_channels, header->ring_capacity);
+    for (uint32_t i = 0; i < layout->num_channels; ++i) {
+        uint32_t expected = 0;
+        if (layout->channels[i].dropped.load(std::memory_order_acquire)) {
+            continue;
+        }
+        if (layout->channels[i].claimed.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+            return std::unique_ptr<ShmChannel>(new ShmChannel(std::move(segment), std::move(layout), i));
+        }
+    }
+    return nullptr;
+}
+
+ShmChannel::ShmChannel(std::unique_ptr<ShmSegment> segment,
+                       std::unique_ptr<ShmSegmentLayout> layout, uint32_t index)
+    : segment_(std::move(segment)),
+      layout_(std::move(layout)),
+      index_(index),
+      spin_iterations_(SpinBudget(kClientSpinIterations)) {}
+
+ShmChannel::~ShmChannel() {
+    // Collect the pending responses, so that the next owner of the channel starts afresh.
+    std::string ignored;
+    while (in_flight_ > 0) {
+        Receive(&ignored);
+    }
+    layout_->channels[index_].claimed.store(0, std::memory_order_release);
+}
+
+bool ShmChannel::Send(uint16_t method_id, std::string_view request) {
+    if (Broken()) {
+        return false;
+    }
+    const RpcFrameHeader header = {
+        .payload_size = static_cast<uint32_t>(request.size()),
+        .call_id = next_call_id_,
+        .method_id = method_id,
+    };
+    if (!layout_->requests(index_).TryWrite(header, request)) {
+        return false;
+    }
+    ++next_call_id_;
+    ++in_flight_;
+    return true;
+}
+
+void ShmChannel::Flush() {
+    layout_->header->server_doorbell.Ring();
+}
+
+RpcStatus ShmChannel::Receive(std::string* response) {
+    if (in_flight_ == 0) {
+        return RpcStatus::kTransportError;
+    }
+    ShmRing responses = layout_->responses(index_);
+    ShmDoorbell& doorbell = layout_->channels[index_].client_doorbell;
+    RpcFrameHeader header;
+    for (uint32_t spins = 0;; ++spins) {
+        const ShmReadResult read = responses.TryRead(&header, response);
+        if (read == ShmReadResult::kRead) {
+            --in_flight_;
+            return static_cast<RpcStatus>(header.status);
+        }
+        if (read == ShmReadResult::kCorrupted || Broken()) {
+            in_flight_ = 0;
+            return RpcStatus::kTransportError;
+        }
+        if (spins < spin_iterations_) {
+            CpuRelax();
+            continue;
+        }
+        const uint32_t seen = doorbell.Load();
+        if (responses.Empty() && !Broken()) {
+            doorbell.Wait(seen);
+        }
+    }
+}
+
+bool ShmChannel::Broken() const {
+    return layout_->header->shutdown.load(std::memory_order_acquire) ||
+        layout_->channels[index_].dropped.load(std::memory_order_acquire);
+}
+
+RpcStatus ShmChannel::Call(uint16_t method_id, std::string_view request, std::string* response) {
+    if (!Send(method_id, request)) {
+        return RpcStatus::kTransportError;
+    }
+    Flush();
+    return Receive(response);
+}
+
+}  // namespace cppschema::rpc
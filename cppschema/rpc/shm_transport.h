@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "cppschema/common/wire_codec.h"
+#include "cppschema/rpc/rpc_dispatch.h"
+#include "cppschema/rpc/rpc_protocol.h"
+#include "cppschema/rpc/shm_ring.h"
+
+namespace cppschema::rpc {
+
+struct ShmSegmentLayout;
+
+/**
+ * A shared memory transport for the clients on the same host (Linux only). It avoids the syscall
+ * and the kernel copy per message of the socket transport.
+ *
+ * The server creates a named segment with a fixed number of channels. Each client claims a free
+ * channel, which is a pair of lock-free SPSC rings: one for the requests, one for the responses.
+ * A single server thread drains the request rings of all the channels, and dispatches them in
+ * order. Wakeups go through futexes, but only when the other side is asleep, so the batched calls
+ * (see `CallBatch`) pay no syscall per call.
+ *
+ * @note The server thread spins for a while before sleeping, trading CPU for latency.
+ */
+class ShmServer {
+public:
+    struct Options {
+        // POSIX shared memory name, like "/graph_api".
+        std::string name;
+        uint32_t num_channels = 16;
+        // Size of each ring in bytes, a power of two. The biggest message is half of it.
+        uint32_t ring_capacity = 1 << 20;
+        // Idle polls of the request rings before sleeping on the futex. Ignored on single core hosts.
+        uint32_t spin_iterations = 4096;
+    };
+
+    ShmServer(Options options, RpcHandler handler);
+    ~ShmServer();
+
+    ShmServer(const ShmServer&) = delete;
+    ShmServer& operator=(const ShmServer&) = delete;
+
+    // Creates the segment, and starts the server thread. Returns false if the segment could not
+    // be created.
+    bool Start();
+
+    // Stops the server thread, and unlinks the segment. Called by the destructor.
+    void Stop();
+
+private:
+    void Loop();
+
+    const Options options_;
+    const RpcHandler handler_;
+    std::unique_ptr<ShmSegment> segment_;
+    std::unique_ptr<ShmSegmentLayout> layout_;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
+
+/**
+ * Client side of a `ShmServer` channel. Not thread-safe, use one channel per thread.
+ *
+ * Besides the blocking `Call`, it supports pipelining: queue any number of requests with `Send`,
+ * `Flush` them, and `Receive` the responses, which arrive in the same order.
+ */
+class ShmChannel {
+public:
+    // Returns nullptr if the segment does not exist, or all its channels are in use.
+    static std::unique_ptr<ShmChannel> Connect(const std::string& name);
+
+    ~ShmChannel();
+
+    ShmChannel(const ShmChannel&) = delete;
+    ShmChannel& operator=(const ShmChannel&) = delete;
+
+    RpcStatus Call(uint16_t method_id, std::string_view request, std::string* response);
+
+    // Queues a request without waking the server. Returns false if the ring is full, or the
+    // channel was dropped by the server.
+    bool Send(uint16_t method_id, std::string_view request);
+
+    // Wakes the server, if it is asleep.
+    void Flush();
+
+    // Waits for the next response.
+    RpcStatus Receive(std::string* response);
+
+    // Number of the sent requests, with the responses not received yet.
+    uint32_t in_flight() const { return in_flight_; }
+
+private:
+    ShmChannel(std::unique_ptr<ShmSegment> segment, std::unique_ptr<ShmSegmentLayout> layout,
+               uint32_t index);
+
+    // The server shut down, or dropped this channel.
+    bool Broken() const;
+
+    std::unique_ptr<ShmSegment> segment_;
+    std::unique_ptr<ShmSegmentLayout> layout_;
+    uint32_t index_;
+    const uint32_t spin_iterations_;
+    uint32_t next_call_id_ = 1;
+    uint32_t in_flight_ = 0;
+};
+
+/**
+ * Creates a shared memory server for the backend registered in `ApiRegistry<API>`.
+ *
+ * @example
+ * auto server = CreateShmServer<GraphApi>({.name = "/graph_api"});
+ * server->Start();
+ *
+ * // Client side, with the generated stub:
+ * RpcClient<GraphApi, ShmChannel> shm(ShmChannel::Connect("/graph_api"));
+ * RpcStub<GraphApi, ShmChannel> graph{shm};
+ */
+template <typename API>
+std::unique_ptr<ShmServer> CreateShmServer(ShmServer::Options options) {
+    const RpcDispatchTable<API>& table = RpcDispatchTable<API>::Get();
+    return std::make_unique<ShmServer>(std::move(options),
+        [&table](uint16_t method_id, std::string_view request, std::string* response) {
+            return table.Dispatch(method_id, request, response);
+        });
+}
+
+/**
+ * Calls an API once per request, pipelining the calls through the ring. The server processes the
+ * whole batch with a single wakeup.
+ *
+ * @example
+ * std::vector<bool> deleted;
+ * RpcStatus status = CallBatch<GraphApi, GraphApi::deleteNode_traits>(*channel, ids, &deleted);
+ */
+template <typename API, typename Traits>
+RpcStatus CallBatch(ShmChannel& channel,
+                    const std::vector<typename Traits::RequestType>& requests,
+                    std::vector<typename Traits::ResponseType>* responses) {
+    const uint16_t method_id = RpcMethodId<API, Traits>();
+    responses->clear();
+    responses->resize(requests.size());
+    std::string buffer;
+    size_t sent = 0;
+    for (size_t received = 0; received < requests.size(); ++received) {
+        for (; sent < requests.size(); ++sent) {
+            buffer.clear();
+            WireEncodeTo(requests[sent], &buffer);
+            if (!channel.Send(method_id, buffer)) {
+                break;
+            }
+        }
+        channel.Flush();
+        if (received == sent) {
+            return RpcStatus::kTransportError;  // The request does not fit in the ring.
+        }
+        RpcStatus status = channel.Receive(&buffer);
+        typename Traits::ResponseType response{};
+        if (status == RpcStatus::kOk && !WireDecode(buffer, &response)) {
+            status = RpcStatus::kTransportError;
+        }
+        if (status != RpcStatus::kOk) {
+            // Drain the rest, to keep the channel usable.
+            while (channel.in_flight() > 0) {
+                channel.Receive(&buffer);
+            }
+            return status;
+        }
+        (*responses)[received] = std::move(response);
+    }
+    return RpcStatus::kOk;
+}
+
+}  // namespace cppschema::rpc
@@ -0,0 +1,117 @@
+// Compares the per call cost of the transports against an in-process `ApiRegistry::Call`. The
+// server runs on a separate thread of the same process, which costs the same as a separate process
+// for the shared memory transport.
+//
+// $ bazel run -c opt //cppschema/rpc:shm_transport_benchmark
+
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/visitor_macros.h"
+#include "cppschema/rpc/rpc_client.h"
+#include "cppschema/rpc/rpc_server.h"
+#include "cppschema/rpc/shm_transport.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::rpc::CallBatch;
+using ::cppschema::rpc::RpcChannel;
+using ::cppschema::rpc::RpcClient;
+using ::cppschema::rpc::RpcStatus;
+using ::cppschema::rpc::RpcStub;
+using ::cppschema::rpc::ShmChannel;
+
+struct BenchApi {
+    ApiStub<std::string, bool> deleteNode;
+
+    DEFINE_API_VISITOR_FUNCTION(deleteNode);
+};
+
+class BenchApiImpl : public cppschema::ApiBackend<BenchApi> {
+public:
+    bool deleteNodeImpl(const std::string& id) { return id.size() % 2 == 0; }
+};
+
+// Set up once, and shared by all the benchmarks.
+struct Servers {
+    std::string shm_name = "/cppschema_shm_bench_" + std::to_string(getpid());
+    std::string socket_path = "@cppschema_shm_bench_" + std::to_string(getpid());
+    std::unique_ptr<cppschema::rpc::ShmServer> shm;
+    std::unique_ptr<cppschema::rpc::RpcServer> socket;
+
+    static Servers& Get() {
+        static Servers* servers = [] {
+            cppschema::RegisterBackend<BenchApi, BenchApiImpl>(new BenchApiImpl(), {
+                .deleteNode = &BenchApiImpl::deleteNodeImpl,
+            });
+            auto* s = new Servers();
+            s->shm = cppschema::rpc::CreateShmServer<BenchApi>({.name = s->shm_name});
+            s->socket = cppschema::rpc::CreateRpcServer<BenchApi>(
+                {.socket_path = s->socket_path, .num_workers = 0});
+            if (!s->shm->Start() || !s->socket->Start()) {
+                std::abort();
+            }
+            return s;
+        }();
+        return *servers;
+    }
+};
+
+const std::string kNodeId = "FUNCTION_1000";
+
+void BM_InProcessRegistryCall(benchmark::State& state) {
+    Servers::Get();
+    auto& registry = ApiRegistry<BenchApi>::Get();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registry.Call<std::string, bool>("deleteNode", kNodeId));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InProcessRegistryCall);
+
+void BM_UnixSocketCall(benchmark::State& state) {
+    RpcClient<BenchApi> rpc(RpcChannel::Connect(Servers::Get().socket_path));
+    RpcStub<BenchApi> stub{rpc};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stub.deleteNode(kNodeId));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UnixSocketCall)->UseRealTime();
+
+void BM_ShmCall(benchmark::State& state) {
+    RpcClient<BenchApi, ShmChannel> shm(ShmChannel::Connect(Servers::Get().shm_name));
+    RpcStub<BenchApi, ShmChannel> stub{shm};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stub.deleteNode(kNodeId));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShmCall)->UseRealTime();
+
+void BM_ShmCallBatch(benchmark::State& state) {
+    std::unique_ptr<ShmChannel> channel = ShmChannel::Connect(Servers::Get().shm_name);
+    const std::vector<std::string> ids(state.range(0), kNodeId);
+    std::vector<bool> results;
+    for (auto _ : state) {
+        if (CallBatch<BenchApi, BenchApi::deleteNode_traits>(*channel, ids, &results) != RpcStatus::kOk) {
+            state.SkipWithError("Batch failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ids.size());
+}
+BENCHMARK(BM_ShmCallBatch)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
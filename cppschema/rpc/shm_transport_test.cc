@@ -0,0 +1,238 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "cppschema/common/visitor_macros.h"
+#include "cppschema/rpc/rpc_client.h"
+#include "cppschema/rpc/shm_ring.h"
+#include "cppschema/rpc/shm_transport.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::cppschema::ApiRegistry;
+using ::cppschema::ApiStub;
+using ::cppschema::rpc::CallBatch;
+using ::cppschema::rpc::CreateShmServer;
+using ::cppschema::rpc::RpcClient;
+using ::cppschema::rpc::RpcFrameHeader;
+using ::cppschema::rpc::RpcStatus;
+using ::cppschema::rpc::RpcStub;
+using ::cppschema::rpc::ShmChannel;
+using ::cppschema::rpc::ShmReadResult;
+using ::cppschema::rpc::ShmRing;
+using ::cppschema::rpc::ShmRingControl;
+using ::cppschema::rpc::ShmServer;
+
+TEST(ShmRingTest, WrapsAround) {
+    constexpr uint32_t kCapacity = 1024;
+    ShmRingControl control;
+    std::vector<char> data(kCapacity);
+    ShmRing ring(&control, data.data(), kCapacity);
+
+    RpcFrameHeader header;
+    std::string payload;
+    EXPECT_EQ(ring.TryRead(&header, &payload), ShmReadResult::kEmpty);
+    // Odd payload sizes move the records around the buffer boundary.
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const std::string sent(i % 300, static_cast<char>('a' + i % 26));
+        ASSERT_TRUE(ring.TryWrite({.call_id = i}, sent));
+        ASSERT_EQ(ring.TryRead(&header, &payload), ShmReadResult::kRead);
+        EXPECT_EQ(header.call_id, i);
+        EXPECT_EQ(payload, sent);
+    }
+    EXPECT_TRUE(ring.Empty());
+}
+
+TEST(ShmRingTest, RejectsWhenFull) {
+    constexpr uint32_t kCapacity = 1024;
+    ShmRingControl control;
+    std::vector<char> data(kCapacity);
+    ShmRing ring(&control, data.data(), kCapacity);
+
+    EXPECT_FALSE(ring.TryWrite({}, std::string(kCapacity, 'x')));
+    int written = 0;
+    while (ring.TryWrite({}, std::string(100, 'x'))) {
+        ++written;
+    }
+    EXPECT_EQ(written, kCapacity / 112);  // 12 byte header + 100 byte payload records.
+}
+
+// Writes the positions and a record header, as a hostile producer could.
+ShmReadResult ReadForged(uint64_t head, uint64_t tail, uint32_t pos, uint32_t payload_size) {
+    constexpr uint32_t kCapacity = 1024;
+    ShmRingControl control;
+    control.head = head;
+    control.tail = tail;
+    std::vector<char> data(kCapacity, 'x');
+    const RpcFrameHeader forged = {.payload_size = payload_size};
+    std::memcpy(data.data() + pos, &forged, sizeof(forged));
+    ShmRing ring(&control, data.data(), kCapacity);
+    RpcFrameHeader header;
+    std::string payload;
+    const ShmReadResult result = ring.TryRead(&header, &payload);
+    if (result != ShmReadResult::kRead) {
+        EXPECT_EQ(control.head.load(), head) << "The head does not move";
+        EXPECT_TRUE(payload.empty());
+    }
+    return result;
+}
+
+TEST(ShmRingTest, RejectsForgedRecords) {
+    EXPECT_EQ(ReadForged(0, 32, 0, 10), ShmReadResult::kRead);
+    // Over the largest payload, or past the end of the ring.
+    EXPECT_EQ(ReadForged(0, 1024, 0, 0x7fffffff), ShmReadResult::kCorrupted);
+    EXPECT_EQ(ReadForged(0, 1024, 0, 1000), ShmReadResult::kCorrupted);
+    EXPECT_EQ(ReadForged(1024 + 960, 1024 + 1008, 960, 200), ShmReadResult::kCorrupted);
+    // More than was written.
+    EXPECT_EQ(ReadForged(0, 32, 0, 100), ShmReadResult::kCorrupted);
+    // A tail behind the head, or more than the capacity ahead.
+    EXPECT_EQ(ReadForged(64, 32, 64, 10), ShmReadResult::kCorrupted);
+    EXPECT_EQ(ReadForged(0, 4096, 0, 10), ShmReadResult::kCorrupted);
+    // A misaligned head, and a wrap marker with nothing after it.
+    EXPECT_EQ(ReadForged(8, 40, 8, 10), ShmReadResult::kCorrupted);
+    EXPECT_EQ(ReadForged(1008, 1024, 1008, 0xffffffff), ShmReadResult::kCorrupted);
+}
+
+TEST(ShmRingTest, ProducerConsumerThreads) {
+    constexpr uint32_t kCapacity = 4096;
+    constexpr uint32_t kRecords = 100000;
+    ShmRingControl control;
+    std::vector<char> data(kCapacity);
+    ShmRing ring(&control, data.data(), kCapacity);
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < kRecords; ++i) {
+            const std::string payload(i % 64, 'p');
+            while (!ring.TryWrite({.call_id = i}, payload)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    RpcFrameHeader header;
+    std::string payload;
+    for (uint32_t i = 0; i < kRecords; ++i) {
+        while (ring.TryRead(&header, &payload) != ShmReadResult::kRead) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(header.call_id, i);
+        ASSERT_EQ(payload.size(), i % 64);
+    }
+    producer.join();
+}
+
+struct KvApi {
+    struct PutRequest {
+        std::string key;
+        std::string value;
+        DEFINE_STRUCT_VISITOR_FUNCTION(key, value);
+    };
+
+    ApiStub<PutRequest, bool> put;
+    ApiStub<std::string, std::string> get;
+
+    DEFINE_API_VISITOR_FUNCTION(put, get);
+};
+
+// Only the server thread calls the backend, so it needs no locking.
+class KvApiImpl : public cppschema::ApiBackend<KvApi> {
+public:
+    bool putImpl(const KvApi::PutRequest& req) {
+        return data_.insert_or_assign(req.key, req.value).second;
+    }
+
+    std::string getImpl(const std::string& key) {
+        auto it = data_.find(key);
+        return it == data_.end() ? "" : it->second;
+    }
+
+private:
+    std::map<std::string, std::string> data_;
+};
+
+class ShmTransportTest : public testing::Test {
+protected:
+    void SetUp() override {
+        cppschema::RegisterBackend<KvApi, KvApiImpl>(new KvApiImpl(), {
+            .put = &KvApiImpl::putImpl,
+            .get = &KvApiImpl::getImpl,
+        });
+        name_ = "/cppschema_shm_test_" + std::to_string(getpid());
+        server_ = CreateShmServer<KvApi>({.name = name_, .num_channels = 4, .ring_capacity = 1 << 16});
+        ASSERT_TRUE(server_->Start());
+    }
+
+    void TearDown() override {
+        server_.reset();
+        ApiRegistry<KvApi>::Get().Clear();
+    }
+
+    std::string name_;
+    std::unique_ptr<ShmServer> server_;
+};
+
+TEST_F(ShmTransportTest, GeneratedStub) {
+    RpcClient<KvApi, ShmChannel> shm(ShmChannel::Connect(name_));
+    ASSERT_TRUE(shm.connected());
+    RpcStub<KvApi, ShmChannel> kv{shm};
+
+    EXPECT_EQ(kv.put({.key = "a", .value = "1"}), true);
+    EXPECT_EQ(kv.put({.key = "a", .value = "2"}), false);
+    EXPECT_EQ(kv.get("a"), "2");
+    EXPECT_EQ(kv.get("b"), "");
+}
+
+TEST_F(ShmTransportTest, BatchLargerThanRing) {
+    std::unique_ptr<ShmChannel> channel = ShmChannel::Connect(name_);
+    ASSERT_NE(channel, nullptr);
+
+    std::vector<KvApi::PutRequest> puts;
+    for (int i = 0; i < 10000; ++i) {
+        puts.push_back({.key = "key" + std::to_string(i), .value = std::to_string(i)});
+    }
+    std::vector<bool> inserted;
+    ASSERT_EQ((CallBatch<KvApi, KvApi::put_traits>(*channel, puts, &inserted)), RpcStatus::kOk);
+    ASSERT_EQ(inserted.size(), puts.size());
+    EXPECT_TRUE(inserted.front());
+    EXPECT_TRUE(inserted.back());
+
+    std::vector<std::string> keys = {"key0", "key9999", "missing"};
+    std::vector<std::string> values;
+    ASSERT_EQ((CallBatch<KvApi, KvApi::get_traits>(*channel, keys, &values)), RpcStatus::kOk);
+    EXPECT_EQ(values, std::vector<std::string>({"0", "9999", ""}));
+}
+
+TEST_F(ShmTransportTest, ChannelsAreReleased) {
+    std::vector<std::unique_ptr<ShmChannel>> channels;
+    for (int i = 0; i < 4; ++i) {
+        channels.push_back(ShmChannel::Connect(name_));
+        ASSERT_NE(channels.back(), nullptr);
+    }
+    EXPECT_EQ(ShmChannel::Connect(name_), nullptr);
+    channels.pop_back();
+    EXPECT_NE(ShmChannel::Connect(name_), nullptr);
+}
+
+TEST_F(ShmTransportTest, UnknownMethod) {
+    std::unique_ptr<ShmChannel> channel = ShmChannel::Connect(name_);
+    std::string response;
+    EXPECT_EQ(channel->Call(7, "", &response), RpcStatus::kUnknownMethod);
+}
+
+TEST_F(ShmTransportTest, ServerShutdownFailsPendingCalls) {
+    std::unique_ptr<ShmChannel> channel = ShmChannel::Connect(name_);
+    ASSERT_NE(channel, nullptr);
+    server_.reset();
+    std::string response;
+    EXPECT_EQ(channel->Call(1, "", &response), RpcStatus::kTransportError);
+}
+
+}  // namespace
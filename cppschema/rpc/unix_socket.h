@@ -0,0 +1,21 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <cstddef>
+#include <string>
+
+namespace cppschema::rpc::internal {
+
+// Fills the socket address for `path`. A leading '@' denotes the Linux abstract namespace, which
+// needs no filesystem cleanup. Returns false if the path is too long.
+bool MakeUnixAddress(const std::string& path, sockaddr_un* addr, socklen_t* addr_len);
+
+bool SetNonBlocking(int fd);
+
+// Blocking helpers, retry on partial transfers and EINTR.
+bool WriteFully(int fd, const void* data, size_t size);
+bool ReadFully(int fd, void* data, size_t size);
+
+}  // namespace cppschema::rpc::internal
@@ -0,0 +1,60 @@
+#include "cppschema/testing/alloc_counter.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local int64_t thread_allocations = 0;
+
+void* CountedAlloc(std::size_t size) {
+    ++thread_allocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* CountedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    ++thread_allocations;
+    const auto alignment = static_cast<std::size_t>(align);
+    // `aligned_alloc` needs the size to be a multiple of the alignment.
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+namespace cppschema::testing {
+
+int64_t AllocationCounter::ThreadAllocations() {
+    return thread_allocations;
+}
+
+}  // namespace cppschema::testing
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    ++thread_allocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    ++thread_allocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace cppschema::testing {
+
+/**
+ * Counts the heap allocations (`operator new`) made by the current thread while in scope. Linking
+ * the `alloc_counter` library replaces the global `operator new` and `operator delete`, so this is
+ * only meant for the tests guarding the allocation free paths.
+ *
+ * @example
+ * AllocationCounter counter;
+ * ASSERT_TRUE(registry.TryCall<Req, Res>("addNode", req, &res).ok());
+ * EXPECT_EQ(counter.count(), 0);
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() : start_(ThreadAllocations()) {}
+
+    int64_t count() const { return ThreadAllocations() - start_; }
+
+    // The number of allocations made by the current thread so far.
+    static int64_t ThreadAllocations();
+
+private:
+    int64_t start_;
+};
+
+}  // namespace cppschema::testing
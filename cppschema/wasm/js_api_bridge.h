@@ -6,18 +6,31 @@
 #include <emscripten/val.h>
 
 #include "cppschema/apispec/api_framework.h"
+#include "cppschema/apispec/api_policies.h"
 #include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/call_recorder.h"
+#include "cppschema/apispec/task.h"
+#include "cppschema/common/enum_registry.h"
+#include "cppschema/common/heap_stats.h"
+#include "cppschema/common/request_limits.h"
+#include "cppschema/common/status.h"
+#include "cppschema/common/trace.h"
 #include "cppschema/common/visitor_macros.h"
 #include "cppschema/wasm/js_converter.h"
+#include "cppschema/wasm/js_crossings.h"
+#include "cppschema/wasm/js_task.h"
+#include "cppschema/wasm/js_value_object.h"
 
 namespace cppschema::jsbridge {
 
+// The shape of the JS responses. The dispatch builds them directly (see `ResponseToJS`), without
+// copying the data into this struct.
 template <typename T>
 struct ApiResponseOrError {
     // std::optional<T> data;
     T data;
     bool ok = false;
-    // Can be "OK", or error message.
+    // Either "ok", or the error as "<CODE>: <message>", like "NOT_FOUND: No such node".
     std::string status;
 
     DEFINE_STRUCT_VISITOR_FUNCTION(data, ok, status);
@@ -35,9 +48,36 @@ struct ApiInfo {
     DEFINE_STRUCT_VISITOR_FUNCTION(name, req, resp);
 };
 
-template <typename API>
+// The heap changes of an api, see `ApiHeapStats`. Numbers rather than BigInts, for JS arithmetic.
+struct ApiHeapInfo {
+    double calls = 0;
+    double maxGrowthBytes = 0;
+    double netBytes = 0;
+    double peakLiveBytes = 0;
+    double reservedGrowthBytes = 0;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(calls, maxGrowthBytes, netBytes, peakLiveBytes, reservedGrowthBytes);
+};
+
+// This is surfaced to JS via the `heapStats` property, see `HeapAccounting`.
+struct HeapInfo {
+    // The current heap.
+    double liveBytes = 0;
+    double reservedBytes = 0;
+    // The largest live bytes sampled around the calls.
+    double peakLiveBytes = 0;
+    // By api name, for the apis of the class which were called with the accounting enabled.
+    std::map<std::string, ApiHeapInfo> apis;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(liveBytes, reservedBytes, peakLiveBytes, apis);
+};
+
+// The JS class of an API. One per engine, as embind binds a C++ type once.
+template <typename API, JsEngine kEngine = JsEngine::kVal>
 struct EmClazz {
     std::map<std::string, ApiInfo> api_infos;  // Collected api infos.
+    // The status of the last call of the object to a method with `NoStatusWrapper`.
+    Status last_status;
 
     static EmClazz& Get() {
         static EmClazz instance;
@@ -56,11 +96,267 @@ struct EmClazz {
         }
         return arr;
     }
+
+    emscripten::val getHeapStatsAsJsVal() const {
+        const auto& api_infos = EmClazz::Get().api_infos;
+        const HeapSample sample = SampleHeap();
+        HeapInfo info{
+            .liveBytes = static_cast<double>(sample.live_bytes),
+            .reservedBytes = static_cast<double>(sample.reserved_bytes),
+            .peakLiveBytes = static_cast<double>(HeapAccounting::Get().peak_live_bytes()),
+        };
+        for (const auto& [name, stats] : HeapAccounting::Get().GetStats()) {
+            if (api_infos.contains(name)) {
+                info.apis[name] = ApiHeapInfo{
+                    .calls = static_cast<double>(stats.calls),
+                    .maxGrowthBytes = static_cast<double>(stats.max_growth_bytes),
+                    .netBytes = static_cast<double>(stats.net_bytes),
+                    .peakLiveBytes = static_cast<double>(stats.peak_live_bytes),
+                    .reservedGrowthBytes = static_cast<double>(stats.reserved_growth_bytes),
+                };
+            }
+        }
+        return JSConverter<HeapInfo>::toJS(info);
+    }
+
+    emscripten::val getLastStatusAsJsVal() const {
+        return emscripten::val(last_status.ok() ? "ok" : last_status.ToString());
+    }
 };
 
-template <typename API>
+// Returns `{data, ok, status}`, see `ApiResponseOrError`.
+inline emscripten::val ResponseToJS(emscripten::val data, const Status& status) {
+    static const emscripten::val* const okString = new emscripten::val("ok");
+    CPPSCHEMA_COUNT_CROSSINGS(kCreate, Status, status.ok() ? 2 : 3);
+    CPPSCHEMA_COUNT_CROSSINGS(kSet, Status, 3);
+    emscripten::val obj = emscripten::val::object();
+    obj.set("data", std::move(data));
+    obj.set("ok", status.ok());
+    obj.set("status", status.ok() ? *okString : emscripten::val(status.ToString()));
+    return obj;
+}
+
+// Same, with the converted data. A null data is reported as the default value.
+template <typename Res>
+emscripten::val ResponseToJS(const Res* data, const Status& status) {
+    return ResponseToJS(data != nullptr ? JSConverter<Res>::toJS(*data) : JSConverter<Res>::toJS(Res{}),
+        status);
+}
+
+// Same, as a value object (see `JsEngine::kValueObject`). Moves the data.
+template <typename Res>
+emscripten::val ValueObjectResponseToJS(Res* data, const Status& status) {
+    CPPSCHEMA_COUNT_CROSSINGS(kCreate, Status, 1);
+    return emscripten::val(ApiResponseOrError<Res>{
+        .data = data != nullptr ? std::move(*data) : Res{},
+        .ok = status.ok(),
+        .status = status.ok() ? "ok" : status.ToString(),
+    });
+}
+
+template <JsEngine kEngine, typename Res>
+emscripten::val EncodeResponse(Res* data, const Status& status) {
+    if constexpr (kEngine == JsEngine::kValueObject) {
+        return ValueObjectResponseToJS(data, status);
+    } else {
+        return ResponseToJS<Res>(data, status);
+    }
+}
+
+// The JS result of a call to the api of `Traits`: `{data, ok, status}`, or with `NoStatusWrapper`
+// the data alone, or `undefined` on failure, with the status in `*last_status`.
+template <typename Traits, JsEngine kEngine>
+emscripten::val EncodeResult(typename Traits::ResponseType* data, const Status& status, Status* last_status) {
+    using Res = typename Traits::ResponseType;
+    if constexpr (kHasPolicy<Traits, NoStatusWrapper>) {
+        *last_status = status;
+        if (!status.ok()) {
+            return emscripten::val::undefined();
+        }
+        if constexpr (kEngine == JsEngine::kValueObject) {
+            return ValueObjectConverter<Res>::toJS(*data);
+        } else {
+            return JSConverter<Res>::toJS(*data);
+        }
+    } else {
+        return EncodeResponse<kEngine, Res>(data, status);
+    }
+}
+
+// Settles the promise of a failed async call, with `{data, ok, status}`, or with `NoStatusWrapper`
+// by rejecting it with an `Error` of the status.
+template <typename Traits, JsEngine kEngine>
+void SettleFailure(const emscripten::val& deferred, const Status& status) {
+    if constexpr (kHasPolicy<Traits, NoStatusWrapper>) {
+        deferred.call<void>("reject", emscripten::val::global("Error").new_(status.ToString()));
+    } else {
+        deferred.call<void>("resolve", EncodeResponse<kEngine, typename Traits::ResponseType>(nullptr, status));
+    }
+}
+
+// With `kSkipDefaults` (see `SkipMissingFieldDefaults`), the properties of a struct request are
+// converted without checking for the missing ones.
+template <JsEngine kEngine, typename Req, bool kSkipDefaults = false>
+Req DecodeRequest(const emscripten::val& jsArgs) {
+    if constexpr (kSkipDefaults && internal::is_visible_struct_like<Req>::value) {
+        if constexpr (kEngine == JsEngine::kValueObject) {
+            // Embind rejects the missing properties itself.
+            CPPSCHEMA_COUNT_CROSSINGS(kAs, Req, 1);
+            return jsArgs.template as<Req>();
+        } else {
+            Req req;
+            auto lambda = [&jsArgs]<typename T>(const char* name, T& field) -> void {
+                CPPSCHEMA_COUNT_CROSSINGS(kGet, Req, 1);
+                field = JSConverter<T>::fromJS(jsArgs[name]);
+            };
+            req._visit_members(lambda);
+            return req;
+        }
+    } else if constexpr (kEngine == JsEngine::kValueObject) {
+        return ValueObjectConverter<Req>::fromJS(jsArgs);
+    } else {
+        return JSConverter<Req>::fromJS(jsArgs);
+    }
+}
+
+// Decodes one property of a JS request, for a `RequestView` of it. `source` is the JS request.
+template <JsEngine kEngine, typename Req, bool kSkipDefaults = false>
+Status DecodeRequestField(const void* source, size_t index, Req* req) {
+    const emscripten::val& jsArgs = *static_cast<const emscripten::val*>(source);
+    Status status;
+    ConversionErrorScope scope(&status);
+    size_t i = 0;
+    auto lambda = [&]<typename T>(const char* name, T& field) -> void {
+        if (i++ != index) {
+            return;
+        }
+        // A missing (or undefined) property leaves the member default initialized.
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, Req, 1);
+        emscripten::val property = jsArgs[name];
+        if constexpr (kSkipDefaults) {
+            field = DecodeRequest<kEngine, T>(property);
+        } else {
+            CPPSCHEMA_COUNT_CROSSINGS(kCheck, Req, 1);
+            if (!property.isUndefined()) {
+                field = DecodeRequest<kEngine, T>(property);
+            }
+        }
+    };
+    req->_visit_members(lambda);
+    return status;
+}
+
+// True for the array responses converted element by element, which are streamed when the backend
+// method writes to an `ArraySink`. The others are converted in bulk from the vector.
+template <typename Res>
+constexpr bool StreamsToJS() {
+    if constexpr (internal::is_array_like<Res>::value) {
+        return JSConverter<Res>::kPerElement;
+    }
+    return false;
+}
+
+// Converts the elements of a streamed array response (see `ArraySink`) as they are emitted.
+template <typename T>
+class JsArraySink final : public ArraySink<T> {
+public:
+    void Append(T&& item) override {
+        CPPSCHEMA_COUNT_CROSSINGS(kSet, std::vector<T>, 1);
+        array_.set(size_++, JSConverter<T>::toJS(item));
+    }
+    using ArraySink<T>::Append;
+
+    const emscripten::val& array() const { return array_; }
+
+private:
+    emscripten::val array_ = [] {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, std::vector<T>, 1);
+        return emscripten::val::array();
+    }();
+    uint32_t size_ = 0;
+};
+
+// Calls a coroutine backend method (see `Task`), one with a batch handler (see
+// `RegisterBatchMethod`), or any method of an `Async` api, and returns a promise of its
+// `{data, ok, status}` response. The method runs until it first suspends, then resumes as what it
+// awaits completes (e.g. from the JS microtasks of `AwaitJs`), interleaved with the other calls.
+template <typename API, typename Traits, JsEngine kEngine = JsEngine::kVal>
+emscripten::val CallAsyncToJS(const emscripten::val& jsArgs) {
+    using Req = typename Traits::RequestType;
+    using Res = typename Traits::ResponseType;
+    const char* name = Traits::name;
+    emscripten::val deferred = internal::MakeDeferred();
+    Status status;
+    {
+        ConversionErrorScope scope(&status);
+        Req req = [&] {
+            DecodeBudget budget(ApiRegistry<API>::Get().GetRequestLimits(name));
+            return DecodeRequest<kEngine, Req, kHasPolicy<Traits, SkipMissingFieldDefaults>>(jsArgs);
+        }();
+        if (status.ok()) {
+            TaskScheduler::Get().Spawn(ApiRegistry<API>::Get().template TryCallAsync<Req, Res>(name, std::move(req)),
+                [name, deferred](Expected<Res> res) {
+                    CrossingScope crossings(name);
+                    Status status = res.has_value() ? OkStatus() : std::move(res).error();
+                    emscripten::val jsResponse;
+                    if (status.ok()) {
+                        ConversionErrorScope scope(&status);
+                        Status last_status;
+                        jsResponse = EncodeResult<Traits, kEngine>(&*res, status, &last_status);
+                    }
+                    if (status.ok()) {
+                        deferred.call<void>("resolve", jsResponse);
+                    } else {
+                        SettleFailure<Traits, kEngine>(deferred, status);
+                    }
+                });
+        }
+    }
+    if (status.ok()) {
+        RunTasks();
+    } else {
+        SettleFailure<Traits, kEngine>(deferred, status);
+    }
+    return deferred["promise"];
+}
+
+// Calls a backend method taking a `RequestView`, which converts only the properties of the JS
+// request that the method reads.
+template <typename API, typename Traits, JsEngine kEngine = JsEngine::kVal>
+emscripten::val CallWithViewToJS(const emscripten::val& jsArgs, Status* last_status) {
+    using Req = typename Traits::RequestType;
+    using Res = typename Traits::ResponseType;
+    using Span = trace::Span<kHasPolicy<Traits, Trace>>;
+    const char* name = Traits::name;
+    Span callSpan(name, trace::kCall);
+    const RequestView<Req> view(
+        &DecodeRequestField<kEngine, Req, kHasPolicy<Traits, SkipMissingFieldDefaults>>, &jsArgs);
+    Res data{};
+    Status status;
+    {
+        // The properties are decoded as the method reads them.
+        DecodeBudget budget(ApiRegistry<API>::Get().GetRequestLimits(name));
+        status = ApiRegistry<API>::Get().template TryCallView<Req, Res>(name, view, &data);
+    }
+    emscripten::val jsResponse;
+    if (status.ok()) {
+        ConversionErrorScope scope(&status);
+        Span span(name, trace::kEncode, trace::PayloadSize(data));
+        jsResponse = EncodeResult<Traits, kEngine>(&data, status, last_status);
+    }
+    return status.ok() ? jsResponse : EncodeResult<Traits, kEngine>(nullptr, status, last_status);
+}
+
+/**
+ * Binds each api of `API` as a method of the JS class, with its dispatch specialized at compile
+ * time for the policies of the api (see api_policies.h): `Async` and `Batchable` always return a
+ * promise, `NoStatusWrapper` returns the data alone, `SkipMissingFieldDefaults` converts the
+ * request without checking for the missing properties, and `Trace` records the spans of the
+ * call even without CPPSCHEMA_TRACING.
+ */
+template <typename API, JsEngine kEngine = JsEngine::kVal>
 struct JsDispatchVisitor {
-    using ApiClazz = EmClazz<API>;
+    using ApiClazz = EmClazz<API, kEngine>;
     emscripten::class_<ApiClazz> clazz;
 
     JsDispatchVisitor(const std::string& alias) : clazz(alias.c_str()) {
@@ -69,50 +365,263 @@ struct JsDispatchVisitor {
 
     ~JsDispatchVisitor() {
         clazz.property("apis", &ApiClazz::getApiInfosAsJsVal);
+        clazz.property("heapStats", &ApiClazz::getHeapStatsAsJsVal);
+        clazz.property("lastStatus", &ApiClazz::getLastStatusAsJsVal);
     }
 
     template <typename Traits>
     void operator()(Traits traits) {
-        std::string methodName = Traits::name;
+        const char* methodName = Traits::name;
         ApiClazz::Get().addApiInfo({
             .name = methodName,
             .req = typeid(typename Traits::RequestType).name(),
             .resp = typeid(typename Traits::ResponseType).name()
         });
+        if constexpr (kEngine == JsEngine::kValueObject) {
+            internal::RegisterValueObjectsOf<typename Traits::RequestType>();
+            if constexpr (kHasPolicy<Traits, NoStatusWrapper>) {
+                internal::RegisterValueObjectsOf<typename Traits::ResponseType>();
+            } else {
+                RegisterValueObject<ApiResponseOrError<typename Traits::ResponseType>>();
+            }
+        }
 
-        clazz.function(methodName.c_str(), emscripten::optional_override(
+        clazz.function(methodName, emscripten::optional_override(
                 [](ApiClazz& self, emscripten::val jsArgs) -> emscripten::val {
             using Req = typename Traits::RequestType;
             using Res = typename Traits::ResponseType;
+            using Span = trace::Span<kHasPolicy<Traits, Trace>>;
             const char* name = Traits::name;
+            CrossingScope crossings(name);
+            HeapCallScope heap(name);
+            if constexpr (kHasPolicy<Traits, Async> || kHasPolicy<Traits, Batchable>) {
+                // Without looking up the method.
+                return CallAsyncToJS<API, Traits, kEngine>(jsArgs);
+            }
+            if (ApiRegistry<API>::Get().IsAsync(name)) [[unlikely]] {
+                return CallAsyncToJS<API, Traits, kEngine>(jsArgs);
+            }
+            if constexpr (internal::is_visible_struct_like<Req>::value) {
+                if (ApiRegistry<API>::Get().TakesView(name)) [[unlikely]] {
+                    return CallWithViewToJS<API, Traits, kEngine>(jsArgs, &self.last_status);
+                }
+            }
+            Span callSpan(name, trace::kCall);
 
-            ApiResponseOrError<Res> response;
-            Req cppReq = JSConverter<Req>::fromJS(jsArgs);
-            // Dispatch to  Registry. Looks up the type-erased handler to execute backend logic.
-            response.data = ApiRegistry<API>::Get().template Call<Req, Res>(name, cppReq);
-            response.ok = true;
-            response.status = "ok";
-            // TODO: Handle error.
-            if (false) {
-                // Handle logic errors or missing backend registration
-                response.ok = false;
-                response.status = "Error message here";
+            Res data{};
+            Status status;
+            emscripten::val jsResponse;
+            {
+                // Conversion errors fail the call, instead of aborting the module.
+                ConversionErrorScope scope(&status);
+                const Req cppReq = [&] {
+                    Span span(name, trace::kDecode);
+                    DecodeBudget budget(ApiRegistry<API>::Get().GetRequestLimits(name));
+                    Req req = DecodeRequest<kEngine, Req, kHasPolicy<Traits, SkipMissingFieldDefaults>>(jsArgs);
+                    span.set_payload_size(trace::PayloadSize(req));
+                    return req;
+                }();
+                auto& registry = ApiRegistry<API>::Get();
+                bool streamed = false;
+                if constexpr (StreamsToJS<Res>()) {
+                    if (status.ok() && registry.IsStreaming(name)) {
+                        // The elements go straight into the JS array, without the `data` vector. They
+                        // are converted within the backend span.
+                        JsArraySink<typename Res::value_type> sink;
+                        status = registry.template TryStream<Req, Res>(name, cppReq, &sink);
+                        heap.Sample();
+                        if constexpr (kHasPolicy<Traits, NoStatusWrapper>) {
+                            self.last_status = status;
+                            jsResponse = status.ok() ? sink.array() : emscripten::val::undefined();
+                        } else {
+                            jsResponse = ResponseToJS(sink.array(), status);
+                        }
+                        streamed = true;
+                    }
+                }
+                if (status.ok() && !streamed) {
+                    // Dispatch to Registry. Looks up the type-erased handler to execute backend logic.
+                    status = registry.template TryCall<Req, Res>(name, cppReq, &data);
+                    // The request and the response are both allocated.
+                    heap.Sample();
+                    if (status.ok()) {
+                        // Convert C++ Response -> JS Object
+                        Span span(name, trace::kEncode, trace::PayloadSize(data));
+                        jsResponse = EncodeResult<Traits, kEngine>(&data, status, &self.last_status);
+                    }
+                }
+            }
+            if (!status.ok()) {
+                // The call, or the conversion of the response, failed. Report that without the data.
+                return EncodeResult<Traits, kEngine>(nullptr, status, &self.last_status);
             }
-            // 4. Convert C++ Response Struct -> JS Object
-            return JSConverter<ApiResponseOrError<Res>>::toJS(response);
+            return jsResponse;
         }));
     }
 };
 
 /**
- * The entry point for Emscripten bindings.
+ * The entry point for Emscripten bindings. The engine (see `JsEngine`) does not change what JS
+ * sees, so an API may be bound with both, under two aliases, to compare them.
+ *
+ * @example
+ * EMSCRIPTEN_BINDINGS(my_app) {
+ *     jsbridge::CreateJsApiMethods<GraphApi>("GraphApi");
+ *     jsbridge::CreateJsApiMethods<GraphApi, jsbridge::JsEngine::kValueObject>("GraphApiValueObject");
+ * }
  */
-template <typename API>
+template <typename API, JsEngine kEngine = JsEngine::kVal>
 void CreateJsApiMethods(const std::string& alias) {
     API skeleton;
     // Drive the visitor to attach methods to the JS object
-    JsDispatchVisitor<API> visitor(alias);
+    JsDispatchVisitor<API, kEngine> visitor(alias);
     skeleton._visit_traits(visitor);
 }
 
+// The enumerator names of all the registered enums, as `{TypeName: [names by ordinal]}`.
+inline emscripten::val EnumNamesToJS() {
+    static const emscripten::val* const tables = []{
+        auto* tables = new emscripten::val(emscripten::val::object());
+        for (const auto& [type, names] : EnumRegistry::instance().allNames()) {
+            emscripten::val table = emscripten::val::array();
+            for (const auto& [ordinal, name] : names.values) {
+                table.set(ordinal, name);
+            }
+            tables->set(names.type_name, table);
+        }
+        return tables;
+    }();
+    return *tables;
+}
+
+/**
+ * Exports the enumerator names, for the enums sent as ordinals (see DEFINE_ENUM_ORDINAL_TRANSFER).
+ * Call it once in the bindings, then JS can map the ordinals to names when it needs them.
+ *
+ * @example
+ * EMSCRIPTEN_BINDINGS(my_app) {
+ *     jsbridge::ExportEnumNames();
+ * }
+ * // JS: const {NodeTypeEnum} = mod.enumNames();  NodeTypeEnum[node.node_type] === "FUNCTION"
+ */
+inline void ExportEnumNames(const char* name = "enumNames") {
+    emscripten::function(name, &EnumNamesToJS);
+}
+
+/**
+ * Exports the tracing controls (see cppschema/common/trace.h). Without CPPSCHEMA_TRACING, the
+ * spans are those of the APIs with the `Trace` policy (see cppschema/apispec/api_policies.h).
+ *
+ * @example
+ * EMSCRIPTEN_BINDINGS(my_app) {
+ *     jsbridge::ExportTracing();
+ * }
+ * // JS: mod.setTraceSampling(10);  fs.writeFileSync("trace.json", mod.exportChromeTrace());
+ */
+inline void ExportTracing() {
+    emscripten::function("exportChromeTrace", &trace::ExportChromeTrace);
+    emscripten::function("setTraceSampling", &trace::SetSampling);
+    emscripten::function("clearTrace", &trace::ClearTrace);
+}
+
+/**
+ * Exports `allocBlob(size)`, which returns the handle of a new blob (see js_blob.h) for JS to fill
+ * and pass in a request, and `liveBlobCount()`, the number of the handles not yet released.
+ *
+ * @example
+ * EMSCRIPTEN_BINDINGS(my_app) {
+ *     jsbridge::ExportBlobs();
+ * }
+ * // JS: const blob = mod.allocBlob(file.length);  blob.bytes.set(file);  api.upload({blob});
+ * //     blob.release();
+ */
+inline void ExportBlobs() {
+    emscripten::function("allocBlob", &internal::AllocBlobToJS);
+    emscripten::function("liveBlobCount", &internal::LiveBlobCount);
+}
+
+inline CallRecorder*& JsCallRecorder() {
+    static CallRecorder* recorder = nullptr;
+    return recorder;
+}
+
+// Starts recording the API calls, discarding a recording in progress.
+inline void StartCallRecording() {
+    SetCallRecorder(nullptr);
+    delete JsCallRecorder();
+    JsCallRecorder() = new CallRecorder();
+    SetCallRecorder(JsCallRecorder());
+}
+
+// Stops the recording, and returns its log as a Uint8Array (empty if none was started).
+inline emscripten::val StopCallRecording() {
+    SetCallRecorder(nullptr);
+    if (JsCallRecorder() == nullptr) {
+        return emscripten::val::global("Uint8Array").new_(0);
+    }
+    const std::string log = JsCallRecorder()->TakeLog();
+    delete JsCallRecorder();
+    JsCallRecorder() = nullptr;
+    // A copy, the view is only valid until the memory grows.
+    return emscripten::val(emscripten::typed_memory_view(log.size(),
+        reinterpret_cast<const uint8_t*>(log.data()))).call<emscripten::val>("slice");
+}
+
+/**
+ * Exports the recording of the API calls (see cppschema/apispec/call_recorder.h), for replaying
+ * the calls of a real session natively, e.g. with //example:graph_replay.
+ *
+ * @example
+ * EMSCRIPTEN_BINDINGS(my_app) {
+ *     jsbridge::ExportCallRecording();
+ * }
+ * // JS: mod.startCallRecording();  ...  fs.writeFileSync("calls.log", mod.stopCallRecording());
+ */
+inline void ExportCallRecording() {
+    emscripten::function("startCallRecording", &StartCallRecording);
+    emscripten::function("stopCallRecording", &StopCallRecording);
+}
+
+/**
+ * Exports the crossing counters (see js_crossings.h), when built with
+ * CPPSCHEMA_WASM_COUNT_CROSSINGS. Counting starts with this call.
+ *
+ * @example
+ * EMSCRIPTEN_BINDINGS(my_app) {
+ *     jsbridge::ExportCrossingCounts();
+ * }
+ * // JS: mod.resetCrossingCounts();  api.addNode(node);  mod.crossingCounts().addNode.total
+ */
+inline void ExportCrossingCounts() {
+    if constexpr (kCountCrossings) {
+        internal::count_crossings = true;
+        emscripten::function("crossingCounts", &CrossingCountsToJS);
+        emscripten::function("resetCrossingCounts", &ResetCrossingCounts);
+    }
+}
+
+inline void SetHeapAccounting(bool enabled) {
+    HeapAccounting::Get().SetEnabled(enabled);
+}
+
+inline void ResetHeapStats() {
+    HeapAccounting::Get().Reset();
+}
+
+/**
+ * Exports the controls of the heap accounting (see cppschema/common/heap_stats.h). It stays off,
+ * as it walks the heap around each call, until JS starts it with `setHeapAccounting(true)`. The
+ * API classes then report the heap changes of their methods in their `heapStats` property.
+ *
+ * @example
+ * EMSCRIPTEN_BINDINGS(my_app) {
+ *     jsbridge::ExportHeapStats();
+ * }
+ * // JS: mod.setHeapAccounting(true);  api.addNode(node);  api.heapStats.apis.addNode.maxGrowthBytes
+ */
+inline void ExportHeapStats() {
+    emscripten::function("setHeapAccounting", &SetHeapAccounting);
+    emscripten::function("resetHeapStats", &ResetHeapStats);
+}
+
 }  // namespace cppschema::jsbridge
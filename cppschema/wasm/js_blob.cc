@@ -0,0 +1,137 @@
+#include "cppschema/wasm/js_blob.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <emscripten/em_js.h>
+#include <emscripten/emscripten.h>
+
+#include "cppschema/wasm/js_converter.h"
+#include "cppschema/wasm/js_crossings.h"
+
+namespace cppschema::jsbridge::internal {
+
+namespace {
+
+// The blobs referenced by the JS handles. The wasm builds are single threaded, see
+// js_string_array.cc.
+class JsBlobTable {
+public:
+    static JsBlobTable& Get() {
+        static JsBlobTable* table = new JsBlobTable();
+        return *table;
+    }
+
+    uint32_t Add(Blob blob) {
+        const uint32_t id = next_id_++;
+        blobs_.emplace(id, std::move(blob));
+        return id;
+    }
+
+    const Blob* Find(uint32_t id) const {
+        auto it = blobs_.find(id);
+        return it != blobs_.end() ? &it->second : nullptr;
+    }
+
+    void Release(uint32_t id) { blobs_.erase(id); }
+
+    size_t size() const { return blobs_.size(); }
+
+private:
+    // Zero is not an id, so that a missing id never matches.
+    uint32_t next_id_ = 1;
+    std::unordered_map<uint32_t, Blob> blobs_;
+};
+
+}  // namespace
+
+}  // namespace cppschema::jsbridge::internal
+
+extern "C" EMSCRIPTEN_KEEPALIVE void cppschema_blob_release(uint32_t id) {
+    cppschema::jsbridge::internal::JsBlobTable::Get().Release(id);
+}
+
+EM_JS_DEPS(cppschema_blob, "$Emval");
+
+// Returns a handle of the blob `id`, see js_blob.h.
+EM_JS(EM_VAL, cppschema_blob_to_js, (uint32_t id, const uint8_t* data, size_t size), {
+    Module.cppschemaBlobFinalizer ??= new FinalizationRegistry((id) => _cppschema_blob_release(id));
+    const handle = {
+        id,
+        size,
+        get bytes() {
+            return id === 0 ? undefined : HEAPU8.subarray(data, data + size);
+        },
+        release() {
+            if (id !== 0) {
+                Module.cppschemaBlobFinalizer.unregister(handle);
+                _cppschema_blob_release(id);
+                id = 0;
+            }
+        },
+    };
+    Module.cppschemaBlobFinalizer.register(handle, id, handle);
+    return Emval.toHandle(handle);
+});
+
+// Returns the id of a blob handle (0 if released), -1 for a `Uint8Array`, and -2 otherwise. Sets
+// `*size` to the size in bytes.
+EM_JS(double, cppschema_blob_from_js, (EM_VAL handle, uint32_t* size), {
+    const value = Emval.toValue(handle);
+    if (value instanceof Uint8Array) {
+        HEAPU32[size >> 2] = value.length;
+        return -1;
+    }
+    if (value !== null && typeof value === 'object' && typeof value.release === 'function' &&
+        typeof value.id === 'number') {
+        HEAPU32[size >> 2] = value.size;
+        return value.id;
+    }
+    return -2;
+});
+
+EM_JS(void, cppschema_blob_copy_from_js, (EM_VAL handle, uint8_t* data), {
+    HEAPU8.set(Emval.toValue(handle), data);
+});
+
+namespace cppschema::jsbridge::internal {
+
+emscripten::val BlobToJS(const Blob& blob) {
+    CPPSCHEMA_COUNT_CROSSINGS(kCall, Blob, 1);
+    const uint32_t id = JsBlobTable::Get().Add(blob);
+    return emscripten::val::take_ownership(cppschema_blob_to_js(id, blob.data(), blob.size()));
+}
+
+Blob BlobFromJS(const emscripten::val& v) {
+    CPPSCHEMA_COUNT_CROSSINGS(kCall, Blob, 1);
+    uint32_t size = 0;
+    const double id = cppschema_blob_from_js(v.as_handle(), &size);
+    if (id == -1) {
+        // Copied once, straight into the blob.
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, Blob, 1);
+        Blob blob = Blob::Allocate(size);
+        cppschema_blob_copy_from_js(v.as_handle(), blob.mutable_data());
+        return blob;
+    }
+    if (id < 0) {
+        ConversionErrorScope::Report("Expected a blob handle or a Uint8Array");
+        return Blob();
+    }
+    const Blob* blob = JsBlobTable::Get().Find(static_cast<uint32_t>(id));
+    if (blob == nullptr) {
+        ConversionErrorScope::Report("The blob handle was released");
+        return Blob();
+    }
+    return *blob;
+}
+
+emscripten::val AllocBlobToJS(double size) {
+    if (!(size >= 0 && size <= static_cast<double>(SIZE_MAX))) {
+        return emscripten::val::undefined();
+    }
+    return BlobToJS(Blob::Allocate(static_cast<size_t>(size)));
+}
+
+size_t LiveBlobCount() { return JsBlobTable::Get().size(); }
+
+}  // namespace cppschema::jsbridge::internal
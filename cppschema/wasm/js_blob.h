@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+#include <emscripten/val.h>
+
+#include "cppschema/common/blob.h"
+
+namespace cppschema::jsbridge::internal {
+
+/**
+ * Conversion of blobs, used by `JSConverter<Blob>`.
+ *
+ * A blob crosses to JS as a handle `{id, size, bytes, release()}`, without copying its bytes.
+ * `bytes` is a getter returning a `Uint8Array` view of them in the wasm memory, so it stays valid
+ * after the memory grows (but not a view kept from an earlier access). Each handle holds a
+ * reference to the bytes in a table, until its `release()` is called (or, as a fallback, until it
+ * is garbage collected).
+ *
+ * A handle passed back from JS adopts the same bytes. A plain `Uint8Array` is copied once.
+ */
+emscripten::val BlobToJS(const Blob& blob);
+
+// Reports a conversion error, and returns an empty blob, if the value is neither a live blob
+// handle nor a `Uint8Array`.
+Blob BlobFromJS(const emscripten::val& v);
+
+// Returns the handle of a new uninitialized blob, for JS to fill, see `ExportBlobs`.
+emscripten::val AllocBlobToJS(double size);
+
+// Number of the blob handles not yet released.
+size_t LiveBlobCount();
+
+}  // namespace cppschema::jsbridge::internal
@@ -1,9 +1,79 @@
 #pragma once
 
+#include <string>
+#include <utility>
+
 #include <emscripten/val.h>
 
+#include "absl/log/log.h"
+#include "cppschema/common/request_limits.h"
+#include "cppschema/common/status.h"
+
+/**
+ * 64-bit integers cross to JS as BigInt, which needs the module to be linked with `-sWASM_BIGINT`
+ * (the default since emscripten 4). Define this to 0 when linking without it, then they cross as
+ * JS numbers, which are exact only up to 2^53.
+ */
+#ifndef CPPSCHEMA_WASM_BIGINT
+#define CPPSCHEMA_WASM_BIGINT 1
+#endif
+
+/**
+ * Enums cross to JS as their names. Define this to 1 to send all of them as their ordinals instead,
+ * or use DEFINE_ENUM_ORDINAL_TRANSFER for a single enum. Either way, names are still accepted from
+ * JS.
+ */
+#ifndef CPPSCHEMA_WASM_ENUM_ORDINALS
+#define CPPSCHEMA_WASM_ENUM_ORDINALS 0
+#endif
+
 namespace cppschema::jsbridge {
 
+/**
+ * Collects the first conversion error raised by the `JSConverter`s while in scope, so that a
+ * malformed JS value fails the API call with an INVALID_ARGUMENT status instead of aborting the
+ * module. Outside of any scope the errors are only logged. Scopes nest, the innermost one wins.
+ *
+ * @example
+ * Status status;
+ * {
+ *     ConversionErrorScope scope(&status);
+ *     req = JSConverter<Req>::fromJS(jsArgs);
+ * }
+ * if (!status.ok()) { ... }
+ */
+class ConversionErrorScope {
+public:
+    explicit ConversionErrorScope(Status* status) : status_(status), previous_(current_) {
+        current_ = this;
+    }
+
+    ~ConversionErrorScope() {
+        current_ = previous_;
+    }
+
+    ConversionErrorScope(const ConversionErrorScope&) = delete;
+    ConversionErrorScope& operator=(const ConversionErrorScope&) = delete;
+
+    static void Report(std::string message) {
+        Report(InvalidArgumentError(std::move(message)));
+    }
+
+    static void Report(Status status) {
+        if (current_ == nullptr) {
+            LOG(ERROR) << "[JSConverter] " << status.ToString();
+        } else if (current_->status_->ok()) {
+            *current_->status_ = std::move(status);
+        }
+    }
+
+private:
+    static inline thread_local ConversionErrorScope* current_ = nullptr;
+
+    Status* status_;
+    ConversionErrorScope* previous_;
+};
+
 /**
  * JSConverter: A template utility to convert between C++ STL types 
  * and native JavaScript objects/arrays using Embind.
@@ -14,6 +84,25 @@ struct JSConverter {
     static T fromJS(emscripten::val v);
 };
 
+namespace internal {
+
+// Charges a container or string about to be decoded to the `DecodeBudget` of the request, if any.
+// False, with the error reported, once the request is over its limits.
+inline bool ChargeDecode(size_t elements, size_t bytes) {
+    DecodeBudget* budget = DecodeBudget::current();
+    if (budget == nullptr) [[likely]] {
+        return true;
+    }
+    Status status = budget->Charge(elements, bytes);
+    if (!status.ok()) [[unlikely]] {
+        ConversionErrorScope::Report(std::move(status));
+        return false;
+    }
+    return true;
+}
+
+}  // namespace internal
+
 }  // namespace cppschema::jsbridge
 
 #include "cppschema/wasm/js_converter_inl.h"
\ No newline at end of file
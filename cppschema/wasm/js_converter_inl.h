@@ -1,14 +1,31 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <type_traits>
+#include <vector>
+
+#include <emscripten/val.h>
 
 #include "absl/log/log.h"
+#include "cppschema/common/containers.h"
 #include "cppschema/common/enum_registry.h"  // IWYU pragma: keep
+#include "cppschema/common/schema_traits.h"
 #include "cppschema/common/strong_types.h"  // IWYU pragma: keep
 #include "cppschema/common/types.h"
 #include "cppschema/common/visitor_macros.h"  // IWYU pragma: keep
+#include "cppschema/wasm/js_blob.h"
+#include "cppschema/wasm/js_crossings.h"
+#include "cppschema/wasm/js_interned_string.h"
+#include "cppschema/wasm/js_string.h"
+#include "cppschema/wasm/js_string_array.h"
 
 namespace cppschema::jsbridge {
 
@@ -23,154 +40,35 @@ template <typename T, typename Enable>
 struct JSConverter;
 
 //-----------------------------------------------------------------------------
-// Type Detection Traits
+// Type Detection Traits (see cppschema/common/schema_traits.h)
 //-----------------------------------------------------------------------------
 namespace internal {
+using namespace ::cppschema::internal;
 
-// Primitive-like: Smaller types with direct emscripten support.
-template <typename T>
-struct is_primitive_like : std::disjunction<
-    std::is_same<T, bool>,
-    std::is_same<T, std::string>,
-    std::is_same<T, float>,
-    std::is_same<T, int32_t>,
-    std::is_same<T, uint32_t>,
-    std::is_same<T, int64_t>,
-    std::is_same<T, uint64_t>
-> {};
-
-
-// VOID: Type trait / Concept to identify VoidType (represents void in C++).
-template <typename T> struct is_void_like : std::false_type {};
-template <> struct is_void_like<VoidType> : std::true_type {};
-
-
-// The types allowed in sets and map keys are very restrictive, because in JS
-// using objects as map keys or as set elements yields a different semantics
-// (object reference) than in C++ (object content).
-// So we only allow primitive types as keys, which have the same semantics in
-// both C++ and Javascript.
-template<typename T>
-struct is_keyable_type : std::disjunction<
-    std::is_same<T, int32_t>,
-    std::is_same<T, uint32_t>,
-    std::is_same<T, std::string>
-> {};
-
-
-// TODO: Use concept, like:
-// template <typename T> concept is_void_type = std::is_same_v<std::decay_t<T>, VoidType>;
-
-// PAIRS: std::pair.
 template <typename T>
-struct is_pair_like : std::false_type {};
-template <typename T1, typename T2>
-struct is_pair_like<std::pair<T1, T2>> : std::true_type {};
-
+inline constexpr bool is_int64_like_v = std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>;
 
-// TUPLE: std::tuple.
+// Converts a JS number to a 64-bit integer. The fractional, non finite and out of range ones, whose
+// cast would be undefined, are reported instead.
 template <typename T>
-struct is_tuple_like : std::false_type {};
-template <typename... Ts>
-struct is_tuple_like<std::tuple<Ts...>> : std::true_type {};
-
-
-// MAP: Has key_type and mapped_type
-template <typename T, typename = void>
-struct is_map_like_impl : std::false_type {};
-
-template <typename T>
-struct is_map_like_impl<T, std::void_t<
-    typename T::key_type,
-    typename T::mapped_type,
-    typename T::value_type,
-    decltype(std::declval<T&>()[std::declval<typename T::key_type>()])
->> : std::true_type {};
-
-template <typename T>
-using is_map_like = is_map_like_impl<T>;
-
-
-// ARRAY: Has value_type, but NOT a map, and NOT a string
-template <typename T, typename = void>
-struct is_array_like : std::false_type {};
-template <typename T, typename A> struct is_array_like<std::vector<T, A>> : std::true_type {};
-
+T Int64FromNumber(double number) {
+    // 2^63 and 2^64, which doubles hold exactly.
+    constexpr double kEnd = std::is_signed_v<T> ? 9223372036854775808.0 : 18446744073709551616.0;
+    constexpr double kBegin = std::is_signed_v<T> ? -kEnd : 0.0;
+    if (!(number >= kBegin && number < kEnd) || std::trunc(number) != number) {
+        ConversionErrorScope::Report(std::is_signed_v<T> ? "Expected an integer in the int64 range"
+                                                         : "Expected an integer in the uint64 range");
+        return T{};
+    }
+    return static_cast<T>(number);
+}
 
-// SET: Has key_type and value_type, but they are the same
+// Enums sent as ordinals, see DEFINE_ENUM_ORDINAL_TRANSFER. Found by ADL in the enum's namespace.
 template <typename T, typename = void>
-struct is_set_like : std::false_type {};
+struct is_ordinal_enum : std::bool_constant<CPPSCHEMA_WASM_ENUM_ORDINALS> {};
 template <typename T>
-struct is_set_like<T, std::void_t<typename T::key_type, typename T::value_type>> 
-    : std::bool_constant<std::is_same_v<typename T::key_type, typename T::value_type> && !is_array_like<T>::value> {};
-
-
-// OPTIONAL: std::optional.
-template <typename T> struct is_optional_like : std::false_type {};
-template <typename U> struct is_optional_like<std::optional<U>> : std::true_type {};
-
-
-// Visible struct like, i.e. a struct whose members are visible. Supports only those C++ structs
-// which has defined the visitor MACRO.
-
-// Mock visitor used only for the concept check to ensure _visit_members exists and is callable.
-struct ProbeVisitor {
-    template<typename T> void visitfn(const char*, T&) {}
-};
-
-template<typename T, typename = void>
-struct is_visible_struct_like : std::false_type {};
-
-template<typename T>
-struct is_visible_struct_like<
-    T,
-    std::void_t<
-        decltype(
-            std::declval<T&>()._visit_members(
-                std::declval<ProbeVisitor&>()
-            )
-        )
-    >
-> : std::true_type {};
-
-
-// ENUMS: should be scoped enum (i.e. not trivially convertible to int).
-template <typename T>
-struct is_enum_like : std::bool_constant<
-    std::is_enum_v<T> &&
-    !std::is_convertible_v<T, int>
-> {};
-
-
-// STRONG TYPES: Types that are wrappers around primitives, but are not implicitly convertible
-// to them.
-template<typename T>
-struct is_strong_type_like : std::false_type {};
-template <typename T, typename Tag>
-struct is_strong_type_like<StrongType<T, Tag>> : std::true_type {};
-
-template<typename T>
-struct is_keyable_strong_type : std::false_type {};
-template <typename T, typename Tag>
-struct is_keyable_strong_type<StrongType<T, Tag>> : is_keyable_type<T> {};
-
-
-// Unsupported type: One which satisfies none of the above.
-template<typename T>
-struct is_unsupported_like : std::conjunction<
-    std::negation<is_primitive_like<T>>,
-    std::negation<is_void_like<T>>,
-    std::negation<is_pair_like<T>>,
-    std::negation<is_tuple_like<T>>,
-    std::negation<is_array_like<T>>,
-    std::negation<is_map_like<T>>,
-    std::negation<is_set_like<T>>,
-    std::negation<is_optional_like<T>>,
-    std::negation<is_visible_struct_like<T>>,
-    std::negation<is_enum_like<T>>,
-    std::negation<is_strong_type_like<T>>
-> {};
-
+struct is_ordinal_enum<T, std::void_t<decltype(CppSchemaEnumAsOrdinal(static_cast<const T*>(nullptr)))>>
+    : std::true_type {};
 }  // namespace internal
 
 //-----------------------------------------------------------------------------
@@ -180,12 +78,41 @@ struct is_unsupported_like : std::conjunction<
 // PRIMITIVES: string, boolean, int32_t etc.
 template <typename PrimitiveType>
 struct JSConverter<PrimitiveType, std::enable_if_t<internal::is_primitive_like<PrimitiveType>::value>> {
-    // Default: Fallback to Embind's internal conversion for primitives
+    // Default: Fallback to Embind's internal conversion for primitives, except for the strings, see
+    // js_string.h.
     static emscripten::val toJS(const PrimitiveType& value) {
-        return emscripten::val(value);
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, PrimitiveType, 1);
+        if constexpr (std::is_same_v<PrimitiveType, std::string>) {
+            return internal::StringToJS(value);
+        } else if constexpr (internal::is_int64_like_v<PrimitiveType> && !CPPSCHEMA_WASM_BIGINT) {
+            return emscripten::val(static_cast<double>(value));
+        } else {
+            return emscripten::val(value);  // BigInt for the 64-bit integers.
+        }
     }
     static PrimitiveType fromJS(emscripten::val v) {
-        return v.as<PrimitiveType>();
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, PrimitiveType, 1);
+        if constexpr (std::is_same_v<PrimitiveType, std::string>) {
+            return internal::StringFromJS(v);
+        } else if constexpr (internal::is_int64_like_v<PrimitiveType> && !CPPSCHEMA_WASM_BIGINT) {
+            return internal::Int64FromNumber<PrimitiveType>(v.as<double>());
+        } else if constexpr (internal::is_int64_like_v<PrimitiveType>) {
+            // Also accept plain numbers, which is what JS code passes for timestamps and the like.
+            CPPSCHEMA_COUNT_CROSSINGS(kCheck, PrimitiveType, 1);
+            if (v.isNumber()) {
+                return internal::Int64FromNumber<PrimitiveType>(v.as<double>());
+            }
+            // Embind throws on the other types, report them instead.
+            static const emscripten::val kBigInt("bigint");
+            CPPSCHEMA_COUNT_CROSSINGS(kCheck, PrimitiveType, 1);
+            if (!v.typeOf().strictlyEquals(kBigInt)) {
+                ConversionErrorScope::Report("Expected a number or a BigInt");
+                return PrimitiveType{};
+            }
+            return v.as<PrimitiveType>();
+        } else {
+            return v.as<PrimitiveType>();
+        }
     }
 };
 
@@ -193,6 +120,7 @@ struct JSConverter<PrimitiveType, std::enable_if_t<internal::is_primitive_like<P
 template <typename VoidLikeType>
 struct JSConverter<VoidLikeType, std::enable_if_t<internal::is_void_like<VoidLikeType>::value>> {
     static emscripten::val toJS(const VoidLikeType& value) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, VoidLikeType, 1);
         return emscripten::val::object();
     }
     static VoidLikeType fromJS(emscripten::val v) {
@@ -200,10 +128,36 @@ struct JSConverter<VoidLikeType, std::enable_if_t<internal::is_void_like<VoidLik
     }
 };
 
+// INTERNED STRINGS: A string in JS. Repeated strings reuse the cached JS string, see
+// js_interned_string.h.
+template <typename InternedType>
+struct JSConverter<InternedType, std::enable_if_t<internal::is_interned_string_like<InternedType>::value>> {
+    static emscripten::val toJS(const InternedType& s) {
+        return internal::InternedStringToJS(s);
+    }
+    static InternedType fromJS(emscripten::val v) {
+        return internal::InternedStringFromJS(v);
+    }
+};
+
+// BLOBS: A handle with a view of the bytes in the wasm memory, which are not copied, see
+// js_blob.h.
+template <typename BlobType>
+struct JSConverter<BlobType, std::enable_if_t<internal::is_blob_like<BlobType>::value>> {
+    static emscripten::val toJS(const BlobType& blob) {
+        return internal::BlobToJS(blob);
+    }
+    static BlobType fromJS(emscripten::val v) {
+        return internal::BlobFromJS(v);
+    }
+};
+
 // PAIRS: std::pair
 template <typename PairType>
 struct JSConverter<PairType, std::enable_if_t<internal::is_pair_like<PairType>::value>> {
     static emscripten::val toJS(const PairType& value) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, PairType, 1);
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, PairType, 2);
         emscripten::val arr = emscripten::val::array();
         arr.call<void>("push", JSConverter<typename PairType::first_type>::toJS(value.first));
         arr.call<void>("push", JSConverter<typename PairType::second_type>::toJS(value.second));
@@ -212,10 +166,14 @@ struct JSConverter<PairType, std::enable_if_t<internal::is_pair_like<PairType>::
 
     static PairType fromJS(emscripten::val v) {
         PairType value;
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, PairType, 1);
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, PairType, 1);
         unsigned int len = v["length"].as<unsigned int>();
         if (len != 2) {
+            ConversionErrorScope::Report("Expected a pair, got an array of length " + std::to_string(len));
             return {};
         }
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, PairType, 2);
         value.first = JSConverter<typename PairType::first_type>::fromJS(v[0]);
         value.second = JSConverter<typename PairType::second_type>::fromJS(v[1]);
         return value;
@@ -226,6 +184,8 @@ struct JSConverter<PairType, std::enable_if_t<internal::is_pair_like<PairType>::
 template <typename TupleType>
 struct JSConverter<TupleType, std::enable_if_t<internal::is_tuple_like<TupleType>::value>> {
     static emscripten::val toJS(const TupleType& value) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, TupleType, 1);
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, TupleType, std::tuple_size_v<TupleType>);
         emscripten::val arr = emscripten::val::array();
         std::apply([&arr](const auto&... elems) {
             auto visit = [&arr]<typename T>(const T& x) {
@@ -237,6 +197,7 @@ struct JSConverter<TupleType, std::enable_if_t<internal::is_tuple_like<TupleType
     }
 
     static TupleType fromJS(emscripten::val v) {
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, TupleType, std::tuple_size_v<TupleType>);
         TupleType tpl;
         std::apply([&v](auto&... elems) {
             size_t index = 0;
@@ -249,7 +210,7 @@ struct JSConverter<TupleType, std::enable_if_t<internal::is_tuple_like<TupleType
     }
 };
 
-// MAPS: std::map, flat_map, etc.
+// MAPS: std::map, std::unordered_map, absl::flat_hash_map, flat_map, etc.
 template <typename MapType>
 struct JSConverter<MapType, std::enable_if_t<internal::is_map_like<MapType>::value>> {
     static_assert(
@@ -257,6 +218,8 @@ struct JSConverter<MapType, std::enable_if_t<internal::is_map_like<MapType>::val
         internal::is_keyable_strong_type<typename MapType::key_type>::value, "Map key type is not allowed in JS" );
 
     static emscripten::val toJS(const MapType& m) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, MapType, 1);
+        CPPSCHEMA_COUNT_CROSSINGS(kSet, MapType, m.size());
         emscripten::val obj = emscripten::val::object();
         for (const auto& [key, value] : m) {
             auto jsKey = JSConverter<typename MapType::key_type>::toJS(key);
@@ -270,38 +233,184 @@ struct JSConverter<MapType, std::enable_if_t<internal::is_map_like<MapType>::val
         MapType m;
         emscripten::val keys = emscripten::val::global("Object").call<emscripten::val>("keys", v);
         const size_t len = keys["length"].as<size_t>();
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, MapType, 2 + 2 * len);
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, MapType, 1);
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, MapType, 1);
+        if (!internal::ChargeDecode(len, 0)) {
+            return m;
+        }
+        // The keys of the objects from sorted maps come back sorted, see `KeyedBuilder`.
+        internal::KeyedBuilder<MapType> builder(&m, len);
         for (size_t i = 0; i < len; ++i) {
             emscripten::val k = keys[i];
-            m[k.as<typename MapType::key_type>()] = 
+            builder.Emplace(JSConverter<typename MapType::key_type>::fromJS(k)) =
                 JSConverter<typename MapType::mapped_type>::fromJS(v[k]);
         }
         return m;
     }
 };
 
-// ARRAYS: std::vector, std::list, std::deque
+// ARRAYS: std::vector, std::deque, std::array
 template <typename ArrayType>
 struct JSConverter<ArrayType, std::enable_if_t<internal::is_array_like<ArrayType>::value>> {
+    using T = typename ArrayType::value_type;
+
+    // Numeric vectors (and std::arrays) cross in bulk, through a typed array view of the wasm
+    // memory. So do the ordinal enum vectors, as their underlying integers. String vectors also
+    // cross in bulk, see js_string_array.h.
+    static constexpr bool kBulk = internal::is_numeric_like<T>::value &&
+        internal::is_contiguous_array<ArrayType>::value &&
+        (CPPSCHEMA_WASM_BIGINT || !internal::is_int64_like_v<T>);
+    static constexpr bool kBulkEnum = internal::is_enum_like<T>::value &&
+        internal::is_contiguous_array<ArrayType>::value && []{
+        if constexpr (internal::is_enum_like<T>::value) {
+            using U = std::underlying_type_t<T>;
+            return internal::is_ordinal_enum<T>::value && sizeof(U) <= sizeof(int32_t);
+        }
+        return false;
+    }();
+    static constexpr bool kBulkString = std::is_same_v<ArrayType, std::vector<std::string>>;
+    // The other element types are converted one by one, see `JsArraySink` for streaming them.
+    static constexpr bool kPerElement = !kBulk && !kBulkEnum && !kBulkString;
+
     static emscripten::val toJS(const ArrayType& container) {
-        emscripten::val arr = emscripten::val::array();
-        for (const auto& item : container) {
-            arr.call<void>("push", JSConverter<typename ArrayType::value_type>::toJS(item));
+        if constexpr (kBulk || kBulkEnum) {
+            // Array.from, on a view of the memory.
+            CPPSCHEMA_COUNT_CROSSINGS(kGet, ArrayType, 1);
+            CPPSCHEMA_COUNT_CROSSINGS(kCreate, ArrayType, 1);
+            CPPSCHEMA_COUNT_CROSSINGS(kCall, ArrayType, 1);
+        } else if constexpr (kPerElement) {
+            CPPSCHEMA_COUNT_CROSSINGS(kCreate, ArrayType, 1);
+            CPPSCHEMA_COUNT_CROSSINGS(kCall, ArrayType, container.size());
+        }
+        if constexpr (kBulk) {
+            // A single copy into a new JS array. The view is only valid until the memory grows.
+            return emscripten::val::global("Array").call<emscripten::val>("from",
+                emscripten::val(emscripten::typed_memory_view(container.size(), container.data())));
+        } else if constexpr (kBulkEnum) {
+            using U = std::underlying_type_t<T>;
+            return emscripten::val::global("Array").call<emscripten::val>("from",
+                emscripten::val(emscripten::typed_memory_view(container.size(),
+                    reinterpret_cast<const U*>(container.data()))));
+        } else if constexpr (kBulkString) {
+            return internal::StringArrayToJS(container);
+        } else {
+            emscripten::val arr = emscripten::val::array();
+            for (const auto& item : container) {
+                arr.call<void>("push", JSConverter<T>::toJS(item));
+            }
+            return arr;
         }
-        return arr;
     }
 
     static ArrayType fromJS(emscripten::val v) {
-        ArrayType container;
+        if constexpr (kBulk && internal::is_int64_like_v<T>) {
+            // `BigInt` also converts the plain numbers, and throws on the fractional ones.
+            const char* typedArray = std::is_signed_v<T> ? "BigInt64Array" : "BigUint64Array";
+            CPPSCHEMA_COUNT_CROSSINGS(kGet, ArrayType, 3);
+            CPPSCHEMA_COUNT_CROSSINGS(kCall, ArrayType, 2);
+            CPPSCHEMA_COUNT_CROSSINGS(kAs, ArrayType, 1);
+            CPPSCHEMA_COUNT_CROSSINGS(kCreate, ArrayType, 1);
+            const emscripten::val typed = emscripten::val::global(typedArray)
+                .call<emscripten::val>("from", v, emscripten::val::global("BigInt"));
+            const size_t len = typed["length"].as<size_t>();
+            ArrayType container{};
+            if (!internal::ChargeDecode(len, len * sizeof(T)) || !startArray(container, len)) {
+                return {};
+            }
+            if constexpr (!internal::is_fixed_size_array<ArrayType>::value) {
+                container.resize(len);
+            }
+            emscripten::val(emscripten::typed_memory_view(container.size(), container.data()))
+                .call<void>("set", typed);
+            return container;
+        } else if constexpr (kBulk) {
+            if (!chargeBulk(v)) {
+                return {};
+            }
+            CPPSCHEMA_COUNT_CROSSINGS(kCall, ArrayType, 1);
+            return fromVector(emscripten::convertJSArrayToNumberVector<T>(v));
+        } else if constexpr (kBulkEnum) {
+            // Converted as doubles, so that no value wraps around into a valid ordinal. The
+            // elements which are not numbers come back as NaN.
+            if (!chargeBulk(v)) {
+                return {};
+            }
+            CPPSCHEMA_COUNT_CROSSINGS(kCall, ArrayType, 1);
+            const std::vector<double> ordinals = emscripten::convertJSArrayToNumberVector<double>(v);
+            std::vector<T> enums(ordinals.size());
+            for (size_t i = 0; i < ordinals.size(); ++i) {
+                std::optional<T> enumv = JSConverter<T>::fromOrdinal(ordinals[i]);
+                if (!enumv.has_value()) {
+                    // Names, or an invalid value to report.
+                    return fromJSPerElement(v, /*charged=*/true);
+                }
+                enums[i] = *enumv;
+            }
+            return fromVector(std::move(enums));
+        } else if constexpr (kBulkString) {
+            return internal::StringArrayFromJS(v);
+        } else {
+            return fromJSPerElement(v);
+        }
+    }
+
+private:
+    // Charges a bulk array to the `DecodeBudget` before it is copied. Reading its length costs a
+    // crossing, so only when there is a budget.
+    static bool chargeBulk(const emscripten::val& v) {
+        if (DecodeBudget::current() == nullptr) [[likely]] {
+            return true;
+        }
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, ArrayType, 1);
+        const size_t len = v["length"].as<size_t>();
+        return internal::ChargeDecode(len, len * sizeof(T));
+    }
+
+    // Starts building `container` for `len` elements, or reports that a std::array has another size.
+    static bool startArray(ArrayType& container, size_t len) {
+        if (!internal::ArrayBuilder<ArrayType>(&container).Start(len)) {
+            ConversionErrorScope::Report("Expected an array of length " + std::to_string(container.size()) +
+                ", got an array of length " + std::to_string(len));
+            return false;
+        }
+        return true;
+    }
+
+    // The vectors are returned as they are, the std::arrays are filled from them.
+    static ArrayType fromVector(std::vector<T>&& elements) {
+        if constexpr (std::is_same_v<ArrayType, std::vector<T>>) {
+            return std::move(elements);
+        } else {
+            ArrayType container{};
+            if (!startArray(container, elements.size())) {
+                return {};
+            }
+            std::copy(elements.begin(), elements.end(), container.begin());
+            return container;
+        }
+    }
+
+    static ArrayType fromJSPerElement(const emscripten::val& v, bool charged = false) {
+        ArrayType container{};
         unsigned int len = v["length"].as<unsigned int>();
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, ArrayType, 1 + len);
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, ArrayType, 1);
+        if (!charged && !internal::ChargeDecode(len, 0)) {
+            return {};
+        }
+        internal::ArrayBuilder<ArrayType> builder(&container);
+        if (!startArray(container, len)) {
+            return {};
+        }
         for (unsigned int i = 0; i < len; ++i) {
-            // Use back_inserter if available, or just push_back for vector/list
-            container.push_back(JSConverter<typename ArrayType::value_type>::fromJS(v[i]));
+            builder.Append(JSConverter<T>::fromJS(v[i]));
         }
         return container;
     }
 };
 
-// SETS: std::set, flat_set
+// SETS: std::set, std::unordered_set, absl::flat_hash_set, flat_set
 template <typename SetType>
 struct JSConverter<SetType, std::enable_if_t<internal::is_set_like<SetType>::value>> {
     static_assert(
@@ -309,6 +418,8 @@ struct JSConverter<SetType, std::enable_if_t<internal::is_set_like<SetType>::val
         internal::is_keyable_strong_type<typename SetType::key_type>::value, "Set key type is not allowed in JS" );
 
     static emscripten::val toJS(const SetType& s) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, SetType, 1);
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, SetType, s.size());
         emscripten::val arr = emscripten::val::array();
         for (const auto& item : s) {
             arr.call<void>("push", JSConverter<typename SetType::value_type>::toJS(item));
@@ -319,8 +430,14 @@ struct JSConverter<SetType, std::enable_if_t<internal::is_set_like<SetType>::val
     static SetType fromJS(emscripten::val v) {
         SetType s;
         unsigned int len = v["length"].as<unsigned int>();
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, SetType, 1 + len);
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, SetType, 1);
+        if (!internal::ChargeDecode(len, 0)) {
+            return s;
+        }
+        internal::KeyedBuilder<SetType> builder(&s, len);
         for (unsigned int i = 0; i < len; ++i) {
-            s.insert(JSConverter<typename SetType::value_type>::fromJS(v[i]));
+            builder.Insert(JSConverter<typename SetType::value_type>::fromJS(v[i]));
         }
         return s;
     }
@@ -349,8 +466,10 @@ struct JSConverter<OptionalType, std::enable_if_t<internal::is_optional_like<Opt
 template <typename StructType>
 struct JSConverter<StructType, std::enable_if_t<internal::is_visible_struct_like<StructType>::value>> {
     static emscripten::val toJS(const StructType& s) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, StructType, 1);
         emscripten::val obj = emscripten::val::object();
         auto lambda = [&obj]<typename T>(const char* name, const T& t) -> void {
+            CPPSCHEMA_COUNT_CROSSINGS(kSet, StructType, 1);
             obj.set(name, JSConverter<T>::toJS(t));
         };
         s._visit_members(lambda);
@@ -360,10 +479,12 @@ struct JSConverter<StructType, std::enable_if_t<internal::is_visible_struct_like
     static StructType fromJS(emscripten::val v) {
         StructType s;
         auto lambda = [&v]<typename T>(const char* name, T& t) -> void {
-            if (v.hasOwnProperty(name)) {
-                t = JSConverter<T>::fromJS(v[name]);
-            } else {
-                t = T{};  // Default initialize the member if the property is missing in the JS object.
+            // A missing (or undefined) property leaves the member default initialized.
+            CPPSCHEMA_COUNT_CROSSINGS(kGet, StructType, 1);
+            CPPSCHEMA_COUNT_CROSSINGS(kCheck, StructType, 1);
+            emscripten::val property = v[name];
+            if (!property.isUndefined()) {
+                t = JSConverter<T>::fromJS(std::move(property));
             }
         };
         s._visit_members(lambda);
@@ -371,31 +492,82 @@ struct JSConverter<StructType, std::enable_if_t<internal::is_visible_struct_like
     }
 };
 
-// ENUM:
+// ENUM: The name, or the ordinal for the ordinal enums (then the vectors cross in bulk, see
+// JSConverter<ArrayType>).
 template <typename EnumType>
 struct JSConverter<EnumType, std::enable_if_t<internal::is_enum_like<EnumType>::value>> {
     using ToEnumFunc = EnumRegistry::ToEnumFunc<EnumType>;
-    using ToInfoFunc = EnumRegistry::ToInfoFunc<EnumType>;
+    using U = std::underlying_type_t<EnumType>;
+
+    static constexpr bool kAsOrdinal = internal::is_ordinal_enum<EnumType>::value;
+
+    // Returns nullopt if the JS number is not the ordinal of an enumerator.
+    static std::optional<EnumType> fromOrdinal(double ordinal) {
+        static const EnumNames* const names = EnumRegistry::instance().getNames<EnumType>();
+        if (names == nullptr || !(ordinal >= std::numeric_limits<int>::min() &&
+                                  ordinal <= std::numeric_limits<int>::max())) {
+            return std::nullopt;
+        }
+        const int i = static_cast<int>(ordinal);
+        if (i != ordinal || !names->contains(i)) {
+            return std::nullopt;
+        }
+        return static_cast<EnumType>(static_cast<U>(i));
+    }
 
     static emscripten::val toJS(const EnumType& value) {
-        const ToInfoFunc toInfo = EnumRegistry::instance().getToInfo<EnumType>();
-        if (!toInfo) {
-            LOG(FATAL) << "Enum not registered";
+        if constexpr (kAsOrdinal) {
+            CPPSCHEMA_COUNT_CROSSINGS(kCreate, EnumType, 1);
+            return emscripten::val(static_cast<int>(value));
         }
-        const auto [name, ordinal] = toInfo(value);
-        return emscripten::val(std::string(name));
+        // The JS strings of the names are created once.
+        static const auto* const jsNames = []{
+            auto* jsNames = new std::unordered_map<int, emscripten::val>();
+            if (const EnumNames* names = EnumRegistry::instance().getNames<EnumType>()) {
+                for (const auto& [ordinal, name] : names->values) {
+                    jsNames->emplace(ordinal, emscripten::val(name));
+                }
+            }
+            return jsNames;
+        }();
+        if (jsNames->empty()) {
+            ConversionErrorScope::Report(std::string("Enum not registered: ") + typeid(EnumType).name());
+            return emscripten::val::undefined();
+        }
+        auto it = jsNames->find(static_cast<int>(value));
+        if (it == jsNames->end()) {
+            ConversionErrorScope::Report("Unknown enum ordinal: " + std::to_string(static_cast<int>(value)));
+            return emscripten::val::undefined();
+        }
+        return it->second;
     }
 
     static EnumType fromJS(emscripten::val v) {
-        const ToEnumFunc toEnum = EnumRegistry::instance().getToEnum<EnumType>();
+        if constexpr (kAsOrdinal) {
+            CPPSCHEMA_COUNT_CROSSINGS(kCheck, EnumType, 1);
+            if (v.isNumber()) {
+                CPPSCHEMA_COUNT_CROSSINGS(kAs, EnumType, 1);
+                const double ordinal = v.as<double>();
+                if (std::optional<EnumType> enumv = fromOrdinal(ordinal)) {
+                    return *enumv;
+                }
+                ConversionErrorScope::Report(std::string("Unknown enum ordinal of ") +
+                    typeid(EnumType).name() + ": " + std::to_string(ordinal));
+                return EnumType{};
+            }
+        }
+        static const ToEnumFunc toEnum = EnumRegistry::instance().getToEnum<EnumType>();
         if (!toEnum) {
-            LOG(FATAL) << "Enum not registered";
+            ConversionErrorScope::Report(std::string("Enum not registered: ") + typeid(EnumType).name());
+            return EnumType{};
         }
-        const std::string strval = v.as<std::string>();
-        std::optional<EnumType> enumv = toEnum(v.as<std::string>());
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, EnumType, 1);
+        const std::string strval = internal::StringFromJS(v);
+        std::optional<EnumType> enumv = toEnum(strval);
         if (enumv.has_value()) {
             return std::move(enumv).value();
         }
+        ConversionErrorScope::Report("Unknown enum value: " + strval);
         return EnumType{};
     }
 };
@@ -416,11 +588,11 @@ struct JSConverter<StrongType, std::enable_if_t<internal::is_strong_type_like<St
 template <typename FallbackType>
 struct JSConverter<FallbackType, std::enable_if_t<internal::is_unsupported_like<FallbackType>::value>> {
     static emscripten::val toJS(const FallbackType& s) {
-        static_assert(false, "unsupported type");
+        static_assert(internal::always_false_v<FallbackType>, "unsupported type");
     }
 
     static FallbackType fromJS(emscripten::val v) {
-        static_assert(false, "unsupported type");
+        static_assert(internal::always_false_v<FallbackType>, "unsupported type");
     }
 };
 
@@ -0,0 +1,82 @@
+#include "cppschema/wasm/js_crossings.h"
+
+#include <cxxabi.h>
+
+#include <array>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <typeindex>
+
+namespace cppschema::jsbridge {
+namespace {
+
+struct ApiCounts {
+    uint64_t calls = 0;
+    std::array<uint64_t, kNumJsCrossings> by_kind{};
+    std::map<std::type_index, uint64_t> by_type;
+};
+
+// Keyed by the API name. The converters only run on the main thread.
+std::map<std::string, ApiCounts>& Counts() {
+    static auto* counts = new std::map<std::string, ApiCounts>();
+    return *counts;
+}
+
+ApiCounts& CurrentCounts() {
+    const char* api = internal::current_api;
+    return Counts()[api != nullptr ? api : "(none)"];
+}
+
+const char* KindName(int kind) {
+    static constexpr const char* kNames[kNumJsCrossings] = {"get", "set", "call", "as", "check", "create"};
+    return kNames[kind];
+}
+
+std::string Demangle(const std::type_index& type) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : type.name();
+    std::free(demangled);
+    return name;
+}
+
+}  // namespace
+
+emscripten::val CrossingCountsToJS() {
+    emscripten::val result = emscripten::val::object();
+    for (const auto& [api, counts] : Counts()) {
+        uint64_t total = 0;
+        emscripten::val by_kind = emscripten::val::object();
+        for (int kind = 0; kind < kNumJsCrossings; ++kind) {
+            by_kind.set(KindName(kind), static_cast<double>(counts.by_kind[kind]));
+            total += counts.by_kind[kind];
+        }
+        emscripten::val by_type = emscripten::val::object();
+        for (const auto& [type, count] : counts.by_type) {
+            by_type.set(Demangle(type), static_cast<double>(count));
+        }
+        emscripten::val entry = emscripten::val::object();
+        entry.set("calls", static_cast<double>(counts.calls));
+        entry.set("total", static_cast<double>(total));
+        entry.set("byKind", by_kind);
+        entry.set("byType", by_type);
+        result.set(api, entry);
+    }
+    return result;
+}
+
+void ResetCrossingCounts() { Counts().clear(); }
+
+namespace internal {
+
+void RecordCrossings(JsCrossing kind, const std::type_info& type, uint32_t count) {
+    ApiCounts& counts = CurrentCounts();
+    counts.by_kind[static_cast<int>(kind)] += count;
+    counts.by_type[std::type_index(type)] += count;
+}
+
+void RecordCall(const char* api) { ++Counts()[api].calls; }
+
+}  // namespace internal
+}  // namespace cppschema::jsbridge
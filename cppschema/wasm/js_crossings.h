@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <typeinfo>
+
+#include <emscripten/val.h>
+
+/**
+ * Define this to 1 for an instrumentation build, in which the converters count their operations
+ * on `emscripten::val`, i.e. their crossings of the wasm / JS boundary. See `ExportCrossingCounts`
+ * for reading them from JS. Otherwise the counting compiles to nothing.
+ */
+#ifndef CPPSCHEMA_WASM_COUNT_CROSSINGS
+#define CPPSCHEMA_WASM_COUNT_CROSSINGS 0
+#endif
+
+namespace cppschema::jsbridge {
+
+inline constexpr bool kCountCrossings = CPPSCHEMA_WASM_COUNT_CROSSINGS;
+
+// The kinds of the counted crossings. Only the operations of the converters are counted, one
+// each, not the reference counting of the `val` handles.
+enum class JsCrossing : uint8_t {
+    kGet,     // operator[], val::global.
+    kSet,     // set.
+    kCall,    // call, and the EM_JS functions.
+    kAs,      // as<T>.
+    kCheck,   // isNumber, isString.
+    kCreate,  // A val from a C++ value, val::object, val::array.
+};
+
+inline constexpr int kNumJsCrossings = 6;
+
+/**
+ * The counts since the last reset, by API (for the calls from `JsDispatchVisitor`), as:
+ *
+ * {addNode: {calls: 2, total: 22, byKind: {get: 6, ...}, byType: {"std::string": 2, ...}}, ...}
+ *
+ * Crossings outside of an API call are under "(none)". The types are those of the converters
+ * which made the crossings.
+ */
+emscripten::val CrossingCountsToJS();
+void ResetCrossingCounts();
+
+namespace internal {
+
+// Enabled by `ExportCrossingCounts`, which is a no-op outside of the instrumentation builds.
+inline bool count_crossings = false;
+// The API being called, see `CrossingScope`.
+inline thread_local const char* current_api = nullptr;
+
+void RecordCrossings(JsCrossing kind, const std::type_info& type, uint32_t count);
+void RecordCall(const char* api);
+
+inline void CountCrossings(JsCrossing kind, const std::type_info& type, uint32_t count = 1) {
+    if (count_crossings) [[unlikely]] {
+        RecordCrossings(kind, type, count);
+    }
+}
+
+}  // namespace internal
+
+// The counting differs with the flag, and is kept apart to not violate the ODR if it is only set
+// for some targets.
+#if CPPSCHEMA_WASM_COUNT_CROSSINGS
+inline namespace counting {
+
+// Attributes the crossings to an API while in scope.
+class CrossingScope {
+public:
+    explicit CrossingScope(const char* api) : previous_(internal::current_api) {
+        internal::current_api = api;
+        if (internal::count_crossings) {
+            internal::RecordCall(api);
+        }
+    }
+    ~CrossingScope() { internal::current_api = previous_; }
+
+    CrossingScope(const CrossingScope&) = delete;
+    CrossingScope& operator=(const CrossingScope&) = delete;
+
+private:
+    const char* previous_;
+};
+
+}  // namespace counting
+
+// Counts `count` crossings of a kind, made by the converter of `Type`.
+#define CPPSCHEMA_COUNT_CROSSINGS(kind, Type, count) \
+    ::cppschema::jsbridge::internal::CountCrossings(::cppschema::jsbridge::JsCrossing::kind, typeid(Type), count)
+#else
+inline namespace not_counting {
+
+class CrossingScope {
+public:
+    explicit CrossingScope(const char*) {}
+};
+
+}  // namespace not_counting
+
+#define CPPSCHEMA_COUNT_CROSSINGS(kind, Type, count) ((void)0)
+#endif
+
+}  // namespace cppschema::jsbridge
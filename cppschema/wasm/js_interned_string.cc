@@ -0,0 +1,112 @@
+#include "cppschema/wasm/js_interned_string.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <emscripten/em_js.h>
+
+#include "cppschema/wasm/js_converter.h"
+#include "cppschema/wasm/js_crossings.h"
+
+EM_JS_DEPS(cppschema_interned_string, "$Emval");
+
+// Returns the pool id registered for a string, or -1.
+EM_JS(int, cppschema_interned_lookup, (EM_VAL handle), {
+    const id = Module.cppschemaInterned?.get(Emval.toValue(handle));
+    return id === undefined ? -1 : id;
+});
+
+EM_JS(void, cppschema_interned_register, (EM_VAL handle, uint32_t id), {
+    (Module.cppschemaInterned ??= new Map()).set(Emval.toValue(handle), id);
+});
+
+EM_JS(void, cppschema_interned_forget, (EM_VAL handle), {
+    Module.cppschemaInterned?.delete(Emval.toValue(handle));
+});
+
+namespace cppschema::jsbridge::internal {
+
+namespace {
+
+// The JS strings by the pool id. The wasm builds are single threaded, see js_string_array.cc.
+class JsInternTable {
+public:
+    static JsInternTable& Get() {
+        static JsInternTable* table = new JsInternTable();
+        return *table;
+    }
+
+    emscripten::val ToJS(const InternedString& s) {
+        const uint32_t id = s.id();
+        if (id == InternEntry::kNotInterned) {
+            CPPSCHEMA_COUNT_CROSSINGS(kCreate, InternedString, 1);
+            return emscripten::val(s.str());
+        }
+        if (id < strings_.size() && strings_[id].has_value()) {
+            return *strings_[id];
+        }
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, InternedString, 1);
+        emscripten::val v(s.str());
+        Register(id, v);
+        return v;
+    }
+
+    InternedString FromJS(const emscripten::val& v) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, InternedString, 1);
+        const int id = cppschema_interned_lookup(v.as_handle());
+        if (id >= 0) {
+            if (auto entry = InternPool::Get().Find(static_cast<uint32_t>(id))) {
+                return InternedString(std::move(entry));
+            }
+        }
+        CPPSCHEMA_COUNT_CROSSINGS(kCheck, InternedString, 1);
+        if (!v.isString()) {
+            ConversionErrorScope::Report("Expected a string");
+            return InternedString();
+        }
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, InternedString, 1);
+        InternedString s(v.as<std::string>());
+        if (s.id() != InternEntry::kNotInterned) {
+            Register(s.id(), v);
+        }
+        return s;
+    }
+
+private:
+    JsInternTable() {
+        InternPool::Get().SetEvictionListener([this](uint32_t id) { Forget(id); });
+    }
+
+    void Register(uint32_t id, const emscripten::val& v) {
+        if (id >= strings_.size()) {
+            strings_.resize(id + 1);
+        }
+        strings_[id] = v;
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, InternedString, 1);
+        cppschema_interned_register(v.as_handle(), id);
+    }
+
+    void Forget(uint32_t id) {
+        if (id < strings_.size() && strings_[id].has_value()) {
+            CPPSCHEMA_COUNT_CROSSINGS(kCall, InternedString, 1);
+            cppschema_interned_forget(strings_[id]->as_handle());
+            strings_[id].reset();
+        }
+    }
+
+    std::vector<std::optional<emscripten::val>> strings_;
+};
+
+}  // namespace
+
+emscripten::val InternedStringToJS(const InternedString& s) {
+    return JsInternTable::Get().ToJS(s);
+}
+
+InternedString InternedStringFromJS(const emscripten::val& v) {
+    return JsInternTable::Get().FromJS(v);
+}
+
+}  // namespace cppschema::jsbridge::internal
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <emscripten/val.h>
+
+#include "cppschema/common/interned_string.h"
+
+namespace cppschema::jsbridge::internal {
+
+/**
+ * Conversion of interned strings, used by `JSConverter<InternedString>`.
+ *
+ * The JS string of each interned string is cached in a table indexed by its pool id, so sending it
+ * again to JS only hands out the cached handle, without decoding. A JS `Map` from the string to
+ * the pool id does the reverse, so a string received again is looked up without encoding and
+ * allocating a copy. Both the tables forget the strings evicted from the `InternPool`, and so are
+ * bounded by its capacity.
+ */
+emscripten::val InternedStringToJS(const InternedString& s);
+
+// Reports a conversion error, and returns an empty string, if the value is not a string.
+InternedString InternedStringFromJS(const emscripten::val& v);
+
+}  // namespace cppschema::jsbridge::internal
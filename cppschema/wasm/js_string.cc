@@ -0,0 +1,111 @@
+#include "cppschema/wasm/js_string.h"
+
+#include <optional>
+#include <vector>
+
+#include <emscripten/em_js.h>
+
+#include "cppschema/common/utf8.h"
+#include "cppschema/wasm/js_converter.h"
+#include "cppschema/wasm/js_crossings.h"
+
+EM_JS_DEPS(cppschema_string, "$Emval");
+
+// Returns a JS string of the `size` Latin-1 bytes at `data`. `apply` is bounded by the stack size,
+// so the long strings are built in chunks.
+EM_JS(EM_VAL, cppschema_latin1_to_js, (const char* data, size_t size), {
+    let string = '';
+    for (let i = 0; i < size; i += 8192) {
+        string += String.fromCharCode.apply(null, HEAPU8.subarray(data + i, data + Math.min(i + 8192, size)));
+    }
+    return Emval.toHandle(string);
+});
+
+// Same, of the `size` UTF-16 code units at `units`.
+EM_JS(EM_VAL, cppschema_utf16_to_js, (const char16_t* units, size_t size), {
+    const begin = units >> 1;
+    let string = '';
+    for (let i = 0; i < size; i += 8192) {
+        string += String.fromCharCode.apply(null, HEAPU16.subarray(begin + i, begin + Math.min(i + 8192, size)));
+    }
+    return Emval.toHandle(string);
+});
+
+// Returns the length of a JS string, and writes its UTF-16 code units to `buffer` if they fit in
+// `capacity`. Returns -1 if the value is not a string.
+EM_JS(double, cppschema_string_to_utf16, (EM_VAL handle, char16_t* buffer, size_t capacity), {
+    const string = Emval.toValue(handle);
+    if (typeof string !== 'string') {
+        return -1;
+    }
+    const length = string.length;
+    if (length <= capacity) {
+        const begin = buffer >> 1;
+        for (let i = 0; i < length; ++i) {
+            HEAPU16[begin + i] = string.charCodeAt(i);
+        }
+    }
+    return length;
+});
+
+namespace cppschema::jsbridge::internal {
+namespace {
+
+// Reused by the conversions of a thread, for the strings up to this many bytes or units. The
+// larger ones get their own buffers, so that the scratch stays small.
+constexpr size_t kScratchSize = 64 * 1024;
+
+template <typename T>
+T* Scratch(size_t size, std::vector<T>* large) {
+    static thread_local std::vector<T> scratch(kScratchSize);
+    if (size <= scratch.size()) [[likely]] {
+        return scratch.data();
+    }
+    large->resize(size);
+    return large->data();
+}
+
+}  // namespace
+
+emscripten::val StringToJS(std::string_view s) {
+    if (AsciiPrefixLength(s) == s.size()) {
+        return emscripten::val::take_ownership(cppschema_latin1_to_js(s.data(), s.size()));
+    }
+    std::vector<char> large_latin1;
+    char* latin1 = Scratch(s.size(), &large_latin1);
+    if (const std::optional<size_t> size = Utf8ToLatin1(s, latin1); size.has_value()) {
+        return emscripten::val::take_ownership(cppschema_latin1_to_js(latin1, *size));
+    }
+    std::vector<char16_t> large_units;
+    char16_t* units = Scratch(s.size(), &large_units);
+    if (const std::optional<size_t> size = Utf8ToUtf16(s, units); size.has_value()) {
+        return emscripten::val::take_ownership(cppschema_utf16_to_js(units, *size));
+    }
+    // Not valid UTF-8. Embind replaces the invalid bytes.
+    return emscripten::val(std::string(s));
+}
+
+std::string StringFromJS(const emscripten::val& v) {
+    std::vector<char16_t> large_units;
+    char16_t* units = Scratch(0, &large_units);
+    const double length = cppschema_string_to_utf16(v.as_handle(), units, kScratchSize);
+    if (length < 0) {
+        ConversionErrorScope::Report("Expected a string");
+        return {};
+    }
+    const size_t size = static_cast<size_t>(length);
+    if (!ChargeDecode(0, size)) {
+        return {};
+    }
+    if (size > kScratchSize) {
+        // Read again, into a buffer large enough.
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, std::string, 1);
+        units = Scratch(size, &large_units);
+        cppschema_string_to_utf16(v.as_handle(), units, size);
+    }
+    std::vector<char> large_utf8;
+    char* utf8 = Scratch(3 * size, &large_utf8);
+    return std::string(utf8, Utf16ToUtf8(std::u16string_view(units, size), utf8));
+}
+
+}  // namespace cppschema::jsbridge::internal
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <emscripten/val.h>
+
+namespace cppschema::jsbridge::internal {
+
+/**
+ * Conversion of single strings, used by `JSConverter<std::string>`, with the kernels of
+ * cppschema/common/utf8.h (SIMD with `-msimd128`).
+ *
+ * Embind copies each string through a temporary allocation, and transcodes it in JS. Instead, a
+ * JS string is read as its UTF-16 code units into a scratch buffer of the wasm memory, and encoded
+ * as UTF-8 in C++, the ASCII ones 16 units at a time. The other way, the ASCII and Latin-1
+ * strings, which are most of the identifiers, are handed to JS as their bytes without a copy, and
+ * the others as UTF-16.
+ */
+emscripten::val StringToJS(std::string_view s);
+
+// Reports a conversion error, and returns an empty string, if the value is not a string.
+std::string StringFromJS(const emscripten::val& v);
+
+}  // namespace cppschema::jsbridge::internal
@@ -0,0 +1,123 @@
+#include "cppschema/wasm/js_string_array.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <emscripten/em_js.h>
+
+#include "cppschema/common/utf8.h"
+#include "cppschema/wasm/js_converter.h"
+#include "cppschema/wasm/js_crossings.h"
+
+// Note: The `HEAP*` views are read after the C++ side has allocated everything, as the memory may
+// not grow while a view is in use. With pthreads, `TextDecoder` rejects views of the shared
+// memory, so this is for the single threaded builds.
+
+EM_JS_DEPS(cppschema_string_array, "$Emval");
+
+// Returns a JS array of `count` strings, sliced from the UTF-8 `data` at the UTF-16 `offsets`.
+EM_JS(EM_VAL, cppschema_strings_to_js, (const char* data, size_t size, const uint32_t* offsets, size_t count), {
+    Module.cppschemaTextDecoder ??= new TextDecoder();
+    const text = Module.cppschemaTextDecoder.decode(HEAPU8.subarray(data, data + size));
+    const ends = HEAPU32.subarray(offsets >> 2, (offsets >> 2) + count + 1);
+    const out = new Array(count);
+    for (let i = 0; i < count; ++i) {
+        out[i] = text.substring(ends[i], ends[i + 1]);
+    }
+    return Emval.toHandle(out);
+});
+
+// Returns an upper bound of the UTF-8 size of the strings in an array, or -1 if an element is not a
+// string. Sets `*count` to the array length.
+EM_JS(double, cppschema_strings_utf8_capacity, (EM_VAL handle, uint32_t* count), {
+    const array = Emval.toValue(handle);
+    let capacity = 0;
+    for (let i = 0; i < array.length; ++i) {
+        if (typeof array[i] !== 'string') {
+            return -1;
+        }
+        capacity += array[i].length * 3;
+    }
+    HEAPU32[count >> 2] = array.length;
+    return capacity;
+});
+
+// Encodes the strings of an array into `data`, and writes the end offset of each one in bytes.
+EM_JS(void, cppschema_strings_from_js, (EM_VAL handle, char* data, size_t capacity, uint32_t* offsets), {
+    const array = Emval.toValue(handle);
+    Module.cppschemaTextEncoder ??= new TextEncoder();
+    const encoder = Module.cppschemaTextEncoder;
+    const buffer = HEAPU8.subarray(data, data + capacity);
+    const ends = HEAPU32.subarray(offsets >> 2, (offsets >> 2) + array.length);
+    let pos = 0;
+    for (let i = 0; i < array.length; ++i) {
+        pos += encoder.encodeInto(array[i], buffer.subarray(pos)).written;
+        ends[i] = pos;
+    }
+});
+
+namespace cppschema::jsbridge::internal {
+
+emscripten::val StringArrayToJS(const std::vector<std::string>& strings) {
+    size_t total_size = 0;
+    for (const std::string& s : strings) {
+        total_size += s.size();
+    }
+    std::string packed;
+    packed.reserve(total_size);
+    std::vector<uint32_t> offsets;
+    offsets.reserve(strings.size() + 1);
+    offsets.push_back(0);
+    uint32_t offset = 0;
+    for (const std::string& s : strings) {
+        const std::optional<size_t> length = Utf16Length(s);
+        if (!length.has_value()) {
+            // The decoder would replace the invalid bytes, and shift the offsets. Let embind deal
+            // with each string instead.
+            CPPSCHEMA_COUNT_CROSSINGS(kCreate, std::vector<std::string>, 1 + strings.size());
+            CPPSCHEMA_COUNT_CROSSINGS(kCall, std::vector<std::string>, strings.size());
+            emscripten::val arr = emscripten::val::array();
+            for (const std::string& item : strings) {
+                arr.call<void>("push", emscripten::val(item));
+            }
+            return arr;
+        }
+        packed.append(s);
+        offset += static_cast<uint32_t>(*length);
+        offsets.push_back(offset);
+    }
+    CPPSCHEMA_COUNT_CROSSINGS(kCall, std::vector<std::string>, 1);
+    return emscripten::val::take_ownership(
+        cppschema_strings_to_js(packed.data(), packed.size(), offsets.data(), strings.size()));
+}
+
+std::vector<std::string> StringArrayFromJS(const emscripten::val& array) {
+    uint32_t count = 0;
+    CPPSCHEMA_COUNT_CROSSINGS(kCall, std::vector<std::string>, 1);
+    const double capacity = cppschema_strings_utf8_capacity(array.as_handle(), &count);
+    if (capacity < 0) {
+        ConversionErrorScope::Report("Expected an array of strings");
+        return {};
+    }
+    // The strings are charged their JS length, like a single one (the capacity is 3 bytes per unit).
+    if (!ChargeDecode(count, static_cast<size_t>(capacity) / 3)) {
+        return {};
+    }
+    // Not zero initialized, the encoder overwrites it.
+    std::unique_ptr<char[]> buffer(new char[static_cast<size_t>(capacity) + 1]);
+    std::vector<uint32_t> ends(count);
+    CPPSCHEMA_COUNT_CROSSINGS(kCall, std::vector<std::string>, 1);
+    cppschema_strings_from_js(array.as_handle(), buffer.get(), static_cast<size_t>(capacity), ends.data());
+
+    std::vector<std::string> strings;
+    strings.reserve(count);
+    uint32_t begin = 0;
+    for (const uint32_t end : ends) {
+        strings.emplace_back(buffer.get() + begin, end - begin);
+        begin = end;
+    }
+    return strings;
+}
+
+}  // namespace cppschema::jsbridge::internal
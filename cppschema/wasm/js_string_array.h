@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <emscripten/val.h>
+
+namespace cppschema::jsbridge::internal {
+
+/**
+ * Bulk conversion of string arrays, used by `JSConverter<std::vector<std::string>>`.
+ *
+ * Converting element by element costs a JS call and a UTF-8 decode per string. Instead, the
+ * strings are packed into one UTF-8 buffer in the wasm memory, with the offset of each one in
+ * UTF-16 code units. A single `TextDecoder` pass turns the buffer into one JS string, which is then
+ * sliced into the elements (V8 keeps the slices as views of the decoded string).
+ *
+ * The other way, the JS strings are written with `TextEncoder.encodeInto` into a buffer sized for
+ * the worst case, and sliced into `std::string`s using the byte offsets recorded on the way.
+ */
+emscripten::val StringArrayToJS(const std::vector<std::string>& strings);
+
+// Reports a conversion error, and returns an empty vector, if an element is not a string.
+std::vector<std::string> StringArrayFromJS(const emscripten::val& array);
+
+}  // namespace cppschema::jsbridge::internal
@@ -0,0 +1,135 @@
+#include "cppschema/wasm/js_task.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <emscripten/em_js.h>
+#include <emscripten/emscripten.h>
+
+#include "cppschema/common/status.h"
+
+namespace cppschema::jsbridge::internal {
+
+namespace {
+
+// The completions of the awaited promises, by id. The wasm builds are single threaded, see
+// js_string_array.cc.
+class PendingPromises {
+public:
+    static PendingPromises& Get() {
+        static PendingPromises* pending = new PendingPromises();
+        return *pending;
+    }
+
+    uint32_t Add(Completion<emscripten::val> completion) {
+        const uint32_t id = next_id_++;
+        completions_.emplace(id, std::move(completion));
+        return id;
+    }
+
+    void Settle(uint32_t id, Expected<emscripten::val> value) {
+        auto it = completions_.find(id);
+        if (it == completions_.end()) {
+            return;
+        }
+        Completion<emscripten::val> completion = std::move(it->second);
+        completions_.erase(it);
+        completion.Set(std::move(value));
+    }
+
+private:
+    uint32_t next_id_ = 1;
+    std::unordered_map<uint32_t, Completion<emscripten::val>> completions_;
+};
+
+// The deadline of the armed JS timer, if any.
+std::optional<TaskScheduler::Clock::time_point> armed_deadline;
+
+}  // namespace
+
+}  // namespace cppschema::jsbridge::internal
+
+// Called by the promise handlers of `cppschema_await_js`. A rejection passes its reason as a string.
+extern "C" EMSCRIPTEN_KEEPALIVE void cppschema_js_promise_settled(uint32_t id, bool fulfilled, EM_VAL handle) {
+    using namespace cppschema;
+    emscripten::val value = emscripten::val::take_ownership(handle);
+    if (fulfilled) {
+        jsbridge::internal::PendingPromises::Get().Settle(id, std::move(value));
+    } else {
+        jsbridge::internal::PendingPromises::Get().Settle(id,
+            Unexpected(InternalError("JS promise rejected: " + value.as<std::string>())));
+    }
+    // Runs the resumed coroutine, and those it made ready.
+    jsbridge::RunTasks();
+}
+
+// Called by the JS timer armed by `RunTasks`.
+extern "C" EMSCRIPTEN_KEEPALIVE void cppschema_run_tasks() {
+    cppschema::jsbridge::internal::armed_deadline.reset();
+    cppschema::TaskScheduler::Get().RunUntilIdle();
+    cppschema::jsbridge::RunTasks();
+}
+
+EM_JS_DEPS(cppschema_task, "$Emval");
+
+// Returns false if `handle` is not a thenable. Otherwise reports its outcome to
+// `cppschema_js_promise_settled(id, ...)`.
+EM_JS(bool, cppschema_await_js, (EM_VAL handle, uint32_t id), {
+    const value = Emval.toValue(handle);
+    if (value === null || typeof value?.then !== 'function') {
+        return false;
+    }
+    value.then(
+        (result) => _cppschema_js_promise_settled(id, true, Emval.toHandle(result)),
+        (reason) => _cppschema_js_promise_settled(id, false, Emval.toHandle(String(reason))));
+    return true;
+});
+
+EM_JS(void, cppschema_set_tasks_timer, (double delay_ms), {
+    setTimeout(() => _cppschema_run_tasks(), delay_ms);
+});
+
+EM_JS(EM_VAL, cppschema_make_deferred, (), {
+    let resolve;
+    const promise = new Promise((r) => { resolve = r; });
+    return Emval.toHandle({promise, resolve});
+});
+
+namespace cppschema::jsbridge {
+
+Task<emscripten::val> AwaitJs(emscripten::val promise) {
+    Completion<emscripten::val> completion;
+    const uint32_t id = internal::PendingPromises::Get().Add(completion);
+    if (!cppschema_await_js(promise.as_handle(), id)) {
+        internal::PendingPromises::Get().Settle(id, std::move(promise));
+    }
+    co_return co_await completion;
+}
+
+void RunTasks() {
+    TaskScheduler& scheduler = TaskScheduler::Get();
+    scheduler.RunReady();
+    const std::optional<TaskScheduler::Clock::time_point> deadline = scheduler.next_deadline();
+    if (!deadline || (internal::armed_deadline && *internal::armed_deadline <= *deadline)) {
+        return;
+    }
+    // A later armed timer just finds nothing to run.
+    internal::armed_deadline = deadline;
+    const auto delay = std::chrono::duration<double, std::milli>(*deadline - TaskScheduler::Clock::now());
+    cppschema_set_tasks_timer(std::max(delay.count(), 0.0));
+}
+
+namespace internal {
+
+emscripten::val MakeDeferred() {
+    return emscripten::val::take_ownership(cppschema_make_deferred());
+}
+
+}  // namespace internal
+
+}  // namespace cppschema::jsbridge
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <emscripten/val.h>
+
+#include "cppschema/apispec/task.h"
+
+namespace cppschema::jsbridge {
+
+/**
+ * Awaits a JS promise (or any thenable) from a coroutine backend method (see `Task`), e.g. to load
+ * a file through a JS callback. The coroutine suspends, and resumes from the JS microtask settling
+ * the promise, after which the other ready coroutines run too. A rejection fails with an INTERNAL
+ * status carrying the reason. A value which is not a thenable is returned as is.
+ *
+ * The coroutine frames hold the state of the suspended calls, so this needs neither JSPI nor
+ * Asyncify, nor a build with threads.
+ *
+ * @example
+ * Task<Blob> loadImpl(const std::string& path) {
+ *     Expected<emscripten::val> bytes = co_await jsbridge::AwaitJs(fetchCallback(path));
+ *     ...
+ * }
+ */
+Task<emscripten::val> AwaitJs(emscripten::val promise);
+
+// Runs the ready coroutines of the `TaskScheduler`, then arms a JS timer to run those waiting for a
+// time (see `SleepFor`) at the earliest deadline. Called by the JS entry points which resume
+// coroutines. The timers run in a later JS task, so e.g. a zero batching window (see
+// `BatchOptions`) spans the calls of the current one.
+void RunTasks();
+
+namespace internal {
+
+// Returns `{promise, resolve}`, a promise with its resolve function.
+emscripten::val MakeDeferred();
+
+}  // namespace internal
+
+}  // namespace cppschema::jsbridge
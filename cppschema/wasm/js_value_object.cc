@@ -0,0 +1,46 @@
+#include "cppschema/wasm/js_value_object.h"
+
+#include <emscripten/em_js.h>
+
+EM_JS_DEPS(cppschema_value_object, "$Emval");
+
+// Copies the properties of `defaults`, from `args` unless undefined there. A nested struct is left
+// to its own value object, see `ValueObjectConverter`.
+EM_JS(EM_VAL, cppschema_with_defaults, (EM_VAL args_handle, EM_VAL defaults_handle), {
+    const args = Emval.toValue(args_handle);
+    const defaults = Emval.toValue(defaults_handle);
+    const filled = {};
+    for (const key in defaults) {
+        const value = args[key];
+        filled[key] = value === undefined ? defaults[key] : value;
+    }
+    return Emval.toHandle(filled);
+});
+
+EM_JS(EM_VAL, cppschema_array_with_defaults, (EM_VAL array_handle, EM_VAL defaults_handle), {
+    const array = Emval.toValue(array_handle);
+    const defaults = Emval.toValue(defaults_handle);
+    const filled = new Array(array.length);
+    for (let i = 0; i < array.length; ++i) {
+        const args = array[i];
+        const element = {};
+        for (const key in defaults) {
+            const value = args[key];
+            element[key] = value === undefined ? defaults[key] : value;
+        }
+        filled[i] = element;
+    }
+    return Emval.toHandle(filled);
+});
+
+namespace cppschema::jsbridge::internal {
+
+EM_VAL WithDefaults(EM_VAL args, EM_VAL defaults) {
+    return cppschema_with_defaults(args, defaults);
+}
+
+EM_VAL ArrayWithDefaults(EM_VAL array, EM_VAL defaults) {
+    return cppschema_array_with_defaults(array, defaults);
+}
+
+}  // namespace cppschema::jsbridge::internal
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include <emscripten/bind.h>
+#include <emscripten/val.h>
+
+#include "cppschema/common/containers.h"
+#include "cppschema/common/schema_traits.h"
+#include "cppschema/wasm/js_converter.h"
+#include "cppschema/wasm/js_crossings.h"
+
+namespace cppschema::jsbridge {
+
+/**
+ * How the requests and responses of the JS methods are converted, see `CreateJsApiMethods`. The
+ * engines have the same JS-visible behavior, and differ in how often they cross the wasm / JS
+ * boundary.
+ */
+enum class JsEngine {
+    // Property by property, through `emscripten::val` (see `JSConverter`). Each field costs a few
+    // calls into JS. Best for the small structs, and for the arrays which cross in bulk.
+    kVal,
+    // The structs are embind value objects, generated from their members (see
+    // `RegisterValueObject`). The generated JS reads and writes their numbers and bools in the
+    // wasm memory, so a struct crosses in one call. Best for the mid-size structs of such fields,
+    // and for the arrays of them.
+    kValueObject,
+};
+
+/**
+ * Converts like `JSConverter`, but the visible structs, and the vectors of them, cross as embind
+ * value objects. Their other fields (e.g. enums, 64-bit integers, vectors) are converted by the
+ * `JSConverter`, from accessors which the generated JS calls.
+ */
+template <typename T, typename Enable = void>
+struct ValueObjectConverter {
+    static emscripten::val toJS(const T& value) { return JSConverter<T>::toJS(value); }
+    static T fromJS(emscripten::val v) { return JSConverter<T>::fromJS(std::move(v)); }
+};
+
+namespace internal {
+
+// The fields read and written in place by the generated JS. The 64-bit integers are not, as they
+// also cross as numbers (see CPPSCHEMA_WASM_BIGINT). Nor are the strings: embind throws on the
+// other types, where `StringFromJS` reports them and charges the request limits.
+template <typename T>
+inline constexpr bool is_wire_field_v =
+    is_primitive_like<T>::value && !is_int64_like_v<T> && !std::is_same_v<T, std::string>;
+
+// The accessors of the fields which are not read in place.
+template <typename T, auto Ptr>
+member_pointee_t<Ptr> GetStructField(const T& obj) {
+    return obj.*Ptr;
+}
+
+template <typename T, auto Ptr>
+emscripten::val GetField(const T& obj) {
+    return ValueObjectConverter<member_pointee_t<Ptr>>::toJS(obj.*Ptr);
+}
+
+template <typename T, auto Ptr>
+void SetField(T& obj, emscripten::val v) {
+    // Only nested fields may still be undefined, see `ValueObjectConverter::fromJS`.
+    if (!v.isUndefined()) {
+        obj.*Ptr = ValueObjectConverter<member_pointee_t<Ptr>>::fromJS(std::move(v));
+    }
+}
+
+template <typename T>
+void RegisterValueObjectsOf();
+
+// The JS object of the default `T`, for filling the missing properties of the requests.
+template <typename T>
+const emscripten::val& DefaultsToJS() {
+    static const emscripten::val* const defaults = new emscripten::val(T{});
+    return *defaults;
+}
+
+// `args`, with the missing (or undefined) properties of `defaults`, so that embind does not reject
+// them. Also for each element of an array. Throws like the `JSConverter` on a null `args`.
+EM_VAL WithDefaults(EM_VAL args, EM_VAL defaults);
+EM_VAL ArrayWithDefaults(EM_VAL array, EM_VAL defaults);
+
+}  // namespace internal
+
+/**
+ * Registers the embind value object of a visible struct (see DEFINE_STRUCT_VISITOR_FUNCTION), and
+ * of the structs of its fields, once. Called by `CreateJsApiMethods` for the request and response
+ * types of an API, within EMSCRIPTEN_BINDINGS.
+ *
+ * The numbers (up to 32 bits) and bools are fields in place. The strings are converted like with
+ * kVal, and the nested structs are written through `ValueObjectConverter`, which keeps the defaults
+ * of their missing properties.
+ */
+template <typename T>
+void RegisterValueObject() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+    // Before the fields, for the recursive structs.
+    registered = true;
+    // The type names are only for the embind errors.
+    emscripten::value_object<T> object(typeid(T).name());
+    auto lambda = [&object]<typename P, P Ptr>(const char* name, std::integral_constant<P, Ptr>) {
+        using F = internal::member_pointee_t<Ptr>;
+        if constexpr (internal::is_wire_field_v<F>) {
+            object.field(name, Ptr);
+        } else if constexpr (internal::is_visible_struct_like<F>::value) {
+            RegisterValueObject<F>();
+            object.field(name, &internal::GetStructField<T, Ptr>, &internal::SetField<T, Ptr>);
+        } else {
+            internal::RegisterValueObjectsOf<F>();
+            object.field(name, &internal::GetField<T, Ptr>, &internal::SetField<T, Ptr>);
+        }
+    };
+    T{}._visit_member_ptrs(lambda);
+}
+
+// VISIBLE STRUCTS: One call each way.
+template <typename StructType>
+struct ValueObjectConverter<StructType, std::enable_if_t<internal::is_visible_struct_like<StructType>::value>> {
+    static emscripten::val toJS(const StructType& s) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, StructType, 1);
+        return emscripten::val(s);
+    }
+    static StructType fromJS(const emscripten::val& v) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, StructType, 1);
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, StructType, 1);
+        return emscripten::val::take_ownership(internal::WithDefaults(v.as_handle(),
+            internal::DefaultsToJS<StructType>().as_handle())).template as<StructType>();
+    }
+};
+
+// ARRAYS OF VISIBLE STRUCTS: Two calls per element.
+template <typename ArrayType>
+struct ValueObjectConverter<ArrayType, std::enable_if_t<internal::is_array_like<ArrayType>::value &&
+        internal::is_visible_struct_like<typename ArrayType::value_type>::value>> {
+    using T = typename ArrayType::value_type;
+
+    static emscripten::val toJS(const ArrayType& container) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCreate, ArrayType, 1 + container.size());
+        CPPSCHEMA_COUNT_CROSSINGS(kSet, ArrayType, container.size());
+        emscripten::val arr = emscripten::val::array();
+        size_t i = 0;
+        for (const T& item : container) {
+            arr.set(i++, emscripten::val(item));
+        }
+        return arr;
+    }
+    static ArrayType fromJS(const emscripten::val& v) {
+        CPPSCHEMA_COUNT_CROSSINGS(kCall, ArrayType, 1);
+        const emscripten::val filled = emscripten::val::take_ownership(
+            internal::ArrayWithDefaults(v.as_handle(), internal::DefaultsToJS<T>().as_handle()));
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, ArrayType, 1);
+        const size_t size = filled["length"].template as<size_t>();
+        CPPSCHEMA_COUNT_CROSSINGS(kGet, ArrayType, size);
+        CPPSCHEMA_COUNT_CROSSINGS(kAs, ArrayType, size);
+        ArrayType container{};
+        if (!internal::ChargeDecode(size, 0)) {
+            return {};
+        }
+        internal::ArrayBuilder<ArrayType> builder(&container);
+        if (!builder.Start(size)) {
+            ConversionErrorScope::Report("Expected an array of length " + std::to_string(container.size()) +
+                ", got an array of length " + std::to_string(size));
+            return {};
+        }
+        for (size_t i = 0; i < size; ++i) {
+            builder.Append(filled[i].template as<T>());
+        }
+        return container;
+    }
+};
+
+namespace internal {
+
+// The value objects which `ValueObjectConverter<T>` uses.
+template <typename T>
+void RegisterValueObjectsOf() {
+    if constexpr (is_visible_struct_like<T>::value) {
+        RegisterValueObject<T>();
+    } else if constexpr (is_array_like<T>::value) {
+        if constexpr (is_visible_struct_like<typename T::value_type>::value) {
+            RegisterValueObject<typename T::value_type>();
+        }
+    }
+}
+
+}  // namespace internal
+
+}  // namespace cppschema::jsbridge
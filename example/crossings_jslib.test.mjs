@@ -0,0 +1,86 @@
+// Execute this as:
+// $ bazel test --config=crossings //example:crossings_jslib_test
+//
+// Checks the number of the wasm / JS boundary crossings of the `GraphApi` calls (see
+// cppschema/wasm/js_crossings.h). A change in the converters that adds crossings should update
+// these budgets deliberately.
+
+import test from 'node:test';
+import assert from 'node:assert/strict';
+import { loadGraphWasmModule } from './graph_jslib_loader.mjs';
+
+test.before(async () => {
+    const wasmModule = await loadGraphWasmModule();
+    if (!wasmModule) {
+      throw new Error("Failed to load graph WASM module during global setup");
+    }
+    global.wasmModule = wasmModule;
+});
+
+// Returns the crossing counts of one API call.
+const countCrossings = (apiName, call) => {
+  wasmModule.resetCrossingCounts();
+  const response = call();
+  const counts = wasmModule.crossingCounts()[apiName];
+  assert.ok(counts, `No counts for ${apiName}`);
+  assert.equal(counts.calls, 1);
+  return {response, counts};
+};
+
+const makeNodes = (n) => Array.from({length: n}, (_, i) => ({
+  ui_name: `node_${i}`,
+  node_type: "FUNCTION",
+  timestamp: i,
+}));
+
+test('GraphApi crossing budgets', async (t) => {
+  if (!wasmModule.crossingCounts) {
+    t.skip("Not built with --config=crossings");
+    return;
+  }
+  const graph = new wasmModule.GraphApi();
+
+  await t.test('addNode', () => {
+    const {response, counts} = countCrossings('addNode',
+      () => graph.addNode({ui_name: "a", node_type: "FUNCTION", timestamp: 1}));
+    assert.ok(response.ok, response.status);
+    // Decode: 3 properties (get and check), each converted once. Encode: the id, and the response.
+    assert.ok(counts.total <= 15, JSON.stringify(counts));
+    assert.equal(counts.byKind.set, 3);
+  });
+
+  await t.test('addNodes grows linearly', () => {
+    const total = (n) => countCrossings('addNodes', () => graph.addNodes({nodes: makeNodes(n)})).counts.total;
+    const small = total(10);
+    const large = total(1010);
+    assert.ok(small <= 110, `${small}`);
+    // Per node: the element, and its 3 properties. The ids cross in bulk.
+    assert.ok((large - small) / 1000 <= 10, `${large - small}`);
+  });
+
+  await t.test('deleteNode', () => {
+    const {counts} = countCrossings('deleteNode', () => graph.deleteNode("missing"));
+    assert.ok(counts.total <= 7, JSON.stringify(counts));
+  });
+
+  await t.test('clearGraph', () => {
+    const {counts} = countCrossings('clearGraph', () => graph.clearGraph({}));
+    assert.ok(counts.total <= 6, JSON.stringify(counts));
+  });
+
+  await t.test('a failed call', () => {
+    const {response, counts} = countCrossings('addNode',
+      () => graph.addNode({ui_name: "a", node_type: "NO_SUCH_TYPE", timestamp: 1}));
+    assert.equal(response.ok, false);
+    // The decode, then the response with the error status.
+    assert.ok(counts.total <= 16, JSON.stringify(counts));
+  });
+
+  await t.test('attributed to the converters', () => {
+    const {counts} = countCrossings('addNode',
+      () => graph.addNode({ui_name: "b", node_type: "FUNCTION", timestamp: 2}));
+    const types = Object.keys(counts.byType);
+    assert.ok(types.some((type) => type.includes("AddNodeRequest")), types.join(", "));
+    assert.ok(types.includes("cppschema::Status"), types.join(", "));
+  });
+});
@@ -0,0 +1,99 @@
+#include "csr_index.h"
+
+#include <algorithm>
+
+namespace graph {
+
+void CsrIndex::Add(NodeIndex from, NodeIndex to, EdgeIndex edge) {
+    pending_[from].push_back({to, edge});
+    ++num_pending_;
+    MaybeCompact();
+}
+
+bool CsrIndex::Remove(NodeIndex from, EdgeIndex edge) {
+    if (auto it = pending_.find(from); it != pending_.end()) {
+        std::vector<Entry>& entries = it->second;
+        auto entry = std::find_if(entries.begin(), entries.end(),
+                                  [edge](const Entry& e) { return e.edge == edge; });
+        if (entry != entries.end()) {
+            *entry = entries.back();
+            entries.pop_back();
+            if (entries.empty()) {
+                pending_.erase(it);
+            }
+            --num_pending_;
+            return true;
+        }
+    }
+    if (static_cast<size_t>(from) + 1 < offsets_.size()) {
+        for (uint32_t i = offsets_[from]; i < offsets_[from + 1]; ++i) {
+            if (entries_[i].node != kRemoved && entries_[i].edge == edge) {
+                entries_[i].node = kRemoved;
+                ++removed_;
+                MaybeCompact();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t CsrIndex::Degree(NodeIndex from) const {
+    size_t degree = 0;
+    ForEach(from, [&degree](const Entry&) { ++degree; });
+    return degree;
+}
+
+void CsrIndex::MaybeCompact() {
+    const size_t changes = removed_ + num_pending_;
+    if (changes >= kMinChangesToCompact && changes >= entries_.size() / 4) {
+        Compact();
+    }
+}
+
+void CsrIndex::Compact() {
+    if (compacted()) {
+        return;
+    }
+    size_t num_rows = offsets_.empty() ? 0 : offsets_.size() - 1;
+    for (const auto& [from, entries] : pending_) {
+        num_rows = std::max<size_t>(num_rows, static_cast<size_t>(from) + 1);
+    }
+    // Counting sort of the live entries by their row, keeping the order within a row.
+    std::vector<uint32_t> offsets(num_rows + 1, 0);
+    for (NodeIndex from = 0; from < num_rows; ++from) {
+        offsets[from + 1] = static_cast<uint32_t>(Degree(from));
+    }
+    for (size_t row = 0; row < num_rows; ++row) {
+        offsets[row + 1] += offsets[row];
+    }
+    std::vector<Entry> entries(offsets[num_rows]);
+    for (NodeIndex from = 0; from < num_rows; ++from) {
+        uint32_t pos = offsets[from];
+        ForEach(from, [&](const Entry& entry) { entries[pos++] = entry; });
+    }
+    offsets_ = std::move(offsets);
+    entries_ = std::move(entries);
+    removed_ = 0;
+    pending_.clear();
+    num_pending_ = 0;
+}
+
+void CsrIndex::Clear() {
+    offsets_.clear();
+    entries_.clear();
+    removed_ = 0;
+    pending_.clear();
+    num_pending_ = 0;
+}
+
+size_t CsrIndex::MemoryUsage() const {
+    size_t bytes = offsets_.capacity() * sizeof(uint32_t) + entries_.capacity() * sizeof(Entry) +
+        pending_.capacity() * (sizeof(std::pair<NodeIndex, std::vector<Entry>>) + 1);
+    for (const auto& [from, entries] : pending_) {
+        bytes += entries.capacity() * sizeof(Entry);
+    }
+    return bytes;
+}
+
+}  // namespace graph
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace graph {
+
+using NodeIndex = uint32_t;
+using EdgeIndex = uint32_t;
+
+/**
+ * The adjacency lists of a graph in compressed sparse row (CSR) form: the neighbors of all the
+ * nodes in a single array, node after node, so that a traversal reads memory sequentially.
+ *
+ * The changes are applied incrementally. Removed entries are marked in place, and added ones are
+ * kept aside per node. Once these amount to a fraction of the index, it is compacted, which keeps
+ * the cost of a change amortized constant.
+ *
+ * @example
+ * CsrIndex out_edges;
+ * out_edges.Add(from, to, edge);
+ * out_edges.ForEach(from, [](const CsrIndex::Entry& e) { Visit(e.node); });
+ */
+class CsrIndex {
+ public:
+    struct Entry {
+        NodeIndex node;
+        EdgeIndex edge;
+    };
+
+    void Add(NodeIndex from, NodeIndex to, EdgeIndex edge);
+    // Returns false if there is no such entry.
+    bool Remove(NodeIndex from, EdgeIndex edge);
+
+    // Calls `fn(const Entry&)` for each neighbor of a node. The index must not change meanwhile.
+    template <typename Fn>
+    void ForEach(NodeIndex from, Fn&& fn) const {
+        if (static_cast<size_t>(from) + 1 < offsets_.size()) {
+            for (uint32_t i = offsets_[from]; i < offsets_[from + 1]; ++i) {
+                if (entries_[i].node != kRemoved) {
+                    fn(entries_[i]);
+                }
+            }
+        }
+        if (!pending_.empty()) {
+            if (auto it = pending_.find(from); it != pending_.end()) {
+                for (const Entry& entry : it->second) {
+                    fn(entry);
+                }
+            }
+        }
+    }
+
+    size_t Degree(NodeIndex from) const;
+
+    // Applies all the pending changes, after which `offsets` and `entries` are the whole index.
+    void Compact();
+    bool compacted() const { return removed_ == 0 && num_pending_ == 0; }
+
+    // Entry `i` of `entries` is a neighbor of node `n` for `offsets[n] <= i < offsets[n + 1]`.
+    const std::vector<uint32_t>& offsets() const { return offsets_; }
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    // Number of the entries.
+    size_t size() const { return entries_.size() - removed_ + num_pending_; }
+    void Clear();
+    size_t MemoryUsage() const;
+
+ private:
+    static constexpr NodeIndex kRemoved = std::numeric_limits<NodeIndex>::max();
+    // Below this many changes, the index is not compacted.
+    static constexpr size_t kMinChangesToCompact = 4096;
+
+    void MaybeCompact();
+
+    std::vector<uint32_t> offsets_;
+    std::vector<Entry> entries_;
+    size_t removed_ = 0;
+    absl::flat_hash_map<NodeIndex, std::vector<Entry>> pending_;
+    size_t num_pending_ = 0;
+};
+
+}  // namespace graph
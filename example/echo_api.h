@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/common/blob.h"
+#include "cppschema/common/enum_registry.h"
+#include "cppschema/common/interned_string.h"
+#include "cppschema/common/visitor_macros.h"
+
+namespace echo {
+
+// Every numeric type, used to check that the values cross the JS boundary without losing precision.
+struct NumericRecord {
+    int8_t i8 = 0;
+    uint8_t u8 = 0;
+    int16_t i16 = 0;
+    uint16_t u16 = 0;
+    int32_t i32 = 0;
+    uint32_t u32 = 0;
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    float f32 = 0;
+    double f64 = 0;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(i8, u8, i16, u16, i32, u32, i64, u64, f32, f64);
+};
+
+struct NumericVectors {
+    std::vector<uint8_t> bytes;
+    std::vector<int32_t> counts;
+    std::vector<int64_t> timestamps;
+    std::vector<uint64_t> hashes;
+    std::vector<double> weights;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(bytes, counts, timestamps, hashes, weights);
+};
+
+struct RepeatRequest {
+    NumericRecord record;
+    uint32_t count = 0;
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(record, count);
+};
+
+// The containers other than std::vector, which cross as the same JS objects and arrays.
+struct Containers {
+    absl::flat_hash_map<std::string, int32_t> counts;
+    absl::btree_map<std::string, double> weights;
+    std::unordered_set<std::string> tags;
+    absl::btree_set<uint32_t> ids;
+    std::deque<NumericRecord> records;
+    std::array<double, 3> position{};
+
+    DEFINE_STRUCT_VISITOR_FUNCTION(counts, weights, tags, ids, records, position);
+};
+
+// Sent to JS as ordinals.
+enum class Shape { CIRCLE, SQUARE, TRIANGLE = 5 };
+
+DEFINE_ENUM_CONVERSION_FUNCTION(Shape, CIRCLE, SQUARE, TRIANGLE);
+DEFINE_ENUM_ORDINAL_TRANSFER(Shape);
+
+// Returns the requests unchanged.
+struct EchoApi {
+    cppschema::ApiStub<NumericRecord, NumericRecord> echoNumbers;
+    cppschema::ApiStub<NumericVectors, NumericVectors> echoVectors;
+    cppschema::ApiStub<std::vector<std::string>, std::vector<std::string>> echoStrings;
+    cppschema::ApiStub<std::vector<cppschema::InternedString>, std::vector<cppschema::InternedString>> echoInterned;
+    cppschema::ApiStub<std::vector<Shape>, std::vector<Shape>> echoShapes;
+    cppschema::ApiStub<Containers, Containers> echoContainers;
+    // Returns `count` copies of the record, streamed by the backend.
+    cppschema::ApiStub<RepeatRequest, std::vector<NumericRecord>> repeatNumbers;
+    // The same bytes, not a copy.
+    cppschema::ApiStub<cppschema::Blob, cppschema::Blob> echoBlob;
+    // Returns a blob of `size` bytes, where byte i is `i % 251`.
+    cppschema::ApiStub<uint32_t, cppschema::Blob> makeBlob;
+    // A coroutine (see cppschema/apispec/task.h), which returns what `globalThis.echoSource(text)`
+    // resolves to in JS, or the text when there is no such function.
+    cppschema::ApiStub<std::string, std::string> echoFromJs;
+    // Same as `echoNumbers`, traced even in the builds without tracing (see api_policies.h).
+    cppschema::ApiStub<NumericRecord, NumericRecord, cppschema::Trace> echoTraced;
+
+    DEFINE_API_VISITOR_FUNCTION(echoNumbers, echoVectors, echoStrings, echoInterned, echoShapes,
+                                echoContainers, repeatNumbers, echoBlob, makeBlob, echoFromJs,
+                                echoTraced);
+};
+
+}  // namespace echo
@@ -0,0 +1,89 @@
+#include <string>
+#include <utility>
+
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/task.h"
+#include "cppschema/backend/api_backend_bridge.h"
+#include "echo_api.h"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/val.h>
+
+#include "cppschema/wasm/js_task.h"
+#endif
+
+namespace echo {
+
+class EchoApiImpl : public cppschema::ApiBackend<EchoApi> {
+ public:
+    NumericRecord echoNumbersImpl(const NumericRecord& request) { return request; }
+
+    NumericVectors echoVectorsImpl(const NumericVectors& request) { return request; }
+
+    std::vector<std::string> echoStringsImpl(const std::vector<std::string>& request) { return request; }
+
+    std::vector<cppschema::InternedString> echoInternedImpl(
+            const std::vector<cppschema::InternedString>& request) {
+        return request;
+    }
+
+    std::vector<Shape> echoShapesImpl(const std::vector<Shape>& request) { return request; }
+
+    Containers echoContainersImpl(const Containers& request) { return request; }
+
+    cppschema::Status repeatNumbersImpl(const RepeatRequest& request,
+                                        cppschema::ArraySink<NumericRecord>* records) {
+        records->Reserve(request.count);
+        for (uint32_t i = 0; i < request.count; ++i) {
+            records->Append(request.record);
+        }
+        return cppschema::OkStatus();
+    }
+
+    cppschema::Blob echoBlobImpl(const cppschema::Blob& request) { return request; }
+
+    cppschema::Blob makeBlobImpl(const uint32_t& size) {
+        cppschema::Blob blob = cppschema::Blob::Allocate(size);
+        uint8_t* data = blob.mutable_data();
+        for (uint32_t i = 0; i < size; ++i) {
+            data[i] = static_cast<uint8_t>(i % 251);
+        }
+        return blob;
+    }
+
+    cppschema::Task<std::string> echoFromJsImpl(const std::string& text) {
+#ifdef __EMSCRIPTEN__
+        emscripten::val source = emscripten::val::global("echoSource");
+        if (source.typeOf().as<std::string>() == "function") {
+            cppschema::Expected<emscripten::val> echoed = co_await cppschema::jsbridge::AwaitJs(source(text));
+            if (!echoed.has_value()) {
+                co_return cppschema::Unexpected(std::move(echoed).error());
+            }
+            if (!echoed->isString()) {
+                co_return cppschema::Unexpected(cppschema::InvalidArgumentError("echoSource must resolve to a string"));
+            }
+            co_return echoed->as<std::string>();
+        }
+#endif
+        co_await cppschema::Yield();
+        co_return text;
+    }
+};
+
+static __attribute__((constructor)) void RegisterEchoApiBackend() {
+    cppschema::RegisterBackend<EchoApi, EchoApiImpl>(new EchoApiImpl(), {
+        .echoNumbers = &EchoApiImpl::echoNumbersImpl,
+        .echoVectors = &EchoApiImpl::echoVectorsImpl,
+        .echoStrings = &EchoApiImpl::echoStringsImpl,
+        .echoInterned = &EchoApiImpl::echoInternedImpl,
+        .echoShapes = &EchoApiImpl::echoShapesImpl,
+        .echoContainers = &EchoApiImpl::echoContainersImpl,
+        .repeatNumbers = &EchoApiImpl::repeatNumbersImpl,
+        .echoBlob = &EchoApiImpl::echoBlobImpl,
+        .makeBlob = &EchoApiImpl::makeBlobImpl,
+        .echoFromJs = &EchoApiImpl::echoFromJsImpl,
+        .echoTraced = &EchoApiImpl::echoNumbersImpl,
+    });
+}
+
+}  // namespace echo
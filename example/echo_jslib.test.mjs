@@ -0,0 +1,319 @@
+// Execute this as:
+// $ bazel test //:echo_jslib_test
+
+import test from 'node:test';
+import assert from 'node:assert/strict';
+import { loadGraphWasmModule } from './graph_jslib_loader.mjs';
+
+test.before(async () => {
+    const wasmModule = await loadGraphWasmModule();
+    if (!wasmModule) {
+      throw new Error("Failed to load graph WASM module during global setup");
+    }
+    global.wasmModule = wasmModule;
+});
+
+test('WASM Numeric Round Trip Test', async (t) => {
+  const echo = new wasmModule.EchoApi();
+
+  const assertRpcOkAndGetPayload = (rpcResp) => {
+    assert.ok(rpcResp.ok, `RPC call failed: ${rpcResp.status}`);
+    return rpcResp.data;
+  }
+
+  await t.test('scalars keep their extreme values', () => {
+    const record = {
+      i8: -128,
+      u8: 255,
+      i16: -32768,
+      u16: 65535,
+      i32: -2147483648,
+      u32: 4294967295,
+      i64: -(2n ** 63n),
+      u64: 2n ** 64n - 1n,
+      f32: Math.fround(0.1),
+      f64: 0.1 + 0.2,
+    };
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoNumbers(record)), record);
+  });
+
+  await t.test('64-bit integers beyond 2^53 are exact', () => {
+    const record = assertRpcOkAndGetPayload(echo.echoNumbers({i64: 2n ** 53n + 1n, u64: 2n ** 63n + 7n}));
+    assert.strictEqual(record.i64, 9007199254740993n);
+    assert.strictEqual(record.u64, 9223372036854775815n);
+  });
+
+  await t.test('64-bit integers accept plain numbers', () => {
+    const timestamp = Date.now();
+    const record = assertRpcOkAndGetPayload(echo.echoNumbers({i64: timestamp}));
+    assert.strictEqual(record.i64, BigInt(timestamp));
+    assert.match(echo.echoNumbers({i64: "1"}).status, /INVALID_ARGUMENT/);
+    for (const record of [{i64: 1.5}, {i64: NaN}, {i64: Infinity}, {i64: 2 ** 63}, {u64: -1}, {u64: 2 ** 64}]) {
+      assert.match(echo.echoNumbers(record).status, /INVALID_ARGUMENT/, JSON.stringify(record));
+    }
+  });
+
+  await t.test('doubles are not narrowed', () => {
+    for (const f64 of [Number.MIN_VALUE, Number.MAX_VALUE, -0, 1 / 3, Infinity, NaN]) {
+      assert.ok(Object.is(assertRpcOkAndGetPayload(echo.echoNumbers({f64})).f64, f64), `${f64}`);
+    }
+  });
+
+  await t.test('numeric vectors round trip in bulk', () => {
+    const vectors = {
+      bytes: [0, 1, 255],
+      counts: [-2147483648, 0, 2147483647],
+      timestamps: [-(2n ** 63n), 0n, 2n ** 53n + 1n],
+      hashes: [0n, 2n ** 64n - 1n],
+      weights: Array.from({length: 100000}, (_, i) => i / 7),
+    };
+    const echoed = assertRpcOkAndGetPayload(echo.echoVectors(vectors));
+    assert.ok(Array.isArray(echoed.weights), "Vectors should come back as plain arrays");
+    assert.deepEqual(echoed, vectors);
+  });
+
+  await t.test('empty vectors', () => {
+    const vectors = {bytes: [], counts: [], timestamps: [], hashes: [], weights: []};
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoVectors(vectors)), vectors);
+  });
+
+  await t.test('requests over the limits are rejected', () => {
+    // echoVectors takes up to 200000 elements, see graph_embind.cpp.
+    const rejected = echo.echoVectors({weights: new Array(300000).fill(0.5)});
+    assert.equal(rejected.ok, false);
+    assert.match(rejected.status, /^RESOURCE_EXHAUSTED: The request has over 200000 elements/);
+    assert.ok(echo.echoVectors({weights: new Array(100).fill(0.5)}).ok, "The next request has its own budget");
+  });
+
+  await t.test('heap stats', () => {
+    const vectors = {weights: Array.from({length: 10000}, (_, i) => i)};
+    wasmModule.resetHeapStats();
+    assertRpcOkAndGetPayload(echo.echoVectors(vectors));
+    assert.equal(echo.heapStats.apis.echoVectors, undefined, "Off until setHeapAccounting(true)");
+
+    wasmModule.setHeapAccounting(true);
+    try {
+      assertRpcOkAndGetPayload(echo.echoVectors(vectors));
+      assertRpcOkAndGetPayload(echo.echoVectors(vectors));
+    } finally {
+      wasmModule.setHeapAccounting(false);
+    }
+    const stats = echo.heapStats;
+    assert.equal(stats.apis.echoVectors.calls, 2);
+    // The request and the response vectors.
+    assert.ok(stats.apis.echoVectors.maxGrowthBytes >= 8 * 10000, JSON.stringify(stats));
+    assert.ok(stats.peakLiveBytes >= stats.apis.echoVectors.peakLiveBytes);
+    assert.ok(stats.reservedBytes >= stats.liveBytes);
+    assert.equal(stats.apis.echoStrings, undefined, "Only the apis called since the reset");
+  });
+
+  await t.test('string arrays round trip in bulk', () => {
+    const strings = ["", "FUNCTION_1000", "é", "中文", "😀 emoji", "a\u0000b", "\uFFFD"];
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoStrings(strings)), strings);
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoStrings([])), []);
+  });
+
+  await t.test('large id lists', () => {
+    const ids = Array.from({length: 300000}, (_, i) => `FUNCTION_${i}`);
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoStrings(ids)), ids);
+  });
+
+  await t.test('interned strings are reused across calls', () => {
+    const ids = Array.from({length: 1000}, (_, i) => `FUNCTION_${i % 100}`);
+    for (let round = 0; round < 3; ++round) {
+      assert.deepEqual(assertRpcOkAndGetPayload(echo.echoInterned(ids)), ids);
+    }
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoInterned(["", "中文", "😀"])), ["", "中文", "😀"]);
+    const response = echo.echoInterned(["a", 1]);
+    assert.equal(response.ok, false);
+    assert.match(response.status, /INVALID_ARGUMENT/);
+  });
+
+  await t.test('ordinal enums cross as numbers', () => {
+    const {Shape: names} = wasmModule.enumNames();
+    assert.equal(names[0], "CIRCLE");
+    assert.equal(names[5], "TRIANGLE");
+    const shapes = Array.from({length: 10000}, (_, i) => [0, 1, 5][i % 3]);
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoShapes(shapes)), shapes);
+    // Names are still accepted.
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoShapes(["SQUARE", 5])), [1, 5]);
+    for (const bad of [[2], [1.5], [256], ["HEXAGON"]]) {
+      const response = echo.echoShapes(bad);
+      assert.equal(response.ok, false, `${bad}`);
+      assert.match(response.status, /INVALID_ARGUMENT/);
+    }
+  });
+
+  await t.test('hash, sorted and fixed size containers', () => {
+    const containers = {
+      counts: {a: 1, b: -2},
+      weights: {y: 0.5, x: 2},
+      tags: ["red", "blue", "red"],
+      ids: [7, 3, 5],
+      records: [{i32: 1}, {u64: 2n}],
+      position: [1.5, -2, 3],
+    };
+    const echoed = assertRpcOkAndGetPayload(echo.echoContainers(containers));
+    assert.deepEqual(echoed.counts, containers.counts);
+    assert.deepEqual(Object.keys(echoed.weights), ["x", "y"], "Sorted maps keep their order");
+    assert.deepEqual(echoed.tags.sort(), ["blue", "red"]);
+    assert.deepEqual(echoed.ids, [3, 5, 7]);
+    assert.equal(echoed.records[1].u64, 2n);
+    assert.deepEqual(echoed.position, containers.position);
+
+    const response = echo.echoContainers({position: [1, 2]});
+    assert.equal(response.ok, false);
+    assert.match(response.status, /INVALID_ARGUMENT: Expected an array of length 3/);
+  });
+
+  await t.test('streamed responses', () => {
+    const record = {i8: 1, u8: 2, i16: 3, u16: 4, i32: 5, u32: 6, i64: 7n, u64: 8n, f32: 0.5, f64: 0.25};
+    const records = assertRpcOkAndGetPayload(echo.repeatNumbers({record, count: 1000}));
+    assert.equal(records.length, 1000);
+    assert.deepEqual(records[999], record);
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.repeatNumbers({record, count: 0})), []);
+  });
+
+  await t.test('blobs cross without a copy', () => {
+    const live = wasmModule.liveBlobCount();
+    const size = 64 * 1024 * 1024;
+    const made = assertRpcOkAndGetPayload(echo.makeBlob(size));
+    assert.equal(made.size, size);
+    assert.ok(made.bytes instanceof Uint8Array);
+    assert.equal(made.bytes[size - 1], (size - 1) % 251);
+
+    // Passing the handle back shares the bytes.
+    const echoed = assertRpcOkAndGetPayload(echo.echoBlob(made));
+    assert.strictEqual(echoed.bytes.buffer, made.bytes.buffer, "Views of the wasm memory");
+    assert.equal(echoed.bytes.byteOffset, made.bytes.byteOffset);
+    assert.equal(wasmModule.liveBlobCount(), live + 2);
+    made.release();
+    made.release();
+    assert.equal(made.bytes, undefined);
+    assert.equal(echoed.bytes[1000], 1000 % 251, "Alive until the last handle is released");
+    echoed.release();
+    assert.equal(wasmModule.liveBlobCount(), live);
+
+    const response = echo.echoBlob(made);
+    assert.equal(response.ok, false);
+    assert.match(response.status, /released/);
+  });
+
+  await t.test('blobs filled by JS are adopted', () => {
+    const blob = wasmModule.allocBlob(1000);
+    blob.bytes.set(Array.from({length: 1000}, (_, i) => i & 0xff));
+    const echoed = assertRpcOkAndGetPayload(echo.echoBlob(blob));
+    assert.equal(echoed.bytes.byteOffset, blob.bytes.byteOffset);
+    blob.bytes[0] = 42;
+    assert.equal(echoed.bytes[0], 42);
+    blob.release();
+    echoed.release();
+
+    // A plain Uint8Array is copied once.
+    const copied = assertRpcOkAndGetPayload(echo.echoBlob(new Uint8Array([1, 2, 3])));
+    assert.deepEqual(Array.from(copied.bytes), [1, 2, 3]);
+    copied.release();
+    assert.equal(echo.echoBlob("abc").ok, false);
+  });
+
+  await t.test('coroutine methods return promises', async () => {
+    const pending = echo.echoFromJs("plain");
+    assert.ok(pending instanceof Promise);
+    assert.equal(assertRpcOkAndGetPayload(await pending), "plain");
+
+    // The calls interleave while they await JS, and complete in the order JS resolves them.
+    const resolvers = [];
+    globalThis.echoSource = (text) => new Promise((resolve) => resolvers.push(() => resolve(text + "!")));
+    try {
+      const done = [];
+      const calls = ["a", "b", "c"].map((text) => echo.echoFromJs(text).then((response) => {
+        done.push(assertRpcOkAndGetPayload(response));
+      }));
+      await new Promise((resolve) => setTimeout(resolve, 0));
+      assert.equal(resolvers.length, 3);
+      resolvers[2]();
+      resolvers[0]();
+      resolvers[1]();
+      await Promise.all(calls);
+      assert.deepEqual(done, ["c!", "a!", "b!"]);
+
+      globalThis.echoSource = () => Promise.reject(new Error("no such file"));
+      const rejected = await echo.echoFromJs("x");
+      assert.equal(rejected.ok, false);
+      assert.match(rejected.status, /INTERNAL: .*no such file/);
+
+      globalThis.echoSource = () => 42;
+      assert.match((await echo.echoFromJs("x")).status, /INVALID_ARGUMENT/);
+    } finally {
+      delete globalThis.echoSource;
+    }
+    // Conversion errors resolve too.
+    assert.equal((await echo.echoFromJs(1)).ok, false);
+  });
+
+  await t.test('non-string elements fail the call', () => {
+    const response = echo.echoStrings(["a", 1]);
+    assert.equal(response.ok, false);
+    assert.match(response.status, /INVALID_ARGUMENT/);
+  });
+
+  await t.test('apis with the Trace policy are traced in any build', () => {
+    wasmModule.clearTrace();
+    assert.deepEqual(assertRpcOkAndGetPayload(echo.echoTraced({i32: 7})).i32, 7);
+    const events = JSON.parse(wasmModule.exportChromeTrace()).traceEvents;
+    const spans = events.filter((event) => event.name === "echoTraced");
+    assert.ok(spans.some((event) => event.cat === "call"), JSON.stringify(events));
+    assert.ok(spans.some((event) => event.cat === "encode"), JSON.stringify(events));
+    wasmModule.clearTrace();
+  });
+});
+
+test('Value object engine', async (t) => {
+  const engines = [new wasmModule.EchoApi(), new wasmModule.EchoApiValueObject()];
+  const graphs = [new wasmModule.GraphApi(), new wasmModule.GraphApiValueObject()];
+
+  // Calls an API with both engines, which should respond the same.
+  const sameResponses = (apis, method, request) => {
+    const [expected, actual] = apis.map((api) => api[method](request));
+    assert.deepEqual(actual, expected, `${method}(${JSON.stringify(request, (_, v) => String(v))})`);
+    return actual;
+  };
+
+  await t.test('structs of numbers', () => {
+    const record = {
+      i8: -128, u8: 255, i16: -32768, u16: 65535, i32: -2147483648, u32: 4294967295,
+      i64: -(2n ** 63n), u64: 2n ** 64n - 1n, f32: Math.fround(0.1), f64: NaN,
+    };
+    assert.deepEqual(sameResponses(engines, 'echoNumbers', record).data, record);
+    // The missing properties are the defaults.
+    assert.deepEqual(sameResponses(engines, 'echoNumbers', {u16: 7}).data.u16, 7);
+    sameResponses(engines, 'echoNumbers', {i64: Date.now(), f64: undefined});
+  });
+
+  await t.test('nested structs and vectors', () => {
+    sameResponses(engines, 'repeatNumbers', {record: {i8: 1, u64: 8n}, count: 3});
+    sameResponses(engines, 'repeatNumbers', {count: 2});
+    sameResponses(engines, 'echoVectors', {bytes: [1, 2], timestamps: [2n ** 53n + 1n], weights: [0.5]});
+    sameResponses(engines, 'echoStrings', ["", "中文", "😀"]);
+    sameResponses(engines, 'echoShapes', [0, "SQUARE", 5]);
+    sameResponses(engines, 'echoContainers', {weights: {b: 1, a: 2}, ids: [2, 1], records: [{i8: 1}], position: [1, 2, 3]});
+  });
+
+  await t.test('errors', () => {
+    assert.equal(sameResponses(engines, 'echoShapes', [2]).ok, false);
+    assert.equal(sameResponses(engines, 'echoContainers', {position: [1]}).ok, false);
+    assert.equal(sameResponses(graphs, 'getReachable', {id: "NO_SUCH_NODE"}).ok, false);
+    assert.equal(sameResponses(graphs, 'addNode', {ui_name: "a", node_type: "NO_SUCH_TYPE"}).ok, false);
+    // A mistyped string field is reported, not thrown by embind.
+    assert.match(sameResponses(graphs, 'addNode', {ui_name: 1}).status, /INVALID_ARGUMENT: Expected a string/);
+  });
+
+  await t.test('coroutine methods', async () => {
+    const [expected, actual] = await Promise.all(engines.map((echo) => echo.echoFromJs("text")));
+    assert.deepEqual(actual, expected);
+  });
+
+  await t.test('api infos', () => {
+    assert.deepEqual(engines[1].apis.map((api) => api.name), engines[0].apis.map((api) => api.name));
+  });
+});
@@ -0,0 +1,66 @@
+// Compares the bindings engines (see `JsEngine` in cppschema/wasm/js_value_object.h) on the same
+// calls, and prints the time per call with each. Build with -c opt for meaningful numbers.
+//
+// $ bazel run -c opt //:engines_benchmark
+
+import { loadGraphWasmModule } from './graph_jslib_loader.mjs';
+
+// The mean time of a call, in microseconds, after a warm up.
+const timeCall = (call, iterations) => {
+  for (let i = 0; i < Math.min(iterations, 100); ++i) {
+    call(i);
+  }
+  const start = performance.now();
+  for (let i = 0; i < iterations; ++i) {
+    const response = call(i);
+    if (!response.ok) {
+      throw new Error(response.status);
+    }
+  }
+  return (performance.now() - start) * 1000 / iterations;
+};
+
+const makeNodes = (n) => Array.from({length: n}, (_, i) => ({
+  ui_name: `node_${i}`,
+  node_type: "FUNCTION",
+  timestamp: i,
+}));
+
+const record = {
+  i8: -1, u8: 2, i16: -3, u16: 4, i32: -5, u32: 6, i64: 7n, u64: 8n, f32: 0.5, f64: 0.25,
+};
+
+// Each case gets fresh APIs, and clears the graph first.
+const cases = [
+  ['addNode', 20000, (graph) => (i) => graph.addNode({ui_name: `n${i}`, node_type: "FUNCTION", timestamp: i})],
+  ['addNodes x100', 500, (graph) => () => graph.addNodes({nodes: makeNodes(100)})],
+  ['getReachable (1000 nodes)', 2000, (graph) => {
+    const ids = graph.addNodes({nodes: makeNodes(1000)}).data;
+    graph.addEdges({entries: ids.slice(1).map((id, i) => ({source: ids[i], target: id}))});
+    return () => graph.getReachable({id: ids[0]});
+  }],
+  ['echoNumbers', 20000, (graph, echo) => () => echo.echoNumbers(record)],
+  ['echoNumbers, 1 property', 20000, (graph, echo) => () => echo.echoNumbers({i32: 1})],
+  ['repeatNumbers x1000', 200, (graph, echo) => () => echo.repeatNumbers({record, count: 1000})],
+  ['echoStrings x300000 ids', 10, (graph, echo) => {
+    const ids = Array.from({length: 300000}, (_, i) => `FUNCTION_${i}`);
+    return () => echo.echoStrings(ids);
+  }],
+];
+
+(async () => {
+  const module = await loadGraphWasmModule();
+  const engines = [
+    ['val', () => [new module.GraphApi(), new module.EchoApi()]],
+    ['value_object', () => [new module.GraphApiValueObject(), new module.EchoApiValueObject()]],
+  ];
+  console.log(['case', ...engines.map(([name]) => `${name} (us/call)`), 'speedup'].join('\t'));
+  for (const [name, iterations, makeCall] of cases) {
+    const times = engines.map(([, makeApis]) => {
+      const [graph, echo] = makeApis();
+      graph.clearGraph({});
+      return timeCall(makeCall(graph, echo), iterations);
+    });
+    console.log([name, ...times.map((t) => t.toFixed(2)), `${(times[0] / times[1]).toFixed(2)}x`].join('\t'));
+  }
+})();
@@ -0,0 +1,57 @@
+// Writes the header of a synthetic API spec (see schema_generator.h), used by the
+// `synthetic_schema` rules of synthetic_schema.bzl.
+//
+// $ bazel run //:generate_schema -- --width=30 --depth=3 --containers=vector,map,optional \
+//       --enums=4 --enum_values=8 --fanout=2 --out=/tmp/synthetic_api.h
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "schema_generator.h"
+
+int main(int argc, char** argv) {
+    synthetic::SchemaShape shape;
+    std::string out;
+    cppschema::Status status;
+    for (int i = 1; i < argc && status.ok(); ++i) {
+        const std::string_view arg = argv[i];
+        const std::string_view value = arg.substr(arg.find('=') + 1);
+        if (arg.starts_with("--width=")) {
+            shape.width = std::atoi(value.data());
+        } else if (arg.starts_with("--depth=")) {
+            shape.depth = std::atoi(value.data());
+        } else if (arg.starts_with("--containers=")) {
+            status = synthetic::ParseContainerKinds(value, &shape.containers);
+        } else if (arg.starts_with("--enums=")) {
+            shape.enums = std::atoi(value.data());
+        } else if (arg.starts_with("--enum_values=")) {
+            shape.enum_values = std::atoi(value.data());
+        } else if (arg.starts_with("--fanout=")) {
+            shape.fanout = std::atoi(value.data());
+        } else if (arg.starts_with("--out=")) {
+            out = value;
+        } else {
+            status = cppschema::InvalidArgumentError("Unknown flag: " + std::string(arg));
+        }
+    }
+    if (status.ok()) {
+        status = synthetic::ValidateSchemaShape(shape);
+    }
+    if (!status.ok() || out.empty()) {
+        std::cerr << status.ToString() << "\nUsage: " << argv[0]
+                  << " --out=<header> [--width=N] [--depth=N] [--containers=vector,deque,array,map,"
+                     "hash_map,set,hash_set,optional] [--enums=N] [--enum_values=N] [--fanout=N]\n";
+        return 2;
+    }
+
+    std::ofstream file(out, std::ios::binary);
+    file << synthetic::GenerateSchemaHeader(shape);
+    if (!file.flush()) {
+        std::cerr << "Can not write " << out << "\n";
+        return 1;
+    }
+    return 0;
+}
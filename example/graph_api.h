@@ -5,6 +5,7 @@
 
 #include "cppschema/apispec/api_framework.h"
 #include "cppschema/common/enum_registry.h"
+#include "cppschema/common/interned_string.h"
 #include "cppschema/common/strong_types.h"
 #include "cppschema/common/types.h"
 #include "cppschema/common/visitor_macros.h"
@@ -15,8 +16,9 @@ DEFINE_STRONG_UINT_TYPE(EdgeId);
 
 struct EdgeConnection {
     EdgeId id;
-    std::string source;
-    std::string target;
+    // Node ids repeat across the edges, and are interned.
+    cppschema::InternedString source;
+    cppschema::InternedString target;
 
     DEFINE_STRUCT_VISITOR_FUNCTION(id, source, target);
 };
@@ -27,6 +29,12 @@ enum class NodeTypeEnum {
 
 DEFINE_ENUM_CONVERSION_FUNCTION(NodeTypeEnum, UNKNOWN, GRAPH_INPUT, GRAPH_OUTPUT, FUNCTION);
 
+enum class EdgeDirection {
+    OUTGOING, INCOMING, BOTH,
+};
+
+DEFINE_ENUM_CONVERSION_FUNCTION(EdgeDirection, OUTGOING, INCOMING, BOTH);
+
 struct GraphApi {
     struct AddNodeRequest {
         std::string ui_name;
@@ -36,22 +44,73 @@ struct GraphApi {
         DEFINE_STRUCT_VISITOR_FUNCTION(ui_name, node_type, timestamp);
     };
 
+    struct AddNodesRequest {
+        std::vector<AddNodeRequest> nodes;
+
+        DEFINE_STRUCT_VISITOR_FUNCTION(nodes);
+    };
+
+    // The nodes exported from another graph.
+    struct ImportNodesRequest {
+        // Only `kImportFormatVersion` is supported.
+        uint32_t format_version = 0;
+        std::vector<AddNodeRequest> nodes;
+
+        DEFINE_STRUCT_VISITOR_FUNCTION(format_version, nodes);
+    };
+
+    static constexpr uint32_t kImportFormatVersion = 1;
+
     struct AddEdgesRequest {
         std::vector<EdgeConnection> entries;
 
         DEFINE_STRUCT_VISITOR_FUNCTION(entries);
     };
 
+    struct NeighborsRequest {
+        std::string id;
+        EdgeDirection direction = EdgeDirection::OUTGOING;
+
+        DEFINE_STRUCT_VISITOR_FUNCTION(id, direction);
+    };
+
+    struct ReachableRequest {
+        std::string id;
+        EdgeDirection direction = EdgeDirection::OUTGOING;
+        // Number of the edges to follow, or 0 for no limit.
+        uint32_t max_depth = 0;
+
+        DEFINE_STRUCT_VISITOR_FUNCTION(id, direction, max_depth);
+    };
+
     // Add a node with external name and timestamp, returns the new id.
     cppschema::ApiStub<AddNodeRequest, std::string> addNode;
-    // Add one or more edges, returns the new edge ids.
+    // Add many nodes at once, returns the new ids in the same order.
+    cppschema::ApiStub<AddNodesRequest, std::vector<std::string>> addNodes;
+    // Add the nodes of an export, returns the new ids in the same order. Fails, without reading the
+    // nodes, if the export is in another format version.
+    cppschema::ApiStub<ImportNodesRequest, std::vector<std::string>> importNodes;
+    // Add one or more edges, returns the new edge ids. Fails, adding none, if an edge refers to an
+    // unknown node.
     cppschema::ApiStub<AddEdgesRequest, std::vector<std::string>> addEdges;
     // Delete a node by id, returns if successfully deleted.
     cppschema::ApiStub<std::string, bool> deleteNode;
+    // Delete many nodes by id, returns the number of deleted nodes.
+    cppschema::ApiStub<std::vector<std::string>, uint32_t> deleteNodes;
     // Clears all data.
     cppschema::ApiStub<VoidType, VoidType> clearGraph;
 
-    DEFINE_API_VISITOR_FUNCTION(addNode, addEdges, deleteNode, clearGraph);
+    // The distinct neighbors of a node.
+    cppschema::ApiStub<NeighborsRequest, std::vector<std::string>> getNeighbors;
+    // The nodes reachable from a node, itself first, in breadth first order.
+    cppschema::ApiStub<ReachableRequest, std::vector<std::string>> getReachable;
+    // All the nodes, each before the targets of its edges. Fails if the graph has a cycle.
+    cppschema::ApiStub<VoidType, std::vector<std::string>> getTopologicalOrder;
+    // The nodes of a cycle, each followed by the target of its edge, or none if there is no cycle.
+    cppschema::ApiStub<VoidType, std::vector<std::string>> findCycle;
+
+    DEFINE_API_VISITOR_FUNCTION(addNode, addNodes, importNodes, addEdges, deleteNode, deleteNodes, clearGraph,
+                                getNeighbors, getReachable, getTopologicalOrder, findCycle);
 };
 
 }  // namespace graph
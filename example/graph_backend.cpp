@@ -1,74 +1,197 @@
+#include "graph_backend.h"
+
+#include <span>
+#include <string>
+#include <vector>
+
 #include "absl/log/log.h"
 #include "cppschema/apispec/api_registry.h"
 #include "cppschema/backend/api_backend_bridge.h"
 #include "graph_api.h"
+#include "graph_queries.h"
+#include "graph_store.h"
 
 namespace graph {
 
-std::string NodeTypeToStr(const NodeTypeEnum node_type) {
-  switch (node_type) {
-    case NodeTypeEnum::UNKNOWN: return "UNKNOWN";
-    case NodeTypeEnum::GRAPH_INPUT: return "GRAPH_INPUT";
-    case NodeTypeEnum::GRAPH_OUTPUT: return "GRAPH_OUTPUT";
-    case NodeTypeEnum::FUNCTION: return "FUNCTION";
-  }
-}
-
 class GraphApiImpl : public cppschema::ApiBackend<GraphApi> {
  public:
+    using AddNodesRequest = GraphApi::AddNodesRequest;
+    using ImportNodesRequest = GraphApi::ImportNodesRequest;
     using AddEdgesRequest = GraphApi::AddEdgesRequest;
+    using NeighborsRequest = GraphApi::NeighborsRequest;
+    using ReachableRequest = GraphApi::ReachableRequest;
 
     std::string addNodeImpl(const GraphApi::AddNodeRequest& request) {
-        std::string new_id = NodeTypeToStr(request.node_type) + "_" + std::to_string(node_counter_++);
-        node_storage_[new_id] = request.ui_name;
-        LOG(ERROR) << "[Backend] Added node: " << request.ui_name 
-                    << " with type: " << NodeTypeToStr(request.node_type)
-                    << " with ID: " << new_id
-                    << " at t=" << request.timestamp;
+        std::string new_id = store_.AddNode(request);
+        VLOG(1) << "[Backend] Added node: " << request.ui_name
+                  << " with type: " << NodeTypeName(request.node_type)
+                  << " with ID: " << new_id
+                  << " at t=" << request.timestamp;
         return new_id;
     }
 
-    std::vector<std::string> addEdgesImpl(const AddEdgesRequest& request) {
-        std::vector<std::string> result;
-        for (const EdgeConnection& conn: request.entries) {
-            std::string new_id = "edge_" + std::to_string(conn.id.value);
-            edge_storage_[new_id] = conn;
-            result.push_back(new_id);
+    cppschema::Status addNodesImpl(const AddNodesRequest& request,
+                                   cppschema::ArraySink<std::string>* node_ids) {
+        store_.Reserve(store_.nodes().size() + request.nodes.size());
+        node_ids->Reserve(request.nodes.size());
+        for (const GraphApi::AddNodeRequest& node : request.nodes) {
+            node_ids->Append(store_.AddNode(node));
+        }
+        return cppschema::OkStatus();
+    }
+
+    // Takes a view of the request, so that an export in another format is rejected without
+    // converting its nodes from JS.
+    cppschema::Expected<std::vector<std::string>> importNodesImpl(
+            const cppschema::RequestView<ImportNodesRequest>& request) {
+        const uint32_t version = request.Get<&ImportNodesRequest::format_version>();
+        if (version != GraphApi::kImportFormatVersion) {
+            return cppschema::Unexpected(cppschema::InvalidArgumentError(
+                "Unsupported export format version: " + std::to_string(version)));
+        }
+        const std::vector<GraphApi::AddNodeRequest>& nodes = request.Get<&ImportNodesRequest::nodes>();
+        store_.Reserve(store_.nodes().size() + nodes.size());
+        std::vector<std::string> ids;
+        ids.reserve(nodes.size());
+        for (const GraphApi::AddNodeRequest& node : nodes) {
+            ids.push_back(store_.AddNode(node));
         }
-        return result;
+        return ids;
+    }
+
+    // Resolves the ends of the edges on the threads of the framework's pool.
+    cppschema::Expected<std::vector<std::string>> addEdgesImpl(const AddEdgesRequest& request,
+                                                               const cppschema::ApiContext& context) {
+        std::vector<std::string> edge_ids;
+        if (cppschema::Status status = store_.AddEdges(request.entries, context.pool(), &edge_ids);
+            !status.ok()) {
+            return cppschema::Unexpected(std::move(status));
+        }
+        return edge_ids;
+    }
+
+    // The batch handler of `addNode`, which reserves the room for all the nodes at once.
+    cppschema::Expected<std::vector<std::string>> addNodeBatchImpl(
+            std::span<const GraphApi::AddNodeRequest> requests) {
+        store_.Reserve(store_.nodes().size() + requests.size());
+        std::vector<std::string> ids;
+        ids.reserve(requests.size());
+        for (const GraphApi::AddNodeRequest& request : requests) {
+            ids.push_back(store_.AddNode(request));
+        }
+        VLOG(1) << "[Backend] Added a batch of " << requests.size() << " nodes";
+        return ids;
     }
 
     bool deleteNodeImpl(const std::string& id) {
-        if (node_storage_.find(id) != node_storage_.end()) {
-            node_storage_.erase(id);
-            LOG(INFO) << "[Backend] Deleted node ID: " << id;
+        if (store_.DeleteNode(id)) {
+            VLOG(1) << "[Backend] Deleted node ID: " << id;
             return true;
         }
-        LOG(INFO) << "[Backend] Delete failed. ID not found: " << id;
+        VLOG(1) << "[Backend] Delete failed. ID not found: " << id;
         return false;
     }
 
+    // The batch handler of `deleteNode`, in the order of the requests.
+    cppschema::Expected<std::vector<bool>> deleteNodeBatchImpl(std::span<const std::string> ids) {
+        std::vector<bool> deleted;
+        deleted.reserve(ids.size());
+        for (const std::string& id : ids) {
+            deleted.push_back(store_.DeleteNode(id));
+        }
+        return deleted;
+    }
+
+    uint32_t deleteNodesImpl(const std::vector<std::string>& ids) {
+        uint32_t deleted = 0;
+        for (const std::string& id : ids) {
+            deleted += store_.DeleteNode(id);
+        }
+        return deleted;
+    }
+
     VoidType clearGraphImpl(const VoidType&) {
-        node_storage_.clear();
-        LOG(INFO) << "[Backend] Cleared all nodes";
+        store_.Clear();
+        LOG(INFO) << "[Backend] Cleared the graph";
         return VoidType{};
     }
 
+    cppschema::Status getNeighborsImpl(const NeighborsRequest& request,
+                                       cppschema::ArraySink<std::string>* node_ids) {
+        const std::optional<NodeIndex> node = store_.FindNode(request.id);
+        if (!node) {
+            return cppschema::NotFoundError("No node with id: " + request.id);
+        }
+        AppendNodeIds(Neighbors(store_, *node, request.direction), node_ids);
+        return cppschema::OkStatus();
+    }
+
+    cppschema::Status getReachableImpl(const ReachableRequest& request,
+                                       cppschema::ArraySink<std::string>* node_ids) {
+        const std::optional<NodeIndex> node = store_.FindNode(request.id);
+        if (!node) {
+            return cppschema::NotFoundError("No node with id: " + request.id);
+        }
+        AppendNodeIds(BreadthFirst(store_, *node, request.direction, request.max_depth), node_ids);
+        return cppschema::OkStatus();
+    }
+
+    cppschema::Status getTopologicalOrderImpl(const VoidType&,
+                                              cppschema::ArraySink<std::string>* node_ids) {
+        std::optional<std::vector<NodeIndex>> order = TopologicalOrder(store_);
+        if (!order) {
+            return cppschema::FailedPreconditionError("The graph has a cycle");
+        }
+        AppendNodeIds(*order, node_ids);
+        return cppschema::OkStatus();
+    }
+
+    cppschema::Status findCycleImpl(const VoidType&, cppschema::ArraySink<std::string>* node_ids) {
+        AppendNodeIds(FindCycle(store_), node_ids);
+        return cppschema::OkStatus();
+    }
+
  private:
-    int32_t node_counter_ = 1000;
-    std::map<std::string, std::string> node_storage_;
-    std::map<std::string, EdgeConnection> edge_storage_;
+    // The traversals run over the node indexes, which are only turned into ids for the response.
+    void AppendNodeIds(const std::vector<NodeIndex>& nodes, cppschema::ArraySink<std::string>* node_ids) {
+        node_ids->Reserve(nodes.size());
+        for (NodeIndex node : nodes) {
+            node_ids->Append(store_.NodeIdOf(node));
+        }
+    }
+
+    GraphStore store_;
 };
 
+// The registered backend, owned by the registry.
+static GraphApiImpl* registered_impl = nullptr;
+
 static __attribute__((constructor)) void RegisterGraphApiBackend() {
     auto* impl = new GraphApiImpl();
+    registered_impl = impl;
     GraphApi::ImplPtrs<GraphApiImpl> ptrs = {
         .addNode = &GraphApiImpl::addNodeImpl,
+        .addNodes = &GraphApiImpl::addNodesImpl,
+        .importNodes = &GraphApiImpl::importNodesImpl,
         .addEdges = &GraphApiImpl::addEdgesImpl,
         .deleteNode = &GraphApiImpl::deleteNodeImpl,
+        .deleteNodes = &GraphApiImpl::deleteNodesImpl,
         .clearGraph = &GraphApiImpl::clearGraphImpl,
+        .getNeighbors = &GraphApiImpl::getNeighborsImpl,
+        .getReachable = &GraphApiImpl::getReachableImpl,
+        .getTopologicalOrder = &GraphApiImpl::getTopologicalOrderImpl,
+        .findCycle = &GraphApiImpl::findCycleImpl,
     };
     cppschema::RegisterBackend<GraphApi, GraphApiImpl>(impl, ptrs);
 }
 
+cppschema::Status EnableBatching(const cppschema::BatchOptions& options) {
+    if (cppschema::Status status = cppschema::RegisterBatchMethod<GraphApi>(
+            "addNode", registered_impl, &GraphApiImpl::addNodeBatchImpl, options); !status.ok()) {
+        return status;
+    }
+    return cppschema::RegisterBatchMethod<GraphApi>(
+        "deleteNode", registered_impl, &GraphApiImpl::deleteNodeBatchImpl, options);
+}
+
 }  // namespace graph
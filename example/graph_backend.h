@@ -0,0 +1,13 @@
+#pragma once
+
+#include "cppschema/apispec/batcher.h"
+#include "cppschema/common/status.h"
+
+namespace graph {
+
+// Registers the batch handlers of `addNode` and `deleteNode` (see `RegisterBatchMethod`), so that
+// their calls made with `TryCallAsync`, or from JS, are dispatched together. Their JS methods then
+// return promises.
+cppschema::Status EnableBatching(const cppschema::BatchOptions& options = {});
+
+}  // namespace graph
@@ -1,8 +1,12 @@
 // Execute this test from the "example" dir as:
 // $ bazel test //:graph_backend_test
 
+#include <optional>
+
 #include "cppschema/apispec/api_registry.h"
+#include "cppschema/apispec/task.h"
 #include "graph_api.h"
+#include "graph_backend.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock-matchers.h"
 
@@ -12,6 +16,7 @@ using ::cppschema::ApiRegistry;
 using ::testing::ElementsAre;
 
 using AddNodeRequest = GraphApi::AddNodeRequest;
+using AddNodesRequest = GraphApi::AddNodesRequest;
 using AddEdgesRequest = GraphApi::AddEdgesRequest;
 
 TEST(GraphApiImplTest, Basic) {
@@ -33,6 +38,102 @@ TEST(GraphApiImplTest, Basic) {
     };
     std::vector<std::string> edge_ids = ApiRegistry<GraphApi>::Get().template Call<AddEdgesRequest, std::vector<std::string>>("addEdges", add_edges_req);
     EXPECT_THAT(edge_ids, ElementsAre("edge_101", "edge_102"));
+
+    EdgeConnection dangling = { .id = EdgeId(103), .source = "FUNCTION_1000", .target = "FUNCTION_999" };
+    std::vector<std::string> no_ids;
+    cppschema::Status status = ApiRegistry<GraphApi>::Get().template TryCall<AddEdgesRequest, std::vector<std::string>>(
+        "addEdges", AddEdgesRequest{.entries = {conn1, dangling}}, &no_ids);
+    EXPECT_EQ(status.code(), cppschema::StatusCode::kNotFound);
+    EXPECT_TRUE(no_ids.empty());
+}
+
+TEST(GraphApiImplTest, BulkAddAndDelete) {
+    auto& registry = ApiRegistry<GraphApi>::Get();
+    registry.Call<VoidType, VoidType>("clearGraph", VoidType{});
+    AddNodesRequest add_nodes_req;
+    for (int i = 0; i < 3; ++i) {
+        add_nodes_req.nodes.push_back({.ui_name = "n", .node_type = NodeTypeEnum::GRAPH_OUTPUT, .timestamp = i});
+    }
+    std::vector<std::string> ids = registry.Call<AddNodesRequest, std::vector<std::string>>("addNodes", add_nodes_req);
+    ASSERT_EQ(ids.size(), 3);
+    EXPECT_TRUE(ids[0].starts_with("GRAPH_OUTPUT_"));
+
+    uint32_t deleted = registry.Call<std::vector<std::string>, uint32_t>(
+        "deleteNodes", std::vector<std::string>{ids[0], ids[2], ids[2], "FUNCTION_1"});
+    EXPECT_EQ(deleted, 2);
+    EXPECT_TRUE((registry.Call<std::string, bool>("deleteNode", ids[1])));
+}
+
+TEST(GraphApiImplTest, ImportNodes) {
+    auto& registry = ApiRegistry<GraphApi>::Get();
+    registry.Call<VoidType, VoidType>("clearGraph", VoidType{});
+    GraphApi::ImportNodesRequest request = {
+        .format_version = GraphApi::kImportFormatVersion,
+        .nodes = {{.node_type = NodeTypeEnum::GRAPH_INPUT}, {.node_type = NodeTypeEnum::FUNCTION}},
+    };
+    std::vector<std::string> ids;
+    cppschema::Status status = registry.TryCall<GraphApi::ImportNodesRequest, std::vector<std::string>>(
+        "importNodes", request, &ids);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ(ids.size(), 2);
+    EXPECT_TRUE(ids[0].starts_with("GRAPH_INPUT_"));
+
+    request.format_version = 0;
+    status = registry.TryCall<GraphApi::ImportNodesRequest, std::vector<std::string>>("importNodes", request, &ids);
+    EXPECT_EQ(status.code(), cppschema::StatusCode::kInvalidArgument);
+}
+
+TEST(GraphApiImplTest, Queries) {
+    auto& registry = ApiRegistry<GraphApi>::Get();
+    registry.Call<VoidType, VoidType>("clearGraph", VoidType{});
+    std::vector<std::string> ids = registry.Call<AddNodesRequest, std::vector<std::string>>(
+        "addNodes", AddNodesRequest{.nodes = {{.node_type = NodeTypeEnum::FUNCTION}, {.node_type = NodeTypeEnum::FUNCTION}}});
+    registry.Call<AddEdgesRequest, std::vector<std::string>>(
+        "addEdges", AddEdgesRequest{.entries = {{.id = EdgeId(1), .source = ids[0], .target = ids[1]}}});
+
+    EXPECT_THAT((registry.Call<GraphApi::NeighborsRequest, std::vector<std::string>>(
+                    "getNeighbors", {.id = ids[1], .direction = EdgeDirection::INCOMING})),
+                ElementsAre(ids[0]));
+    EXPECT_THAT((registry.Call<GraphApi::ReachableRequest, std::vector<std::string>>("getReachable", {.id = ids[0]})),
+                ElementsAre(ids[0], ids[1]));
+    EXPECT_THAT((registry.Call<VoidType, std::vector<std::string>>("getTopologicalOrder", VoidType{})),
+                ElementsAre(ids[0], ids[1]));
+
+    registry.Call<AddEdgesRequest, std::vector<std::string>>(
+        "addEdges", AddEdgesRequest{.entries = {{.id = EdgeId(2), .source = ids[1], .target = ids[0]}}});
+    std::vector<std::string> order;
+    cppschema::Status status = registry.TryCall<VoidType, std::vector<std::string>>("getTopologicalOrder", VoidType{}, &order);
+    EXPECT_EQ(status.code(), cppschema::StatusCode::kFailedPrecondition);
+    EXPECT_THAT((registry.Call<VoidType, std::vector<std::string>>("findCycle", VoidType{})),
+                ::testing::UnorderedElementsAre(ids[0], ids[1]));
+}
+
+TEST(GraphApiImplTest, BatchedCalls) {
+    auto& registry = ApiRegistry<GraphApi>::Get();
+    registry.Call<VoidType, VoidType>("clearGraph", VoidType{});
+    ASSERT_TRUE(EnableBatching().ok());
+
+    cppschema::TaskScheduler& scheduler = cppschema::TaskScheduler::Get();
+    std::vector<std::optional<cppschema::Expected<std::string>>> ids(3);
+    for (int i = 0; i < 3; ++i) {
+        scheduler.Spawn(registry.TryCallAsync<AddNodeRequest, std::string>("addNode",
+                {.ui_name = "n", .node_type = NodeTypeEnum::FUNCTION, .timestamp = i}),
+            [&ids, i](cppschema::Expected<std::string> id) { ids[i] = std::move(id); });
+    }
+    std::optional<cppschema::Expected<bool>> deleted;
+    scheduler.Spawn(registry.TryCallAsync<std::string, bool>("deleteNode", "FUNCTION_1"),
+        [&](cppschema::Expected<bool> res) { deleted = std::move(res); });
+    scheduler.RunUntilIdle();
+
+    ASSERT_TRUE(ids[2].has_value() && ids[2]->has_value());
+    EXPECT_NE(**ids[0], **ids[2]);
+    EXPECT_FALSE(**deleted);
+    EXPECT_EQ(registry.GetBatchStats("addNode").calls, 3);
+    EXPECT_EQ(registry.GetBatchStats("addNode").batches, 1);
+    EXPECT_EQ(registry.GetBatchStats("deleteNode").batches, 1);
+
+    // The synchronous calls are unchanged.
+    EXPECT_TRUE((registry.Call<std::string, bool>("deleteNode", **ids[0])));
 }
 
 }  // namespace graph
@@ -1,9 +1,41 @@
 #include <emscripten/bind.h>
 #include <emscripten/em_js.h>
 
+#include <string>
+
+#include "cppschema/apispec/api_registry.h"
 #include "cppschema/wasm/js_api_bridge.h"
+#include "echo_api.h"
 #include "graph_api.h"
+#include "graph_backend.h"
+
+namespace {
+
+// "OK", or the error.
+std::string EnableGraphBatching() { return graph::EnableBatching().ToString(); }
+
+std::string GraphBatchStats(const std::string& name) {
+    return cppschema::ApiRegistry<graph::GraphApi>::Get().GetBatchStats(name).ToString();
+}
+
+}  // namespace
 
 EMSCRIPTEN_BINDINGS(Hello) {
     cppschema::jsbridge::CreateJsApiMethods<graph::GraphApi>("GraphApi");
+    cppschema::jsbridge::CreateJsApiMethods<echo::EchoApi>("EchoApi");
+    // The same APIs with the other engine, see example/engines_benchmark.mjs.
+    cppschema::jsbridge::CreateJsApiMethods<graph::GraphApi, cppschema::jsbridge::JsEngine::kValueObject>(
+        "GraphApiValueObject");
+    cppschema::jsbridge::CreateJsApiMethods<echo::EchoApi, cppschema::jsbridge::JsEngine::kValueObject>(
+        "EchoApiValueObject");
+    cppschema::jsbridge::ExportEnumNames();
+    cppschema::jsbridge::ExportTracing();
+    cppschema::jsbridge::ExportCrossingCounts();
+    cppschema::jsbridge::ExportCallRecording();
+    cppschema::jsbridge::ExportBlobs();
+    cppschema::jsbridge::ExportHeapStats();
+    cppschema::ApiRegistry<echo::EchoApi>::Get().SetRequestLimits("echoVectors",
+        {.max_elements = 200000, .max_bytes = 4 << 20});
+    emscripten::function("enableGraphBatching", &EnableGraphBatching);
+    emscripten::function("graphBatchStats", &GraphBatchStats);
 }
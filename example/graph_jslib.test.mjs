@@ -68,5 +68,77 @@ test('WASM Graph Library Test', async (t) => {
     };
     const edgeIds = assertRpcOkAndGetPayload(graph.addEdges(addEdgesReq));
     assert.deepEqual(edgeIds, ["edge_501", "edge_502"]);
+
+    const dangling = graph.addEdges({entries: [{ id: 503, source: nodeId1, target: "FUNCTION_1" }]});
+    assert.equal(dangling.ok, false, "Edges to unknown nodes should fail");
+    assert.match(dangling.status, /NOT_FOUND/);
+  });
+
+  await t.test('verify bulk insert and delete', () => {
+    const nodes = Array.from({length: 1000}, (_, i) => ({
+      ui_name: `Node ${i}`,
+      node_type: "GRAPH_OUTPUT",
+      timestamp: i,
+    }));
+    const nodeIds = assertRpcOkAndGetPayload(graph.addNodes({nodes}));
+    assert.equal(nodeIds.length, 1000);
+    assert.equal(new Set(nodeIds).size, 1000, "Node ids should be unique");
+    assert.ok(nodeIds.every((id) => id.startsWith("GRAPH_OUTPUT_")));
+
+    const deleted = assertRpcOkAndGetPayload(graph.deleteNodes([...nodeIds, nodeIds[0], "FUNCTION_1"]));
+    assert.equal(deleted, 1000);
+  });
+
+  await t.test('verify graph queries', () => {
+    assertRpcOkAndGetPayload(graph.clearGraph({}));
+    const nodes = Array.from({length: 3}, () => ({ui_name: "Step", node_type: "FUNCTION", timestamp: 0}));
+    const [a, b, c] = assertRpcOkAndGetPayload(graph.addNodes({nodes}));
+    assertRpcOkAndGetPayload(graph.addEdges({entries: [
+      { id: 601, source: a, target: b },
+      { id: 602, source: b, target: c },
+    ]}));
+
+    assert.deepEqual(assertRpcOkAndGetPayload(graph.getNeighbors({id: b, direction: "BOTH"})), [a, c]);
+    assert.deepEqual(assertRpcOkAndGetPayload(graph.getReachable({id: a})), [a, b, c]);
+    assert.deepEqual(assertRpcOkAndGetPayload(graph.getReachable({id: a, max_depth: 1})), [a, b]);
+    assert.deepEqual(assertRpcOkAndGetPayload(graph.getTopologicalOrder({})), [a, b, c]);
+    assert.deepEqual(assertRpcOkAndGetPayload(graph.findCycle({})), []);
+
+    assertRpcOkAndGetPayload(graph.addEdges({entries: [{ id: 603, source: c, target: a }]}));
+    assert.match(graph.getTopologicalOrder({}).status, /FAILED_PRECONDITION/);
+    assert.deepEqual(new Set(assertRpcOkAndGetPayload(graph.findCycle({}))), new Set([a, b, c]));
+    assert.match(graph.getReachable({id: "FUNCTION_1"}).status, /NOT_FOUND/);
   });
-});
\ No newline at end of file
+
+  await t.test('verify import of nodes', () => {
+    const nodes = [{ui_name: "Imported", node_type: "GRAPH_INPUT"}, {node_type: "FUNCTION"}];
+    const ids = assertRpcOkAndGetPayload(graph.importNodes({format_version: 1, nodes}));
+    assert.equal(ids.length, 2);
+    assert.ok(ids[0].startsWith("GRAPH_INPUT_"), ids[0]);
+
+    // Rejected on the version, the nodes are not read, so their errors are not reported.
+    const rejected = graph.importNodes({format_version: 2, nodes: [{node_type: "NO_SUCH_TYPE"}]});
+    assert.match(rejected.status, /INVALID_ARGUMENT: Unsupported export format version: 2/);
+    assert.deepEqual(rejected.data, []);
+    assert.match(graph.importNodes({format_version: 1, nodes: [{node_type: "NO_SUCH_TYPE"}]}).status,
+                 /INVALID_ARGUMENT/);
+  });
+
+  // Last: the batched methods return promises from now on.
+  await t.test('verify batched calls', async () => {
+    assert.equal(graphModule.enableGraphBatching(), "OK");
+    const pending = [1, 2, 3].map((i) => graph.addNode({ui_name: `Batched_${i}`, node_type: "FUNCTION", timestamp: i}));
+    assert.ok(pending[0] instanceof Promise);
+    const ids = (await Promise.all(pending)).map(assertRpcOkAndGetPayload);
+    assert.equal(new Set(ids).size, 3);
+    assert.match(graphModule.graphBatchStats("addNode"), /^1 batches, 3 calls/);
+
+    // Each caller gets its own response, in the order of the calls.
+    const deleted = await Promise.all([...ids, ids[0]].map((id) => graph.deleteNode(id)));
+    assert.deepEqual(deleted.map(assertRpcOkAndGetPayload), [true, true, true, false]);
+    assert.match(graphModule.graphBatchStats("deleteNode"), /4-7: 1/);
+
+    // The other methods are unchanged.
+    assert.equal(graph.getNeighbors({id: ids[0]}).ok, false);
+  });
+});
@@ -0,0 +1,132 @@
+#include "graph_queries.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace graph {
+namespace {
+
+// The frontier nodes expanded per task. The smaller frontiers are expanded on the calling thread.
+constexpr size_t kFrontierGrain = 4096;
+
+// Kahn's algorithm. Returns the sorted nodes, and leaves the in-degree of the nodes on or
+// downstream of a cycle above 0.
+std::vector<NodeIndex> KahnOrder(const GraphStore& store, std::vector<uint32_t>& in_degree) {
+    in_degree.assign(store.nodes().end_index(), 0);
+    std::vector<NodeIndex> order;
+    order.reserve(store.nodes().size());
+    store.nodes().ForEach([&](NodeIndex node, const NodeRecord&) {
+        in_degree[node] = static_cast<uint32_t>(store.in_edges().Degree(node));
+        if (in_degree[node] == 0) {
+            order.push_back(node);
+        }
+    });
+    // `order` doubles as the queue.
+    for (size_t i = 0; i < order.size(); ++i) {
+        store.out_edges().ForEach(order[i], [&](const CsrIndex::Entry& e) {
+            if (--in_degree[e.node] == 0) {
+                order.push_back(e.node);
+            }
+        });
+    }
+    return order;
+}
+
+}  // namespace
+
+std::vector<NodeIndex> Neighbors(const GraphStore& store, NodeIndex node, EdgeDirection direction) {
+    std::vector<NodeIndex> neighbors;
+    ForEachNeighbor(store, node, direction, [&neighbors](NodeIndex n) { neighbors.push_back(n); });
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    return neighbors;
+}
+
+std::vector<NodeIndex> BreadthFirst(const GraphStore& store, NodeIndex start, EdgeDirection direction,
+                                    uint32_t max_depth, cppschema::TaskPool& pool) {
+    std::vector<std::atomic<uint8_t>> visited(store.nodes().end_index());
+    visited[start].store(1, std::memory_order_relaxed);
+    // Expands the frontier `order[begin, end)` into `next`.
+    auto expand = [&](const std::vector<NodeIndex>& order, size_t begin, size_t end,
+                      std::vector<NodeIndex>& next) {
+        for (size_t i = begin; i < end; ++i) {
+            ForEachNeighbor(store, order[i], direction, [&](NodeIndex n) {
+                if (visited[n].load(std::memory_order_relaxed) == 0 &&
+                    visited[n].exchange(1, std::memory_order_relaxed) == 0) {
+                    next.push_back(n);
+                }
+            });
+        }
+    };
+
+    std::vector<NodeIndex> order = {start};
+    std::vector<NodeIndex> next;
+    size_t level_begin = 0;
+    for (uint32_t depth = 0; level_begin < order.size() && (max_depth == 0 || depth < max_depth); ++depth) {
+        const size_t level_end = order.size();
+        if (pool.num_threads() == 0 || level_end - level_begin < 2 * kFrontierGrain) {
+            next.clear();
+            expand(order, level_begin, level_end, next);
+            order.insert(order.end(), next.begin(), next.end());
+        } else {
+            // Each chunk of the frontier is expanded into its own vector, then appended in order.
+            std::vector<NodeIndex> level = pool.ParallelReduce(level_begin, level_end, kFrontierGrain,
+                std::vector<NodeIndex>(),
+                [&](size_t begin, size_t end) {
+                    std::vector<NodeIndex> part;
+                    expand(order, begin, end, part);
+                    return part;
+                },
+                [](std::vector<NodeIndex> all, std::vector<NodeIndex> part) {
+                    all.insert(all.end(), part.begin(), part.end());
+                    return all;
+                });
+            order.insert(order.end(), level.begin(), level.end());
+        }
+        level_begin = level_end;
+    }
+    return order;
+}
+
+std::optional<std::vector<NodeIndex>> TopologicalOrder(const GraphStore& store) {
+    std::vector<uint32_t> in_degree;
+    std::vector<NodeIndex> order = KahnOrder(store, in_degree);
+    if (order.size() != store.nodes().size()) {
+        return std::nullopt;
+    }
+    return order;
+}
+
+std::vector<NodeIndex> FindCycle(const GraphStore& store) {
+    std::vector<uint32_t> in_degree;
+    if (KahnOrder(store, in_degree).size() == store.nodes().size()) {
+        return {};
+    }
+    // Each node left has a predecessor which is also left. Walking back through them must repeat a
+    // node, which closes a cycle.
+    NodeIndex node = 0;
+    while (!store.nodes().contains(node) || in_degree[node] == 0) {
+        ++node;
+    }
+    std::vector<uint32_t> position(store.nodes().end_index(), UINT32_MAX);
+    std::vector<NodeIndex> path;
+    while (position[node] == UINT32_MAX) {
+        position[node] = static_cast<uint32_t>(path.size());
+        path.push_back(node);
+        NodeIndex predecessor = node;
+        store.in_edges().ForEach(node, [&](const CsrIndex::Entry& e) {
+            if (in_degree[e.node] > 0) {
+                predecessor = e.node;
+            }
+        });
+        node = predecessor;
+    }
+    std::vector<NodeIndex> cycle(path.begin() + position[node], path.end());
+    std::reverse(cycle.begin(), cycle.end());
+    return cycle;
+}
+
+}  // namespace graph
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "cppschema/apispec/task_pool.h"
+#include "graph_api.h"
+#include "graph_store.h"
+
+namespace graph {
+
+// Calls `fn(NodeIndex)` for the node at the other end of each edge of `node`, in the direction.
+template <typename Fn>
+void ForEachNeighbor(const GraphStore& store, NodeIndex node, EdgeDirection direction, Fn&& fn) {
+    if (direction != EdgeDirection::INCOMING) {
+        store.out_edges().ForEach(node, [&fn](const CsrIndex::Entry& e) { fn(e.node); });
+    }
+    if (direction != EdgeDirection::OUTGOING) {
+        store.in_edges().ForEach(node, [&fn](const CsrIndex::Entry& e) { fn(e.node); });
+    }
+}
+
+// The distinct neighbors of a node, sorted by index.
+std::vector<NodeIndex> Neighbors(const GraphStore& store, NodeIndex node, EdgeDirection direction);
+
+/**
+ * The nodes reachable from `start` in at most `max_depth` edges (0 for no limit), in breadth first
+ * order: `start` first, then the nodes at depth 1, etc. Within a depth, the order is unspecified.
+ *
+ * The large frontiers are expanded on the threads of `pool`, each claiming the nodes it reaches
+ * with an atomic flag.
+ *
+ * @example
+ * for (NodeIndex node : BreadthFirst(store, *store.FindNode(id), EdgeDirection::OUTGOING)) {
+ *     ids.push_back(store.NodeIdOf(node));
+ * }
+ */
+std::vector<NodeIndex> BreadthFirst(const GraphStore& store, NodeIndex start, EdgeDirection direction,
+                                    uint32_t max_depth = 0,
+                                    cppschema::TaskPool& pool = cppschema::TaskPool::Default());
+
+// All the nodes, each before the targets of its outgoing edges, or nullopt if there is a cycle.
+std::optional<std::vector<NodeIndex>> TopologicalOrder(const GraphStore& store);
+
+// The nodes of a cycle, each with an edge to the next (and the last to the first), or none.
+std::vector<NodeIndex> FindCycle(const GraphStore& store);
+
+}  // namespace graph
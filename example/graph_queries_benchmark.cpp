@@ -0,0 +1,84 @@
+// Measures the graph queries on synthetic DAGs of 10^5 to 10^7 edges, with 8 edges per node.
+//
+// $ bazel run -c opt //:graph_queries_benchmark
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "cppschema/apispec/task_pool.h"
+#include "graph_queries.h"
+#include "graph_store.h"
+
+namespace graph {
+namespace {
+
+constexpr int64_t kEdgesPerNode = 8;
+
+// Each node has edges to random later nodes, so node 0 reaches most of the graph. Built once per
+// size, as building the largest one takes seconds.
+const GraphStore& Dag(int64_t num_edges) {
+    static auto* graphs = new std::map<int64_t, std::unique_ptr<GraphStore>>();
+    std::unique_ptr<GraphStore>& store = (*graphs)[num_edges];
+    if (store == nullptr) {
+        store = std::make_unique<GraphStore>();
+        const auto num_nodes = static_cast<uint32_t>(num_edges / kEdgesPerNode);
+        store->Reserve(num_nodes);
+        for (uint32_t i = 0; i < num_nodes; ++i) {
+            store->AddNode({.ui_name = "node_" + std::to_string(i), .node_type = NodeTypeEnum::FUNCTION});
+        }
+        std::mt19937 rng(42);
+        uint32_t edge_id = 0;
+        for (uint32_t i = 0; i + 1 < num_nodes; ++i) {
+            std::uniform_int_distribution<uint32_t> later(i + 1, num_nodes - 1);
+            for (int64_t k = 0; k < kEdgesPerNode; ++k) {
+                store->AddEdge(EdgeId(edge_id++), i, later(rng));
+            }
+        }
+        store->Compact();
+    }
+    return *store;
+}
+
+// By the number of pool threads besides the caller.
+void BM_BreadthFirst(benchmark::State& state) {
+    const GraphStore& store = Dag(state.range(0));
+    cppschema::TaskPool pool(state.range(1));
+    size_t reached = 0;
+    for (auto _ : state) {
+        reached = BreadthFirst(store, 0, EdgeDirection::OUTGOING, 0, pool).size();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["reached"] = static_cast<double>(reached);
+}
+BENCHMARK(BM_BreadthFirst)
+    ->ArgsProduct({{100'000, 1'000'000, 10'000'000}, {0, 3}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_TopologicalOrder(benchmark::State& state) {
+    const GraphStore& store = Dag(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(TopologicalOrder(store));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TopologicalOrder)->Arg(100'000)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+void BM_Neighbors(benchmark::State& state) {
+    const GraphStore& store = Dag(state.range(0));
+    const NodeIndex num_nodes = store.nodes().end_index();
+    NodeIndex node = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Neighbors(store, node, EdgeDirection::BOTH));
+        node = (node + 7919) % num_nodes;
+    }
+}
+BENCHMARK(BM_Neighbors)->Arg(100'000)->Arg(10'000'000);
+
+}  // namespace
+}  // namespace graph
+
+BENCHMARK_MAIN();
@@ -0,0 +1,129 @@
+// Execute this test from the "example" dir as:
+// $ bazel test //:graph_queries_test
+
+#include "graph_queries.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cppschema/apispec/task_pool.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace graph {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+class GraphQueriesTest : public ::testing::Test {
+ protected:
+    // Adds the nodes 0 to count - 1, which have the same index in the store.
+    void AddNodes(int count) {
+        for (int i = 0; i < count; ++i) {
+            store_.AddNode({.ui_name = "n", .node_type = NodeTypeEnum::FUNCTION});
+        }
+    }
+
+    void AddEdge(NodeIndex source, NodeIndex target) {
+        store_.AddEdge(EdgeId(next_edge_id_++), source, target);
+    }
+
+    GraphStore store_;
+    uint32_t next_edge_id_ = 0;
+};
+
+TEST_F(GraphQueriesTest, Neighbors) {
+    AddNodes(4);
+    AddEdge(0, 1);
+    AddEdge(0, 2);
+    AddEdge(0, 2);
+    AddEdge(3, 0);
+    EXPECT_THAT(Neighbors(store_, 0, EdgeDirection::OUTGOING), ElementsAre(1, 2));
+    EXPECT_THAT(Neighbors(store_, 0, EdgeDirection::INCOMING), ElementsAre(3));
+    EXPECT_THAT(Neighbors(store_, 0, EdgeDirection::BOTH), ElementsAre(1, 2, 3));
+    EXPECT_THAT(Neighbors(store_, 1, EdgeDirection::OUTGOING), IsEmpty());
+}
+
+TEST_F(GraphQueriesTest, BreadthFirst) {
+    // 0 -> 1 -> 2 -> 3, and 0 -> 2.
+    AddNodes(5);
+    AddEdge(0, 1);
+    AddEdge(1, 2);
+    AddEdge(2, 3);
+    AddEdge(0, 2);
+    EXPECT_THAT(BreadthFirst(store_, 0, EdgeDirection::OUTGOING), ElementsAre(0, 1, 2, 3));
+    EXPECT_THAT(BreadthFirst(store_, 0, EdgeDirection::OUTGOING, /*max_depth=*/1), ElementsAre(0, 1, 2));
+    EXPECT_THAT(BreadthFirst(store_, 3, EdgeDirection::INCOMING), ElementsAre(3, 2, 1, 0));
+    EXPECT_THAT(BreadthFirst(store_, 4, EdgeDirection::BOTH), ElementsAre(4));
+}
+
+TEST_F(GraphQueriesTest, ParallelBreadthFirstMatchesSequential) {
+    // A root with a wide fan out, each node of which has a child, and some shared grandchildren.
+    constexpr NodeIndex kWidth = 40000;
+    AddNodes(1 + 2 * kWidth);
+    for (NodeIndex i = 1; i <= kWidth; ++i) {
+        AddEdge(0, i);
+        AddEdge(i, kWidth + i);
+        AddEdge(i, kWidth + 1 + i % 100);
+    }
+    cppschema::TaskPool serial_pool(0);
+    cppschema::TaskPool pool(3);
+    const std::vector<NodeIndex> sequential = BreadthFirst(store_, 0, EdgeDirection::OUTGOING, 0, serial_pool);
+    std::vector<NodeIndex> parallel = BreadthFirst(store_, 0, EdgeDirection::OUTGOING, 0, pool);
+    ASSERT_EQ(parallel.size(), sequential.size());
+    EXPECT_EQ(parallel[0], 0);
+    // Same levels, in any order within a level.
+    std::sort(parallel.begin() + 1, parallel.begin() + 1 + kWidth);
+    std::sort(parallel.begin() + 1 + kWidth, parallel.end());
+    std::vector<NodeIndex> expected = sequential;
+    std::sort(expected.begin() + 1 + kWidth, expected.end());
+    EXPECT_EQ(parallel, expected);
+}
+
+TEST_F(GraphQueriesTest, ReadTheChangesSinceTheLastCompaction) {
+    AddNodes(3);
+    AddEdge(0, 1);
+    store_.Compact();
+    AddEdge(1, 2);
+    ASSERT_FALSE(store_.out_edges().compacted());
+    EXPECT_THAT(BreadthFirst(store_, 0, EdgeDirection::OUTGOING), ElementsAre(0, 1, 2));
+    EXPECT_THAT(TopologicalOrder(store_), ::testing::Optional(ElementsAre(0, 1, 2)));
+}
+
+TEST_F(GraphQueriesTest, TopologicalOrder) {
+    AddNodes(4);
+    AddEdge(2, 1);
+    AddEdge(1, 0);
+    AddEdge(3, 0);
+    EXPECT_THAT(TopologicalOrder(store_), ::testing::Optional(ElementsAre(2, 3, 1, 0)));
+    EXPECT_THAT(FindCycle(store_), IsEmpty());
+}
+
+TEST_F(GraphQueriesTest, FindCycle) {
+    // 0 -> 1 -> 2 -> 3 -> 1, and 3 -> 4.
+    AddNodes(5);
+    AddEdge(0, 1);
+    AddEdge(1, 2);
+    AddEdge(2, 3);
+    AddEdge(3, 1);
+    AddEdge(3, 4);
+    EXPECT_EQ(TopologicalOrder(store_), std::nullopt);
+    std::vector<NodeIndex> cycle = FindCycle(store_);
+    ASSERT_THAT(cycle, UnorderedElementsAre(1, 2, 3));
+    // Rotate it to start at 1, to check the direction.
+    std::rotate(cycle.begin(), std::find(cycle.begin(), cycle.end(), 1), cycle.end());
+    EXPECT_THAT(cycle, ElementsAre(1, 2, 3));
+}
+
+TEST_F(GraphQueriesTest, SelfLoop) {
+    AddNodes(2);
+    AddEdge(0, 1);
+    AddEdge(1, 1);
+    EXPECT_THAT(FindCycle(store_), ElementsAre(1));
+}
+
+}  // namespace
+}  // namespace graph
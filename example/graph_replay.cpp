@@ -0,0 +1,53 @@
+// Replays a log of GraphApi calls, recorded with `CallRecorder` (e.g. `mod.startCallRecording()`
+// and `mod.stopCallRecording()` in JS), through the native backend, and prints the throughput
+// and the latencies per API.
+//
+// $ bazel run -c opt //:graph_replay -- /path/to/calls.log [--paced] [--speed=N]
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "cppschema/apispec/call_replay.h"
+#include "graph_api.h"
+
+int main(int argc, char** argv) {
+    std::string path;
+    cppschema::ReplayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--paced") {
+            options.original_pacing = true;
+        } else if (arg.starts_with("--speed=")) {
+            options.original_pacing = true;
+            options.speed = std::atof(argv[i] + 8);
+        } else {
+            path = arg;
+        }
+    }
+    if (path.empty() || options.speed <= 0) {
+        std::cerr << "Usage: " << argv[0] << " <calls.log> [--paced] [--speed=N]\n";
+        return 2;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Can not read " << path << "\n";
+        return 1;
+    }
+    std::stringstream log;
+    log << file.rdbuf();
+
+    // The backend is registered by graph_backend.cpp.
+    cppschema::ReplayReport report;
+    const cppschema::Status status = cppschema::ReplayCalls<graph::GraphApi>(log.str(), options, &report);
+    std::cout << report.ToString();
+    if (!status.ok()) {
+        std::cerr << status.ToString() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "graph_store.h"
+
+#include <algorithm>
+#include <charconv>
+#include <utility>
+#include <vector>
+
+namespace graph {
+namespace {
+
+std::string FormatId(std::string_view prefix, uint32_t number) {
+    char digits[16];
+    const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), number);
+    std::string id;
+    id.reserve(prefix.size() + 1 + (end - digits));
+    id.append(prefix).append(1, '_').append(digits, end);
+    return id;
+}
+
+// The edges resolved by each task of `AddEdges`: a lookup is a fraction of a microsecond.
+constexpr size_t kEdgeGrain = 1024;
+
+template <typename Index>
+size_t HashIndexMemoryUsage(const absl::flat_hash_map<uint32_t, Index>& index) {
+    // A slot per entry, plus a control byte.
+    return index.capacity() * (sizeof(std::pair<const uint32_t, Index>) + 1);
+}
+
+}  // namespace
+
+std::string_view NodeTypeName(NodeTypeEnum node_type) {
+    switch (node_type) {
+        case NodeTypeEnum::UNKNOWN: return "UNKNOWN";
+        case NodeTypeEnum::GRAPH_INPUT: return "GRAPH_INPUT";
+        case NodeTypeEnum::GRAPH_OUTPUT: return "GRAPH_OUTPUT";
+        case NodeTypeEnum::FUNCTION: return "FUNCTION";
+    }
+    return "UNKNOWN";
+}
+
+std::string GraphStore::AddNode(const GraphApi::AddNodeRequest& request) {
+    const uint32_t serial = next_serial_++;
+    const NodeIndex node = nodes_.Insert(NodeRecord{
+        .ui_name = request.ui_name,
+        .node_type = request.node_type,
+        .timestamp = request.timestamp,
+        .serial = serial,
+    });
+    node_by_serial_.emplace(serial, node);
+    return FormatId(NodeTypeName(request.node_type), serial);
+}
+
+std::optional<NodeIndex> GraphStore::FindNode(std::string_view id) const {
+    const size_t separator = id.rfind('_');
+    if (separator == std::string_view::npos) {
+        return std::nullopt;
+    }
+    uint32_t serial;
+    const char* const end = id.data() + id.size();
+    const auto [ptr, ec] = std::from_chars(id.data() + separator + 1, end, serial);
+    if (ec != std::errc() || ptr != end) {
+        return std::nullopt;
+    }
+    auto it = node_by_serial_.find(serial);
+    if (it == node_by_serial_.end() ||
+        NodeTypeName(nodes_[it->second].node_type) != id.substr(0, separator)) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::string GraphStore::NodeIdOf(NodeIndex node) const {
+    return FormatId(NodeTypeName(nodes_[node].node_type), nodes_[node].serial);
+}
+
+bool GraphStore::DeleteNode(std::string_view id) {
+    const std::optional<NodeIndex> node = FindNode(id);
+    if (!node) {
+        return false;
+    }
+    std::vector<EdgeIndex> incident;
+    out_edges_.ForEach(*node, [&incident](const CsrIndex::Entry& e) { incident.push_back(e.edge); });
+    in_edges_.ForEach(*node, [&incident](const CsrIndex::Entry& e) { incident.push_back(e.edge); });
+    for (EdgeIndex edge : incident) {
+        // A self loop is listed both ways.
+        if (edges_.contains(edge)) {
+            DeleteEdge(edge);
+        }
+    }
+    node_by_serial_.erase(nodes_[*node].serial);
+    nodes_.Erase(*node);
+    return true;
+}
+
+cppschema::Status GraphStore::ValidateEdge(const EdgeConnection& edge) const {
+    for (const cppschema::InternedString& end : {edge.source, edge.target}) {
+        if (!FindNode(end)) {
+            return cppschema::NotFoundError("Edge " + std::to_string(edge.id.value) +
+                                            " refers to unknown node: " + end.str());
+        }
+    }
+    return cppschema::OkStatus();
+}
+
+std::string GraphStore::AddEdge(const EdgeConnection& edge) {
+    AddEdge(edge.id, *FindNode(edge.source), *FindNode(edge.target));
+    return FormatId("edge", edge.id.value);
+}
+
+void GraphStore::AddEdge(EdgeId id, NodeIndex source, NodeIndex target) {
+    if (auto it = edge_by_id_.find(id.value); it != edge_by_id_.end()) {
+        DeleteEdge(it->second);
+    }
+    const EdgeIndex index = edges_.Insert(EdgeRecord{.id = id, .source = source, .target = target});
+    edge_by_id_.emplace(id.value, index);
+    out_edges_.Add(source, target, index);
+    in_edges_.Add(target, source, index);
+}
+
+cppschema::Status GraphStore::AddEdges(std::span<const EdgeConnection> edges, cppschema::TaskPool& pool,
+                                       std::vector<std::string>* ids) {
+    struct Ends {
+        std::optional<NodeIndex> source;
+        std::optional<NodeIndex> target;
+    };
+    // The lookups only read the store, so they can run on any thread.
+    std::vector<Ends> ends(edges.size());
+    ids->resize(edges.size());
+    pool.ParallelFor(0, edges.size(), kEdgeGrain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ends[i] = {FindNode(edges[i].source), FindNode(edges[i].target)};
+            (*ids)[i] = FormatId("edge", edges[i].id.value);
+        }
+    });
+    // The first invalid edge, as a serial check would report it.
+    const size_t invalid = pool.ParallelReduce(0, edges.size(), kEdgeGrain, edges.size(),
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (!ends[i].source || !ends[i].target) {
+                    return i;
+                }
+            }
+            return edges.size();
+        },
+        [](size_t a, size_t b) { return std::min(a, b); });
+    if (invalid < edges.size()) {
+        ids->clear();
+        return ValidateEdge(edges[invalid]);
+    }
+    edge_by_id_.reserve(edge_by_id_.size() + edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        AddEdge(edges[i].id, *ends[i].source, *ends[i].target);
+    }
+    return cppschema::OkStatus();
+}
+
+void GraphStore::DeleteEdge(EdgeIndex edge) {
+    const EdgeRecord& record = edges_[edge];
+    out_edges_.Remove(record.source, edge);
+    in_edges_.Remove(record.target, edge);
+    edge_by_id_.erase(record.id.value);
+    edges_.Erase(edge);
+}
+
+void GraphStore::Clear() {
+    nodes_.Clear();
+    edges_.Clear();
+    node_by_serial_.clear();
+    edge_by_id_.clear();
+    out_edges_.Clear();
+    in_edges_.Clear();
+}
+
+void GraphStore::Compact() {
+    out_edges_.Compact();
+    in_edges_.Compact();
+}
+
+void GraphStore::Reserve(size_t num_nodes) {
+    nodes_.Reserve(num_nodes);
+    node_by_serial_.reserve(num_nodes);
+}
+
+size_t GraphStore::MemoryUsage() const {
+    return nodes_.MemoryUsage() + edges_.MemoryUsage() + HashIndexMemoryUsage(node_by_serial_) +
+        HashIndexMemoryUsage(edge_by_id_) + out_edges_.MemoryUsage() + in_edges_.MemoryUsage();
+}
+
+}  // namespace graph
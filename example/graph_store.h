@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "cppschema/apispec/task_pool.h"
+#include "cppschema/common/interned_string.h"
+#include "csr_index.h"
+#include "graph_api.h"
+#include "slot_map.h"
+
+namespace graph {
+
+// Prefix of the node ids, e.g. "FUNCTION" in "FUNCTION_1000".
+std::string_view NodeTypeName(NodeTypeEnum node_type);
+
+struct NodeRecord {
+    // Not interned: the names are mostly distinct, and would hold the slots of the process-wide
+    // `InternPool` for the lifetime of the nodes.
+    std::string ui_name;
+    NodeTypeEnum node_type = NodeTypeEnum::UNKNOWN;
+    int32_t timestamp = 0;
+    // The number in the id.
+    uint32_t serial = 0;
+};
+
+struct EdgeRecord {
+    EdgeId id;
+    NodeIndex source = 0;
+    NodeIndex target = 0;
+};
+
+/**
+ * The storage of the reference `GraphApi` backend, laid out for bulk changes and traversals.
+ *
+ * Nodes and edges live in dense slot maps, and are addressed internally by their slot index. The
+ * external ids are only parsed at the API boundary and looked up in flat hash indexes, and the
+ * adjacency is kept both ways in CSR form. Not thread-safe.
+ *
+ * @example
+ * GraphStore store;
+ * std::string a = store.AddNode({.ui_name = "a", .node_type = NodeTypeEnum::FUNCTION});
+ * std::string b = store.AddNode({.ui_name = "b", .node_type = NodeTypeEnum::FUNCTION});
+ * store.AddEdge({.id = EdgeId(1), .source = a, .target = b});  // "edge_1"
+ * store.DeleteNode(a);  // Also deletes the edge.
+ */
+class GraphStore {
+ public:
+    static constexpr uint32_t kFirstSerial = 1000;
+
+    // Returns the new node id, "<TYPE>_<serial>".
+    std::string AddNode(const GraphApi::AddNodeRequest& request);
+    // Deletes a node and its edges. Returns false if there is no such node.
+    bool DeleteNode(std::string_view id);
+
+    // Checks that both ends of an edge exist.
+    cppschema::Status ValidateEdge(const EdgeConnection& edge) const;
+    // Adds a valid edge, replacing any edge with the same id. Returns the edge id, "edge_<id>".
+    std::string AddEdge(const EdgeConnection& edge);
+    // Same, between nodes known by their index.
+    void AddEdge(EdgeId id, NodeIndex source, NodeIndex target);
+    // Adds a batch of edges, or none if one of them is invalid. The ends are looked up and the ids
+    // formatted on the threads of `pool`, and the edges inserted in order. Sets `ids` as `AddEdge`.
+    cppschema::Status AddEdges(std::span<const EdgeConnection> edges, cppschema::TaskPool& pool,
+                               std::vector<std::string>* ids);
+
+    // Deletes everything. The ids are not reused.
+    void Clear();
+
+    std::optional<NodeIndex> FindNode(std::string_view id) const;
+    std::string NodeIdOf(NodeIndex node) const;
+
+    const SlotMap<NodeRecord>& nodes() const { return nodes_; }
+    const SlotMap<EdgeRecord>& edges() const { return edges_; }
+    const CsrIndex& out_edges() const { return out_edges_; }
+    const CsrIndex& in_edges() const { return in_edges_; }
+
+    // Applies the pending changes to the adjacency indexes at once. Not needed by the traversals,
+    // which read the pending changes, and the indexes compact themselves as those accumulate.
+    void Compact();
+    void Reserve(size_t num_nodes);
+    // Approximate heap bytes held by the store.
+    size_t MemoryUsage() const;
+
+ private:
+    void DeleteEdge(EdgeIndex edge);
+
+    uint32_t next_serial_ = kFirstSerial;
+    SlotMap<NodeRecord> nodes_;
+    SlotMap<EdgeRecord> edges_;
+    absl::flat_hash_map<uint32_t, NodeIndex> node_by_serial_;
+    absl::flat_hash_map<uint32_t, EdgeIndex> edge_by_id_;
+    CsrIndex out_edges_;
+    CsrIndex in_edges_;
+};
+
+}  // namespace graph
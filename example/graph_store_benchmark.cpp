@@ -0,0 +1,114 @@
+// Measures the insert and delete throughput of the `GraphStore`, its memory per node, and the
+// scaling of the bulk edge insertion with the threads of the `TaskPool`.
+//
+// $ bazel run -c opt //:graph_store_benchmark
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "cppschema/apispec/task_pool.h"
+#include "graph_store.h"
+
+namespace graph {
+namespace {
+
+constexpr int kEdgesPerNode = 4;
+
+// Distinct, as the UI names of a real graph mostly are.
+std::string NodeName(int64_t i) { return "node_" + std::to_string(i); }
+
+// A graph of `num_nodes`, each with edges to the next few nodes. Returns the node ids.
+std::vector<std::string> BuildGraph(GraphStore& store, int64_t num_nodes) {
+    std::vector<std::string> ids;
+    ids.reserve(num_nodes);
+    store.Reserve(num_nodes);
+    for (int64_t i = 0; i < num_nodes; ++i) {
+        ids.push_back(store.AddNode({.ui_name = NodeName(i), .node_type = NodeTypeEnum::FUNCTION}));
+    }
+    uint32_t edge_id = 0;
+    for (int64_t i = 0; i < num_nodes; ++i) {
+        for (int k = 1; k <= kEdgesPerNode; ++k) {
+            store.AddEdge({
+                .id = EdgeId(edge_id++),
+                .source = ids[i],
+                .target = ids[(i + k) % num_nodes],
+            });
+        }
+    }
+    return ids;
+}
+
+void BM_AddNodes(benchmark::State& state) {
+    for (auto _ : state) {
+        GraphStore store;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            benchmark::DoNotOptimize(store.AddNode({.ui_name = NodeName(i), .node_type = NodeTypeEnum::FUNCTION}));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AddNodes)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 18);
+
+// Nodes with their edges.
+void BM_BuildGraph(benchmark::State& state) {
+    size_t bytes = 0;
+    for (auto _ : state) {
+        GraphStore store;
+        BuildGraph(store, state.range(0));
+        bytes = store.MemoryUsage();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes_per_node"] = static_cast<double>(bytes) / state.range(0);
+}
+BENCHMARK(BM_BuildGraph)->Arg(1 << 10)->Arg(1 << 16);
+
+// Deleting the nodes also deletes their edges.
+void BM_DeleteNodes(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        GraphStore store;
+        const std::vector<std::string> ids = BuildGraph(store, state.range(0));
+        state.ResumeTiming();
+        for (const std::string& id : ids) {
+            benchmark::DoNotOptimize(store.DeleteNode(id));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DeleteNodes)->Arg(1 << 10)->Arg(1 << 16);
+
+// A bulk `addEdges` of 4 edges per node, by the number of pool threads besides the caller.
+void BM_AddEdges(benchmark::State& state) {
+    const int64_t num_nodes = 1 << 16;
+    cppschema::TaskPool pool(state.range(0));
+    GraphStore store;
+    std::vector<std::string> ids;
+    for (int64_t i = 0; i < num_nodes; ++i) {
+        ids.push_back(store.AddNode({.ui_name = NodeName(i), .node_type = NodeTypeEnum::FUNCTION}));
+    }
+    std::vector<EdgeConnection> edges;
+    for (int64_t i = 0; i < num_nodes; ++i) {
+        for (int k = 1; k <= kEdgesPerNode; ++k) {
+            edges.push_back({
+                .id = EdgeId(static_cast<uint32_t>(edges.size())),
+                .source = ids[i],
+                .target = ids[(i + k) % num_nodes],
+            });
+        }
+    }
+    std::vector<std::string> edge_ids;
+    for (auto _ : state) {
+        // The same ids again replace the edges, so the store does not grow.
+        benchmark::DoNotOptimize(store.AddEdges(edges, pool, &edge_ids));
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+BENCHMARK(BM_AddEdges)->ArgName("threads")->Arg(0)->Arg(1)->Arg(3)->Arg(7)->UseRealTime();
+
+}  // namespace
+}  // namespace graph
+
+BENCHMARK_MAIN();
@@ -0,0 +1,164 @@
+// Execute this test from the "example" dir as:
+// $ bazel test //:graph_store_test
+
+#include "graph_store.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock-matchers.h"
+#include "gtest/gtest.h"
+
+namespace graph {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+std::vector<NodeIndex> Neighbors(const CsrIndex& index, NodeIndex node) {
+    std::vector<NodeIndex> neighbors;
+    index.ForEach(node, [&neighbors](const CsrIndex::Entry& e) { neighbors.push_back(e.node); });
+    return neighbors;
+}
+
+GraphApi::AddNodeRequest Function(std::string name) {
+    return {.ui_name = std::move(name), .node_type = NodeTypeEnum::FUNCTION, .timestamp = 1};
+}
+
+TEST(SlotMapTest, ReusesErasedSlots) {
+    SlotMap<int> slots;
+    EXPECT_EQ(slots.Insert(10), 0);
+    EXPECT_EQ(slots.Insert(11), 1);
+    slots.Erase(0);
+    EXPECT_FALSE(slots.contains(0));
+    EXPECT_EQ(slots.size(), 1);
+    EXPECT_EQ(slots.Insert(12), 0);
+    EXPECT_EQ(slots[0], 12);
+    EXPECT_EQ(slots.end_index(), 2);
+}
+
+TEST(CsrIndexTest, AddRemoveAndCompact) {
+    CsrIndex index;
+    index.Add(0, 1, 100);
+    index.Add(0, 2, 101);
+    index.Add(3, 0, 102);
+    EXPECT_THAT(Neighbors(index, 0), UnorderedElementsAre(1, 2));
+    index.Compact();
+    EXPECT_TRUE(index.compacted());
+    EXPECT_THAT(index.offsets(), ElementsAre(0, 2, 2, 2, 3));
+    EXPECT_TRUE(index.Remove(0, 100));
+    EXPECT_FALSE(index.Remove(0, 100));
+    index.Add(1, 3, 103);
+    EXPECT_THAT(Neighbors(index, 0), ElementsAre(2));
+    EXPECT_THAT(Neighbors(index, 1), ElementsAre(3));
+    EXPECT_EQ(index.size(), 3);
+    index.Compact();
+    EXPECT_THAT(index.offsets(), ElementsAre(0, 1, 2, 2, 3));
+    EXPECT_EQ(index.Degree(7), 0);
+}
+
+TEST(CsrIndexTest, CompactsAutomatically) {
+    CsrIndex index;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        index.Add(i % 100, i, i);
+    }
+    for (uint32_t i = 0; i < 10000; i += 2) {
+        ASSERT_TRUE(index.Remove(i % 100, i));
+    }
+    EXPECT_EQ(index.size(), 5000);
+    EXPECT_EQ(index.Degree(0), 0);
+    EXPECT_EQ(index.Degree(1), 100);
+    EXPECT_LT(index.entries().size(), 10000);
+}
+
+TEST(GraphStoreTest, NodeIds) {
+    GraphStore store;
+    EXPECT_EQ(store.AddNode(Function("a")), "FUNCTION_1000");
+    EXPECT_EQ(store.AddNode({.node_type = NodeTypeEnum::GRAPH_INPUT}), "GRAPH_INPUT_1001");
+    EXPECT_TRUE(store.FindNode("GRAPH_INPUT_1001").has_value());
+    for (const char* id : {"FUNCTION_1001", "GRAPH_INPUT_1000", "FUNCTION_", "FUNCTION_1000x", "1000", ""}) {
+        EXPECT_FALSE(store.FindNode(id).has_value()) << id;
+    }
+    EXPECT_EQ(store.NodeIdOf(*store.FindNode("FUNCTION_1000")), "FUNCTION_1000");
+    EXPECT_EQ(store.nodes()[*store.FindNode("FUNCTION_1000")].ui_name, "a");
+}
+
+TEST(GraphStoreTest, DeleteNodeDeletesItsEdges) {
+    GraphStore store;
+    const std::string a = store.AddNode(Function("a"));
+    const std::string b = store.AddNode(Function("b"));
+    const std::string c = store.AddNode(Function("c"));
+    EXPECT_EQ(store.AddEdge({.id = EdgeId(1), .source = a, .target = b}), "edge_1");
+    store.AddEdge({.id = EdgeId(2), .source = b, .target = c});
+    store.AddEdge({.id = EdgeId(3), .source = b, .target = b});
+    store.AddEdge({.id = EdgeId(4), .source = c, .target = a});
+    EXPECT_FALSE(store.ValidateEdge({.id = EdgeId(5), .source = a, .target = "FUNCTION_7"}).ok());
+
+    EXPECT_TRUE(store.DeleteNode(b));
+    EXPECT_FALSE(store.DeleteNode(b));
+    EXPECT_EQ(store.edges().size(), 1);
+    const NodeIndex c_index = *store.FindNode(c);
+    EXPECT_THAT(Neighbors(store.out_edges(), c_index), ElementsAre(*store.FindNode(a)));
+    EXPECT_THAT(Neighbors(store.in_edges(), c_index), ElementsAre());
+
+    // The slot of `b` is reused, not its id.
+    EXPECT_EQ(store.AddNode(Function("d")), "FUNCTION_1003");
+    EXPECT_EQ(store.nodes().end_index(), 3);
+}
+
+TEST(GraphStoreTest, ReAddingAnEdgeReplacesIt) {
+    GraphStore store;
+    const std::string a = store.AddNode(Function("a"));
+    const std::string b = store.AddNode(Function("b"));
+    store.AddEdge({.id = EdgeId(1), .source = a, .target = b});
+    store.AddEdge({.id = EdgeId(1), .source = b, .target = a});
+    EXPECT_EQ(store.edges().size(), 1);
+    EXPECT_THAT(Neighbors(store.out_edges(), *store.FindNode(a)), ElementsAre());
+    EXPECT_THAT(Neighbors(store.out_edges(), *store.FindNode(b)), ElementsAre(*store.FindNode(a)));
+}
+
+TEST(GraphStoreTest, AddEdgesInParallel) {
+    cppschema::TaskPool pool(3);
+    GraphStore store;
+    std::vector<std::string> ids;
+    for (int i = 0; i < 100; ++i) {
+        ids.push_back(store.AddNode(Function("n")));
+    }
+    std::vector<EdgeConnection> edges;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        edges.push_back({.id = EdgeId(i), .source = ids[i % 100], .target = ids[(i + 1) % 100]});
+    }
+    std::vector<std::string> edge_ids;
+    ASSERT_TRUE(store.AddEdges(edges, pool, &edge_ids).ok());
+    ASSERT_EQ(edge_ids.size(), 5000);
+    EXPECT_EQ(edge_ids[4321], "edge_4321");
+    EXPECT_EQ(store.edges().size(), 5000);
+    EXPECT_EQ(Neighbors(store.out_edges(), *store.FindNode(ids[7])).size(), 50);
+
+    // The first invalid edge is reported, and none of the batch is added.
+    edges[3000].target = "FUNCTION_7";
+    edges[4000].source = "FUNCTION_8";
+    for (EdgeConnection& edge : edges) {
+        edge.id = EdgeId(edge.id.value + 5000);
+    }
+    const cppschema::Status status = store.AddEdges(edges, pool, &edge_ids);
+    EXPECT_EQ(status.code(), cppschema::StatusCode::kNotFound);
+    EXPECT_EQ(status.message(), "Edge 8000 refers to unknown node: FUNCTION_7");
+    EXPECT_TRUE(edge_ids.empty());
+    EXPECT_EQ(store.edges().size(), 5000);
+}
+
+TEST(GraphStoreTest, ClearDeletesEverything) {
+    GraphStore store;
+    const std::string a = store.AddNode(Function("a"));
+    store.AddEdge({.id = EdgeId(1), .source = a, .target = a});
+    store.Clear();
+    EXPECT_EQ(store.nodes().size(), 0);
+    EXPECT_EQ(store.edges().size(), 0);
+    EXPECT_EQ(store.out_edges().size(), 0);
+    EXPECT_FALSE(store.FindNode(a).has_value());
+    EXPECT_EQ(store.AddNode(Function("b")), "FUNCTION_1001");
+}
+
+}  // namespace
+}  // namespace graph
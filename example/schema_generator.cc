@@ -0,0 +1,251 @@
+#include "schema_generator.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace synthetic {
+namespace {
+
+constexpr int kMaxMembers = 30;
+
+struct ContainerName {
+    std::string_view name;
+    ContainerKind kind;
+};
+
+constexpr std::array<ContainerName, 8> kContainerNames = {{
+    {"vector", ContainerKind::kVector},
+    {"deque", ContainerKind::kDeque},
+    {"array", ContainerKind::kArray},
+    {"map", ContainerKind::kMap},
+    {"hash_map", ContainerKind::kHashMap},
+    {"set", ContainerKind::kSet},
+    {"hash_set", ContainerKind::kHashSet},
+    {"optional", ContainerKind::kOptional},
+}};
+
+// The scalar fields cycle through these, then the enums.
+struct ScalarType {
+    std::string_view type;
+    std::string_view init;
+};
+
+constexpr std::array<ScalarType, 7> kScalarTypes = {{
+    {"int32_t", " = 0"},
+    {"double", " = 0"},
+    {"std::string", ""},
+    {"bool", " = false"},
+    {"int64_t", " = 0"},
+    {"uint32_t", " = 0"},
+    {"float", " = 0"},
+}};
+
+bool IsSet(ContainerKind kind) { return kind == ContainerKind::kSet || kind == ContainerKind::kHashSet; }
+
+// The kinds which can hold a struct.
+std::vector<ContainerKind> StructContainers(const SchemaShape& shape) {
+    std::vector<ContainerKind> kinds;
+    for (ContainerKind kind : shape.containers) {
+        if (!IsSet(kind)) {
+            kinds.push_back(kind);
+        }
+    }
+    return kinds;
+}
+
+// The fields of a struct above the last level which hold the next level.
+int NumChildFields(const SchemaShape& shape) {
+    return std::max<int>(StructContainers(shape).size(), 1);
+}
+
+std::string Wrap(ContainerKind kind, const std::string& type, int fanout) {
+    switch (kind) {
+        case ContainerKind::kVector:
+            return "std::vector<" + type + ">";
+        case ContainerKind::kDeque:
+            return "std::deque<" + type + ">";
+        case ContainerKind::kArray:
+            return "std::array<" + type + ", " + std::to_string(fanout) + ">";
+        case ContainerKind::kMap:
+            return "std::map<std::string, " + type + ">";
+        case ContainerKind::kHashMap:
+            return "std::unordered_map<std::string, " + type + ">";
+        case ContainerKind::kSet:
+            return "std::set<" + type + ">";
+        case ContainerKind::kHashSet:
+            return "std::unordered_set<" + type + ">";
+        case ContainerKind::kOptional:
+            return "std::optional<" + type + ">";
+    }
+    return type;
+}
+
+std::string EnumName(int index) { return "Enum" + std::to_string(index); }
+
+std::string LevelName(int level) { return "Level" + std::to_string(level); }
+
+void AppendEnum(int index, int num_values, std::string* out) {
+    std::string values;
+    for (int v = 0; v < num_values; ++v) {
+        values += (v == 0 ? "V" : ", V") + std::to_string(v);
+    }
+    *out += "enum class " + EnumName(index) + " { " + values + " };\n";
+    *out += "DEFINE_ENUM_CONVERSION_FUNCTION(" + EnumName(index) + ", " + values + ");\n\n";
+}
+
+void AppendStruct(const SchemaShape& shape, int level, std::string* out) {
+    const bool has_children = level + 1 < shape.depth;
+    const std::vector<ContainerKind> struct_containers = StructContainers(shape);
+    const int num_children = has_children ? NumChildFields(shape) : 0;
+    const int num_scalar_types = static_cast<int>(kScalarTypes.size()) + shape.enums;
+
+    std::string names;
+    *out += "struct " + LevelName(level) + " {\n";
+    for (int i = 0; i < shape.width; ++i) {
+        const std::string name = "f" + std::to_string(i);
+        names += (i == 0 ? "" : ", ") + name;
+        if (i < num_children) {
+            const std::string child = LevelName(level + 1);
+            const std::string type =
+                struct_containers.empty() ? child : Wrap(struct_containers[i], child, shape.fanout);
+            *out += "    " + type + " " + name + ";\n";
+            continue;
+        }
+        const int j = i - num_children;
+        const int scalar = j % num_scalar_types;
+        std::string type;
+        std::string init;
+        if (scalar < static_cast<int>(kScalarTypes.size())) {
+            type = kScalarTypes[scalar].type;
+            init = kScalarTypes[scalar].init;
+        } else {
+            type = EnumName(scalar - static_cast<int>(kScalarTypes.size()));
+            init = " = " + type + "::V0";
+        }
+        if (!shape.containers.empty() && j % 3 == 2) {
+            const ContainerKind kind = shape.containers[(j / 3) % shape.containers.size()];
+            if (IsSet(kind) && type != "int32_t" && type != "uint32_t") {
+                type = "std::string";  // The keyable types only, see schema_traits.h.
+            }
+            type = Wrap(kind, type, shape.fanout);
+            init = kind == ContainerKind::kArray ? "{}" : "";
+        }
+        *out += "    " + type + " " + name + init + ";\n";
+    }
+    *out += "\n    bool operator==(const " + LevelName(level) + "&) const = default;\n";
+    *out += "\n    DEFINE_STRUCT_VISITOR_FUNCTION(" + names + ");\n};\n\n";
+}
+
+}  // namespace
+
+cppschema::Status ValidateSchemaShape(const SchemaShape& shape) {
+    if (shape.width < 1 || shape.width > kMaxMembers) {
+        return cppschema::InvalidArgumentError("width must be in [1, 30], the members of DEFINE_STRUCT_VISITOR_FUNCTION");
+    }
+    if (shape.depth < 1) {
+        return cppschema::InvalidArgumentError("depth must be at least 1");
+    }
+    if (shape.depth > 1 && NumChildFields(shape) > shape.width) {
+        return cppschema::InvalidArgumentError("width must fit a field per container of the nested structs");
+    }
+    if (shape.enums < 0) {
+        return cppschema::InvalidArgumentError("enums must not be negative");
+    }
+    if (shape.enum_values < 1 || shape.enum_values > kMaxMembers) {
+        return cppschema::InvalidArgumentError("enum_values must be in [1, 30], the values of DEFINE_ENUM_CONVERSION_FUNCTION");
+    }
+    if (shape.fanout < 1) {
+        return cppschema::InvalidArgumentError("fanout must be at least 1");
+    }
+    return cppschema::OkStatus();
+}
+
+cppschema::Status ParseContainerKinds(std::string_view list, std::vector<ContainerKind>* kinds) {
+    kinds->clear();
+    while (!list.empty()) {
+        const size_t comma = list.find(',');
+        const std::string_view name = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        bool found = false;
+        for (const ContainerName& container : kContainerNames) {
+            if (container.name == name) {
+                kinds->push_back(container.kind);
+                found = true;
+            }
+        }
+        if (!found) {
+            return cppschema::InvalidArgumentError("Unknown container: " + std::string(name));
+        }
+    }
+    return cppschema::OkStatus();
+}
+
+std::string SchemaShapeToString(const SchemaShape& shape) {
+    std::string containers;
+    for (ContainerKind kind : shape.containers) {
+        for (const ContainerName& container : kContainerNames) {
+            if (container.kind == kind) {
+                containers += (containers.empty() ? "" : ",") + std::string(container.name);
+            }
+        }
+    }
+    return "--width=" + std::to_string(shape.width) + " --depth=" + std::to_string(shape.depth) +
+           " --containers=" + containers + " --enums=" + std::to_string(shape.enums) +
+           " --enum_values=" + std::to_string(shape.enum_values) + " --fanout=" + std::to_string(shape.fanout);
+}
+
+std::string GenerateSchemaHeader(const SchemaShape& shape) {
+    const std::string flags = SchemaShapeToString(shape);
+    std::string out;
+    out += "// Generated by generate_schema " + flags + ", do not edit.\n";
+    out += R"(
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cppschema/apispec/api_framework.h"
+#include "cppschema/common/enum_registry.h"
+#include "cppschema/common/visitor_macros.h"
+
+namespace synthetic {
+
+)";
+    out += "inline constexpr char kSchemaShape[] = \"" + flags + "\";\n";
+    out += "inline constexpr int kFanout = " + std::to_string(shape.fanout) + ";\n\n";
+    for (int i = 0; i < shape.enums; ++i) {
+        AppendEnum(i, shape.enum_values, &out);
+    }
+    // The leaves first, each struct uses the next level.
+    for (int level = shape.depth - 1; level >= 0; --level) {
+        AppendStruct(shape, level, &out);
+    }
+    out += R"(using Root = Level0;
+
+struct SyntheticApi {
+    // Return their requests.
+    cppschema::ApiStub<Root, Root> echo;
+    cppschema::ApiStub<std::vector<Root>, std::vector<Root>> echoMany;
+    // Returns the root filled from a seed, see synthetic_schema.h.
+    cppschema::ApiStub<uint32_t, Root> make;
+
+    DEFINE_API_VISITOR_FUNCTION(echo, echoMany, make);
+};
+
+}  // namespace synthetic
+)";
+    return out;
+}
+
+}  // namespace synthetic
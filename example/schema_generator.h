@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cppschema/common/status.h"
+
+namespace synthetic {
+
+// The containers which wrap the generated fields. Sets only hold the scalars which can be keys
+// (int32_t, uint32_t and strings), the others are replaced by strings in them.
+enum class ContainerKind { kVector, kDeque, kArray, kMap, kHashMap, kSet, kHashSet, kOptional };
+
+/**
+ * The shape of a generated API spec (see `GenerateSchemaHeader`), for stressing the reflection
+ * macros and the converter templates with schemas larger than the example APIs.
+ *
+ * The root struct is `Level0`, each `LevelN` struct has `width` fields, and the structs above the
+ * last level have one field per container kind of `containers` (or a plain field when there is
+ * none) holding the struct of the next level. The other fields cycle through the scalar types and
+ * the enums, every third of them wrapped in a container of `containers`.
+ *
+ * @example
+ * SchemaShape shape{.width = 30, .depth = 3, .containers = {ContainerKind::kVector,
+ *                   ContainerKind::kMap, ContainerKind::kOptional}, .enums = 4};
+ * if (cppschema::Status status = ValidateSchemaShape(shape); !status.ok()) { ... }
+ * std::string header = GenerateSchemaHeader(shape);
+ */
+struct SchemaShape {
+    // The fields per struct, up to the 30 members of `DEFINE_STRUCT_VISITOR_FUNCTION`.
+    int width = 8;
+    // The levels of nested structs, 1 for a flat root struct.
+    int depth = 2;
+    std::vector<ContainerKind> containers = {ContainerKind::kVector};
+    // The enum types, and the values of each, up to 30 as well.
+    int enums = 1;
+    int enum_values = 4;
+    // The elements of each container in the sample data (see synthetic_schema.h), and the size of
+    // the std::array fields.
+    int fanout = 2;
+};
+
+// The limits of the macros, and enough fields for the nested structs.
+cppschema::Status ValidateSchemaShape(const SchemaShape& shape);
+
+// Parses a comma separated list of "vector", "deque", "array", "map", "hash_map", "set",
+// "hash_set" and "optional". An empty list has no containers.
+cppschema::Status ParseContainerKinds(std::string_view list, std::vector<ContainerKind>* kinds);
+
+// The shape as the flags of generate_schema, e.g. "--width=30 --depth=1 --containers=vector".
+std::string SchemaShapeToString(const SchemaShape& shape);
+
+// A header defining the enums and structs of `shape` in the `synthetic` namespace, and the
+// `SyntheticApi` over them (see synthetic_backend.cpp). The shape must be valid.
+std::string GenerateSchemaHeader(const SchemaShape& shape);
+
+}  // namespace synthetic
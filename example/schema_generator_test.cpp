@@ -0,0 +1,81 @@
+#include "schema_generator.h"
+
+#include <string>
+#include <vector>
+
+#include "cppschema/common/status.h"
+#include "gtest/gtest.h"
+
+namespace synthetic {
+namespace {
+
+using ::cppschema::StatusCode;
+
+int Count(const std::string& text, const std::string& part) {
+    int count = 0;
+    for (size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+TEST(SchemaGeneratorTest, ValidatesTheMacroLimits) {
+    EXPECT_TRUE(ValidateSchemaShape({.width = 30, .enum_values = 30}).ok());
+    EXPECT_EQ(ValidateSchemaShape({.width = 31}).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(ValidateSchemaShape({.width = 0}).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(ValidateSchemaShape({.depth = 0}).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(ValidateSchemaShape({.enum_values = 31}).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(ValidateSchemaShape({.fanout = 0}).code(), StatusCode::kInvalidArgument);
+    // A field per container of the next level.
+    const std::vector<ContainerKind> three = {ContainerKind::kVector, ContainerKind::kMap, ContainerKind::kOptional};
+    EXPECT_EQ(ValidateSchemaShape({.width = 2, .depth = 2, .containers = three}).code(), StatusCode::kInvalidArgument);
+    EXPECT_TRUE(ValidateSchemaShape({.width = 2, .depth = 1, .containers = three}).ok());
+}
+
+TEST(SchemaGeneratorTest, ParsesContainerKinds) {
+    std::vector<ContainerKind> kinds;
+    ASSERT_TRUE(ParseContainerKinds("vector,hash_map,optional", &kinds).ok());
+    EXPECT_EQ(kinds, (std::vector<ContainerKind>{ContainerKind::kVector, ContainerKind::kHashMap, ContainerKind::kOptional}));
+    ASSERT_TRUE(ParseContainerKinds("", &kinds).ok());
+    EXPECT_TRUE(kinds.empty());
+    EXPECT_EQ(ParseContainerKinds("vector,list", &kinds).code(), StatusCode::kInvalidArgument);
+
+    const SchemaShape shape{.containers = {ContainerKind::kDeque, ContainerKind::kHashSet}};
+    EXPECT_EQ(SchemaShapeToString(shape),
+              "--width=8 --depth=2 --containers=deque,hash_set --enums=1 --enum_values=4 --fanout=2");
+}
+
+TEST(SchemaGeneratorTest, GeneratesTheShape) {
+    const std::string header = GenerateSchemaHeader({
+        .width = 30,
+        .depth = 3,
+        .containers = {ContainerKind::kVector, ContainerKind::kArray, ContainerKind::kSet},
+        .enums = 2,
+        .enum_values = 5,
+        .fanout = 3,
+    });
+    EXPECT_EQ(Count(header, "DEFINE_ENUM_CONVERSION_FUNCTION("), 2);
+    EXPECT_EQ(Count(header, "enum class Enum1 { V0, V1, V2, V3, V4 };"), 1);
+    EXPECT_EQ(Count(header, "DEFINE_STRUCT_VISITOR_FUNCTION("), 3);
+    EXPECT_EQ(Count(header, ", f29);"), 3);
+    // The structs are defined before the levels which use them, in containers other than sets.
+    EXPECT_LT(header.find("struct Level2 {"), header.find("struct Level1 {"));
+    EXPECT_LT(header.find("struct Level1 {"), header.find("struct Level0 {"));
+    EXPECT_EQ(Count(header, "std::vector<Level2> f0;"), 1);
+    EXPECT_EQ(Count(header, "std::array<Level1, 3> f1;"), 1);
+    EXPECT_EQ(Count(header, "std::set<Level"), 0);
+    // The sets hold the keyable types only.
+    EXPECT_EQ(Count(header, "std::set<double>"), 0);
+    EXPECT_GT(Count(header, "std::set<std::string>"), 0);
+    EXPECT_EQ(Count(header, "DEFINE_API_VISITOR_FUNCTION(echo, echoMany, make);"), 1);
+}
+
+TEST(SchemaGeneratorTest, FlatWithoutContainers) {
+    const std::string header = GenerateSchemaHeader({.width = 3, .depth = 1, .containers = {}, .enums = 0});
+    EXPECT_EQ(Count(header, "struct Level"), 1);
+    EXPECT_EQ(Count(header, "enum class"), 0);
+    EXPECT_NE(header.find("int32_t f0 = 0;\n    double f1 = 0;\n    std::string f2;\n"), std::string::npos) << header;
+}
+
+}  // namespace
+}  // namespace synthetic
@@ -0,0 +1,41 @@
+#!/bin/bash
+# Compares the synthetic schemas of BUILD.bazel (see synthetic_schema.bzl): for each, the time to
+# recompile its sources natively and as wasm, the size of both binaries, then its native and JS
+# conversion benchmarks. Run from this directory, for all the schemas or the given ones:
+#
+# $ ./schema_stress.sh [synthetic_wide synthetic_deep ...]
+#
+# The sources are recompiled by giving them a new define, the other actions stay cached. The
+# times are the wall times of the builds, so they include the analysis and the links.
+
+set -euo pipefail
+cd "$(dirname "$0")"
+
+schemas=("$@")
+if [ ${#schemas[@]} -eq 0 ]; then
+    schemas=($(bazel query --output=label 'attr(generator_function, "^synthetic_schema$", kind(genrule, //:all))' 2>/dev/null |
+        sed -e 's|^//:||' -e 's|_gen$||'))
+fi
+
+# Prints the wall time of building the targets, with the synthetic sources recompiled.
+rebuild_seconds() {
+    local TIMEFORMAT=%R
+    { time bazel build -c opt --per_file_copt="synthetic_.*\.cpp@-DSYNTHETIC_REBUILD=$RANDOM$RANDOM" "$@" \
+        >/dev/null 2>&1; } 2>&1
+}
+
+summary="schema\tnative compile (s)\twasm compile (s)\tnative binary (bytes)\twasm binary (bytes)"
+for schema in "${schemas[@]}"; do
+    echo "=== $schema" >&2
+    bazel build -c opt "//:${schema}_benchmark" "//:${schema}_wasm"
+    native_seconds=$(rebuild_seconds "//:${schema}_benchmark")
+    wasm_seconds=$(rebuild_seconds "//:${schema}_wasm")
+    native_bytes=$(wc -c < "bazel-bin/${schema}_benchmark")
+    wasm_bytes=$(wc -c < "bazel-bin/${schema}_wasm/${schema}_bind.wasm")
+    summary+="\n${schema}\t${native_seconds}\t${wasm_seconds}\t${native_bytes// /}\t${wasm_bytes// /}"
+
+    "bazel-bin/${schema}_benchmark"
+    bazel run -c opt "//:${schema}_js_benchmark"
+done
+
+echo -e "\n$summary"
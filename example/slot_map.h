@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Dense storage addressed by a stable integer index. Erased slots are reused by the later inserts,
+ * so the indices stay small and the values contiguous, which is what the CSR index and the
+ * traversals want.
+ *
+ * @example
+ * SlotMap<NodeRecord> nodes;
+ * uint32_t index = nodes.Insert(record);
+ * nodes[index].timestamp = 5;
+ * nodes.Erase(index);  // `index` may be handed out again.
+ */
+template <typename T>
+class SlotMap {
+ public:
+    using Index = uint32_t;
+
+    Index Insert(T value) {
+        ++size_;
+        if (!free_.empty()) {
+            const Index index = free_.back();
+            free_.pop_back();
+            slots_[index] = std::move(value);
+            alive_[index] = true;
+            return index;
+        }
+        slots_.push_back(std::move(value));
+        alive_.push_back(true);
+        return static_cast<Index>(slots_.size() - 1);
+    }
+
+    void Erase(Index index) {
+        slots_[index] = T{};
+        alive_[index] = false;
+        free_.push_back(index);
+        --size_;
+    }
+
+    bool contains(Index index) const { return index < alive_.size() && alive_[index]; }
+
+    T& operator[](Index index) { return slots_[index]; }
+    const T& operator[](Index index) const { return slots_[index]; }
+
+    // Number of the values.
+    size_t size() const { return size_; }
+    // One past the largest index ever handed out, i.e. the size of the arrays indexed by slot.
+    Index end_index() const { return static_cast<Index>(slots_.size()); }
+
+    // Calls `fn(index, value)` for each value, in index order.
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (Index i = 0; i < slots_.size(); ++i) {
+            if (alive_[i]) {
+                fn(i, slots_[i]);
+            }
+        }
+    }
+
+    void Clear() {
+        slots_.clear();
+        alive_.clear();
+        free_.clear();
+        size_ = 0;
+    }
+
+    void Reserve(size_t count) {
+        slots_.reserve(count);
+        alive_.reserve(count);
+    }
+
+    size_t MemoryUsage() const {
+        return slots_.capacity() * sizeof(T) + alive_.capacity() / 8 + free_.capacity() * sizeof(Index);
+    }
+
+ private:
+    std::vector<T> slots_;
+    std::vector<bool> alive_;
+    std::vector<Index> free_;
+    size_t size_ = 0;
+};
+
+}  // namespace graph
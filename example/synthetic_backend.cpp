@@ -0,0 +1,33 @@
+// The backend of the generated `SyntheticApi`, the same for every shape (see synthetic_schema.bzl).
+
+#include <cstdint>
+#include <vector>
+
+#include "cppschema/backend/api_backend_bridge.h"
+#include "synthetic_api.h"
+#include "synthetic_schema.h"
+
+namespace synthetic {
+
+class SyntheticApiImpl : public cppschema::ApiBackend<SyntheticApi> {
+ public:
+    Root echoImpl(const Root& request) { return request; }
+
+    std::vector<Root> echoManyImpl(const std::vector<Root>& request) { return request; }
+
+    Root makeImpl(const uint32_t& seed) {
+        Root root;
+        Fill(root, seed, kFanout);
+        return root;
+    }
+};
+
+static __attribute__((constructor)) void RegisterSyntheticApiBackend() {
+    cppschema::RegisterBackend<SyntheticApi, SyntheticApiImpl>(new SyntheticApiImpl(), {
+        .echo = &SyntheticApiImpl::echoImpl,
+        .echoMany = &SyntheticApiImpl::echoManyImpl,
+        .make = &SyntheticApiImpl::makeImpl,
+    });
+}
+
+}  // namespace synthetic
@@ -0,0 +1,95 @@
+// Measures the native conversions of a generated schema (see synthetic_schema.bzl): the wire codec
+// of the RPC transports and call recording, and the calls through the `ApiRegistry`, per scalar
+// value and per encoded byte.
+//
+// $ bazel run -c opt //:synthetic_wide_benchmark
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "cppschema/apispec/api_registry.h"
+#include "cppschema/common/wire_codec.h"
+#include "synthetic_api.h"
+#include "synthetic_schema.h"
+
+namespace synthetic {
+namespace {
+
+// `n` roots of different seeds.
+std::vector<Root> MakeRoots(int64_t n) {
+    std::vector<Root> roots(n);
+    for (int64_t i = 0; i < n; ++i) {
+        Fill(roots[i], static_cast<uint32_t>(i), kFanout);
+    }
+    return roots;
+}
+
+// The values and the encoded bytes of `roots`, per iteration.
+void SetCounters(benchmark::State& state, const std::vector<Root>& roots) {
+    size_t values = 0;
+    for (const Root& root : roots) {
+        values += CountValues(root);
+    }
+    state.SetItemsProcessed(state.iterations() * values);
+    state.SetBytesProcessed(state.iterations() * cppschema::WireEncode(roots).size());
+}
+
+void BM_WireEncode(benchmark::State& state) {
+    const std::vector<Root> roots = MakeRoots(state.range(0));
+    std::string bytes;
+    for (auto _ : state) {
+        bytes.clear();
+        cppschema::WireEncodeTo(roots, &bytes);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    SetCounters(state, roots);
+}
+BENCHMARK(BM_WireEncode)->Arg(1)->Arg(64);
+
+void BM_WireDecode(benchmark::State& state) {
+    const std::vector<Root> roots = MakeRoots(state.range(0));
+    const std::string bytes = cppschema::WireEncode(roots);
+    std::vector<Root> decoded;
+    for (auto _ : state) {
+        if (!cppschema::WireDecode(bytes, &decoded)) {
+            state.SkipWithError("WireDecode failed");
+            break;
+        }
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    SetCounters(state, roots);
+}
+BENCHMARK(BM_WireDecode)->Arg(1)->Arg(64);
+
+// The dispatch, and the copies of the echo backend (see synthetic_backend.cpp).
+void BM_CallEcho(benchmark::State& state) {
+    const std::vector<Root> roots = MakeRoots(state.range(0));
+    cppschema::ApiRegistry<SyntheticApi>& registry = cppschema::ApiRegistry<SyntheticApi>::Get();
+    std::vector<Root> echoed;
+    for (auto _ : state) {
+        cppschema::Status status = registry.TryCall("echoMany", roots, &echoed);
+        if (!status.ok()) {
+            state.SkipWithError(status.ToString().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(echoed.data());
+    }
+    SetCounters(state, roots);
+}
+BENCHMARK(BM_CallEcho)->Arg(1)->Arg(64);
+
+}  // namespace
+}  // namespace synthetic
+
+int main(int argc, char** argv) {
+    benchmark::AddCustomContext("schema", synthetic::kSchemaShape);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Times the JS conversions of a generated schema (see synthetic_schema.bzl) with both bindings
+// engines, and prints the size of its wasm binary. Build with -c opt for meaningful numbers.
+//
+// $ bazel run -c opt //:synthetic_wide_js_benchmark
+
+import fs from "fs";
+import path from "path";
+import process from "process";
+
+// The wasm_cc_binary directory and the cc_binary name, see the `synthetic_schema` macro.
+const [wasmDirName, bindName] = process.argv.slice(2);
+
+async function loadSyntheticWasmModule() {
+  const runfiles = process.env.JS_BINARY__RUNFILES || "";
+  const workspace = process.env.JS_BINARY__WORKSPACE || "";
+  if (runfiles.length <= 0 || workspace.length <= 0 || !wasmDirName || !bindName) {
+    console.error("Usage: synthetic_benchmark.mjs <wasm dir> <bind name>, under bazel run: ",
+                  {runfiles, workspace});
+    process.exit(1);
+  }
+  const wasmDir = path.join(runfiles, workspace, wasmDirName);
+  const wasmBinaryPath = path.join(wasmDir, `${bindName}.wasm`);
+  const { default: WasmModule } = await import(path.join(wasmDir, `${bindName}.js`));
+  const module = await WasmModule({ binaryStream: fs.ReadStream(wasmBinaryPath) });
+  return { module, wasmBytes: fs.statSync(wasmBinaryPath).size };
+}
+
+// The mean time of a call, in microseconds, after a warm up.
+const timeCall = (call, iterations) => {
+  for (let i = 0; i < Math.min(iterations, 100); ++i) {
+    call(i);
+  }
+  const start = performance.now();
+  for (let i = 0; i < iterations; ++i) {
+    const response = call(i);
+    if (!response.ok) {
+      throw new Error(response.status);
+    }
+  }
+  return (performance.now() - start) * 1000 / iterations;
+};
+
+// `make` converts C++ to JS only, `echo` both ways.
+const cases = [
+  ['make', 2000, (api) => (i) => api.make(i)],
+  ['echo', 2000, (api) => {
+    const root = api.make(1).data;
+    return () => api.echo(root);
+  }],
+  ['echoMany x64', 50, (api) => {
+    const roots = Array.from({length: 64}, (_, i) => api.make(i).data);
+    return () => api.echoMany(roots);
+  }],
+];
+
+(async () => {
+  const { module, wasmBytes } = await loadSyntheticWasmModule();
+  console.log(`schema: ${module.schemaShape()}`);
+  console.log(`wasm: ${wasmBytes} bytes`);
+  const engines = [
+    ['val', () => new module.SyntheticApi()],
+    ['value_object', () => new module.SyntheticApiValueObject()],
+  ];
+  console.log(['case', ...engines.map(([name]) => `${name} (us/call)`), 'speedup'].join('\t'));
+  for (const [name, iterations, makeCall] of cases) {
+    const times = engines.map(([, makeApi]) => timeCall(makeCall(makeApi()), iterations));
+    console.log([name, ...times.map((t) => t.toFixed(2)), `${(times[0] / times[1]).toFixed(2)}x`].join('\t'));
+  }
+})();
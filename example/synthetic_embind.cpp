@@ -0,0 +1,20 @@
+#include <emscripten/bind.h>
+
+#include <string>
+
+#include "cppschema/wasm/js_api_bridge.h"
+#include "synthetic_api.h"
+
+namespace {
+
+std::string SchemaShape() { return synthetic::kSchemaShape; }
+
+}  // namespace
+
+// Both engines, compared by example/synthetic_benchmark.mjs.
+EMSCRIPTEN_BINDINGS(Synthetic) {
+    cppschema::jsbridge::CreateJsApiMethods<synthetic::SyntheticApi>("SyntheticApi");
+    cppschema::jsbridge::CreateJsApiMethods<synthetic::SyntheticApi, cppschema::jsbridge::JsEngine::kValueObject>(
+        "SyntheticApiValueObject");
+    emscripten::function("schemaShape", &SchemaShape);
+}
@@ -0,0 +1,130 @@
+"""Synthetic API specs of a configurable shape, for finding the schemas which are slow to convert,
+large or slow to compile before real ones grow into them. See schema_generator.h."""
+
+load("@aspect_rules_js//js:defs.bzl", "js_binary")
+load("@emsdk//emscripten_toolchain:wasm_rules.bzl", "wasm_cc_binary")
+load("@rules_cc//cc:defs.bzl", "cc_binary", "cc_library", "cc_test")
+
+def synthetic_schema(
+        name,
+        width = 8,
+        depth = 2,
+        containers = ["vector"],
+        enums = 1,
+        enum_values = 4,
+        fanout = 2):
+    """Generates a `SyntheticApi` of the given shape, and builds it natively and as wasm.
+
+    Defines:
+      <name>_api: The generated "synthetic_api.h".
+      <name>_test: The conversions round trip natively, see synthetic_schema_test.cpp.
+      <name>_benchmark: The native conversions, see synthetic_benchmark.cpp.
+      <name>_wasm: The wasm binary, with both bindings engines.
+      <name>_js_benchmark: The JS conversions, see synthetic_benchmark.mjs.
+
+    Args:
+      name: The prefix of the targets.
+      width: The fields per struct, up to 30.
+      depth: The levels of nested structs.
+      containers: The container kinds of the fields, see `ParseContainerKinds`.
+      enums: The enum types.
+      enum_values: The values per enum, up to 30.
+      fanout: The elements per container in the sample data.
+    """
+    flags = [
+        "--width=%d" % width,
+        "--depth=%d" % depth,
+        "--containers=%s" % ",".join(containers),
+        "--enums=%d" % enums,
+        "--enum_values=%d" % enum_values,
+        "--fanout=%d" % fanout,
+    ]
+    native.genrule(
+        name = name + "_gen",
+        outs = [name + "/synthetic_api.h"],
+        cmd = "$(location :generate_schema) %s --out=$@" % " ".join(flags),
+        tools = [":generate_schema"],
+    )
+
+    cc_library(
+        name = name + "_api",
+        hdrs = [name + "/synthetic_api.h"],
+        strip_include_prefix = name,
+        deps = [
+            "@cppschema//:apispec",
+            "@cppschema//:enum_registry",
+            "@cppschema//:visitor_macros",
+        ],
+    )
+
+    cc_library(
+        name = name + "_backend",
+        srcs = ["synthetic_backend.cpp"],
+        deps = [
+            ":" + name + "_api",
+            ":synthetic_schema",
+            "@cppschema//:backend_bridge",
+        ],
+        alwayslink = 1,
+    )
+
+    cc_test(
+        name = name + "_test",
+        srcs = ["synthetic_schema_test.cpp"],
+        deps = [
+            ":" + name + "_api",
+            ":" + name + "_backend",
+            ":synthetic_schema",
+            "@cppschema//:apispec",
+            "@cppschema//:wire_codec",
+            "@googletest//:gtest_main",
+        ],
+    )
+
+    cc_binary(
+        name = name + "_benchmark",
+        srcs = ["synthetic_benchmark.cpp"],
+        deps = [
+            ":" + name + "_api",
+            ":" + name + "_backend",
+            ":synthetic_schema",
+            "@cppschema//:apispec",
+            "@cppschema//:wire_codec",
+            "@google_benchmark//:benchmark",
+        ],
+    )
+
+    # Same as `graph_bind`, see BUILD.bazel.
+    cc_binary(
+        name = name + "_bind",
+        srcs = ["synthetic_embind.cpp"],
+        deps = [
+            ":" + name + "_api",
+            ":" + name + "_backend",
+            "@cppschema//:js_api_bridge",
+            "@cppschema//:js_converter",
+        ],
+        linkopts = [
+            "--bind",
+            "--closure=0",
+            "--no-entry",
+            "-s MODULARIZE",
+            "-s STANDALONE_WASM",
+            "-s ENVIRONMENT=node",
+            "-s WASM_BIGINT",
+            "-s ALLOW_MEMORY_GROWTH",
+        ],
+        tags = ["manual"],
+    )
+
+    wasm_cc_binary(
+        name = name + "_wasm",
+        cc_target = ":" + name + "_bind",
+    )
+
+    js_binary(
+        name = name + "_js_benchmark",
+        entry_point = "synthetic_benchmark.mjs",
+        data = [":" + name + "_wasm"],
+        args = [name + "_wasm", name + "_bind"],
+    )
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "cppschema/common/schema_traits.h"
+
+// The sample data of the generated schemas (see schema_generator.h), for any type of the schema:
+// the values are derived from a seed, and the containers get `fanout` elements each.
+
+namespace synthetic {
+
+/**
+ * Fills `value` from `seed`, recursing into the struct fields and the container elements. The
+ * enums are left to their first value.
+ *
+ * @example
+ * Root root;
+ * Fill(root, 42, kFanout);
+ */
+template <typename T>
+void Fill(T& value, uint32_t seed, int fanout) {
+    using namespace cppschema::internal;
+    if constexpr (std::is_same_v<T, bool>) {
+        value = (seed & 1) != 0;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        value = "value_" + std::to_string(seed);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        value = static_cast<T>(seed) * T(0.5);
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        value = static_cast<T>(seed);
+    } else if constexpr (is_enum_like<T>::value) {
+        value = T{};
+    } else if constexpr (is_optional_like<T>::value) {
+        Fill(value.emplace(), seed, fanout);
+    } else if constexpr (is_fixed_size_array<T>::value) {
+        for (size_t i = 0; i < value.size(); ++i) {
+            Fill(value[i], seed * 31 + static_cast<uint32_t>(i), fanout);
+        }
+    } else if constexpr (is_array_like<T>::value) {
+        value.clear();
+        for (int i = 0; i < fanout; ++i) {
+            Fill(value.emplace_back(), seed * 31 + i, fanout);
+        }
+    } else if constexpr (is_map_like<T>::value) {
+        value.clear();
+        for (int i = 0; i < fanout; ++i) {
+            Fill(value["key_" + std::to_string(i)], seed * 31 + i, fanout);
+        }
+    } else if constexpr (is_set_like<T>::value) {
+        value.clear();
+        for (int i = 0; i < fanout; ++i) {
+            typename T::value_type element;
+            Fill(element, seed * 31 + i, fanout);
+            value.insert(std::move(element));
+        }
+    } else if constexpr (is_visible_struct_like<T>::value) {
+        uint32_t field = 0;
+        auto visitor = [&]<typename F>(const char*, F& member) { Fill(member, seed + field++, fanout); };
+        value._visit_members(visitor);
+    } else {
+        static_assert(always_false_v<T>, "Not a type of the generated schemas");
+    }
+}
+
+// The scalar values in `value`, i.e. the bools, numbers, strings and enums, for reporting the
+// throughput of the conversions per value.
+template <typename T>
+size_t CountValues(const T& value) {
+    using namespace cppschema::internal;
+    if constexpr (is_primitive_like<T>::value || is_enum_like<T>::value) {
+        return 1;
+    } else if constexpr (is_optional_like<T>::value) {
+        return value.has_value() ? CountValues(*value) : 0;
+    } else if constexpr (is_map_like<T>::value) {
+        size_t count = 0;
+        for (const auto& [key, element] : value) {
+            count += 1 + CountValues(element);
+        }
+        return count;
+    } else if constexpr (is_array_like<T>::value || is_set_like<T>::value) {
+        size_t count = 0;
+        for (const auto& element : value) {
+            count += CountValues(element);
+        }
+        return count;
+    } else if constexpr (is_visible_struct_like<T>::value) {
+        size_t count = 0;
+        auto visitor = [&]<typename F>(const char*, const F& member) { count += CountValues(member); };
+        value._visit_members(visitor);
+        return count;
+    } else {
+        static_assert(always_false_v<T>, "Not a type of the generated schemas");
+    }
+}
+
+}  // namespace synthetic